@@ -62,6 +62,11 @@ namespace GeoGenfun {
     virtual double operator() (double argument)          const=0;   
     virtual double operator() (const Argument &argument) const=0; 
 
+    // Function values over an array (1D functions):  y[i]=f(x[i]) for i<n.
+    // x and y may be the same array.  The default calls operator() for each
+    // value; the functions of the library override it with plain loops.
+    virtual void evaluate(const double *x, double *y, unsigned int n) const;
+
     // Every function must override this:
     virtual AbsFunction * clone() const=0;
   
@@ -80,9 +85,20 @@ namespace GeoGenfun {
     // Does this function have an analytic derivative?
     virtual bool hasAnalyticDerivative() const {return false;}
 
+    // Is this function linear, a*x+b (1D functions)?  If so the coefficients
+    // are returned.  Functions say so when it follows from their form, which
+    // lets the transform functions built on them be evaluated in closed form.
+    virtual bool isLinear(double & a, double & b) const;
+
     // Derivative.  Overriders may be provided, numerical method by default!
     virtual Derivative partial(unsigned int) const;
   
+  protected:
+
+    // Composite functions evaluate arrays in chunks of this size, in
+    // buffers on the stack:
+    static constexpr unsigned int EVALUATION_CHUNK = 256;
+
   private:
 
     // It is illegal to assign a function.
@@ -8,6 +8,7 @@
 //                                                                     //
 // A function of more than one variable uses this argument class to    //
 // agglomerate the variables. It is similar to a vector.               // 
+// Arguments of few dimensions do not allocate memory.                 //
 //                                                                     //
 //---------------------------------------------------------------------//
 #ifndef ARGUMENT_H
@@ -48,52 +49,73 @@ namespace GeoGenfun {
 
   private:
 
-    std::vector<double> *_data;
+    // Arguments of up to this many dimensions are held in place,
+    // larger ones on the heap:
+    static constexpr unsigned int NLOCAL = 4;
+
+    // Points to the values, either _local or a heap array:
+    double       *_data;
+    unsigned int  _ndim;
+    double        _local[NLOCAL];
+
+    // Makes room for ndim values, dropping the current ones:
+    void resize(unsigned int ndim);
 
     friend std::ostream & operator << (std::ostream & o, const Argument & a);
 
   };
 
+  inline void Argument::resize(unsigned int ndim) {
+    if (_data!=_local) delete [] _data;
+    _data = ndim > NLOCAL ? new double[ndim] : _local;
+    _ndim = ndim;
+  }
+
   inline Argument::Argument(const Argument & right):
-    _data(new std::vector<double>(*(right._data))){
+    _data(_local),_ndim(0) {
+    resize(right._ndim);
+    std::copy(right._data,right._data+_ndim,_data);
   }
 
   inline const Argument & Argument::operator=( const Argument & right) {
     if (this != &right) {
-      delete _data;
-      _data = nullptr;
-      _data = new std::vector<double>(*(right._data));
+      if (_ndim!=right._ndim) resize(right._ndim);
+      std::copy(right._data,right._data+_ndim,_data);
     }
     return *this;
   }
 
   inline unsigned int Argument::dimension() const {
-    return static_cast<unsigned int>(_data->size());
+    return _ndim;
   }
 
   inline double & Argument::operator[] (int i) {
-    return (*_data)[i];
+    return _data[i];
   } 
 
   inline const double & Argument::operator[] (int i) const {
-    return (*_data)[i];
+    return _data[i];
   } 
 
-  inline Argument::Argument(int ndim): _data(new std::vector<double>(ndim)) {
+  inline Argument::Argument(int ndim): _data(_local),_ndim(0) {
+    resize(ndim);
+    std::fill(_data,_data+_ndim,0.0);
   }
 
   inline Argument::~Argument() {
-    delete _data;
+    if (_data!=_local) delete [] _data;
   }
 
   // Construct from initializer list:
-  inline Argument::Argument(std::initializer_list<double> lst):_data(new std::vector<double>(lst)) {
+  inline Argument::Argument(std::initializer_list<double> lst):_data(_local),_ndim(0) {
+    resize(static_cast<unsigned int>(lst.size()));
+    std::copy(lst.begin(),lst.end(),_data);
   }
 
 
   inline std::ostream & operator << (std::ostream & os, const Argument & a) {
     std::ostream_iterator<double> oi(os,",");
-    std::copy (a._data->begin(),a._data->end(),oi);
+    std::copy (a._data,a._data+a._ndim,oi);
     return os;
   }
 
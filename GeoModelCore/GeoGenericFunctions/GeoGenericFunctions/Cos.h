@@ -33,6 +33,7 @@ namespace GeoGenfun {
     // Retreive function value
     virtual double operator ()(double argument) const override;
     virtual double operator ()(const Argument & a) const override {return operator() (a[0]);}
+    virtual void evaluate(const double *x, double *y, unsigned int n) const override;
 
     // Derivative.  
     virtual Derivative partial (unsigned int) const override;
@@ -38,12 +38,16 @@ namespace GeoGenfun {
     // Retrieve function value
     virtual double operator ()(double argument) const override;
     virtual double operator ()(const Argument & a) const override {return operator() (a[0]);}
+    virtual void evaluate(const double *x, double *y, unsigned int n) const override;
   
     // Derivative.  
     virtual Derivative partial (unsigned int) const override;
 
     // Does this function have an analytic derivative?
     virtual bool hasAnalyticDerivative() const override {return true;}
+
+    // Is this function linear, a*x+b?
+    virtual bool isLinear(double & a, double & b) const override;
   
   private:
 
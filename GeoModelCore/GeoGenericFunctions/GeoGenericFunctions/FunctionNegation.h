@@ -36,6 +36,7 @@ namespace GeoGenfun {
     // Retreive function value
     virtual double operator ()(double argument) const override;
     virtual double operator ()(const Argument & a) const override;
+    virtual void evaluate(const double *x, double *y, unsigned int n) const override;
   
     // Dimensionality 
     virtual unsigned int dimensionality() const override;
@@ -46,6 +47,9 @@ namespace GeoGenfun {
     // Does this function have an analytic derivative?
     virtual bool hasAnalyticDerivative() const override {return true;}
 
+    // Is this function linear, a*x+b?
+    virtual bool isLinear(double & a, double & b) const override;
+
   private:
   
     // It is illegal to assign a FunctionNegation
@@ -26,6 +26,7 @@ namespace GeoGenfun {
 
     virtual double operator ()(double argument) const override; 
     virtual double operator ()(const Argument & a) const override {return operator() (a[0]);}
+    virtual void evaluate(const double *x, double *y, unsigned int n) const override;
 
     // Retrieve the modulus:
     double modulus() const {return _y;}
@@ -36,6 +36,7 @@ namespace GeoGenfun {
 
     virtual double operator ()(double argument) const override;
     virtual double operator ()(const Argument & a) const override {return operator() (a[0]);}
+    virtual void evaluate(const double *x, double *y, unsigned int n) const override;
   
     // Derivative.  
     virtual Derivative partial (unsigned int) const override;
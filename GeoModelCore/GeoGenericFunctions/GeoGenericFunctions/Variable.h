@@ -39,6 +39,7 @@ namespace GeoGenfun {
     // Retrieve function value
     virtual double operator ()(double argument) const override; 
     virtual double operator ()(const Argument & a) const override;
+    virtual void evaluate(const double *x, double *y, unsigned int n) const override;
 
     // Get the dimensionality, as specified in the constructor:
     virtual unsigned int dimensionality() const override;  
@@ -52,6 +53,9 @@ namespace GeoGenfun {
     // Does this function have an analytic derivative?
     virtual bool hasAnalyticDerivative() const override {return true;}
 
+    // Is this function linear, a*x+b?
+    virtual bool isLinear(double & a, double & b) const override;
+
   private:
 
     // It is illegal to assign a fixed constant
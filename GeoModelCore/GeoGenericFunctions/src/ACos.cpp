@@ -26,6 +26,10 @@ double ACos::operator() (double x) const {
   return acos(x);
 }
 
+void ACos::evaluate(const double *x, double *y, unsigned int n) const {
+  for (unsigned int i=0;i<n;i++) y[i]=acos(x[i]);
+}
+
 
 Derivative ACos::partial(unsigned int index) const {
  if (index!=0) throw std::range_error("ACos: partial derivative index out of range");
@@ -26,6 +26,10 @@ double ASin::operator() (double x) const {
   return asin(x);
 }
 
+void ASin::evaluate(const double *x, double *y, unsigned int n) const {
+  for (unsigned int i=0;i<n;i++) y[i]=asin(x[i]);
+}
+
 
 
 Derivative ASin::partial(unsigned int index) const {
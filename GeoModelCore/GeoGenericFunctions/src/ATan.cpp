@@ -25,6 +25,10 @@ double ATan::operator() (double x) const {
   return atan(x);
 }
 
+void ATan::evaluate(const double *x, double *y, unsigned int n) const {
+  for (unsigned int i=0;i<n;i++) y[i]=atan(x[i]);
+}
+
 // don't generate warnings about unused parameter inside assert
 #if defined __GNUC__ 
   #if __GNUC__ > 3 && __GNUC_MINOR__ > 6
@@ -79,6 +79,14 @@ unsigned int AbsFunction::dimensionality() const {
   return 1;
 }
 
+bool AbsFunction::isLinear(double &, double &) const {
+  return false;
+}
+
+void AbsFunction::evaluate(const double *x, double *y, unsigned int n) const {
+  for (unsigned int i=0;i<n;i++) y[i]=(*this)(x[i]);
+}
+
 FunctionDirectProduct operator % (const AbsFunction & a, const AbsFunction & b) {
   return FunctionDirectProduct(&a,&b);
 }
@@ -43,6 +43,19 @@ double ConstMinusFunction::operator ()(const Argument & x) const
   return _constant - (*_arg)(x);
 }
 
+void ConstMinusFunction::evaluate(const double *x, double *y, unsigned int n) const {
+  _arg->evaluate(x,y,n);
+  const double c=_constant;
+  for (unsigned int i=0;i<n;i++) y[i]=c - y[i];
+}
+
+bool ConstMinusFunction::isLinear(double & a, double & b) const {
+  if (!_arg->isLinear(a,b)) return false;
+  a=-a;
+  b=_constant-b;
+  return true;
+}
+
 
 Derivative ConstMinusFunction::partial(unsigned int index) const {
   const Derivative & d=_arg->partial(index);
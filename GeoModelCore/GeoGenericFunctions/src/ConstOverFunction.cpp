@@ -43,6 +43,19 @@ double ConstOverFunction::operator ()(const Argument & x) const
   return _constant / (*_arg)(x);
 }
 
+void ConstOverFunction::evaluate(const double *x, double *y, unsigned int n) const {
+  _arg->evaluate(x,y,n);
+  const double c=_constant;
+  for (unsigned int i=0;i<n;i++) y[i]=c / y[i];
+}
+
+bool ConstOverFunction::isLinear(double & a, double & b) const {
+  // Only if the denominator is a constant:
+  if (!_arg->isLinear(a,b) || a!=0) return false;
+  b=_constant/b;
+  return true;
+}
+
 
 Derivative ConstOverFunction::partial(unsigned int index) const {
   // d/dx (k/f) = -(k/f^2)(df/dx)
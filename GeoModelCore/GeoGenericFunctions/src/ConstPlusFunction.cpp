@@ -42,6 +42,18 @@ double ConstPlusFunction::operator ()(const Argument & x) const
   return _constant + (*_arg)(x);
 }
 
+void ConstPlusFunction::evaluate(const double *x, double *y, unsigned int n) const {
+  _arg->evaluate(x,y,n);
+  const double c=_constant;
+  for (unsigned int i=0;i<n;i++) y[i]=c + y[i];
+}
+
+bool ConstPlusFunction::isLinear(double & a, double & b) const {
+  if (!_arg->isLinear(a,b)) return false;
+  b=_constant+b;
+  return true;
+}
+
 
 Derivative ConstPlusFunction::partial(unsigned int index) const {
   const Derivative & d=_arg->partial(index);
@@ -42,6 +42,19 @@ double ConstTimesFunction::operator ()(const Argument & x) const
   return _constant * (*_arg)(x);
 }
 
+void ConstTimesFunction::evaluate(const double *x, double *y, unsigned int n) const {
+  _arg->evaluate(x,y,n);
+  const double c=_constant;
+  for (unsigned int i=0;i<n;i++) y[i]=c * y[i];
+}
+
+bool ConstTimesFunction::isLinear(double & a, double & b) const {
+  if (!_arg->isLinear(a,b)) return false;
+  a=_constant*a;
+  b=_constant*b;
+  return true;
+}
+
   Derivative ConstTimesFunction::partial(unsigned int index) const {
     // d/dx (k*f) = k*(df/dx)
     const Derivative & d=_arg->partial(index);
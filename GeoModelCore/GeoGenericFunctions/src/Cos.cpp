@@ -25,6 +25,10 @@ double Cos::operator() (double x) const {
   return cos(x);
 }
 
+void Cos::evaluate(const double *x, double *y, unsigned int n) const {
+  for (unsigned int i=0;i<n;i++) y[i]=cos(x[i]);
+}
+
 
 Derivative Cos::partial(unsigned int index) const {
   if (index!=0) throw std::range_error("Cos:  partial derivative index ot of range");
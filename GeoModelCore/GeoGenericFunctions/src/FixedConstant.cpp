@@ -6,6 +6,7 @@
 
 #include "GeoGenericFunctions/FixedConstant.h"
 #include <stdexcept>
+#include <algorithm>
 
 namespace GeoGenfun {
 FUNCTION_OBJECT_IMP(FixedConstant)
@@ -28,6 +29,16 @@ double FixedConstant::operator ()(double) const
   return _value;
 }
 
+void FixedConstant::evaluate(const double *, double *y, unsigned int n) const {
+  std::fill(y,y+n,_value);
+}
+
+bool FixedConstant::isLinear(double & a, double & b) const {
+  a=0;
+  b=_value;
+  return true;
+}
+
 Derivative FixedConstant::partial(unsigned int index) const {
   if (index!=0) throw std::range_error("FixedConstant: partial derivative index out of range");
   FixedConstant fPrime(0.0);
@@ -53,6 +53,22 @@ double FunctionComposition::operator() (const Argument &  v) const {
   }
 }
 
+void FunctionComposition::evaluate(const double *x, double *y, unsigned int n) const {
+  if (dimensionality()!=1) {
+    throw std::runtime_error("FunctionComposition: dimension mismatch");
+  }
+  _arg2->evaluate(x,y,n);
+  _arg1->evaluate(y,y,n);
+}
+
+bool FunctionComposition::isLinear(double & a, double & b) const {
+  double a2, b2;
+  if (!_arg1->isLinear(a,b) || !_arg2->isLinear(a2,b2)) return false;
+  b=a*b2+b;
+  a=a*a2;
+  return true;
+}
+
 
 Derivative FunctionComposition::partial(unsigned int index) const {
   const Derivative & d1=_arg1->partial(0);
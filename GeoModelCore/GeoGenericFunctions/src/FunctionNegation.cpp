@@ -41,6 +41,18 @@ double FunctionNegation::operator ()(const Argument & x) const
   return -((*_arg1)(x));
 }
 
+void FunctionNegation::evaluate(const double *x, double *y, unsigned int n) const {
+  _arg1->evaluate(x,y,n);
+  for (unsigned int i=0;i<n;i++) y[i]=-y[i];
+}
+
+bool FunctionNegation::isLinear(double & a, double & b) const {
+  if (!_arg1->isLinear(a,b)) return false;
+  a=-a;
+  b=-b;
+  return true;
+}
+
 
 Derivative FunctionNegation::partial(unsigned int index) const {
   const Derivative & d = _arg1->partial(index);
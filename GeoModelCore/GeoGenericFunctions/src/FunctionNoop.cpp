@@ -40,6 +40,14 @@ double FunctionNoop::operator ()(const Argument & x) const
   return +((*_arg1)(x));
 }
 
+void FunctionNoop::evaluate(const double *x, double *y, unsigned int n) const {
+  _arg1->evaluate(x,y,n);
+}
+
+bool FunctionNoop::isLinear(double & a, double & b) const {
+  return _arg1->isLinear(a,b);
+}
+
 
 Derivative FunctionNoop::partial(unsigned int index) const {
   return _arg1->partial(index);
@@ -46,6 +46,12 @@ double FunctionPlusParameter::operator ()(const Argument & x) const
   return _parameter->getValue() + (*_function)(x);
 }
 
+void FunctionPlusParameter::evaluate(const double *x, double *y, unsigned int n) const {
+  _function->evaluate(x,y,n);
+  const double c=_parameter->getValue();
+  for (unsigned int i=0;i<n;i++) y[i]=c + y[i];
+}
+
 Derivative FunctionPlusParameter::partial(unsigned int index) const {
   const Derivative & d=_function->partial(index);
   return d;
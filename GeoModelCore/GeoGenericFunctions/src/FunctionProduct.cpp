@@ -6,6 +6,7 @@
 
 #include "GeoGenericFunctions/FunctionProduct.h"
 #include <stdexcept>
+#include <algorithm>
 
 namespace GeoGenfun {
 FUNCTION_OBJECT_IMP(FunctionProduct)
@@ -47,6 +48,33 @@ double FunctionProduct::operator ()(const Argument & x) const
   return (*_arg1)(x)*(*_arg2)(x);
 }
 
+void FunctionProduct::evaluate(const double *x, double *y, unsigned int n) const {
+  double tmp[EVALUATION_CHUNK];
+  for (unsigned int i=0;i<n;i+=EVALUATION_CHUNK) {
+    unsigned int m=std::min(n-i,EVALUATION_CHUNK);
+    _arg2->evaluate(x+i,tmp,m);
+    _arg1->evaluate(x+i,y+i,m);
+    for (unsigned int j=0;j<m;j++) y[i+j]=y[i+j]*tmp[j];
+  }
+}
+
+bool FunctionProduct::isLinear(double & a, double & b) const {
+  // Only if one of the factors is a constant:
+  double a2, b2;
+  if (!_arg1->isLinear(a,b) || !_arg2->isLinear(a2,b2)) return false;
+  if (a==0) {
+    a=b*a2;
+    b=b*b2;
+    return true;
+  }
+  if (a2==0) {
+    a=a*b2;
+    b=b*b2;
+    return true;
+  }
+  return false;
+}
+
 Derivative FunctionProduct::partial(unsigned int index) const {
   const Derivative & d1=_arg1->partial(index);
   const Derivative & d2=_arg2->partial(index);
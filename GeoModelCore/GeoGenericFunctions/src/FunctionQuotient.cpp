@@ -6,6 +6,7 @@
 
 #include "GeoGenericFunctions/FunctionQuotient.h"
 #include <stdexcept>
+#include <algorithm>
 
 namespace GeoGenfun {
 FUNCTION_OBJECT_IMP(FunctionQuotient)
@@ -45,6 +46,25 @@ double FunctionQuotient::operator ()(const Argument & x) const
   return (*_arg1)(x)/(*_arg2)(x);
 }
 
+void FunctionQuotient::evaluate(const double *x, double *y, unsigned int n) const {
+  double tmp[EVALUATION_CHUNK];
+  for (unsigned int i=0;i<n;i+=EVALUATION_CHUNK) {
+    unsigned int m=std::min(n-i,EVALUATION_CHUNK);
+    _arg2->evaluate(x+i,tmp,m);
+    _arg1->evaluate(x+i,y+i,m);
+    for (unsigned int j=0;j<m;j++) y[i+j]=y[i+j]/tmp[j];
+  }
+}
+
+bool FunctionQuotient::isLinear(double & a, double & b) const {
+  // Only if the denominator is a constant:
+  double a2, b2;
+  if (!_arg1->isLinear(a,b) || !_arg2->isLinear(a2,b2) || a2!=0) return false;
+  a=a/b2;
+  b=b/b2;
+  return true;
+}
+
 
 Derivative FunctionQuotient::partial(unsigned int index) const {
   const Derivative & d1=_arg1->partial(index);
@@ -6,6 +6,7 @@
 
 #include "GeoGenericFunctions/FunctionSum.h"
 #include <stdexcept>
+#include <algorithm>
     
 
 namespace GeoGenfun {
@@ -49,6 +50,24 @@ double FunctionSum::operator ()(const Argument & x) const
   return (*_arg1)(x)+(*_arg2)(x);
 }
 
+void FunctionSum::evaluate(const double *x, double *y, unsigned int n) const {
+  double tmp[EVALUATION_CHUNK];
+  for (unsigned int i=0;i<n;i+=EVALUATION_CHUNK) {
+    unsigned int m=std::min(n-i,EVALUATION_CHUNK);
+    _arg2->evaluate(x+i,tmp,m);
+    _arg1->evaluate(x+i,y+i,m);
+    for (unsigned int j=0;j<m;j++) y[i+j]=y[i+j]+tmp[j];
+  }
+}
+
+bool FunctionSum::isLinear(double & a, double & b) const {
+  double a2, b2;
+  if (!_arg1->isLinear(a,b) || !_arg2->isLinear(a2,b2)) return false;
+  a=a+a2;
+  b=b+b2;
+  return true;
+}
+
 
 
 Derivative FunctionSum::partial(unsigned int index) const {
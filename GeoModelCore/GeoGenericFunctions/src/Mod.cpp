@@ -26,4 +26,8 @@ double Mod::operator() (double x) const {
   return (x - _y*floor(x/_y));
 }
 
+void Mod::evaluate(const double *x, double *y, unsigned int n) const {
+  for (unsigned int i=0;i<n;i++) y[i]=x[i] - _y*floor(x[i]/_y);
+}
+
 } // namespace GeoGenfun
@@ -6,6 +6,7 @@
 #include "GeoGenericFunctions/Power.h"
 #include <cmath>      // for pow()
 #include <stdexcept>
+#include <algorithm>
 namespace GeoGenfun {
 FUNCTION_OBJECT_IMP(Power)
 
@@ -60,6 +61,31 @@ double Power::operator() (double x) const {
 
 }
 
+void Power::evaluate(const double *x, double *y, unsigned int n) const {
+  if (!_asInteger) {
+    for (unsigned int i=0;i<n;i++) y[i]=std::pow(x[i],_doublePower);
+    return;
+  }
+  // The same products or quotients as operator(), one factor at a time
+  // over a chunk of the array:
+  double tmp[EVALUATION_CHUNK];
+  for (unsigned int i=0;i<n;i+=EVALUATION_CHUNK) {
+    unsigned int m=std::min(n-i,EVALUATION_CHUNK);
+    std::copy(x+i,x+i+m,tmp);
+    std::fill(y+i,y+i+m,1.0);
+    if (_intPower>0) {
+      for (int k=0;k<_intPower;k++) {
+        for (unsigned int j=0;j<m;j++) y[i+j]*=tmp[j];
+      }
+    }
+    else {
+      for (int k=0;k<-_intPower;k++) {
+        for (unsigned int j=0;j<m;j++) y[i+j]/=tmp[j];
+      }
+    }
+  }
+}
+
 
 
 Derivative Power::partial(unsigned int index) const {
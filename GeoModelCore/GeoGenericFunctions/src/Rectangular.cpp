@@ -41,6 +41,12 @@ double Rectangular::operator() (double x) const {
   }
 }
 
+void Rectangular::evaluate(const double *x, double *y, unsigned int n) const {
+  const double x0=_x0.getValue(), x1=_x1.getValue();
+  const double baseline=_baseline.getValue(), height=_height.getValue();
+  for (unsigned int i=0;i<n;i++) y[i]=(x[i]>=x0 && x[i]<x1) ? height : baseline;
+}
+
 Parameter & Rectangular::x0() {
   return _x0;
 }
@@ -25,6 +25,10 @@ double Sin::operator() (double x) const {
   return sin(x);
 }
 
+void Sin::evaluate(const double *x, double *y, unsigned int n) const {
+  for (unsigned int i=0;i<n;i++) y[i]=sin(x[i]);
+}
+
 
 
 Derivative Sin::partial(unsigned int index) const {
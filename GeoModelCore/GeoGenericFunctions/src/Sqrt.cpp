@@ -23,6 +23,10 @@ double Sqrt::operator() (double x) const {
   return sqrt(x);
 }
 
+void Sqrt::evaluate(const double *x, double *y, unsigned int n) const {
+  for (unsigned int i=0;i<n;i++) y[i]=sqrt(x[i]);
+}
+
 
 Derivative Sqrt::partial(unsigned int index) const {
   if (index!=0) throw std::range_error("Sqrt: partial derivative index out of range");
@@ -24,6 +24,10 @@ double Square::operator() (double x) const {
   return x*x;
 }
 
+void Square::evaluate(const double *x, double *y, unsigned int n) const {
+  for (unsigned int i=0;i<n;i++) y[i]=x[i]*x[i];
+}
+
 
 
 Derivative Square::partial(unsigned int index) const {
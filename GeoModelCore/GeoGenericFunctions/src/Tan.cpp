@@ -25,6 +25,10 @@ double Tan::operator() (double x) const {
   return tan(x);
 }
 
+void Tan::evaluate(const double *x, double *y, unsigned int n) const {
+  for (unsigned int i=0;i<n;i++) y[i]=tan(x[i]);
+}
+
 
 
 Derivative Tan::partial(unsigned int index) const {
@@ -23,6 +23,10 @@ double Theta::operator() (double x) const {
   return (x>=0) ? 1.0:0.0;
 }
 
+void Theta::evaluate(const double *x, double *y, unsigned int n) const {
+  for (unsigned int i=0;i<n;i++) y[i]=(x[i]>=0) ? 1.0:0.0;
+}
+
 
 
 Derivative Theta::partial(unsigned int index) const {
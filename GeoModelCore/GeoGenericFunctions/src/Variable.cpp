@@ -7,6 +7,7 @@
 #include "GeoGenericFunctions/Variable.h"
 #include "GeoGenericFunctions/KVector.h"
 #include <stdexcept>
+#include <algorithm>
 namespace GeoGenfun {
 FUNCTION_OBJECT_IMP(Variable)
 
@@ -35,6 +36,18 @@ double Variable::operator () (const Argument & a) const {
   return a[_selectionIndex];
 }
 
+void Variable::evaluate(const double *x, double *y, unsigned int n) const {
+  if (_selectionIndex!=0) throw std::runtime_error("GeoGenfun::Variable: selection index !=0") ;
+  if (x!=y) std::copy(x,x+n,y);
+}
+
+bool Variable::isLinear(double & a, double & b) const {
+  if (_selectionIndex!=0 || _dimensionality!=1) return false;
+  a=1;
+  b=0;
+  return true;
+}
+
 unsigned int Variable::index() const {
   return _selectionIndex;
 }
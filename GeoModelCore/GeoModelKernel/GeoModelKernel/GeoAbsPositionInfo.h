@@ -39,6 +39,13 @@ class GeoAbsPositionInfo
   //	Sets the absolute transform.
   void setDefAbsTransform (const GeoTrf::Transform3D &  xform);
 
+  //	Returns the alignment epoch at which the absolute transform
+  //	was computed.  See GeoAlignableTransform.
+  unsigned long long getEpoch () const;
+
+  //	Sets the alignment epoch of the absolute transform.
+  void setEpoch (unsigned long long epoch);
+
  private:
   GeoAbsPositionInfo(const GeoAbsPositionInfo &right);
   GeoAbsPositionInfo & operator=(const GeoAbsPositionInfo &right);
@@ -50,6 +57,11 @@ class GeoAbsPositionInfo
   //	The default absolute transform from the world coord down
   //	to this positioned object.
   GeoTrf::Transform3D *m_defAbsTransform;
+
+  //	The alignment epoch at which the absolute transform was
+  //	computed.  The transform is stale if any ancestor has been
+  //	realigned since.
+  unsigned long long m_epoch;
 };
 
 inline const GeoTrf::Transform3D * GeoAbsPositionInfo::getAbsTransform () const
@@ -62,4 +74,14 @@ inline const GeoTrf::Transform3D * GeoAbsPositionInfo::getDefAbsTransform () con
   return m_defAbsTransform;
 }
 
+inline unsigned long long GeoAbsPositionInfo::getEpoch () const
+{
+  return m_epoch;
+}
+
+inline void GeoAbsPositionInfo::setEpoch (unsigned long long epoch)
+{
+  m_epoch = epoch;
+}
+
 #endif
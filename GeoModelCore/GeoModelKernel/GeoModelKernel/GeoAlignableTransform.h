@@ -6,11 +6,29 @@
 #define GEOMODELKERNEL_GEOALIGNABLETRANSFORM_H
 
 #include "GeoModelKernel/GeoTransform.h"
+#include <atomic>
 #include <vector>
 #include <mutex>
 
 class GeoVAlignmentStore;
 
+/**
+ * @class GeoAlignableTransform
+ *
+ * @brief A transform which can be corrected by an alignment delta.
+ *
+ * When a delta is set without an alignment store, the absolute positions
+ * cached by full physical volumes are invalidated lazily: the parent
+ * volumes are stamped with the current alignment epoch, and a cached
+ * absolute position is recomputed on its next access if any of its
+ * ancestors carries a stamp at least as recent as the cache.  Setting a
+ * delta therefore costs O(number of parents) and no graph traversal.
+ *
+ * Many deltas can be applied as one update between beginBatchUpdate()
+ * and commitBatchUpdate(); they then share a single epoch.  Alignment
+ * updates are expected to come from one thread at a time.
+ */
+
 class GeoAlignableTransform final : public GeoTransform
 {
  public:
@@ -19,6 +37,9 @@ class GeoAlignableTransform final : public GeoTransform
   /// Gets the total transform, including the alignment correction
   virtual GeoTrf::Transform3D getTransform(const GeoVAlignmentStore* store=nullptr) const override;
 
+  /// Multiplies x on the right by the total transform, including the alignment correction
+  virtual void accumulateTransform(GeoTrf::Transform3D& x, const GeoVAlignmentStore* store=nullptr) const override;
+
   /// Sets an alignment delta
   void setDelta(const GeoTrf::Transform3D& delta, GeoVAlignmentStore* store=nullptr);
 
@@ -34,6 +55,21 @@ class GeoAlignableTransform final : public GeoTransform
   /// take some actions, such as adding the parent volume to a list
   virtual void dockTo(GeoVPhysVol* parent) override;
 
+  /// Returns the current alignment epoch.  Absolute positions computed
+  /// now are stamped with this value.
+  static unsigned long long getCurrentEpoch();
+
+  /// Returns the epoch of the most recent alignment change.  Positions
+  /// stamped with a later epoch are known to be up to date.
+  static unsigned long long getLastChangeEpoch();
+
+  /// Starts a batch of alignment updates.  Batches may be nested.
+  static void beginBatchUpdate();
+
+  /// Ends a batch of alignment updates, moving on to a new epoch when
+  /// the outermost batch is committed.
+  static void commitBatchUpdate();
+
  protected:
   virtual ~GeoAlignableTransform() override;
 
@@ -50,9 +86,17 @@ class GeoAlignableTransform final : public GeoTransform
   // memory corruption in multithreaded applications
   mutable std::mutex m_deltaMutex;
   
+  // Stamps the parents with the current epoch
+  void markParents() const;
+
   // A list of parents who use this alignable target.  They
   // must all be notified when the alignment changes!
-  std::vector<GeoGraphNode*>  m_parentList;
+  std::vector<GeoVPhysVol*>  m_parentList;
+
+  // The alignment epochs, see the class description
+  static std::atomic<unsigned long long> s_epoch;
+  static std::atomic<unsigned long long> s_lastChangeEpoch;
+  static std::atomic<unsigned int>       s_batchDepth;
 };
 
 #endif
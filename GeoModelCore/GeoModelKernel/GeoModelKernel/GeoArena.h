@@ -0,0 +1,165 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEOARENA_H
+#define GEOMODELKERNEL_GEOARENA_H
+
+/**
+ * @class GeoArena
+ *
+ * @brief Bulk memory for reference counted objects (RCBase): nodes,
+ * shapes, materials, facets...
+ *
+ * While a GeoArena::Scope is open on a thread, the objects created on that
+ * thread take their memory from the arena, in large blocks, instead of
+ * from the heap.  Deleting such an object runs its destructor but frees
+ * nothing; the arena frees all its blocks at once when it has been
+ * released and its last object is gone:
+ *
+ *     GeoArena* arena = new GeoArena;
+ *     {
+ *       GeoArena::Scope scope(arena);
+ *       world = buildWorld();
+ *     }
+ *     arena->release();
+ *     ...
+ *     world->unref();   // the arena goes with the last node in it
+ *
+ * Several threads may fill one arena, each within its own scope.
+ *
+ * For single-threaded construction, the objects in an arena may use
+ * non-atomic reference counts.  Their counts must then be changed by one
+ * thread at a time, until the arena is switched back to atomic counts
+ * (before the tree is handed to other threads).
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class GeoArena
+{
+ public:
+  /// Takes memory from the system in blocks of at least blockSize bytes.
+  GeoArena(size_t blockSize=1<<20);
+
+  GeoArena(const GeoArena &right) = delete;
+  GeoArena & operator=(const GeoArena &right) = delete;
+
+  /// Gives up the arena.  It is deleted, with all its memory, as soon as
+  /// no object in it remains and no scope is open on it.
+  void release();
+
+  /// Chooses atomic (the default) or non-atomic reference counts for the
+  /// objects in the arena.
+  void setAtomicRefCounts(bool atomic);
+  bool getAtomicRefCounts() const;
+
+  /// Returns the number of blocks taken from the system, and the number of
+  /// bytes handed to objects and of objects created in the scopes closed.
+  size_t getNBlocks() const;
+  size_t getBytesAllocated() const;
+  unsigned long getNObjects() const;
+
+  /// While it exists, objects created on the calling thread are placed in
+  /// the arena.  Scopes may be nested, the innermost one being in effect.
+  class Scope
+  {
+  public:
+    Scope(GeoArena* arena);
+    ~Scope();
+
+    Scope(const Scope &right) = delete;
+    Scope & operator=(const Scope &right) = delete;
+
+  private:
+    friend class GeoArena;
+    GeoArena* m_arena;
+    Scope*    m_previous;
+    /// The block being filled by this scope.
+    char*     m_begin;
+    char*     m_cursor;
+    char*     m_end;
+    /// The last allocation, which the object being constructed is usually in.
+    char*     m_last;
+    /// Objects and bytes allocated, added to the arena totals at the end.
+    unsigned long m_nObjects;
+    size_t        m_bytes;
+  };
+
+  /// Used by RCBase: memory from the arena in scope on the calling thread,
+  /// or nullptr if there is none.
+  static void* allocate(size_t size, size_t alignment);
+  /// Used by RCBase: the slot of the arena holding an object just
+  /// allocated, or 0 if it is on the heap.
+  static unsigned int slotOf(const void* object);
+  /// Used by RCBase: notes that an object of the arena in the slot is gone.
+  static void deallocate(unsigned int slot);
+  /// Used by RCBase: true if the memory of an object which failed to
+  /// construct belongs to an arena in scope.  The arena forgets it.
+  static bool isInScope(const void* p);
+  /// Used by RCBase: the arena in a slot.
+  static const GeoArena* inSlot(unsigned int slot);
+
+ private:
+  /// The arenas in existence, by slot.  Objects refer to their arena by
+  /// slot, which fits in the padding of RCBase.  The slots are allocated
+  /// in chunks as arenas are created, and the chunks are never moved.
+  static constexpr unsigned int SLOTS_PER_CHUNK = 4096;
+  static std::atomic<std::atomic<GeoArena*>*> s_chunks[];
+  static std::atomic<GeoArena*>& slotAt(unsigned int slot);
+
+  ~GeoArena();
+
+  /// Gives a scope a new block able to hold size bytes.
+  void newBlock(Scope* scope, size_t size);
+  bool owns(const void* p) const;
+  /// Drops one of the references which keep the arena alive.
+  void unref();
+
+  size_t                     m_blockSize;
+  unsigned int               m_slot;
+  std::atomic<bool>          m_atomic;
+  /// Objects alive, plus open scopes, plus one until released.
+  std::atomic<unsigned long> m_refs;
+  std::atomic<unsigned long> m_nObjects;
+  std::atomic<size_t>        m_bytes;
+  mutable std::mutex         m_mutex;
+  /// The blocks, by address, with their size.
+  std::vector<std::pair<char*,size_t>> m_blocks;
+};
+
+inline void GeoArena::setAtomicRefCounts(bool atomic)
+{
+  m_atomic.store(atomic);
+}
+
+inline bool GeoArena::getAtomicRefCounts() const
+{
+  return m_atomic.load(std::memory_order_relaxed);
+}
+
+inline std::atomic<GeoArena*>& GeoArena::slotAt(unsigned int slot)
+{
+  return s_chunks[slot / SLOTS_PER_CHUNK].load(std::memory_order_acquire)[slot % SLOTS_PER_CHUNK];
+}
+
+inline const GeoArena* GeoArena::inSlot(unsigned int slot)
+{
+  return slotAt(slot).load(std::memory_order_relaxed);
+}
+
+inline size_t GeoArena::getBytesAllocated() const
+{
+  return m_bytes.load(std::memory_order_relaxed);
+}
+
+inline unsigned long GeoArena::getNObjects() const
+{
+  return m_nObjects.load(std::memory_order_relaxed);
+}
+
+#endif
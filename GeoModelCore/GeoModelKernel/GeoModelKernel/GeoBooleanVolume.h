@@ -0,0 +1,65 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEOBOOLEANVOLUME_H
+#define GEOMODELKERNEL_GEOBOOLEANVOLUME_H
+
+/**
+ * @class GeoBooleanVolume
+ *
+ * @brief Computes the volume of boolean shapes without polyhedral
+ * booleans.
+ *
+ * The volume of a union, subtraction or intersection follows from the
+ * volumes of its operands and the volume of their overlap:
+ *     V(A+B) = V(A) + V(B) - V(A*B)
+ *     V(A-B) = V(A) - V(A*B)
+ * The overlap is zero when the bounding boxes of the operands do not
+ * meet, and is the smaller operand when its box lies inside a convex
+ * primitive.  Otherwise it is estimated by sampling points in the
+ * overlap of the boxes and classifying them with GeoShape::inside().
+ * The samples are drawn in fixed blocks, each from its own seed, so the
+ * estimate does not depend on the number of threads.
+ *
+ * GeoShapeUnion, GeoShapeSubtraction and GeoShapeIntersection call
+ * compute() with the default configuration the first time their
+ * volume() is asked for, and keep the result.
+ */
+
+class GeoShape;
+
+class GeoBooleanVolume
+{
+ public:
+  struct Config {
+    /// Target relative standard error of each sampled overlap.
+    double        relativeError = 1e-3;
+    /// Bounds on the number of points sampled for one overlap.
+    unsigned long minSamples    = 100000;
+    unsigned long maxSamples    = 100000000;
+    /// Seed of the sampled points.
+    unsigned long seed          = 1;
+    /// Number of threads sampling an overlap, the calling one included.
+    /// By default, and with 0, sampling runs on the calling thread only:
+    /// volume() is called from mass loops and from traversal workers, so
+    /// parallel sampling is left for the callers to ask for.
+    unsigned int  nThreads      = 1;
+  };
+
+  /// Returns the volume of a shape.  Primitives return their own volume.
+  /// Throws std::runtime_error if an operand which has to be sampled cannot
+  /// classify points or report its extent.
+  static double compute(const GeoShape* shape, const Config& config);
+
+  /// As compute(), but takes the volumes of the operands from their own,
+  /// possibly cached, volume().  Used by the volume() of boolean shapes.
+  static double computeFromOperands(const GeoShape* shape, const Config& config);
+
+  /// The configuration used by the volume() of boolean shapes.  Changing it
+  /// does not affect the volumes already computed.
+  static Config getDefaultConfig();
+  static void setDefaultConfig(const Config& config);
+};
+
+#endif
@@ -0,0 +1,184 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEOCHILDVOLUMEINDEX_H
+#define GEOMODELKERNEL_GEOCHILDVOLUMEINDEX_H
+
+/**
+ * @class GeoChildVolumeIndex
+ *
+ * @brief A flat table of the child volumes of a physical volume, one
+ * entry per placement, a serial transformer being one entry for all
+ * of its copies.
+ *
+ * The table is built in a single pass over the daughter nodes and
+ * records, for every placement, the volume, the range of transform
+ * nodes which places it, the serial transformer if any, and the nodes
+ * the name and identifier come from.  Transforms are composed on
+ * request from the transform nodes, so the index remains valid when
+ * alignment deltas change, and it stays small: a few pointers per
+ * placement, whatever the number of serial transformer copies.
+ *
+ * A child slot is found directly when every placement has one copy,
+ * and by a binary search over the placements otherwise.  The transform
+ * queries then compose the transform nodes of the placement, and the
+ * copy of the serial transformer if any, on every call: their cost grows
+ * with the number of transform nodes in front of the volume, and with
+ * the logarithm of the number of placements.
+ *
+ * GeoPhysVol and GeoFullPhysVol build an index lazily on the first
+ * indexed query and rebuild it on the first query after a node is
+ * added, see GeoVPhysVol::getChildVolumeIndex().  Traversals and tools which
+ * walk the whole tree instead build indices of their own, one per level
+ * (see GeoTraversalState and GeoCompiledGeometry) or one per volume
+ * (see GeoVolumeBVH), so that the volumes do not keep one each.
+ */
+
+#include "GeoModelKernel/GeoDefinitions.h"
+#include "GeoModelKernel/Query.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+class GeoVPhysVol;
+class GeoTransform;
+class GeoNameTag;
+class GeoIdentifierTag;
+class GeoSerialDenominator;
+class GeoSerialIdentifier;
+class GeoSerialTransformer;
+class GeoVAlignmentStore;
+
+class GeoChildVolumeIndex
+{
+ public:
+  /// Builds an empty index.
+  GeoChildVolumeIndex();
+
+  /// Builds the index from the daughter nodes of the parent volume.
+  GeoChildVolumeIndex(const GeoVPhysVol* parent);
+  ~GeoChildVolumeIndex();
+
+  GeoChildVolumeIndex(const GeoChildVolumeIndex &right) = delete;
+  GeoChildVolumeIndex & operator=(const GeoChildVolumeIndex &right) = delete;
+
+  /// Rebuilds the index from the daughter nodes of another volume,
+  /// reusing the storage of the previous one.
+  void rebuild(const GeoVPhysVol* parent);
+
+  /// Returns the number of child volumes, serial transformer copies included.
+  unsigned int getNChildVols() const;
+
+  /// Returns the number of child physical volumes and Serial Transformers.
+  unsigned int getNChildVolAndST() const;
+
+  /// Returns the ith child volume, or nullptr if the index is out of range.
+  const GeoVPhysVol* getChildVol(unsigned int index) const;
+
+  /// Returns the transform to the ith volume, including alignment corrections.
+  GeoTrf::Transform3D getXToChildVol(unsigned int index, const GeoVAlignmentStore* store=nullptr) const;
+
+  /// Returns the default transform to the ith volume.
+  GeoTrf::Transform3D getDefXToChildVol(unsigned int index) const;
+
+  /// Returns the name of the ith volume.  From nametag or serial denominator.
+  std::string getNameOfChildVol(unsigned int index) const;
+
+  /// Returns the id of the ith volume.  From identifier tag or serial identifier.
+  Query<int> getIdOfChildVol(unsigned int index) const;
+
+  /// Returns the serial transformer which places the ith volume, or nullptr.
+  const GeoSerialTransformer* getSerialTransformer(unsigned int index) const;
+
+  /// Returns the copy number of the ith volume within its serial transformer.
+  unsigned int getCopyNumber(unsigned int index) const;
+
+  /// Returns the bytes of the index and of the tables it owns, retired
+  /// indices included.
+  size_t getBytes() const;
+
+ private:
+  struct Entry {
+    /// The child volume itself.  Kept alive by the parent.
+    const GeoVPhysVol* volume;
+
+    /// The serial transformer which places the copies, if any.
+    const GeoSerialTransformer* serialTransformer;
+
+    /// The name tag or serial denominator naming this volume, if any.
+    const GeoNameTag* nameTag;
+    const GeoSerialDenominator* serialDenominator;
+
+    /// The identifier tag or serial identifier identifying this volume, if any.
+    const GeoIdentifierTag* idTag;
+    const GeoSerialIdentifier* serialIdentifier;
+
+    /// The first child slot of the placement.
+    unsigned int firstSlot;
+
+    /// The slots of the first volumes named and identified by the serial
+    /// denominator and serial identifier.
+    unsigned int serialDenomPosition;
+    unsigned int serialIdentPosition;
+
+    /// Range of the transforms placing the volume in m_transforms.
+    unsigned int firstTransform;
+    unsigned int nTransforms;
+  };
+
+  friend class GeoChildVolumeIndexBuilder;
+
+  /// Returns the entry of the ith slot, or nullptr if out of range.
+  const Entry* findEntry(unsigned int index) const;
+
+  std::vector<Entry> m_entries;
+
+  /// The transform nodes placing the children, in order.
+  std::vector<const GeoTransform*> m_transforms;
+
+  unsigned int m_nChildVols;
+
+  /// True if every entry holds exactly one slot.
+  bool m_oneSlotPerEntry;
+
+  friend class GeoVPhysVol;
+
+  /// Set by the volume when its daughters change.  The next query rebuilds
+  /// the index.
+  mutable std::atomic<bool> m_stale;
+
+  /// The index this one replaced.  Readers may still hold it, so it is
+  /// kept until this one is deleted.
+  GeoChildVolumeIndex* m_retired;
+};
+
+inline unsigned int GeoChildVolumeIndex::getNChildVols() const
+{
+  return m_nChildVols;
+}
+
+inline unsigned int GeoChildVolumeIndex::getNChildVolAndST() const
+{
+  return m_entries.size();
+}
+
+inline const GeoVPhysVol* GeoChildVolumeIndex::getChildVol(unsigned int index) const
+{
+  const Entry* entry = findEntry(index);
+  return entry ? entry->volume : nullptr;
+}
+
+inline const GeoSerialTransformer* GeoChildVolumeIndex::getSerialTransformer(unsigned int index) const
+{
+  const Entry* entry = findEntry(index);
+  return entry ? entry->serialTransformer : nullptr;
+}
+
+inline unsigned int GeoChildVolumeIndex::getCopyNumber(unsigned int index) const
+{
+  const Entry* entry = findEntry(index);
+  return entry ? index - entry->firstSlot : 0;
+}
+
+#endif
@@ -0,0 +1,215 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEOCOMPILEDGEOMETRY_H
+#define GEOMODELKERNEL_GEOCOMPILEDGEOMETRY_H
+
+/**
+ * @class GeoCompiledGeometry
+ *
+ * @brief An immutable, flattened snapshot of a physical volume tree.
+ *
+ * The tree below a top volume is compiled once into one node per
+ * placement, stored in depth-first order as a structure of arrays:
+ * parent index, first child and next sibling, logical volume index,
+ * local and absolute transforms, name and identifier.  Shared volumes
+ * are unfolded, so every node has a unique absolute position.  The
+ * descendants of node i are the nodes i+1 to getSubtreeEnd(i)-1.
+ *
+ * Serial transformers are either expanded into one node per copy, or
+ * compiled to their first copy only, in which case
+ * getSerialTransformer() returns the transformer for that node and
+ * its subtree stands for all the copies.
+ *
+ * Transforms are those of the alignment store given at compile time.
+ * The snapshot does not follow later changes to the graph or the
+ * alignment; compile a new one instead.  Since nothing is mutable
+ * after construction, any number of threads may read it concurrently.
+ *
+ * The root of the snapshot is named after its logical volume, and has
+ * the identity as local transform.
+ */
+
+#include "GeoModelKernel/GeoVPhysVol.h"
+#include "GeoModelKernel/GeoDefinitions.h"
+#include "GeoModelKernel/Query.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+class GeoLogVol;
+class GeoSerialTransformer;
+class GeoVAlignmentStore;
+
+class GeoCompiledGeometry
+{
+ public:
+  /// Index value of a missing parent, child or sibling.
+  static constexpr unsigned int NONE = ~0u;
+
+  /// Compiles the tree below top.
+  GeoCompiledGeometry(PVConstLink top
+		      ,bool expandSerialTransformers=true
+		      ,const GeoVAlignmentStore* store=nullptr);
+  ~GeoCompiledGeometry();
+
+  GeoCompiledGeometry(const GeoCompiledGeometry &right) = delete;
+  GeoCompiledGeometry & operator=(const GeoCompiledGeometry &right) = delete;
+
+  /// Returns the number of nodes.
+  unsigned int getNNodes() const;
+
+  /// Returns the parent of node i, or NONE for the root.
+  unsigned int getParent(unsigned int i) const;
+
+  /// Returns the first child of node i, or NONE.
+  unsigned int getFirstChild(unsigned int i) const;
+
+  /// Returns the next sibling of node i, or NONE.
+  unsigned int getNextSibling(unsigned int i) const;
+
+  /// Returns one past the last descendant of node i.
+  unsigned int getSubtreeEnd(unsigned int i) const;
+
+  /// Returns the depth of node i.  The root has depth 0.
+  unsigned int getDepth(unsigned int i) const;
+
+  /// Returns the physical volume of node i.
+  const GeoVPhysVol* getVolume(unsigned int i) const;
+
+  /// Returns the index of the logical volume of node i.
+  unsigned int getLogVolIndex(unsigned int i) const;
+
+  /// Returns the logical volume of node i.
+  const GeoLogVol* getLogVol(unsigned int i) const;
+
+  /// Returns the number of distinct logical volumes.
+  unsigned int getNLogVols() const;
+
+  /// Returns a distinct logical volume by index.
+  const GeoLogVol* getLogVolByIndex(unsigned int index) const;
+
+  /// Returns the transform of node i with respect to its parent.
+  const GeoTrf::Transform3D& getLocalTransform(unsigned int i) const;
+
+  /// Returns the transform of node i with respect to the top volume.
+  const GeoTrf::Transform3D& getAbsoluteTransform(unsigned int i) const;
+
+  /// Returns the name of node i.
+  std::string_view getName(unsigned int i) const;
+
+  /// Returns the identifier of node i.
+  Query<int> getId(unsigned int i) const;
+
+  /// Returns the serial transformer of node i, if the node stands for all
+  /// its copies (i.e. serial transformers were not expanded), else nullptr.
+  const GeoSerialTransformer* getSerialTransformer(unsigned int i) const;
+
+ private:
+  const GeoVPhysVol* m_top;
+
+  std::vector<unsigned int>        m_parent;
+  std::vector<unsigned int>        m_firstChild;
+  std::vector<unsigned int>        m_nextSibling;
+  std::vector<unsigned int>        m_subtreeEnd;
+  std::vector<unsigned int>        m_depth;
+  std::vector<const GeoVPhysVol*>  m_volume;
+  std::vector<unsigned int>        m_logVolIndex;
+  std::vector<GeoTrf::Transform3D> m_localXf;
+  std::vector<GeoTrf::Transform3D> m_absXf;
+
+  /// Names are packed into one buffer. Name i spans m_nameOffset[i] to m_nameOffset[i+1]
+  std::vector<unsigned int>        m_nameOffset;
+  std::string                      m_names;
+
+  std::vector<int>                 m_id;
+  std::vector<unsigned char>       m_hasId;
+
+  /// Only filled when serial transformers are not expanded.
+  std::vector<const GeoSerialTransformer*> m_serialTransformer;
+
+  std::vector<const GeoLogVol*>    m_logVols;
+};
+
+inline unsigned int GeoCompiledGeometry::getNNodes() const
+{
+  return m_parent.size();
+}
+
+inline unsigned int GeoCompiledGeometry::getParent(unsigned int i) const
+{
+  return m_parent[i];
+}
+
+inline unsigned int GeoCompiledGeometry::getFirstChild(unsigned int i) const
+{
+  return m_firstChild[i];
+}
+
+inline unsigned int GeoCompiledGeometry::getNextSibling(unsigned int i) const
+{
+  return m_nextSibling[i];
+}
+
+inline unsigned int GeoCompiledGeometry::getSubtreeEnd(unsigned int i) const
+{
+  return m_subtreeEnd[i];
+}
+
+inline unsigned int GeoCompiledGeometry::getDepth(unsigned int i) const
+{
+  return m_depth[i];
+}
+
+inline const GeoVPhysVol* GeoCompiledGeometry::getVolume(unsigned int i) const
+{
+  return m_volume[i];
+}
+
+inline unsigned int GeoCompiledGeometry::getLogVolIndex(unsigned int i) const
+{
+  return m_logVolIndex[i];
+}
+
+inline const GeoLogVol* GeoCompiledGeometry::getLogVol(unsigned int i) const
+{
+  return m_logVols[m_logVolIndex[i]];
+}
+
+inline unsigned int GeoCompiledGeometry::getNLogVols() const
+{
+  return m_logVols.size();
+}
+
+inline const GeoLogVol* GeoCompiledGeometry::getLogVolByIndex(unsigned int index) const
+{
+  return m_logVols[index];
+}
+
+inline const GeoTrf::Transform3D& GeoCompiledGeometry::getLocalTransform(unsigned int i) const
+{
+  return m_localXf[i];
+}
+
+inline const GeoTrf::Transform3D& GeoCompiledGeometry::getAbsoluteTransform(unsigned int i) const
+{
+  return m_absXf[i];
+}
+
+inline std::string_view GeoCompiledGeometry::getName(unsigned int i) const
+{
+  return std::string_view(m_names.data()+m_nameOffset[i],m_nameOffset[i+1]-m_nameOffset[i]);
+}
+
+inline Query<int> GeoCompiledGeometry::getId(unsigned int i) const
+{
+  return m_hasId[i] ? Query<int>(m_id[i]) : Query<int>();
+}
+
+inline const GeoSerialTransformer* GeoCompiledGeometry::getSerialTransformer(unsigned int i) const
+{
+  return m_serialTransformer.empty() ? nullptr : m_serialTransformer[i];
+}
+
+#endif
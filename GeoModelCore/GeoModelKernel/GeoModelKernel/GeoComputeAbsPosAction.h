@@ -0,0 +1,114 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEOCOMPUTEABSPOSACTION_H
+#define GEOMODELKERNEL_GEOCOMPUTEABSPOSACTION_H
+
+/**
+ * @class GeoComputeAbsPosAction
+ *
+ * @brief Computes the absolute and the default absolute positions of all
+ * full physical volumes below the volume it is executed on, in a single
+ * top-down traversal.
+ *
+ * The positions are written either into the position cache of each full
+ * physical volume or, if one is supplied, into an alignment store.  The
+ * result is the same as calling getAbsoluteTransform() and
+ * getDefAbsoluteTransform() on every full physical volume, but each
+ * transform in the graph is evaluated only once.
+ *
+ * Positions already held by the caches of the volumes are overwritten.
+ * A GeoDenseAlignmentStore keeps the positions it holds, so after the
+ * alignment deltas have changed its clearPositions() must be called
+ * before the action is run again on it.
+ *
+ * Full physical volumes which sit in a shared portion of the graph, or
+ * which are placed by serial transformers, have no unique position and
+ * are skipped.
+ *
+ * computeParallel() splits the tree at a given depth and distributes the
+ * subtrees over a pool of worker threads.  If an alignment store is used
+ * in this mode, it must allow concurrent writers (as GeoDenseAlignmentStore
+ * does).
+ */
+
+#include "GeoModelKernel/GeoNodeAction.h"
+#include "GeoModelKernel/GeoDefinitions.h"
+#include <vector>
+
+class GeoVAlignmentStore;
+
+class GeoComputeAbsPosAction : public GeoNodeAction
+{
+ public:
+  GeoComputeAbsPosAction(GeoVAlignmentStore* store=nullptr);
+  virtual ~GeoComputeAbsPosAction() override;
+
+  /// Sets the absolute transforms of the volume on which the action is
+  /// executed.  By default they are computed by walking up to the world.
+  void setStartTransforms(const GeoTrf::Transform3D& absXf, const GeoTrf::Transform3D& defAbsXf);
+
+  /// Returns the number of full physical volumes whose positions were set.
+  unsigned int getNComputed() const;
+
+  /// Computes the positions of all full physical volumes below top, running
+  /// the subtrees found at splitDepth on nThreads worker threads (0 means one
+  /// thread per hardware core).  Returns the number of positions set.
+  static unsigned int computeParallel(PVConstLink top
+				      ,GeoVAlignmentStore* store=nullptr
+				      ,unsigned int nThreads=0
+				      ,unsigned int splitDepth=1);
+
+  /// Handles a Transform.
+  virtual void handleTransform(const GeoTransform *xform) override;
+
+  /// Handles a physical volume.
+  virtual void handlePhysVol(const GeoPhysVol *vol) override;
+
+  /// Handles a full physical volume.
+  virtual void handleFullPhysVol(const GeoFullPhysVol *vol) override;
+
+  /// Handles a Serial Transformer
+  virtual void handleSerialTransformer(const GeoSerialTransformer *sT) override;
+
+ private:
+  GeoComputeAbsPosAction(const GeoComputeAbsPosAction &right) = delete;
+  GeoComputeAbsPosAction & operator=(const GeoComputeAbsPosAction &right) = delete;
+
+  /// A subtree which is left to another worker.
+  struct Subtree {
+    const GeoVPhysVol*  volume;
+    GeoTrf::Transform3D absXf;
+    GeoTrf::Transform3D defAbsXf;
+  };
+
+  /// The state of one level of the traversal.
+  struct Level {
+    /// Absolute transforms of the volume at this level.
+    GeoTrf::Transform3D absXf;
+    GeoTrf::Transform3D defAbsXf;
+    /// Transforms pending for the next child volume.
+    GeoTrf::Transform3D pendingXf;
+    GeoTrf::Transform3D pendingDefXf;
+    /// True if this volume, or one of its ancestors, is shared.
+    bool shared;
+  };
+
+  void handleVolume(const GeoVPhysVol* vol, const GeoVFullPhysVol* fullVol);
+
+  GeoVAlignmentStore* m_store;
+  std::vector<Level>  m_levels;
+  bool                m_hasStartTransforms;
+  unsigned int        m_nComputed;
+
+  /// When set, volumes at the depth limit are collected rather than handled.
+  std::vector<Subtree>* m_subtrees;
+};
+
+inline unsigned int GeoComputeAbsPosAction::getNComputed() const
+{
+  return m_nComputed;
+}
+
+#endif
@@ -0,0 +1,44 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEOCONTENTHASH_H
+#define GEOMODELKERNEL_GEOCONTENTHASH_H
+
+/**
+ * @class GeoContentHash
+ *
+ * @brief Hashes and compares shapes, elements, materials and logical
+ * volumes by content rather than by address.
+ *
+ * The content of a shape is its type and all its parameters, and for
+ * boolean and shifted shapes their operands, compared in turn by content.
+ * A material is its name, density, elements and fractions; a logical
+ * volume its name, shape and material.  Parameters are compared exactly.
+ * Materials must be locked.
+ */
+
+#include <cstddef>
+
+class GeoShape;
+class GeoElement;
+class GeoMaterial;
+class GeoLogVol;
+
+class GeoContentHash
+{
+ public:
+  /// Hashes of the content.  Nodes with the same content have the same hash.
+  static size_t hash(const GeoShape* shape);
+  static size_t hash(const GeoElement* element);
+  static size_t hash(const GeoMaterial* material);
+  static size_t hash(const GeoLogVol* logVol);
+
+  /// True if the two nodes have the same content.
+  static bool equal(const GeoShape* a, const GeoShape* b);
+  static bool equal(const GeoElement* a, const GeoElement* b);
+  static bool equal(const GeoMaterial* a, const GeoMaterial* b);
+  static bool equal(const GeoLogVol* a, const GeoLogVol* b);
+};
+
+#endif
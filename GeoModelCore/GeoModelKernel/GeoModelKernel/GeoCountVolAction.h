@@ -25,6 +25,10 @@ class GeoCountVolAction : public GeoNodeAction
   //	The volume count.
   unsigned int getCount () const;
 
+  //	The count can be made with GeoParallelTraversal.
+  virtual GeoNodeAction* clone () const;
+  virtual void merge (const GeoNodeAction &other);
+
  private:
   GeoCountVolAction(const GeoCountVolAction &right);
   GeoCountVolAction & operator=(const GeoCountVolAction &right);
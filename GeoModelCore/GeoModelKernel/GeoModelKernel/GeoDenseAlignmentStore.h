@@ -0,0 +1,137 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEODENSEALIGNMENTSTORE_H
+#define GEOMODELKERNEL_GEODENSEALIGNMENTSTORE_H
+
+/**
+ * @class GeoDenseAlignmentStore
+ *
+ * @brief An alignment store which assigns a dense integer slot to every
+ * alignable transform and every full physical volume of a geometry when
+ * it is created.
+ *
+ * Deltas, absolute positions and default absolute positions are held in
+ * contiguous arrays indexed by slot.  Pointers are mapped onto slots by a
+ * binary search over a sorted table, so no hashing and no locking happen
+ * on lookup.  Clients may also resolve the slot once, with getDeltaSlot()
+ * or getPositionSlot(), and then use the slot based accessors.
+ *
+ * Thread safety: any number of threads may read from the store and fill
+ * in absolute positions concurrently, and readers never wait.  Each
+ * position slot is published atomically and only once: the first writer
+ * wins and later writes to the same slot are ignored, so that a position,
+ * once returned, never changes under a reader.  A slot which is still
+ * being written reads as empty.  Deltas are meant to be set by a single
+ * thread before the store is handed over to the readers; they may be
+ * overwritten then, but not while other threads read them.  Absolute
+ * positions computed before a delta changes must be dropped with
+ * clearPositions() before new ones can be stored.
+ */
+
+#include "GeoModelKernel/GeoVAlignmentStore.h"
+#include "GeoModelKernel/GeoVPhysVol.h"
+#include "GeoModelKernel/Query.h"
+#include <atomic>
+#include <utility>
+#include <vector>
+
+class GeoDenseAlignmentStore : public GeoVAlignmentStore
+{
+ public:
+  /// Assigns slots to all alignable transforms and all full physical
+  /// volumes found in the geometry tree below (and including) the world.
+  GeoDenseAlignmentStore(PVConstLink world);
+
+  /// Assigns slots to the given alignable transforms and full physical
+  /// volumes, in the order in which they are given.
+  GeoDenseAlignmentStore(const std::vector<const GeoAlignableTransform*>& alignables
+			 ,const std::vector<const GeoVFullPhysVol*>& fullPhysVols);
+
+  virtual ~GeoDenseAlignmentStore() override;
+
+  GeoDenseAlignmentStore(const GeoDenseAlignmentStore &right) = delete;
+  GeoDenseAlignmentStore & operator=(const GeoDenseAlignmentStore &right) = delete;
+
+  virtual void setDelta(const GeoAlignableTransform* xf, const GeoTrf::Transform3D& delta) override;
+  virtual const GeoTrf::Transform3D* getDelta(const GeoAlignableTransform* xf) const override;
+
+  virtual void setAbsPosition(const GeoVFullPhysVol* fpv, const GeoTrf::Transform3D& xf) override;
+  virtual const GeoTrf::Transform3D* getAbsPosition(const GeoVFullPhysVol* fpv) const override;
+
+  virtual void setDefAbsPosition(const GeoVFullPhysVol* fpv, const GeoTrf::Transform3D& xf) override;
+  virtual const GeoTrf::Transform3D* getDefAbsPosition(const GeoVFullPhysVol* fpv) const override;
+
+  /// Returns the number of alignable transforms known to the store.
+  unsigned int getNDeltaSlots() const;
+
+  /// Returns the number of full physical volumes known to the store.
+  unsigned int getNPositionSlots() const;
+
+  /// Returns the slot of an alignable transform.  Invalid if unknown to the store.
+  Query<unsigned int> getDeltaSlot(const GeoAlignableTransform* xf) const;
+
+  /// Returns the slot of a full physical volume.  Invalid if unknown to the store.
+  Query<unsigned int> getPositionSlot(const GeoVFullPhysVol* fpv) const;
+
+  /// Slot based accessors.  The getters return nullptr if nothing has been set.
+  /// Positions already set are kept, see above.
+  void setDelta(unsigned int slot, const GeoTrf::Transform3D& delta);
+  const GeoTrf::Transform3D* getDelta(unsigned int slot) const;
+  void setAbsPosition(unsigned int slot, const GeoTrf::Transform3D& xf);
+  const GeoTrf::Transform3D* getAbsPosition(unsigned int slot) const;
+  void setDefAbsPosition(unsigned int slot, const GeoTrf::Transform3D& xf);
+  const GeoTrf::Transform3D* getDefAbsPosition(unsigned int slot) const;
+
+  /// Drops all absolute and default absolute positions, keeping the deltas.
+  /// Must not be called while other threads use the store.
+  void clearPositions();
+
+ private:
+  /// A contiguous array of transforms, each one published atomically.
+  class TransformArray {
+  public:
+    void resize(unsigned int n);
+    /// Overwrites the slot.  No other thread may read it meanwhile.
+    void set(unsigned int slot, const GeoTrf::Transform3D& xf);
+    /// Fills the slot if it is empty, leaves it as it is otherwise.  Returns
+    /// once the slot holds a transform, from this writer or from another.
+    void setOnce(unsigned int slot, const GeoTrf::Transform3D& xf);
+    /// Never waits: returns nullptr for a slot which is empty or being written.
+    const GeoTrf::Transform3D* get(unsigned int slot) const;
+    void clear();
+  private:
+    std::vector<GeoTrf::Transform3D> m_transforms;
+    mutable std::vector<std::atomic<unsigned char>> m_state;
+  };
+
+  template<class T>
+  using SlotTable = std::vector<std::pair<const T*, unsigned int>>;
+
+  template<class T>
+  static Query<unsigned int> findSlot(const SlotTable<T>& table, const T* key);
+
+  void assignSlots(const std::vector<const GeoAlignableTransform*>& alignables
+		   ,const std::vector<const GeoVFullPhysVol*>& fullPhysVols);
+
+  /// Pointer to slot maps, sorted by pointer.
+  SlotTable<GeoAlignableTransform> m_deltaSlots;
+  SlotTable<GeoVFullPhysVol>       m_positionSlots;
+
+  TransformArray m_deltas;
+  TransformArray m_absPositions;
+  TransformArray m_defAbsPositions;
+};
+
+inline unsigned int GeoDenseAlignmentStore::getNDeltaSlots() const
+{
+  return m_deltaSlots.size();
+}
+
+inline unsigned int GeoDenseAlignmentStore::getNPositionSlots() const
+{
+  return m_positionSlots.size();
+}
+
+#endif
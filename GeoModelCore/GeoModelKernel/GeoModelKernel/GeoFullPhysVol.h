@@ -35,6 +35,9 @@ class GeoFullPhysVol final : public GeoVFullPhysVol
     /// Adds a Graph Node to the Geometry Graph
   virtual void add(GeoGraphNode* graphNode) override final;
 
+  /// Replaces the daughter nodes.
+  virtual void setChildNodes(const std::vector<GeoGraphNode*>& nodes) override final;
+
   /// Returns the number of child physical volumes.
   virtual unsigned int getNChildVols() const override;
 
@@ -19,6 +19,20 @@ class GeoGenericTrap : public GeoShape
 
   virtual double volume() const;
 
+  //	Classifies a point, given in the local frame of the shape.
+  virtual Location inside(const GeoTrf::Vector3D &p, double tolerance=TOLERANCE) const;
+
+  //	Classifies n points at once.
+  virtual void inside(size_t n, const double *x, const double *y, const double *z
+		      , Location *result, double tolerance=TOLERANCE) const;
+
+  //	Computes the intervals in which a line is inside the shape.
+  virtual void getRayIntervals(const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+				, RayIntervals &intervals) const;
+
+  //	Lower bound of the distance from a point to the surface.
+  virtual double safety(const GeoTrf::Vector3D &p) const;
+
   virtual const std::string& type() const;
   virtual ShapeType typeID() const;
 
@@ -33,10 +47,17 @@ class GeoGenericTrap : public GeoShape
  protected:
   virtual ~GeoGenericTrap();
 
+  //	Computes the bounding box.
+  virtual void computeExtent (double &xmin, double &ymin, double &zmin
+			      , double &xmax, double &ymax, double &zmax) const;
+
  private:
   GeoGenericTrap(const GeoGenericTrap &right);
   GeoGenericTrap& operator=(const GeoGenericTrap &right);
 
+  //	Signed distance to the surface, negative inside.
+  double distance(const GeoTrf::Vector3D &p) const;
+
   static const std::string s_classType;
   static const ShapeType s_classTypeID;
 
@@ -0,0 +1,82 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEOINTERNACTION_H
+#define GEOMODELKERNEL_GEOINTERNACTION_H
+
+/**
+ * @class GeoInternAction
+ *
+ * @brief Rewrites a tree in place so that its physical volumes use the
+ * canonical logical volumes of a GeoInternRegistry, and with them the
+ * canonical shapes, materials and elements.
+ *
+ * The statistics count the distinct nodes found under the logical volumes
+ * of the tree, those replaced by a canonical instance, and the memory of
+ * the nodes replaced less that of the instances the registry had to build.
+ * The memory is freed once nothing else refers to the replaced nodes; the
+ * action itself holds them until it is destroyed.
+ */
+
+#include "GeoModelKernel/GeoNodeAction.h"
+#include <unordered_map>
+#include <unordered_set>
+
+class GeoInternRegistry;
+
+class GeoInternAction : public GeoNodeAction
+{
+ public:
+  struct Statistics {
+    /// Distinct nodes found, and how many were replaced.
+    unsigned long nLogVols = 0;
+    unsigned long nShapes = 0;
+    unsigned long nMaterials = 0;
+    unsigned long nElements = 0;
+    unsigned long nReplacedLogVols = 0;
+    unsigned long nReplacedShapes = 0;
+    unsigned long nReplacedMaterials = 0;
+    unsigned long nReplacedElements = 0;
+    /// Approximate memory of the nodes replaced, less that of the nodes built.
+    long long bytesSaved = 0;
+  };
+
+  GeoInternAction(GeoInternRegistry& registry);
+  virtual ~GeoInternAction();
+
+  virtual void handlePhysVol (const GeoPhysVol *vol);
+  virtual void handleFullPhysVol (const GeoFullPhysVol *vol);
+  virtual void handleSerialTransformer (const GeoSerialTransformer *sT);
+
+  const Statistics& getStatistics() const;
+
+ private:
+  GeoInternAction(const GeoInternAction &right);
+  GeoInternAction & operator=(const GeoInternAction &right);
+
+  void replace(const GeoVPhysVol* vol);
+
+  /// Count a node seen for the first time, and whether it was replaced.
+  void count(const GeoShape* shape);
+  void count(const GeoMaterial* material);
+  void count(const GeoElement* element);
+
+  /// Marks a node as seen, returning false if it was already.
+  bool see(const RCBase* node);
+  /// Accounts the memory of a replaced node, and of its canonical instance if built.
+  void account(size_t bytes, const RCBase* canonical, size_t canonicalBytes);
+
+  GeoInternRegistry&                                     m_registry;
+  Statistics                                             m_stats;
+  std::unordered_map<const GeoLogVol*,const GeoLogVol*>  m_canonical;
+  /// Nodes seen; a reference is kept so that their addresses are not reused.
+  std::unordered_set<const RCBase*>                      m_seen;
+};
+
+inline const GeoInternAction::Statistics& GeoInternAction::getStatistics() const
+{
+  return m_stats;
+}
+
+#endif
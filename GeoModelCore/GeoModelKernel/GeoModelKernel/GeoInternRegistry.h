@@ -0,0 +1,90 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEOINTERNREGISTRY_H
+#define GEOMODELKERNEL_GEOINTERNREGISTRY_H
+
+/**
+ * @class GeoInternRegistry
+ *
+ * @brief Keeps one canonical instance of each shape, element, material
+ * and logical volume content, in the sense of GeoContentHash.
+ *
+ * intern() returns the canonical instance with the content of a node,
+ * making the node itself canonical if it is the first of its kind.  The
+ * parts of a canonical node (operands, elements, shape and material) are
+ * canonical too: when those of the node are not, the registry builds the
+ * canonical instance from the canonical parts.
+ *
+ * Use is opt-in: factories may intern the nodes they create, and
+ * GeoInternAction rewrites an existing tree.  The registry keeps a
+ * reference to its canonical nodes until it is cleared or destroyed.  It
+ * may be used from several threads.
+ */
+
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+class RCBase;
+class GeoShape;
+class GeoElement;
+class GeoMaterial;
+class GeoLogVol;
+
+class GeoInternRegistry
+{
+ public:
+  GeoInternRegistry();
+  ~GeoInternRegistry();
+
+  GeoInternRegistry(const GeoInternRegistry &right) = delete;
+  GeoInternRegistry & operator=(const GeoInternRegistry &right) = delete;
+
+  /// Returns the canonical instance with the content of the node.  Null
+  /// nodes are returned as they are.  Materials must be locked.
+  const GeoShape*    intern(const GeoShape* shape);
+  const GeoElement*  intern(const GeoElement* element);
+  const GeoMaterial* intern(const GeoMaterial* material);
+  const GeoLogVol*   intern(const GeoLogVol* logVol);
+
+  /// True if the node is a canonical instance built by the registry, with
+  /// canonical parts in place of those of the node interned.
+  bool isRebuilt(const RCBase* node) const;
+
+  /// Returns the number of canonical nodes of each kind.
+  size_t getNShapes() const;
+  size_t getNElements() const;
+  size_t getNMaterials() const;
+  size_t getNLogVols() const;
+
+  /// Forgets all the canonical nodes.
+  void clear();
+
+ private:
+  /// Canonical nodes by hash, and the hash of each.
+  template <class T>
+  struct Table {
+    std::unordered_multimap<size_t,const T*> byHash;
+    std::unordered_map<const T*,size_t>      hashOf;
+  };
+
+  /// intern() without locking, also returning the hash of the canonical node.
+  const GeoShape*    internShape(const GeoShape* shape, size_t& hash);
+  const GeoElement*  internElement(const GeoElement* element, size_t& hash);
+  const GeoMaterial* internMaterial(const GeoMaterial* material, size_t& hash);
+
+  /// Registers a canonical node, keeping a reference to it.
+  template <class T>
+  void insert(Table<T>& table, const T* node, size_t hash);
+
+  mutable std::mutex              m_mutex;
+  Table<GeoShape>                 m_shapes;
+  Table<GeoElement>               m_elements;
+  Table<GeoMaterial>              m_materials;
+  Table<GeoLogVol>                m_logVols;
+  std::unordered_set<const RCBase*> m_rebuilt;
+};
+
+#endif
@@ -0,0 +1,175 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEOMATERIALBUDGET_H
+#define GEOMODELKERNEL_GEOMATERIALBUDGET_H
+
+/**
+ * @class GeoMaterialBudget
+ *
+ * @brief Integrates the material crossed by straight rays through a
+ * volume tree, in radiation lengths and nuclear interaction lengths,
+ * without Geant4.
+ *
+ * The rays are followed with a GeoVolumeBVH, so every shape in the tree
+ * must provide GeoShape::extent() and GeoShape::getRayIntervals().  The
+ * lengths come from GeoMaterial::getRadLength() and getIntLength(), and
+ * from the same per element terms GeoMaterial::lock() sums them from.
+ *
+ * The thicknesses are broken down like those of the geantino maps of
+ * FullSimLight, under the same keys:
+ *   Total_X0                    everything
+ *   D_<detector>                the detector is the part of the logical
+ *                               volume name before "::"
+ *   M_<material>, DM_<detector>_<material>
+ *   E_<element>, ME_<material>_<element>, DE_<detector>_<element>
+ * Radiation lengths are in percent of X0.  scan() fills profiles named
+ * like the histograms written by geantinoMaps.
+ */
+
+#include "GeoModelKernel/GeoVolumeBVH.h"
+#include "GeoModelKernel/GeoDefinitions.h"
+#include <cmath>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class GeoLogVol;
+
+class GeoMaterialBudget
+{
+ public:
+  /// A thickness, in percent of a radiation length and in interaction lengths.
+  struct Thickness {
+    double x0     = 0;
+    double lambda = 0;
+  };
+
+  /// Thicknesses along one ray, by breakdown key.
+  typedef std::map<std::string,Thickness> Breakdown;
+
+  /// The mean of the values filled into bins of one or two variables, as a
+  /// TProfile or TProfile2D.  Only the bins which were filled take memory.
+  class Profile {
+  public:
+    Profile(unsigned int nX=1, double xMin=0, double xMax=1
+	    ,unsigned int nY=1, double yMin=0, double yMax=1);
+
+    void fill(double x, double value);
+    void fill(double x, double y, double value);
+
+    /// Adds the contents of another profile with the same binning.
+    void merge(const Profile& other);
+
+    unsigned int getNBinsX() const { return m_nX; }
+    unsigned int getNBinsY() const { return m_nY; }
+    double getXMin() const { return m_xMin; }
+    double getXMax() const { return m_xMax; }
+    double getYMin() const { return m_yMin; }
+    double getYMax() const { return m_yMax; }
+
+    /// Returns the number of values filled into a bin, and their mean.
+    unsigned long getEntries(unsigned int ix, unsigned int iy=0) const;
+    double getMean(unsigned int ix, unsigned int iy=0) const;
+
+    /// Writes the filled bins as lines of: ix iy x y entries mean.
+    void write(std::ostream& out) const;
+
+  private:
+    struct Bin {
+      double        sum     = 0;
+      unsigned long entries = 0;
+    };
+    unsigned int m_nX, m_nY;
+    double       m_xMin, m_xMax, m_yMin, m_yMax;
+    std::unordered_map<unsigned int,Bin> m_bins;
+  };
+
+  /// Profiles by name.
+  typedef std::map<std::string,Profile> Maps;
+
+  /// What scan() shoots, and which profiles it fills.  The defaults are
+  /// those of geantinoMaps.
+  struct Config {
+    /// Number of rays, and the seed of their directions.
+    unsigned long    nRays  = 100000;
+    unsigned long    seed   = 1;
+    /// Where the rays start, and the range of their directions.
+    GeoTrf::Vector3D vertex = GeoTrf::Vector3D(0,0,0);
+    double           etaMin = -6, etaMax = 6;
+    double           phiMin = -M_PI, phiMax = M_PI;
+    /// Only steps starting in this window are counted.
+    double           rMin = -12500, rMax = 12500;
+    double           zMin = -23000, zMax = 23000;
+    /// The range of the xy profiles.
+    double           xMin = -12500, xMax = 12500;
+    double           yMin = -12500, yMax = 12500;
+    /// Which profiles to fill besides etaRadLen, etaIntLen, RZRadLen and RZIntLen.
+    bool             etaPhiMaps    = true;
+    bool             detectorsMaps = false;
+    bool             materialsMaps = false;
+    bool             elementsMaps  = false;
+    /// Number of worker threads, 0 for one per hardware core.
+    unsigned int     nThreads = 0;
+  };
+
+  /// Indexes the tree below world.
+  GeoMaterialBudget(PVConstLink world, const GeoVAlignmentStore* store=nullptr);
+  ~GeoMaterialBudget();
+
+  GeoMaterialBudget(const GeoMaterialBudget &right) = delete;
+  GeoMaterialBudget & operator=(const GeoMaterialBudget &right) = delete;
+
+  /// Integrates the material along the ray origin+t*direction, with a unit
+  /// direction, for 0<=t<=tMax.  The thicknesses are added to breakdown.
+  void integrate(const GeoTrf::Vector3D& origin
+		 ,const GeoTrf::Vector3D& direction
+		 ,Breakdown& breakdown
+		 ,double tMax=HUGE_VAL) const;
+
+  /// Shoots config.nRays rays from the vertex, uniformly in eta and phi,
+  /// on several threads.  Up to rounding, the result does not depend on the
+  /// number of threads.
+  Maps scan(const Config& config) const;
+
+  /// Writes profiles, each one as a line "# <name>" followed by its bins.
+  static void write(const Maps& maps, std::ostream& out);
+
+ private:
+  /// A breakdown key, and the thickness per unit length it gets from a material.
+  struct Term {
+    unsigned int key;
+    double       x0;
+    double       lambda;
+  };
+
+  /// The terms a logical volume contributes to.
+  struct LogVolTerms {
+    /// Total_X0, D_, M_ and DM_.
+    std::vector<Term> material;
+    /// E_, ME_ and DE_.
+    std::vector<Term> elements;
+  };
+
+  struct Worker;
+
+  /// Returns the index of a breakdown key, adding it if new.
+  unsigned int getKey(const std::string& name);
+
+  /// Follows one ray, adding the thickness of each step to the worker's sums.
+  void integrate(const GeoTrf::Vector3D& origin
+		 ,const GeoTrf::Vector3D& direction
+		 ,double tMax
+		 ,const Config* config
+		 ,Worker& worker) const;
+
+  GeoVolumeBVH m_bvh;
+  std::vector<std::string> m_keys;
+  std::unordered_map<std::string,unsigned int> m_keyIndex;
+  std::unordered_map<const GeoLogVol*,LogVolTerms> m_terms;
+};
+
+#endif
@@ -0,0 +1,198 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEOMATERIALREGISTRY_H
+#define GEOMODELKERNEL_GEOMATERIALREGISTRY_H
+
+/**
+ * @class GeoMaterialRegistry
+ *
+ * @brief Dense, contiguous tables of the properties of the materials of a
+ * geometry, for code that scans materials or looks them up per step.
+ *
+ * Each material registered gets a dense identifier, 0 to getNMaterials()-1,
+ * in the order of registration.  The density, radiation length, interaction
+ * length and dE/dx terms are kept in one array each, indexed by identifier.
+ * The element composition is flattened into arrays of Z, A and fraction by
+ * mass: the elements of material id are the entries getFirstElement(id) to
+ * getFirstElement(id+1)-1.
+ *
+ * Logical volumes registered map to the identifier of their material.
+ *
+ * The registry is meant to be filled once the geometry is built, from one
+ * thread; materials must be locked.  It keeps a reference to the materials
+ * and logical volumes registered.  Once filled, any number of threads may
+ * read it.
+ */
+
+#include "GeoModelKernel/GeoVPhysVol.h"
+#include <unordered_map>
+#include <vector>
+
+class GeoMaterial;
+class GeoLogVol;
+
+class GeoMaterialRegistry
+{
+ public:
+  /// Identifier of a material which is not registered.
+  static constexpr unsigned int NONE = ~0u;
+
+  GeoMaterialRegistry();
+  /// Registers the materials of the logical volumes of the tree below top.
+  GeoMaterialRegistry(PVConstLink top);
+  ~GeoMaterialRegistry();
+
+  GeoMaterialRegistry(const GeoMaterialRegistry &right) = delete;
+  GeoMaterialRegistry & operator=(const GeoMaterialRegistry &right) = delete;
+
+  /// Registers a material, returning its identifier.  A material
+  /// registered already keeps its identifier.  Throws std::runtime_error
+  /// if the material is null, and std::out_of_range if it is not locked.
+  unsigned int add(const GeoMaterial* material);
+
+  /// Registers a logical volume and its material, returning the
+  /// identifier of the material.  Throws std::runtime_error if the
+  /// logical volume has no material.
+  unsigned int add(const GeoLogVol* logVol);
+
+  /// Registers the logical volumes of the tree below top, including the
+  /// volumes of serial transformers.
+  void addTree(PVConstLink top);
+
+  /// Returns the number of materials registered.
+  unsigned int getNMaterials() const;
+
+  /// Returns the identifier of a material, or NONE.
+  unsigned int getId(const GeoMaterial* material) const;
+
+  /// Returns the identifier of the material of a logical volume, or NONE
+  /// if the logical volume is not registered.
+  unsigned int getId(const GeoLogVol* logVol) const;
+
+  /// Returns the material of an identifier.
+  const GeoMaterial* getMaterial(unsigned int id) const;
+
+  /// Properties of the material of an identifier.
+  double getDensity(unsigned int id) const;
+  double getRadLength(unsigned int id) const;
+  double getIntLength(unsigned int id) const;
+  double getDeDxConstant(unsigned int id) const;
+  double getDeDxI0(unsigned int id) const;
+
+  /// The same, for all the materials, indexed by identifier.
+  const std::vector<double>& getDensities() const;
+  const std::vector<double>& getRadLengths() const;
+  const std::vector<double>& getIntLengths() const;
+  const std::vector<double>& getDeDxConstants() const;
+  const std::vector<double>& getDeDxI0s() const;
+
+  /// Returns the first entry of the composition of a material.  id may be
+  /// getNMaterials(), giving the total number of entries.
+  unsigned int getFirstElement(unsigned int id) const;
+
+  /// Z, A and fraction by mass of the entries of the compositions.
+  const std::vector<double>& getElementZ() const;
+  const std::vector<double>& getElementA() const;
+  const std::vector<double>& getElementFraction() const;
+
+ private:
+  std::vector<const GeoMaterial*> m_materials;
+  std::vector<double>             m_density;
+  std::vector<double>             m_radLength;
+  std::vector<double>             m_intLength;
+  std::vector<double>             m_deDxConstant;
+  std::vector<double>             m_deDxI0;
+
+  /// The composition of material i spans m_firstElement[i] to m_firstElement[i+1].
+  std::vector<unsigned int>       m_firstElement;
+  std::vector<double>             m_elementZ;
+  std::vector<double>             m_elementA;
+  std::vector<double>             m_elementFraction;
+
+  std::unordered_map<const GeoMaterial*,unsigned int> m_materialId;
+  std::unordered_map<const GeoLogVol*,unsigned int>   m_logVolId;
+};
+
+inline unsigned int GeoMaterialRegistry::getNMaterials() const
+{
+  return m_materials.size();
+}
+
+inline const GeoMaterial* GeoMaterialRegistry::getMaterial(unsigned int id) const
+{
+  return m_materials[id];
+}
+
+inline double GeoMaterialRegistry::getDensity(unsigned int id) const
+{
+  return m_density[id];
+}
+
+inline double GeoMaterialRegistry::getRadLength(unsigned int id) const
+{
+  return m_radLength[id];
+}
+
+inline double GeoMaterialRegistry::getIntLength(unsigned int id) const
+{
+  return m_intLength[id];
+}
+
+inline double GeoMaterialRegistry::getDeDxConstant(unsigned int id) const
+{
+  return m_deDxConstant[id];
+}
+
+inline double GeoMaterialRegistry::getDeDxI0(unsigned int id) const
+{
+  return m_deDxI0[id];
+}
+
+inline const std::vector<double>& GeoMaterialRegistry::getDensities() const
+{
+  return m_density;
+}
+
+inline const std::vector<double>& GeoMaterialRegistry::getRadLengths() const
+{
+  return m_radLength;
+}
+
+inline const std::vector<double>& GeoMaterialRegistry::getIntLengths() const
+{
+  return m_intLength;
+}
+
+inline const std::vector<double>& GeoMaterialRegistry::getDeDxConstants() const
+{
+  return m_deDxConstant;
+}
+
+inline const std::vector<double>& GeoMaterialRegistry::getDeDxI0s() const
+{
+  return m_deDxI0;
+}
+
+inline unsigned int GeoMaterialRegistry::getFirstElement(unsigned int id) const
+{
+  return m_firstElement[id];
+}
+
+inline const std::vector<double>& GeoMaterialRegistry::getElementZ() const
+{
+  return m_elementZ;
+}
+
+inline const std::vector<double>& GeoMaterialRegistry::getElementA() const
+{
+  return m_elementA;
+}
+
+inline const std::vector<double>& GeoMaterialRegistry::getElementFraction() const
+{
+  return m_elementFraction;
+}
+
+#endif
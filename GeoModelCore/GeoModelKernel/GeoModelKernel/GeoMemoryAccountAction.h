@@ -0,0 +1,200 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEOMEMORYACCOUNTACTION_H
+#define GEOMODELKERNEL_GEOMEMORYACCOUNTACTION_H
+
+/**
+ * @class GeoMemoryAccountAction
+ *
+ * @brief Accounts the memory taken by the nodes of a tree, by node class,
+ * by shape type and by subtree, counting every node once however many
+ * times it is shared.
+ *
+ * The nodes are those of the graph (volumes, transforms, tags and serial
+ * transformers, with the volumes they replicate) and those they refer to:
+ * logical volumes, shapes and their operands, materials and elements,
+ * and the transform functions of serial transformers.
+ * The bytes of a node are the size of its object and of the memory it
+ * owns (arrays of children, facets, strings too long to be held in place,
+ * element lists), without the overhead of the allocator.  The generic
+ * functions inside transform functions cannot be walked, and only their
+ * outermost object is counted.
+ *
+ * The caches built on demand are reported apart, by kind, and are not part
+ * of the total: the indices of the child volumes of the volumes, the tables
+ * of transforms of the serial transformers and the absolute positions,
+ * names and identifiers of the full physical volumes.
+ *
+ * A subtree is one of the volumes placed directly in the top volume.
+ * Each node is accounted to the first subtree in which it is found, so
+ * that the subtrees add up to the total less the top volume and the
+ * other nodes placed directly in it.
+ *
+ * The sharing of a logical volume is given by the number of distinct
+ * physical volumes using it and the number of times these are placed
+ * (each copy of a serial transformer counting); that of a shape, by the
+ * number of logical volumes and boolean shapes using it.
+ *
+ *     GeoMemoryAccountAction action;
+ *     world->exec(&action);
+ *     action.writeJSON(std::cout);
+ *
+ * The results refer to the nodes of the tree, which must outlive them.
+ */
+
+#include "GeoModelKernel/GeoNodeAction.h"
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class GeoShape;
+class GeoMaterial;
+class GeoElement;
+namespace GeoXF {
+  class Function;
+}
+
+class GeoMemoryAccountAction : public GeoNodeAction
+{
+ public:
+  /// A number of distinct nodes, and their bytes.
+  struct Usage {
+    unsigned long count = 0;
+    size_t        bytes = 0;
+  };
+
+  /// The nodes first found in a volume placed in the top volume, and below.
+  struct SubtreeUsage {
+    const GeoVPhysVol* volume;
+    Usage              usage;
+  };
+
+  struct LogVolSharing {
+    const GeoLogVol* logVol;
+    /// Distinct physical volumes using the logical volume.
+    unsigned long    volumes = 0;
+    /// Placements of these volumes in the tree.
+    unsigned long    placements = 0;
+  };
+
+  struct ShapeSharing {
+    const GeoShape* shape;
+    /// Logical volumes and boolean shapes using the shape.
+    unsigned long   users = 0;
+    /// Bytes of the shape itself, operands excluded.
+    size_t          bytes = 0;
+  };
+
+  GeoMemoryAccountAction();
+  virtual ~GeoMemoryAccountAction();
+
+  virtual void handleTransform (const GeoTransform *xform);
+  virtual void handlePhysVol (const GeoPhysVol *vol);
+  virtual void handleFullPhysVol (const GeoFullPhysVol *vol);
+  virtual void handleNameTag (const GeoNameTag *nameTag);
+  virtual void handleSerialDenominator (const GeoSerialDenominator *sD);
+  virtual void handleSerialTransformer (const GeoSerialTransformer *sT);
+  virtual void handleIdentifierTag (const GeoIdentifierTag *idTag);
+  virtual void handleSerialIdentifier (const GeoSerialIdentifier *sI);
+
+  /// All the nodes.
+  const Usage& getTotal() const;
+
+  /// The nodes by class name (GeoPhysVol, GeoTransform, GeoShape...).
+  const std::map<std::string,Usage>& getClassUsage() const;
+
+  /// The shapes by type (Box, Tubs...).
+  const std::map<std::string,Usage>& getShapeTypeUsage() const;
+
+  /// The caches held by the nodes, by kind.
+  const std::map<std::string,Usage>& getCacheUsage() const;
+
+  /// The subtrees, in the order in which they were found.
+  const std::vector<SubtreeUsage>& getSubtreeUsage() const;
+
+  /// The logical volumes and the shapes, in the order in which they were found.
+  const std::vector<LogVolSharing>& getLogVolSharing() const;
+  const std::vector<ShapeSharing>& getShapeSharing() const;
+
+  /// Writes all the results as a JSON object.
+  void writeJSON(std::ostream& out) const;
+
+ private:
+  GeoMemoryAccountAction(const GeoMemoryAccountAction &right);
+  GeoMemoryAccountAction & operator=(const GeoMemoryAccountAction &right);
+
+  /// Accounts a node found for the first time, returning false if it was
+  /// found already.
+  bool account(const void* node, const char* className, size_t bytes);
+
+  /// Accounts a cache of a node, if it is built.
+  void accountCache(const char* kind, size_t bytes);
+
+  /// Returns true if the volume was found for the first time.
+  bool accountVolume(const GeoVPhysVol* vol, const char* className, size_t bytes);
+  void accountFunction(const GeoXF::Function* function);
+  void accountShape(const GeoShape* shape);
+  void accountMaterial(const GeoMaterial* material);
+  void accountElement(const GeoElement* element);
+
+  /// The subtree of the nodes being handled, or none.
+  SubtreeUsage* currentSubtree();
+
+  Usage                                            m_total;
+  std::map<std::string,Usage>                      m_classes;
+  std::map<std::string,Usage>                      m_shapeTypes;
+  std::map<std::string,Usage>                      m_caches;
+  std::vector<SubtreeUsage>                        m_subtrees;
+  std::vector<LogVolSharing>                       m_logVols;
+  std::vector<ShapeSharing>                        m_shapes;
+
+  std::unordered_set<const void*>                  m_seen;
+  std::unordered_map<const GeoVPhysVol*,size_t>    m_subtreeIndex;
+  std::unordered_map<const GeoLogVol*,size_t>      m_logVolIndex;
+  std::unordered_map<const GeoShape*,size_t>       m_shapeIndex;
+
+  /// The number of copies each placement stands for, within serial transformers.
+  unsigned long                                    m_multiplicity;
+};
+
+inline const GeoMemoryAccountAction::Usage& GeoMemoryAccountAction::getTotal() const
+{
+  return m_total;
+}
+
+inline const std::map<std::string,GeoMemoryAccountAction::Usage>& GeoMemoryAccountAction::getClassUsage() const
+{
+  return m_classes;
+}
+
+inline const std::map<std::string,GeoMemoryAccountAction::Usage>& GeoMemoryAccountAction::getShapeTypeUsage() const
+{
+  return m_shapeTypes;
+}
+
+inline const std::map<std::string,GeoMemoryAccountAction::Usage>& GeoMemoryAccountAction::getCacheUsage() const
+{
+  return m_caches;
+}
+
+inline const std::vector<GeoMemoryAccountAction::SubtreeUsage>& GeoMemoryAccountAction::getSubtreeUsage() const
+{
+  return m_subtrees;
+}
+
+inline const std::vector<GeoMemoryAccountAction::LogVolSharing>& GeoMemoryAccountAction::getLogVolSharing() const
+{
+  return m_logVols;
+}
+
+inline const std::vector<GeoMemoryAccountAction::ShapeSharing>& GeoMemoryAccountAction::getShapeSharing() const
+{
+  return m_shapes;
+}
+
+#endif
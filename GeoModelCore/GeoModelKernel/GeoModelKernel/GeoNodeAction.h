@@ -83,6 +83,18 @@ class GeoNodeAction
   
   //	Clears a depth limit, if any.
   void clearDepthLimit ();
+
+  //	For actions which only read the graph and whose results
+  //	can be combined, so that GeoParallelTraversal may run
+  //	them on several subtrees at once: returns a new action
+  //	configured like this one, with empty results.  Returns
+  //	nullptr (the default) if the action must see the whole
+  //	graph in a single pass.
+  virtual GeoNodeAction* clone () const;
+
+  //	Adds the results of a clone which visited the nodes
+  //	following those visited by this action.
+  virtual void merge (const GeoNodeAction &other);
   
  protected:
   //	Termination flag; causes an abortion of action execution.
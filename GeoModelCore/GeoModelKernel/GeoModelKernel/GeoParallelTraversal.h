@@ -0,0 +1,44 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEOPARALLELTRAVERSAL_H
+#define GEOMODELKERNEL_GEOPARALLELTRAVERSAL_H
+
+/**
+ * @class GeoParallelTraversal
+ *
+ * @brief Executes a node action on a volume, visiting independent subtrees
+ * on several threads at once.
+ *
+ * The action must be able to clone itself and merge the results of its
+ * clones (see GeoNodeAction::clone).  The graph is cut at a given depth:
+ * each volume found there becomes a task, together with the transforms and
+ * tags placed before it, and the nodes above are divided into tasks in the
+ * same way.  Each task is run by its own clone, whose path starts with the
+ * ancestors of the nodes it visits.  The tasks are handed out to the worker
+ * threads one at a time, so that threads which finish early take over the
+ * remaining work.  The clones are finally merged into the action in the
+ * order of a serial traversal, so the action ends up with the same results
+ * as if it had been executed on the volume directly.  This is why there is
+ * a clone per task rather than per thread: the tasks a thread runs depend
+ * on timing, and a clone per thread would hold results out of order.
+ */
+
+#include "GeoModelKernel/GeoVPhysVol.h"
+
+class GeoNodeAction;
+
+class GeoParallelTraversal
+{
+ public:
+  /// Executes the action on top, cutting the graph at splitDepth (1 for
+  /// the children of top) and running the tasks on nThreads worker
+  /// threads (0 means one thread per hardware core).
+  static void exec(PVConstLink top
+		   ,GeoNodeAction* action
+		   ,unsigned int nThreads=0
+		   ,unsigned int splitDepth=1);
+};
+
+#endif
@@ -27,6 +27,17 @@ class GeoPcon : public GeoShape
 
   //	Returns the volume of the shape, for mass inventory
   virtual double volume () const;
+
+  //	Classifies a point, given in the local frame of the shape.
+  virtual Location inside (const GeoTrf::Vector3D &p, double tolerance=TOLERANCE) const;
+  using GeoShape::inside;
+
+  //	Computes the intervals in which a line is inside the shape.
+  virtual void getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+				, RayIntervals &intervals) const;
+
+  //	Lower bound of the distance from a point to the surface.
+  virtual double safety (const GeoTrf::Vector3D &p) const;
   
   //	Returns the PCON shape type, as a string.
   virtual const std::string & type () const;
@@ -72,6 +83,10 @@ class GeoPcon : public GeoShape
 
  protected:
   virtual ~GeoPcon();
+
+  //	Computes the bounding box.
+  virtual void computeExtent (double &xmin, double &ymin, double &zmin
+			      , double &xmax, double &ymax, double &zmax) const;
   
  private:
   GeoPcon(const GeoPcon &right);
@@ -18,6 +18,17 @@ class GeoPgon : public GeoShape
 
   //	Returns the volume of the shape, for mass inventory
   virtual double volume () const;
+
+  //	Classifies a point, given in the local frame of the shape.
+  virtual Location inside (const GeoTrf::Vector3D &p, double tolerance=TOLERANCE) const;
+  using GeoShape::inside;
+
+  //	Computes the intervals in which a line is inside the shape.
+  virtual void getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+				, RayIntervals &intervals) const;
+
+  //	Lower bound of the distance from a point to the surface.
+  virtual double safety (const GeoTrf::Vector3D &p) const;
   
   //	Returns the PGON shape type, as a string.
   virtual const std::string & type () const;
@@ -66,6 +77,10 @@ class GeoPgon : public GeoShape
   
  protected:
   virtual ~GeoPgon();
+
+  //	Computes the bounding box.
+  virtual void computeExtent (double &xmin, double &ymin, double &zmin
+			      , double &xmax, double &ymax, double &zmax) const;
   
  private:
   GeoPgon(const GeoPgon &right);
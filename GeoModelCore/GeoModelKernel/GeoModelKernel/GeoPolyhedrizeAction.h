@@ -12,16 +12,27 @@
  * A polhyedral representation is useful when you want to:
  *   -visualize the shape
  *   -compute the shape's volume
+ *
+ * Curved surfaces are divided into a number of steps per whole circle,
+ * given at construction.  Actions with different resolutions can run
+ * concurrently on different threads.
+ *
+ * Given a GeoPolyhedronCache, the action takes the polyhedra of boolean
+ * and shifted shapes from it, rather than building them.  Shapes which
+ * are not referenced yet are built without the cache.
  */
 
 
 #include "GeoModelKernel/GeoShapeAction.h"
 class GeoPolyhedron;
+class GeoPolyhedronCache;
 
 class GeoPolyhedrizeAction : public GeoShapeAction
 {
  public:
-  GeoPolyhedrizeAction();
+  //	Uses nRotationSteps steps per whole circle, or the GeoPolyhedron default if 0,
+  //	and the cache if any.
+  GeoPolyhedrizeAction(int nRotationSteps=0, GeoPolyhedronCache *cache=nullptr);
   virtual ~GeoPolyhedrizeAction();
 
   //	Handles a shift shape.
@@ -65,9 +76,16 @@ class GeoPolyhedrizeAction : public GeoShapeAction
   
   //	Handles a tubs shape.
   virtual void handleTubs (const GeoTubs *tubs);
+
+  //	Handles a tessellated solid.  A mesh is taken as it is; facets added
+  //	one by one are joined at their common vertices.
+  virtual void handleTessellatedSolid (const GeoTessellatedSolid *tessellated);
   
   //	Returns the polyhedral representation of a shape.
   const GeoPolyhedron * getPolyhedron () const;
+
+  //	Returns the number of steps per whole circle, 0 for the default.
+  int getNumberOfRotationSteps () const;
   
   private:
   GeoPolyhedrizeAction(const GeoPolyhedrizeAction &right);
@@ -75,6 +93,15 @@ class GeoPolyhedrizeAction : public GeoShapeAction
 
   //	This polyhedral representation of the shape.
   GeoPolyhedron *m_polyhedron;
+
+  //	The number of steps per whole circle, 0 for the default.
+  int m_nRotationSteps;
+
+  //	The cache of boolean and shifted shapes, if any.
+  GeoPolyhedronCache *m_cache;
+
+  //	Takes a copy of the cached polyhedron of a shape.  False without cache.
+  bool getCached (const GeoShape *shape);
 };
 
 
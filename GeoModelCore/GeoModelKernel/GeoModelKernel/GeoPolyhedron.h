@@ -71,6 +71,9 @@
 //                                        - create polyhedron for Sphere;
 //   GeoPolyhedronTorus (rmin,rmax,rtor,phi,dphi)
 //                                        - create polyhedron for Torus;
+//   GeoPolyhedronArbitrary (nvert,nface)
+//                                        - create polyhedron from vertices
+//                                          and facets added one by one;
 // Public functions:
 //
 //   GetNoVertices ()       - returns number of vertices;
@@ -111,6 +114,10 @@
 //   SetNumberOfRotationSteps (n) - set number of steps for whole circle;
 //   ResetNumberOfRotationSteps() - reset number of steps for whole circle
 //                            to default value;
+//   The constructors of bodies of revolution also take the number of steps
+//   for whole circle as a last, optional, argument.  When given, they do not
+//   read the default, so polyhedra of different resolutions can be built
+//   concurrently.
 // History:
 //
 // 20.06.96 Evgeni Chernyaev <Evgueni.Tcherniaev@cern.ch> - initial version
@@ -159,6 +166,7 @@
 // - added GetSurfaceArea() and GetVolume();
 //
 #include "GeoModelKernel/GeoDefinitions.h"
+#include <atomic>
 #include <iostream>
 
 #ifndef DEFAULT_NUMBER_OF_STEPS
@@ -171,7 +179,7 @@ class GeoPolyhedron
   friend std::ostream & operator<< (std::ostream &, const GeoPolyhedron & ph);
 
 private:
-  static int s_fNumberOfRotationSteps;
+  static std::atomic<int> s_fNumberOfRotationSteps;
 
 protected:
   class GeoFacet
@@ -230,7 +238,11 @@ protected:
   // Create GeoPolyhedron for body of revolution around Z-axis
   void RotateAroundZ (int nstep, double phi, double dphi,
 		      int np1, int np2,
-		      const double *z, double *r, int nodeVis, int edgeVis);
+		      const double *z, double *r, int nodeVis, int edgeVis,
+		      int nRotationSteps = 0);
+
+  // Number of steps for whole circle: n if positive, else the default
+  static int GetNumberOfRotationSteps (int n);
 
   // For each edge set reference to neighbouring facet
   void SetReferences ();
@@ -340,7 +352,7 @@ public:
   // Get number of steps for whole circle
   static int GetNumberOfRotationSteps ()
   {
-    return s_fNumberOfRotationSteps;
+    return s_fNumberOfRotationSteps.load (std::memory_order_relaxed);
   }
 
   // Set number of steps for whole circle
@@ -349,7 +361,7 @@ public:
   // Reset number of steps for whole circle to default value
   static void ResetNumberOfRotationSteps ()
   {
-    s_fNumberOfRotationSteps = DEFAULT_NUMBER_OF_STEPS;
+    s_fNumberOfRotationSteps.store (DEFAULT_NUMBER_OF_STEPS, std::memory_order_relaxed);
   }
 
 
@@ -434,7 +446,7 @@ class GeoPolyhedronCons:public GeoPolyhedron
 public:
   GeoPolyhedronCons (double Rmn1, double Rmx1,
 		     double Rmn2, double Rmx2, double Dz,
-		     double Phi1, double Dphi);
+		     double Phi1, double Dphi, int nRotationSteps = 0);
   virtual ~ GeoPolyhedronCons ();
   virtual GeoPolyhedron & operator = (const GeoPolyhedron & from)
   {
@@ -446,7 +458,7 @@ class GeoPolyhedronCone:public GeoPolyhedronCons
 {
 public:
   GeoPolyhedronCone (double Rmn1, double Rmx1,
-		     double Rmn2, double Rmx2, double Dz);
+		     double Rmn2, double Rmx2, double Dz, int nRotationSteps = 0);
   virtual ~ GeoPolyhedronCone ();
   virtual GeoPolyhedron & operator = (const GeoPolyhedron & from)
   {
@@ -458,7 +470,7 @@ class GeoPolyhedronTubs:public GeoPolyhedronCons
 {
 public:
   GeoPolyhedronTubs (double Rmin, double Rmax, double Dz,
-		     double Phi1, double Dphi);
+		     double Phi1, double Dphi, int nRotationSteps = 0);
   virtual ~ GeoPolyhedronTubs ();
   virtual GeoPolyhedron & operator = (const GeoPolyhedron & from)
   {
@@ -469,7 +481,7 @@ public:
 class GeoPolyhedronTube:public GeoPolyhedronCons
 {
 public:
-  GeoPolyhedronTube (double Rmin, double Rmax, double Dz);
+  GeoPolyhedronTube (double Rmin, double Rmax, double Dz, int nRotationSteps = 0);
   virtual ~ GeoPolyhedronTube ();
   virtual GeoPolyhedron & operator = (const GeoPolyhedron & from)
   {
@@ -481,7 +493,8 @@ class GeoPolyhedronPgon:public GeoPolyhedron
 {
 public:
   GeoPolyhedronPgon (double phi, double dphi, int npdv, int nz,
-		     const double *z, const double *rmin, const double *rmax);
+		     const double *z, const double *rmin, const double *rmax,
+		     int nRotationSteps = 0);
   virtual ~ GeoPolyhedronPgon ();
   virtual GeoPolyhedron & operator = (const GeoPolyhedron & from)
   {
@@ -493,7 +506,8 @@ class GeoPolyhedronPcon:public GeoPolyhedronPgon
 {
 public:
   GeoPolyhedronPcon (double phi, double dphi, int nz,
-		     const double *z, const double *rmin, const double *rmax);
+		     const double *z, const double *rmin, const double *rmax,
+		     int nRotationSteps = 0);
   virtual ~ GeoPolyhedronPcon ();
   virtual GeoPolyhedron & operator = (const GeoPolyhedron & from)
   {
@@ -505,7 +519,8 @@ class GeoPolyhedronSphere:public GeoPolyhedron
 {
 public:
   GeoPolyhedronSphere (double rmin, double rmax,
-		       double phi, double dphi, double the, double dthe);
+		       double phi, double dphi, double the, double dthe,
+		       int nRotationSteps = 0);
   virtual ~ GeoPolyhedronSphere ();
   virtual GeoPolyhedron & operator = (const GeoPolyhedron & from)
   {
@@ -517,7 +532,7 @@ class GeoPolyhedronTorus:public GeoPolyhedron
 {
 public:
   GeoPolyhedronTorus (double rmin, double rmax, double rtor,
-		      double phi, double dphi);
+		      double phi, double dphi, int nRotationSteps = 0);
   virtual ~ GeoPolyhedronTorus ();
   virtual GeoPolyhedron & operator = (const GeoPolyhedron & from)
   {
@@ -525,5 +540,25 @@ public:
   }
 };
 
+class GeoPolyhedronArbitrary:public GeoPolyhedron
+{
+public:
+  GeoPolyhedronArbitrary (int nvert, int nface);
+  virtual ~ GeoPolyhedronArbitrary ();
+  virtual GeoPolyhedron & operator = (const GeoPolyhedron & from)
+  {
+    return GeoPolyhedron::operator = (from);
+  }
+  // Add the next vertex
+  void AddVertex (const GeoTrf::Vector3D & v);
+  // Add the next facet, given by vertex numbers counted from 1; iv4 = 0 for a triangle
+  void AddFacet (int iv1, int iv2, int iv3, int iv4 = 0);
+  // Set the neighbours of the facets, once all are added
+  void Finalize ();
+private:
+  int m_nVertexCount;
+  int m_nFacetCount;
+};
+
 
 #endif
@@ -0,0 +1,115 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEOPOLYHEDRONCACHE_H
+#define GEOMODELKERNEL_GEOPOLYHEDRONCACHE_H
+
+/**
+ * @class GeoPolyhedronCache
+ *
+ * @brief A bounded cache of the polyhedral representations of shapes,
+ * by shape and number of steps per whole circle.
+ *
+ * The operands of boolean and shifted shapes are taken from the cache
+ * too, so a shape used in many boolean trees is meshed, and every
+ * boolean combination processed, once.  A GeoPolyhedrizeAction given a
+ * cache uses it for boolean and shifted shapes.
+ *
+ * The cache keeps a reference to the shapes it holds, so their addresses
+ * cannot be reused while they are in it.  The caller must hold a reference
+ * to the shape it asks for (get() throws std::runtime_error otherwise), so
+ * that dropping a shape never deletes one still in use.  When full, the
+ * cache drops the least recently used polyhedra.  It may be used from any
+ * number of threads; a polyhedron asked for by several threads at once is
+ * built once.
+ */
+
+#include <atomic>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class GeoShape;
+class GeoPolyhedron;
+
+class GeoPolyhedronCache
+{
+ public:
+  /// Holds at most maxSize polyhedra.
+  GeoPolyhedronCache(size_t maxSize=10000);
+  ~GeoPolyhedronCache();
+
+  GeoPolyhedronCache(const GeoPolyhedronCache &right) = delete;
+  GeoPolyhedronCache & operator=(const GeoPolyhedronCache &right) = delete;
+
+  /// Returns the polyhedron of a shape with nRotationSteps steps per whole
+  /// circle, or the GeoPolyhedron default if 0, building it if needed.
+  /// The shape must be referenced by the caller.
+  std::shared_ptr<const GeoPolyhedron> get(const GeoShape* shape, int nRotationSteps=0);
+
+  /// Drops all the polyhedra.
+  void clear();
+
+  /// Returns the number of polyhedra held, and the maximum.
+  size_t size() const;
+  size_t getMaxSize() const;
+
+  /// Returns the number of requests served from the cache, the number of
+  /// polyhedra built, and the number dropped to make room.
+  unsigned long getHits() const;
+  unsigned long getMisses() const;
+  unsigned long getEvictions() const;
+
+ private:
+  typedef std::pair<const GeoShape*,int> Key;
+  typedef std::shared_future<std::shared_ptr<const GeoPolyhedron>> Result;
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  /// Entries in order of use, the most recent first, and their index.
+  /// The cache is split into shards by key, each with its own lock.
+  struct Shard {
+    std::mutex mutex;
+    std::list<std::pair<Key,Result>> entries;
+    std::unordered_map<Key,std::list<std::pair<Key,Result>>::iterator,KeyHash> index;
+  };
+
+  /// Builds a polyhedron, taking the operands of boolean shapes from the cache.
+  GeoPolyhedron* build(const GeoShape* shape, int nRotationSteps);
+
+  size_t                    m_maxSize;
+  size_t                    m_shardSize;
+  std::vector<std::unique_ptr<Shard>> m_shards;
+  std::atomic<unsigned long> m_hits;
+  std::atomic<unsigned long> m_misses;
+  std::atomic<unsigned long> m_evictions;
+};
+
+inline size_t GeoPolyhedronCache::getMaxSize() const
+{
+  return m_maxSize;
+}
+
+inline unsigned long GeoPolyhedronCache::getHits() const
+{
+  return m_hits.load(std::memory_order_relaxed);
+}
+
+inline unsigned long GeoPolyhedronCache::getMisses() const
+{
+  return m_misses.load(std::memory_order_relaxed);
+}
+
+inline unsigned long GeoPolyhedronCache::getEvictions() const
+{
+  return m_evictions.load(std::memory_order_relaxed);
+}
+
+#endif
@@ -10,15 +10,45 @@
  * 
  * @brief This class takes a physical volume and places it
  * according to a transformation field, N times.
+ *
+ * The transforms of all copies may be evaluated once and kept in a table,
+ * in the compact 3x4 form, so that getting the transform of a copy costs
+ * an array lookup rather than the evaluation of the transformation field.
+ * The table is built on the first call to getTransforms(), or on the first
+ * call to getTransform() if the number of copies reached the threshold set
+ * with setTableThreshold() when the serial transformer was constructed.
+ * It is built once, and can be used from several threads.
+ *
+ * The transformation field is compiled to a closed form when it has one
+ * (see GeoXF::CompiledFunction), which is then used to evaluate it.
  */
 
 #include "GeoModelKernel/GeoGraphNode.h"
 #include "GeoModelKernel/GeoVPhysVol.h"
 #include "GeoModelKernel/GeoXF.h"
+#include "GeoModelKernel/GeoXFCompiled.h"
+#include <atomic>
 
 class GeoSerialTransformer : public GeoGraphNode
 {
  public:
+  /// The form in which the transforms are kept in the table.
+  typedef Eigen::Transform<double,3,Eigen::AffineCompact> CompactTransform3D;
+
+  /// A contiguous range of copy transforms from the table.
+  class TransformSpan {
+  public:
+    TransformSpan(const CompactTransform3D* data, unsigned int size) : m_data(data), m_size(size) {}
+    const CompactTransform3D* data() const { return m_data; }
+    unsigned int size() const { return m_size; }
+    const CompactTransform3D* begin() const { return m_data; }
+    const CompactTransform3D* end() const { return m_data + m_size; }
+    const CompactTransform3D& operator[](unsigned int i) const { return m_data[i]; }
+  private:
+    const CompactTransform3D* m_data;
+    unsigned int              m_size;
+  };
+
   GeoSerialTransformer (const GeoVPhysVol *volume, const GeoXF::Function *func, unsigned int copies);
 
   //	Executes a GeoNodeAction.
@@ -27,6 +57,13 @@ class GeoSerialTransformer : public GeoGraphNode
   //	Returns the transformation field itself.
   const GeoXF::Function * getFunction () const;
 
+  //	Returns the closed form of the transformation field, which
+  //	is not valid if it has none.
+  const GeoXF::CompiledFunction & getCompiledFunction () const
+  {
+    return m_compiled;
+  }
+
   // Returns the volume:
   PVConstLink getVolume () const
   {
@@ -42,9 +79,27 @@ class GeoSerialTransformer : public GeoGraphNode
   // Returns the transformation to the ith copy:
   GeoTrf::Transform3D getTransform (int i) const
   {
-    return (*m_function) (i);
+    const CompactTransform3D* table = m_table.load(std::memory_order_acquire);
+    if (!table && m_tableOnGet) table = getTable();
+    if (table && static_cast<unsigned int>(i) < m_nCopies) return GeoTrf::Transform3D(table[i]);
+    return m_compiled.isValid() ? m_compiled (i) : (*m_function) (i);
   }
 
+  /// Returns the transforms of the copies first to first+n-1 (or to the
+  /// last copy), building the table if needed.  They remain valid as long
+  /// as the serial transformer.
+  TransformSpan getTransforms (unsigned int first=0, unsigned int n=~0u) const;
+
+  /// Sets the number of copies from which the table is built on the first
+  /// call to getTransform(), for the serial transformers constructed from
+  /// then on.  The default, 0, leaves the transforms to be evaluated on
+  /// each call until getTransforms() is used.
+  static void setTableThreshold (unsigned int nCopies);
+  static unsigned int getTableThreshold ();
+
+  /// Returns the bytes of the table of transforms, 0 if it is not built.
+  size_t getTableBytes () const;
+
  protected:
   virtual ~GeoSerialTransformer();
 
@@ -59,8 +114,25 @@ class GeoSerialTransformer : public GeoGraphNode
   //	Transform-valued m_function of a single variable.
   const GeoXF::Function *m_function;
 
+  //	The closed form of m_function, if it has one.
+  GeoXF::CompiledFunction m_compiled;
+
   //	The physical volume to be multiply placed.
   const GeoVPhysVol *m_physVol;
+
+  //	Builds the table of transforms, if it does not exist yet.
+  const CompactTransform3D* getTable () const;
+
+  //	The transforms of all copies, once built.
+  mutable std::atomic<const CompactTransform3D*> m_table;
+
+  //	Whether getTransform() builds the table, decided at construction.
+  const bool m_tableOnGet;
+
+  //	The number of copies from which new serial transformers build the
+  //	table in getTransform(); stored as the largest unsigned int when 0
+  //	was requested.
+  static std::atomic<unsigned int> s_tableThreshold;
 };
 
 #endif
@@ -11,6 +11,10 @@
  * @brief This class describes a Shape. Shapes will be able to do the following things:
  *          * Identify themselves.
  *          * Compute their volume.
+ *          * Classify points as inside, outside or on their surface.
+ *          * Report their extent, as a bounding box in their local frame.
+ *          * Measure distances to their surface along a ray, and safety
+ *            distances, for navigation without Geant4.
  *          * Combine themselves using Boolean operations with other shapes.
  *      The type identification works as follows:
  *           if (myShape->typeId()==GeoBox::classTypeId()) {
@@ -26,7 +30,10 @@
 
 #include "GeoModelKernel/RCBase.h"
 #include <GeoModelKernel/GeoDefinitions.h>
+#include <atomic>
 #include <string>
+#include <utility>
+#include <vector>
 
 typedef unsigned int ShapeType;
 class GeoShapeIntersection;
@@ -38,12 +45,65 @@ class GeoShapeAction;
 class GeoShape : public RCBase
 {
  public:
+  //	Location of a point with respect to a shape.
+  enum Location
+  {
+    OUTSIDE,
+    SURFACE,
+    INSIDE
+  };
+
+  //	Default half thickness of the surface, for point classification.
+  static constexpr double TOLERANCE = 1e-9;
+
+  //	Sorted, disjoint intervals [t1,t2] of a ray parameter.
+  typedef std::vector<std::pair<double,double> > RayIntervals;
+
   // Constructor for shape.  Must provide the name, a string to identify this shape.
   GeoShape ();
 
   //	Returns the volume of the shape, for mass inventory
   virtual double volume () const = 0;
 
+  //	Classifies a point, given in the local frame of the shape.  Points
+  //	closer to the surface than the tolerance are on the SURFACE.
+  //	Shapes which cannot classify points throw std::runtime_error.
+  virtual Location inside (const GeoTrf::Vector3D &p, double tolerance=TOLERANCE) const;
+
+  //	Classifies n points at once.  The coordinates are given in separate
+  //	arrays, so that shapes can process them in vectorizable loops.
+  //	GeoBox, GeoTube, GeoTrd, GeoTrap, GeoPara, GeoGenericTrap, the
+  //	boolean shapes and GeoShapeShift have a batched implementation; the
+  //	other shapes classify the points one by one with inside(p).
+  virtual void inside (size_t n, const double *x, const double *y, const double *z
+		       , Location *result, double tolerance=TOLERANCE) const;
+
+  //	True if the point is inside the shape or on its surface.
+  bool contains (const GeoTrf::Vector3D &p) const;
+
+  //	Returns the bounding box of the shape, in its local frame.  Exact for
+  //	primitives, conservative for boolean shapes.  Computed on first use.
+  void extent (double &xmin, double &ymin, double &zmin
+	       , double &xmax, double &ymax, double &zmax) const;
+
+  //	Computes the intervals of t in which the point p+t*v is inside the
+  //	shape, along the whole line.  Infinite ends are +-HUGE_VAL.
+  //	Shapes which cannot intersect lines throw std::runtime_error.
+  virtual void getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+				, RayIntervals &intervals) const;
+
+  //	Distance from the point p along the unit vector v to where the ray
+  //	enters the shape.  Zero if p is inside, HUGE_VAL if the ray misses.
+  double distanceToIn (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v) const;
+
+  //	Distance from the point p along the unit vector v to where the ray
+  //	leaves the shape.  Zero if p is outside.
+  double distanceToOut (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v) const;
+
+  //	Returns a lower bound of the distance from the point to the surface,
+  //	from either side.  Shapes which cannot estimate it throw std::runtime_error.
+  virtual double safety (const GeoTrf::Vector3D &p) const;
+
   //	Boolean OR operation for shapes
   const GeoShapeUnion & add (const GeoShape& shape) const;
   
@@ -68,10 +128,27 @@ class GeoShape : public RCBase
  protected:
   virtual ~GeoShape();
 
+  //	Computes the bounding box, see extent().  Shapes which cannot compute
+  //	it throw std::runtime_error.
+  virtual void computeExtent (double &xmin, double &ymin, double &zmin
+			      , double &xmax, double &ymax, double &zmax) const;
+
+  //	Drops the cached bounding box.  For shapes which are built incrementally.
+  void invalidateExtent ();
+
  private:
   GeoShape(const GeoShape &right);
   GeoShape & operator=(const GeoShape &right);
 
+  //	The cached bounding box, and whether it has been computed.
+  mutable double m_extent[6];
+  mutable std::atomic<unsigned char> m_extentState;
+
 };
 
+inline bool GeoShape::contains (const GeoTrf::Vector3D &p) const
+{
+  return inside(p) != OUTSIDE;
+}
+
 #endif
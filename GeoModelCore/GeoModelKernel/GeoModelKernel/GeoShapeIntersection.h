@@ -22,9 +22,23 @@ class GeoShapeIntersection : public GeoShape
   //	Constructor taking two shape operands.
   GeoShapeIntersection (const GeoShape* A, const GeoShape* B);
 
-  //	Returns the volume of the shape, for mass inventory
+  //	Returns the volume of the shape, for mass inventory.  Computed on first use.
   virtual double volume () const;
 
+  //	Classifies a point, given in the local frame of the shape.
+  virtual Location inside (const GeoTrf::Vector3D &p, double tolerance=TOLERANCE) const;
+
+  //	Classifies n points at once.
+  virtual void inside (size_t n, const double *x, const double *y, const double *z
+		       , Location *result, double tolerance=TOLERANCE) const;
+
+  //	Computes the intervals in which a line is inside the shape.
+  virtual void getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+				, RayIntervals &intervals) const;
+
+  //	Lower bound of the distance from a point to the surface.
+  virtual double safety (const GeoTrf::Vector3D &p) const;
+
   //	Returns the AND shape type, as a string.
   virtual const std::string & type () const;
 
@@ -49,6 +63,10 @@ class GeoShapeIntersection : public GeoShape
  protected:
   virtual ~GeoShapeIntersection();
 
+  //	Computes the bounding box.
+  virtual void computeExtent (double &xmin, double &ymin, double &zmin
+			      , double &xmax, double &ymax, double &zmax) const;
+
  private:
   GeoShapeIntersection(const GeoShapeIntersection &right);
   GeoShapeIntersection & operator=(const GeoShapeIntersection &right);
@@ -59,6 +77,9 @@ class GeoShapeIntersection : public GeoShape
   //	The second shape operand in the AND operation.
   const GeoShape* m_opB;
 
+  //	The volume, once computed, negative until then.  See GeoBooleanVolume.
+  mutable std::atomic<double> m_volume{-1};
+
   static const std::string s_classType;
   static const ShapeType s_classTypeID;
 
@@ -22,6 +22,20 @@ class GeoShapeShift : public GeoShape
   //	Returns the volume of the shape, for mass inventory
   virtual double volume () const;
 
+  //	Classifies a point, given in the local frame of the shape.
+  virtual Location inside (const GeoTrf::Vector3D &p, double tolerance=TOLERANCE) const;
+
+  //	Classifies n points at once.
+  virtual void inside (size_t n, const double *x, const double *y, const double *z
+		       , Location *result, double tolerance=TOLERANCE) const;
+
+  //	Computes the intervals in which a line is inside the shape.
+  virtual void getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+				, RayIntervals &intervals) const;
+
+  //	Lower bound of the distance from a point to the surface.
+  virtual double safety (const GeoTrf::Vector3D &p) const;
+
   //	Returns the OR shape type, as a string.
   virtual const std::string & type () const;
 
@@ -46,6 +60,10 @@ class GeoShapeShift : public GeoShape
  protected:
   virtual ~GeoShapeShift();
 
+  //	Computes the bounding box.
+  virtual void computeExtent (double &xmin, double &ymin, double &zmin
+			      , double &xmax, double &ymax, double &zmax) const;
+
  private:
   GeoShapeShift(const GeoShapeShift &right);
   GeoShapeShift & operator=(const GeoShapeShift &right);
@@ -56,6 +74,9 @@ class GeoShapeShift : public GeoShape
   //	Gives the amount by which the volume is shifted.
   GeoTrf::Transform3D m_shift;
 
+  //	The inverse of the shift, for point classification.
+  GeoTrf::Transform3D m_invShift;
+
   static const std::string s_classType;
   static const ShapeType s_classTypeID;
 
@@ -18,9 +18,23 @@ class GeoShapeSubtraction : public GeoShape
  public:
   GeoShapeSubtraction (const GeoShape* A, const GeoShape* B);
 
-  //	Returns the volume of the shape, for mass inventory
+  //	Returns the volume of the shape, for mass inventory.  Computed on first use.
   virtual double volume () const;
 
+  //	Classifies a point, given in the local frame of the shape.
+  virtual Location inside (const GeoTrf::Vector3D &p, double tolerance=TOLERANCE) const;
+
+  //	Classifies n points at once.
+  virtual void inside (size_t n, const double *x, const double *y, const double *z
+		       , Location *result, double tolerance=TOLERANCE) const;
+
+  //	Computes the intervals in which a line is inside the shape.
+  virtual void getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+				, RayIntervals &intervals) const;
+
+  //	Lower bound of the distance from a point to the surface.
+  virtual double safety (const GeoTrf::Vector3D &p) const;
+
   //	Returns the NOT shape type, as a string.
   virtual const std::string & type () const;
 
@@ -45,6 +59,10 @@ class GeoShapeSubtraction : public GeoShape
  protected:
   virtual ~GeoShapeSubtraction();
 
+  //	Computes the bounding box.
+  virtual void computeExtent (double &xmin, double &ymin, double &zmin
+			      , double &xmax, double &ymax, double &zmax) const;
+
  private:
   GeoShapeSubtraction(const GeoShapeSubtraction &right);
   GeoShapeSubtraction & operator=(const GeoShapeSubtraction &right);
@@ -55,6 +73,9 @@ class GeoShapeSubtraction : public GeoShape
   //	The shape operand in the Subtraction operation
   const GeoShape* m_opB;
 
+  //	The volume, once computed, negative until then.  See GeoBooleanVolume.
+  mutable std::atomic<double> m_volume{-1};
+
   static const std::string s_classType;
   static const ShapeType s_classTypeID;
 
@@ -27,6 +27,17 @@ class GeoSimplePolygonBrep : public GeoShape
 
   virtual double volume() const;
 
+  //	Classifies a point, given in the local frame of the shape.
+  virtual Location inside(const GeoTrf::Vector3D &p, double tolerance=TOLERANCE) const;
+  using GeoShape::inside;
+
+  //	Computes the intervals in which a line is inside the shape.
+  virtual void getRayIntervals(const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+				, RayIntervals &intervals) const;
+
+  //	Lower bound of the distance from a point to the surface.
+  virtual double safety(const GeoTrf::Vector3D &p) const;
+
   virtual const std::string& type() const;
   virtual ShapeType typeID() const;
 
@@ -48,10 +59,17 @@ class GeoSimplePolygonBrep : public GeoShape
  protected:
   virtual ~GeoSimplePolygonBrep();
 
+  //	Computes the bounding box.
+  virtual void computeExtent (double &xmin, double &ymin, double &zmin
+			      , double &xmax, double &ymax, double &zmax) const;
+
  private:
   GeoSimplePolygonBrep(const GeoSimplePolygonBrep &right);
   GeoSimplePolygonBrep & operator=(const GeoSimplePolygonBrep &right);
 
+  //	Signed distance to the surface, negative inside.
+  double distance(const GeoTrf::Vector3D &p) const;
+
   static const std::string s_classType;
   static const ShapeType s_classTypeID;
 
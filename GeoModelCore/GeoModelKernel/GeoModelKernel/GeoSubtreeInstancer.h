@@ -0,0 +1,111 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEOSUBTREEINSTANCER_H
+#define GEOMODELKERNEL_GEOSUBTREEINSTANCER_H
+
+/**
+ * @class GeoSubtreeInstancer
+ *
+ * @brief Rewrites a tree in place so that physical volumes with the same
+ * content share one instance, and so that regular runs of placements of
+ * one volume become serial transformers.
+ *
+ * The content of a physical volume is its logical volume, compared in the
+ * sense of GeoContentHash, and its daughter nodes in order: transforms,
+ * name and identifier tags, serial denominators and identifiers, serial
+ * transformers and daughter volumes, compared by content in turn.
+ * Parameters and transforms are compared exactly.  Only GeoPhysVols are
+ * shared.  Full physical volumes, volumes of other classes and volumes
+ * holding alignable transforms or nodes of unknown kinds are left as they
+ * are, and so are the volumes above them, so that full physical volumes
+ * keep their unique position.  The daughters of volumes of classes other
+ * than GeoPhysVol and GeoFullPhysVol are not rewritten either.
+ *
+ * A run of placements is a sequence of daughters of one volume, each a
+ * transform followed by the same volume, with no tags in between except
+ * serial denominators and identifiers before the first one.  When the
+ * transforms of at least getMinSerialCopies() placements are T*Pow(D,i),
+ * as for a row of modules, or Pow(D,i)*T, as for a ring of modules turned
+ * about an axis of the mother, within the tolerance, the run is replaced
+ * by a serial transformer.  Its transforms are checked against those of
+ * the placements before they are replaced.
+ * Names, identifiers and the number of child volumes are unchanged.
+ *
+ * The statistics give the volumes found, the placements rewritten and the
+ * nodes and bytes of the tree before and after, as GeoMemoryAccountAction
+ * counts them.  Materials must be locked.  Nodes replaced are freed once
+ * nothing else refers to them.  Not to be used while the tree is being
+ * accessed.
+ *
+ *     GeoSubtreeInstancer instancer;
+ *     instancer.apply(world);
+ */
+
+#include "GeoModelKernel/GeoVPhysVol.h"
+
+class GeoSubtreeInstancer
+{
+ public:
+  struct Statistics {
+    /// Distinct physical volumes found, and distinct contents among them.
+    unsigned long nVolumes = 0;
+    unsigned long nDistinctVolumes = 0;
+    /// Daughter volumes and serial transformers replaced by a shared instance.
+    unsigned long nReplacedPlacements = 0;
+    /// Serial transformers built from runs, and the placements they replace.
+    unsigned long nSerialTransformers = 0;
+    unsigned long nSerializedPlacements = 0;
+    /// Distinct nodes of the tree and their bytes, before and after.
+    unsigned long nodesBefore = 0;
+    unsigned long nodesAfter = 0;
+    size_t        bytesBefore = 0;
+    size_t        bytesAfter = 0;
+  };
+
+  GeoSubtreeInstancer();
+  ~GeoSubtreeInstancer();
+
+  GeoSubtreeInstancer(const GeoSubtreeInstancer &right) = delete;
+  GeoSubtreeInstancer & operator=(const GeoSubtreeInstancer &right) = delete;
+
+  /// The shortest run replaced by a serial transformer, 8 by default.
+  /// Zero leaves the runs as they are.
+  void setMinSerialCopies(unsigned int nCopies);
+  unsigned int getMinSerialCopies() const;
+
+  /// The largest difference allowed between an element of the transform
+  /// of a placement and that of the serial transformer, relative to the
+  /// element when larger than one.  1e-9 by default.
+  void setTolerance(double tolerance);
+  double getTolerance() const;
+
+  /// Rewrites the tree below top, returning the statistics of the pass.
+  const Statistics& apply(PVLink top);
+
+  /// The statistics of the last pass.
+  const Statistics& getStatistics() const;
+
+ private:
+  unsigned int m_minSerialCopies;
+  double       m_tolerance;
+  Statistics   m_stats;
+};
+
+inline unsigned int GeoSubtreeInstancer::getMinSerialCopies() const
+{
+  return m_minSerialCopies;
+}
+
+inline double GeoSubtreeInstancer::getTolerance() const
+{
+  return m_tolerance;
+}
+
+inline const GeoSubtreeInstancer::Statistics& GeoSubtreeInstancer::getStatistics() const
+{
+  return m_stats;
+}
+
+#endif
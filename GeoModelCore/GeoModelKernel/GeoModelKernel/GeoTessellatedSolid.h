@@ -7,14 +7,52 @@
 
 #include "GeoModelKernel/GeoShape.h"
 #include "GeoModelKernel/GeoFacet.h"
+#include <atomic>
+#include <vector>
+
+/**
+ * @class GeoTessellatedSolid
+ *
+ * @brief A solid bounded by triangular and quadrangular facets.
+ *
+ * The facets are either added one by one as GeoFacet objects, or given in
+ * bulk as an indexed mesh: one buffer of vertices, shared by the facets,
+ * and one buffer of indices into it, three or four per facet.  A mesh
+ * with four indices per facet may hold triangles, their fourth index being
+ * NO_VERTEX.  The vertices of a mesh are absolute, and the facets of a
+ * mesh cost a few tens of bytes each instead of a few hundred.
+ *
+ * A solid holds facets or a mesh, not both.  On a mesh, getFacet() builds
+ * GeoFacet objects for all the facets on first use, for code which does
+ * not read the mesh itself; getFacetVertices() reads either form.
+ */
 
 class GeoTessellatedSolid : public GeoShape
 {
  public:
+  /// The fourth index of a triangle, in a mesh with four indices per facet.
+  static constexpr unsigned int NO_VERTEX = ~0u;
+
   GeoTessellatedSolid();
 
+  /// A solid made of a mesh, see setMesh().
+  GeoTessellatedSolid(std::vector<GeoFacetVertex> vertices
+		      , std::vector<unsigned int> indices
+		      , unsigned int verticesPerFacet=3);
+
   virtual double volume() const;
 
+  //	Classifies a point, given in the local frame of the shape.
+  virtual Location inside(const GeoTrf::Vector3D &p, double tolerance=TOLERANCE) const;
+  using GeoShape::inside;
+
+  //	Computes the intervals in which a line is inside the shape.
+  virtual void getRayIntervals(const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+				, RayIntervals &intervals) const;
+
+  //	Lower bound of the distance from a point to the surface.
+  virtual double safety(const GeoTrf::Vector3D &p) const;
+
   virtual const std::string& type() const;
   virtual ShapeType typeID() const;
 
@@ -27,6 +65,25 @@ class GeoTessellatedSolid : public GeoShape
   GeoFacet* getFacet(size_t) const;
   size_t getNumberOfFacets() const;
 
+  //	Sets the facets from a vertex buffer and an index buffer of
+  //	verticesPerFacet (3 or 4) indices per facet.  Throws if the solid has
+  //	facets already, if the mesh has no facet or if the buffers are
+  //	inconsistent.
+  void setMesh(std::vector<GeoFacetVertex> vertices
+	       , std::vector<unsigned int> indices
+	       , unsigned int verticesPerFacet=3);
+
+  //	True if the solid is made of a mesh.
+  bool isIndexed() const;
+
+  //	The buffers of the mesh, empty if the solid is made of facets.
+  const std::vector<GeoFacetVertex>& getVertices() const;
+  const std::vector<unsigned int>& getIndices() const;
+  unsigned int getVerticesPerFacet() const;
+
+  //	Puts the absolute vertices of a facet in v, returning their number.
+  size_t getFacetVertices(size_t index, GeoFacetVertex v[4]) const;
+
   // True if the tessellated solid has at least four facets (tetrahedron).
   // False otherwise.
   bool isValid () const;
@@ -34,6 +91,10 @@ class GeoTessellatedSolid : public GeoShape
  protected:
   virtual ~GeoTessellatedSolid();
 
+  //	Computes the bounding box.
+  virtual void computeExtent (double &xmin, double &ymin, double &zmin
+			      , double &xmax, double &ymax, double &zmax) const;
+
  private:
   GeoTessellatedSolid(const GeoTessellatedSolid &right);
   GeoTessellatedSolid& operator=(const GeoTessellatedSolid &right);
@@ -42,6 +103,14 @@ class GeoTessellatedSolid : public GeoShape
   static const ShapeType s_classTypeID;
 
   std::vector<GeoFacet*> m_facets;
+
+  //	The mesh, if any.
+  std::vector<GeoFacetVertex> m_vertices;
+  std::vector<unsigned int> m_indices;
+  unsigned int m_verticesPerFacet;
+
+  //	Facet objects built from the mesh by getFacet(), on first use.
+  mutable std::atomic<GeoFacet* const*> m_meshFacets;
 };
 
 inline const std::string& GeoTessellatedSolid::getClassType()
@@ -56,7 +125,27 @@ inline ShapeType GeoTessellatedSolid::getClassTypeID()
 
 inline bool GeoTessellatedSolid::isValid () const
 {
-  return m_facets.size () >= 4;
+  return getNumberOfFacets () >= 4;
+}
+
+inline bool GeoTessellatedSolid::isIndexed () const
+{
+  return !m_indices.empty ();
+}
+
+inline const std::vector<GeoFacetVertex>& GeoTessellatedSolid::getVertices () const
+{
+  return m_vertices;
+}
+
+inline const std::vector<unsigned int>& GeoTessellatedSolid::getIndices () const
+{
+  return m_indices;
+}
+
+inline unsigned int GeoTessellatedSolid::getVerticesPerFacet () const
+{
+  return m_verticesPerFacet;
 }
 
 #endif
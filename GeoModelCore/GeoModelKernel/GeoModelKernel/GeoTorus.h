@@ -15,6 +15,17 @@ class GeoTorus : public GeoShape
 
   virtual double volume () const;
 
+  //	Classifies a point, given in the local frame of the shape.
+  virtual Location inside (const GeoTrf::Vector3D &p, double tolerance=TOLERANCE) const;
+  using GeoShape::inside;
+
+  //	Computes the intervals in which a line is inside the shape.
+  virtual void getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+				, RayIntervals &intervals) const;
+
+  //	Lower bound of the distance from a point to the surface.
+  virtual double safety (const GeoTrf::Vector3D &p) const;
+
   virtual const std::string & type () const;
   virtual ShapeType typeID () const;
 
@@ -32,10 +43,17 @@ class GeoTorus : public GeoShape
  protected:
   virtual ~GeoTorus();
 
+  //	Computes the bounding box.
+  virtual void computeExtent (double &xmin, double &ymin, double &zmin
+			      , double &xmax, double &ymax, double &zmax) const;
+
  private:
   GeoTorus(const GeoTorus &right);
   GeoTorus & operator=(const GeoTorus &right);
 
+  //	Signed distance to the surface, regardless of the phi segment.
+  double radialDistance (const GeoTrf::Vector3D &p) const;
+
   static const std::string s_classType;
   static const ShapeType s_classTypeID;
 
@@ -3,7 +3,7 @@
 */
 
 #ifndef GEOMODELKERNEL_GEOTRANSFORM_H
-#define GEOMODELKERNEL_GEOTRANSFORM_H 
+#define GEOMODELKERNEL_GEOTRANSFORM_H
 
 /**
  * @class GeoTransform
@@ -11,7 +11,13 @@
  * @brief A basic geometrical (Euclidean) transform.  Can return a GeoTrf::Transform3D.
  * Reference counted.  There is no (mis)alignment present in this class.  For a transform
  * that can be  (mis)aligned, see GeoAlignableTransform
- * 
+ *
+ * The transform is stored in the most compact of the following forms
+ * that represents it, up to rounding errors: the identity, a translation,
+ * a translation combined with a rotation about the x, y or z axis, or a
+ * general 3x3 matrix and a translation.  The general matrix is kept out of line.  The
+ * accumulate methods compose the transform onto another one, taking
+ * shortcuts for the compact forms.
  */
 
 #include "GeoModelKernel/GeoGraphNode.h"
@@ -22,6 +28,9 @@ class GeoVAlignmentStore;
 class GeoTransform : public GeoGraphNode
 {
  public:
+  /// The forms in which a transform is stored.
+  enum Kind : unsigned char { IDENTITY, TRANSLATION, AXIS_ROTATION, GENERAL };
+
   GeoTransform(const GeoTrf::Transform3D& transform);
 
   GeoTransform(const GeoTransform &right) = delete;
@@ -33,15 +42,40 @@ class GeoTransform : public GeoGraphNode
   /// Gets the default transformation (no alignment correction)
   GeoTrf::Transform3D getDefTransform(const GeoVAlignmentStore* store=nullptr) const;
 
+  /// Multiplies x on the right by the total transformation.
+  virtual void accumulateTransform(GeoTrf::Transform3D& x, const GeoVAlignmentStore* store=nullptr) const;
+
+  /// Multiplies x on the right by the default transformation.
+  void accumulateDefTransform(GeoTrf::Transform3D& x) const;
+
+  /// Gets the form in which the default transformation is stored.
+  Kind getKind() const;
+
   ///	Executes a GeoNodeAction.
   virtual void exec(GeoNodeAction *action) const override final;
-  
+
  protected:
   virtual ~GeoTransform() override;
 
  private:
-  // The Euclidean (Rigid Body) transform.
-  GeoTrf::Transform3D m_transform;
+  // The form of the transform, and for AXIS_ROTATION, the axis (0,1,2 for x,y,z).
+  Kind          m_kind;
+  unsigned char m_axis;
+
+  // The translation, unless the transform is the identity.
+  double        m_translation[3];
+
+  // The rotation: its cosine and sine for AXIS_ROTATION, or a column-major
+  // 3x3 matrix on the heap for GENERAL.
+  union {
+    double      m_cosSin[2];
+    double*     m_matrix;
+  };
 };
 
+inline GeoTransform::Kind GeoTransform::getKind() const
+{
+  return m_kind;
+}
+
 #endif
@@ -20,6 +20,20 @@ class GeoTrap : public GeoShape
 
   //	Returns the volume of the shape, for mass inventory
   virtual double volume () const;
+
+  //	Classifies a point, given in the local frame of the shape.
+  virtual Location inside (const GeoTrf::Vector3D &p, double tolerance=TOLERANCE) const;
+
+  //	Classifies n points at once.
+  virtual void inside (size_t n, const double *x, const double *y, const double *z
+		       , Location *result, double tolerance=TOLERANCE) const;
+
+  //	Computes the intervals in which a line is inside the shape.
+  virtual void getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+				, RayIntervals &intervals) const;
+
+  //	Lower bound of the distance from a point to the surface.
+  virtual double safety (const GeoTrf::Vector3D &p) const;
   
   //	Returns the TRAP shape type, as a string.
   virtual const std::string & type () const;
@@ -70,10 +84,20 @@ class GeoTrap : public GeoShape
  protected:
   virtual ~GeoTrap();
 
+  //	Computes the bounding box.
+  virtual void computeExtent (double &xmin, double &ymin, double &zmin
+			      , double &xmax, double &ymax, double &zmax) const;
+
  private:
   GeoTrap(const GeoTrap &right);
   GeoTrap & operator=(const GeoTrap &right);
 
+  //	Signed distance to the surface, negative inside.
+  double distance (const GeoTrf::Vector3D &p) const;
+
+  //	Outward unit normals n and offsets d of the side faces: inside, n.p <= d.
+  void getSidePlanes (GeoTrf::Vector3D *n, double *d) const;
+
   static const std::string s_classType;
   static const ShapeType s_classTypeID;
 
@@ -13,104 +13,150 @@
  *	* The default absolute transform from the place where the action started.
  *	* The path to the node.
  *	* The depth
+ *
+ * The state keeps one entry per level of the path, in an array which grows
+ * to the depth of the tree and is reused from then on, so that a traversal
+ * does not allocate memory at every volume.  The transforms, names and
+ * identifiers of the volumes are looked up from their parents only when
+ * asked for, and the absolute transforms and names composed then; values
+ * that the action does not need (see setNeeds) are never looked up.  The
+ * lookups go through an index of the child volumes which the state keeps
+ * for each level and rebuilds in place, so that a traversal leaves no
+ * index attached to the volumes it visits.
  */
- 
+
 #include "GeoModelKernel/GeoNodePath.h"
 #include "GeoModelKernel/GeoDefinitions.h"
-#include <stack>
+#include <memory>
 #include <string>
+#include <vector>
 
-class GeoTraversalState 
+class GeoChildVolumeIndex;
+
+class GeoTraversalState
 {
  public:
+  /// The parts of the state an action can ask for.
+  enum Needs
+  { TRANSFORMS = 1, NAMES = 2, IDS = 4, ALL = 7 };
+
   GeoTraversalState ();
   virtual ~GeoTraversalState();
 
   //	Gets the transformation of the current node with respect
   //	to its parent.
   const GeoTrf::Transform3D & getTransform () const;
-  
+
   //	Gets the name of the current node.
   const std::string & getName () const;
-  
+
   //	Gets the default transformation of the current node with
   //	respect to its parent.
   const GeoTrf::Transform3D & getDefTransform () const;
-  
+
   //	Gets the absolute name of the current node.
   const std::string & getAbsoluteName () const;
-  
+
   //	Gets the default absolute transformation to the current
   //	node.
   const GeoTrf::Transform3D & getDefAbsoluteTransform () const;
 
   //	Gets the absolute transformation to the current node.
   const GeoTrf::Transform3D & getAbsoluteTransform () const;
-  
+
   //	Sets the transform for the current node.
   void setTransform (const GeoTrf::Transform3D &transform);
-  
+
   //	Sets the name for the current node.
   void setName (const std::string &name);
-  
+
   //	Sets the default absolute transform for the current node.
   void setDefTransform (const GeoTrf::Transform3D &transform);
-  
-  //	Goes to the next level.  Pushes the last absolute
-  //	transform onto the stack so that it can be retreived
+
+  //	Makes the current node the child volume of the given index
+  //	of the volume at the tail of the path.  Its transforms,
+  //	name and identifier are looked up when asked for.
+  void setChildVol (unsigned int index);
+
+  //	Goes to the next level, below the volume pv.  The state
+  //	of the current node is kept so that it can be retreived
   //	when going back to the previous level.
   void nextLevel (const GeoVPhysVol* pv);
-  
-  //	Goes to the previous level.  Pops the last absolute
-  //	transform onto the stack, restoring the absolute
-  //	transform to that of the previous level.
+
+  //	Goes to the previous level, restoring the state of the
+  //	node of that level.
   void previousLevel ();
-  
+
+  //	Returns the index of the child volumes of the volume at the
+  //	tail of the path, built by nextLevel.
+  const GeoChildVolumeIndex & getChildVolumes () const;
+
   //	Returns the path.
   const GeoNodePath * getPath () const;
-  
+
   //	Sets the identifier for the current node.
   void setId (const Query<int> &id);
-  
+
   //	Gets the id of the current node.
   const Query<int> getId () const;
 
+  //	Declares the parts of the state (a combination of Needs)
+  //	that are used.  The others keep their default values:
+  //	identity transforms, empty names and invalid identifiers.
+  void setNeeds (unsigned int needs);
+  unsigned int getNeeds () const;
+
  private:
   GeoTraversalState(const GeoTraversalState &right);
   GeoTraversalState & operator=(const GeoTraversalState &right);
 
-  //	A list of tranformations for all nodes visited at all
-  //	previous levels of traversal.
-  std::stack<GeoTrf::Transform3D> m_absTransformList;
-  
-  //	A list of default tranformations for all nodes visited
-  //	at all previous levels of traversal.
-  std::stack<GeoTrf::Transform3D> m_defAbsTransformList;
-  
-  //	List of volume names.
-  std::stack<std::string> m_absNameList;
-  
-  //	The absolute transform for the present volume.
-  GeoTrf::Transform3D m_absTransform;
-  
-  //	The default absolute transform.
-  GeoTrf::Transform3D m_defAbsTransform;
-  
-  //	The absolute name.
-  std::string m_absName;
-  
-  //	The transform from parent to current.
-  GeoTrf::Transform3D m_transform;
-  
-  //	The default transform from parent to current.
-  GeoTrf::Transform3D m_defTransform;
-  
-  //	The relative name.
-  std::string m_name;
-  
-  //	And identifier for this volume.
-  Query<int> m_id;
-  
+  // What is known of the node at one level of the path.  The values
+  // are filled in on demand, the flags telling which ones are valid.
+  struct Level {
+    enum Valid
+    { TRANSFORM = 1, DEF_TRANSFORM = 2, ABS_TRANSFORM = 4, DEF_ABS_TRANSFORM = 8
+      , NAME = 16, ABS_NAME = 32, ID = 64, VALID_ALL = 127 };
+
+    Level();
+
+    // The child volume index of the node in its parent.
+    unsigned int                 index;
+    mutable unsigned int         valid;
+    mutable GeoTrf::Transform3D  transform;
+    mutable GeoTrf::Transform3D  defTransform;
+    mutable GeoTrf::Transform3D  absTransform;
+    mutable GeoTrf::Transform3D  defAbsTransform;
+    mutable std::string          name;
+    mutable std::string          absName;
+    mutable Query<int>           id;
+  };
+
+  // The level of the current node.
+  Level & current ();
+  const Level & current () const;
+
+  // Fill in the values of the level, and of those above it.
+  const GeoTrf::Transform3D & transformAt (unsigned int level) const;
+  const GeoTrf::Transform3D & defTransformAt (unsigned int level) const;
+  const GeoTrf::Transform3D & absTransformAt (unsigned int level) const;
+  const GeoTrf::Transform3D & defAbsTransformAt (unsigned int level) const;
+  const std::string & nameAt (unsigned int level) const;
+  const std::string & absNameAt (unsigned int level) const;
+
+  // The values which are not needed, and therefore always valid.
+  unsigned int notNeeded () const;
+
+  // One entry for each level down to the deepest reached, the first one
+  // being the volume where the action started.  Entries are never removed.
+  std::vector<Level> m_levels;
+
+  // The index of the child volumes of each volume of the path, rebuilt
+  // in place when the path goes through another volume at that depth.
+  std::vector<std::unique_ptr<GeoChildVolumeIndex> > m_childVolumes;
+
+  // The parts of the state used by the action.
+  unsigned int m_needs;
+
   //	The path from the point at which the action started, to
   //	the current node.
   GeoNodePath m_path;
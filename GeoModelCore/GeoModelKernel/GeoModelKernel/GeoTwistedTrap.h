@@ -97,6 +97,10 @@ class GeoTwistedTrap : public GeoShape
  protected:
   virtual ~GeoTwistedTrap();
 
+  //	Computes the bounding box.
+  virtual void computeExtent (double &xmin, double &ymin, double &zmin
+			      , double &xmax, double &ymax, double &zmax) const;
+
  private:
   GeoTwistedTrap(const GeoTwistedTrap &right);
   GeoTwistedTrap & operator=(const GeoTwistedTrap &right);
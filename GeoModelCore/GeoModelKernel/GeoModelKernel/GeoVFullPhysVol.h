@@ -38,17 +38,26 @@ class GeoVFullPhysVol : public GeoVPhysVol
   const GeoTrf::Transform3D& getCachedDefAbsoluteTransform(const GeoVAlignmentStore* store=nullptr) const;
 
   /// Clears the position information.  This can be used if
-  /// the cache is determined to be invalid.  The usual client
-  /// is one of the parents, upon changing its own position.
-  /// There is little need for casual users to call this.
+  /// the cache is determined to be invalid.  Alignment changes
+  /// no longer need it, they invalidate the cache lazily (see
+  /// GeoAlignableTransform).  There is little need for casual
+  /// users to call this.
   void clearPositionInfo() const;
 
+  /// Sets the cached absolute and default absolute transforms in one go.
+  /// Used by GeoComputeAbsPosAction, which computes them for a whole tree.
+  void setPositionInfo(const GeoTrf::Transform3D& absXf, const GeoTrf::Transform3D& defAbsXf) const;
+
   /// Returns the absolute name of this node.
   const std::string& getAbsoluteName() const;
 
   /// Returns the identification bits.
   unsigned int getId() const;
 
+  /// Returns the bytes of the cached absolute transforms, absolute name
+  /// and identifier, 0 if none of them was computed.
+  size_t getPositionInfoBytes() const;
+
  protected:
   virtual ~GeoVFullPhysVol() override;
 
@@ -58,6 +67,10 @@ class GeoVFullPhysVol : public GeoVPhysVol
   mutable std::mutex m_mutex;
 
  private:
+  /// Checks the cached absolute transform against the alignment epochs of the
+  /// ancestors. Must be called with the mutex held.
+  bool isAbsPositionCurrent() const;
+
   /// The absolute name of this volume.
   mutable std::string m_absName;
 
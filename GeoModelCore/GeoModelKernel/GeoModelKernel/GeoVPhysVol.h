@@ -18,12 +18,15 @@ typedef const GeoVPhysVol *PVConstLink;
 #include "GeoModelKernel/GeoDefinitions.h"
 #include "GeoModelKernel/Query.h"
 #include <string>
+#include <vector>
 
 #include "GeoModelKernel/GeoLogVol.h"
 #include "GeoModelKernel/GeoGraphNode.h"
+#include <atomic>
 
 class GeoVolumeAction;
 class GeoVAlignmentStore;
+class GeoChildVolumeIndex;
 
 class GeoVPhysVol : public GeoGraphNode
 {
@@ -48,6 +51,10 @@ class GeoVPhysVol : public GeoGraphNode
   /// Returns the logical volume.
   const GeoLogVol* getLogVol() const;
 
+  /// Replaces the logical volume, for tools which rewrite a tree, such as
+  /// GeoInternAction.  Not to be used while the tree is being accessed.
+  void setLogVol(const GeoLogVol* logVol);
+
   /// Returns the number of child physical volumes.
   virtual unsigned int getNChildVols() const = 0;
 
@@ -89,9 +96,41 @@ class GeoVPhysVol : public GeoGraphNode
   /// Adds a Graph Node to the Geometry Graph
   virtual void add(GeoGraphNode* graphNode) = 0;
 
+  /// Replaces the daughter nodes, for tools which rewrite a tree, such as
+  /// GeoSubtreeInstancer.  The nodes which were not daughters already are
+  /// docked to the volume.  Not to be used while the tree is being accessed.
+  /// The default throws std::runtime_error, for classes which do not allow it.
+  virtual void setChildNodes(const std::vector<GeoGraphNode*>& nodes);
+
+  /// Returns the bytes of the index of the child volumes kept for the
+  /// indexed queries, 0 if it is not built.
+  size_t getChildVolumeIndexBytes() const;
+
+  /// Returns the alignment epoch at which one of the transforms placing the
+  /// daughters of this volume was last changed, 0 if never.  Absolute positions
+  /// of descendants cached at that epoch or earlier are stale.
+  unsigned long long getAlignmentEpoch() const;
+
+  /// Stamps the volume with the epoch of an alignment change.  Called by
+  /// GeoAlignableTransform::setDelta().
+  void setAlignmentEpoch(unsigned long long epoch) const;
+
  protected:
   virtual ~GeoVPhysVol();
 
+  /// Returns the index of the child volumes used by the indexed queries,
+  /// building it on first use and after the daughters change.  Concurrent
+  /// readers may call this safely; the index is published atomically and
+  /// stays valid for as long as the volume lives.  Tools walking many
+  /// volumes build GeoChildVolumeIndex objects of their own instead.
+  const GeoChildVolumeIndex& getChildVolumeIndex() const;
+
+  /// Marks the index of the child volumes for rebuilding on the next
+  /// query.  Must be called whenever the list of daughter nodes changes.
+  /// The index is not deleted, as readers may still hold it: it is kept,
+  /// with the other retired ones, until the volume is deleted.
+  void clearChildVolumeIndex();
+
  private:
   /// If one parent           ...pointer=PARENT;
   /// If no parent            ...pointer=nullptr.
@@ -99,6 +138,11 @@ class GeoVPhysVol : public GeoGraphNode
   const GeoVPhysVol* m_parentPtr;
   
   const GeoLogVol *m_logVol;
+
+  /// Lazily built index of the child volumes.
+  mutable std::atomic<GeoChildVolumeIndex*> m_childVolIndex;
+  /// The alignment epoch of the last change to a daughter transform.
+  mutable std::atomic<unsigned long long> m_alignEpoch;
 };
 
 inline bool GeoVPhysVol::isShared () const
@@ -106,4 +150,14 @@ inline bool GeoVPhysVol::isShared () const
   return m_parentPtr == this;
 }
 
+inline unsigned long long GeoVPhysVol::getAlignmentEpoch() const
+{
+  return m_alignEpoch.load(std::memory_order_acquire);
+}
+
+inline void GeoVPhysVol::setAlignmentEpoch(unsigned long long epoch) const
+{
+  m_alignEpoch.store(epoch,std::memory_order_release);
+}
+
 #endif
@@ -25,7 +25,10 @@ class GeoVolumeAction
   { TOP_DOWN, BOTTOM_UP };
 
  public:
-  GeoVolumeAction (Type type = TOP_DOWN);
+  //	The needs are the parts of the traversal state used by the
+  //	action (see GeoTraversalState::Needs); the others are
+  //	not computed.
+  GeoVolumeAction (Type type = TOP_DOWN, unsigned int needs = GeoTraversalState::ALL);
   virtual ~GeoVolumeAction();
 
   //	Callback method. Overriden by users.
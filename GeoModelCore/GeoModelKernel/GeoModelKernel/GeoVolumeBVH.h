@@ -0,0 +1,156 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEOVOLUMEBVH_H
+#define GEOMODELKERNEL_GEOVOLUMEBVH_H
+
+/**
+ * @class GeoVolumeBVH
+ *
+ * @brief Bounding volume hierarchies over the placed volumes of a tree,
+ * for point location and ray queries without Geant4.
+ *
+ * Every physical volume with daughters gets one hierarchy of the
+ * bounding boxes of its daughters, in its own frame.  A volume placed
+ * many times, or shared by several mothers, is indexed once, so the
+ * memory grows with the number of distinct volumes rather than with
+ * the number of placements.  The boxes come from GeoShape::extent(),
+ * so every shape in the tree must provide it; locate() also needs
+ * GeoShape::inside(), and getSegments() GeoShape::getRayIntervals().
+ *
+ * Positions are taken from the alignment store given at construction
+ * (the default positions if none).  The hierarchies are not updated when
+ * the graph or the alignment changes.  Once built, the object may be
+ * queried from any number of threads.
+ */
+
+#include "GeoModelKernel/GeoNodePath.h"
+#include "GeoModelKernel/GeoDefinitions.h"
+#include <cmath>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class GeoVAlignmentStore;
+
+class GeoVolumeBVH
+{
+ public:
+  /// A volume crossed by a ray.
+  struct Crossing {
+    /// The volumes from the top down to the crossed one.
+    std::vector<const GeoVPhysVol*> volumes;
+    /// The position of each volume among the child volumes of its mother.
+    std::vector<unsigned int> childIndices;
+    /// The ray parameters where the ray enters and leaves the volume's box.
+    double tIn;
+    double tOut;
+  };
+
+  /// A piece of a ray inside a volume and outside all of its daughters.
+  struct Segment {
+    const GeoVPhysVol* volume;
+    double tIn;
+    double tOut;
+  };
+
+  /// Indexes the tree below top.
+  GeoVolumeBVH(PVConstLink top, const GeoVAlignmentStore* store=nullptr);
+  ~GeoVolumeBVH();
+
+  GeoVolumeBVH(const GeoVolumeBVH &right) = delete;
+  GeoVolumeBVH & operator=(const GeoVolumeBVH &right) = delete;
+
+  /// Finds the deepest volume containing a point, given in the frame of the
+  /// top volume.  Fills the path with the volumes from the top down to it and,
+  /// optionally, the position of each of them in its mother and the transform
+  /// from the frame of the deepest volume to the top frame.  Returns false,
+  /// leaving the path empty, if the point is outside the top volume.
+  bool locate(const GeoTrf::Vector3D& point
+	      ,GeoNodePath& path
+	      ,std::vector<unsigned int>* childIndices=nullptr
+	      ,GeoTrf::Transform3D* absXf=nullptr) const;
+
+  /// Collects the daughter volumes, at any depth below the top, whose boxes are
+  /// crossed by the ray origin+t*direction for 0<=t<=tMax.  Crossings are
+  /// appended in depth-first order.
+  void intersect(const GeoTrf::Vector3D& origin
+		 ,const GeoTrf::Vector3D& direction
+		 ,std::vector<Crossing>& crossings
+		 ,double tMax=HUGE_VAL) const;
+
+  /// Follows the ray origin+t*direction, for 0<=t<=tMax, through the tree.
+  /// Fills the pieces of the ray inside the top volume, each one in the
+  /// deepest volume containing it, in the order of t.  Daughters are assumed
+  /// not to overlap.
+  void getSegments(const GeoTrf::Vector3D& origin
+		   ,const GeoTrf::Vector3D& direction
+		   ,std::vector<Segment>& segments
+		   ,double tMax=HUGE_VAL) const;
+
+  /// Returns the number of hierarchies, one per distinct volume with daughters.
+  unsigned int getNHierarchies() const;
+
+ private:
+  struct Mother;
+
+  /// A daughter placed in a mother.
+  struct Daughter {
+    GeoTrf::Transform3D xf;
+    GeoTrf::Transform3D invXf;
+    /// The box of the daughter in the frame of the mother.
+    double              lo[3];
+    double              hi[3];
+    const GeoVPhysVol*  volume;
+    /// The hierarchy of the daughter's own daughters, nullptr if none.
+    const Mother*       mother;
+    unsigned int        childIndex;
+  };
+
+  /// A node of the hierarchy. Leaves hold count>0 daughters starting at first.
+  /// The children of an inner node are the next node and the node at first.
+  struct Node {
+    double       lo[3];
+    double       hi[3];
+    unsigned int first;
+    unsigned int count;
+  };
+
+  /// The hierarchy over the daughters of one volume.
+  struct Mother {
+    std::vector<Daughter> daughters;
+    std::vector<Node>     nodes;
+  };
+
+  /// Builds the hierarchy of one volume, queueing those of its daughters.
+  void build(const GeoVPhysVol* vol, Mother& mother, std::vector<const GeoVPhysVol*>& pending);
+
+  void intersect(const Mother& mother
+		 ,const GeoTrf::Vector3D& origin
+		 ,const GeoTrf::Vector3D& direction
+		 ,double tMax
+		 ,Crossing& prefix
+		 ,std::vector<Crossing>& crossings) const;
+
+  /// Splits the piece [tIn,tOut] of the ray inside vol among its daughters.
+  void getSegments(const GeoVPhysVol* vol
+		   ,const Mother* mother
+		   ,const GeoTrf::Vector3D& origin
+		   ,const GeoTrf::Vector3D& direction
+		   ,double tIn
+		   ,double tOut
+		   ,std::vector<Segment>& segments) const;
+
+  const GeoVPhysVol*        m_top;
+  const GeoVAlignmentStore* m_store;
+  const Mother*             m_topMother;
+  std::unordered_map<const GeoVPhysVol*,std::unique_ptr<Mother>> m_mothers;
+};
+
+inline unsigned int GeoVolumeBVH::getNHierarchies() const
+{
+  return m_mothers.size();
+}
+
+#endif
@@ -0,0 +1,83 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEOXFCOMPILED_H
+#define GEOMODELKERNEL_GEOXFCOMPILED_H
+
+/**
+ * @class GeoXF::CompiledFunction
+ *
+ * @brief A closed form of a transform function, for the common functions
+ * made of one GeoXF::Pow whose exponent is linear in the argument:
+ *
+ *     x -> A * Pow(T, a*x+b) * B
+ *
+ * with constant transforms A and B taken from PreMult, PostMult and Product
+ * factors which do not depend on x.  "Rotate by k*dphi about z" and
+ * "translate by k*d along an axis" are of this form.  The transform at x is
+ * then computed directly from the rotation angle and translation of T,
+ * without going through the function tree, its generic functions and the
+ * decomposition of T.
+ *
+ * Functions of any other form cannot be compiled (isValid() returns false);
+ * the caller then evaluates the function itself.
+ */
+
+#include "GeoModelKernel/GeoXF.h"
+
+namespace GeoXF
+{
+  class CompiledFunction
+  {
+  public:
+    /// The forms of the compiled function, with the simplest evaluation.
+    enum Kind { NONE, CONSTANT, TRANSLATION, ROTATION };
+
+    /// Analyses the function.
+    CompiledFunction(const Function& function);
+
+    /// True if the function could be compiled.
+    bool isValid() const;
+    Kind getKind() const;
+
+    /// The value of the function at x.  The function must be valid.
+    GeoTrf::Transform3D operator()(double x) const;
+
+  private:
+    // The function, as it is analysed: A * Pow(T, a*x+b) * B, or the
+    // constant A when there is no Pow.
+    struct Form;
+    static bool analyse(const Function& function, Form& form);
+
+    Kind                 m_kind;
+    // Whether A and B are identities, sparing two matrix products.
+    bool                 m_bare;
+    // The exponent, a*x+b.
+    double               m_a;
+    double               m_b;
+    // The value, for CONSTANT.  For TRANSLATION, the value at exponent 0,
+    // the translation growing by m_step for each unit of the exponent.
+    GeoTrf::Transform3D  m_constant;
+    GeoTrf::Vector3D     m_step;
+    // For ROTATION: the angle and axis of the rotation of T, its
+    // translation, and A and B.
+    double               m_angle;
+    GeoTrf::Vector3D     m_axis;
+    GeoTrf::Vector3D     m_translation;
+    GeoTrf::Transform3D  m_pre;
+    GeoTrf::Transform3D  m_post;
+  };
+
+  inline bool CompiledFunction::isValid() const
+  {
+    return m_kind != NONE;
+  }
+
+  inline CompiledFunction::Kind CompiledFunction::getKind() const
+  {
+    return m_kind;
+  }
+}
+
+#endif
@@ -14,12 +14,18 @@
  *	and decrease the reference count of an object.  When
  *	the reference count decreases to zero, the object deletes
  *	itself
+ *
+ *	Objects created while a GeoArena::Scope is open take their
+ *	memory from the arena, and may use non-atomic reference
+ *	counts (see GeoArena).
  */
 
 #ifndef GEOMODELKERNEL_RCBASE_H
 #define GEOMODELKERNEL_RCBASE_H
 
 #include <atomic>
+#include <cstddef>
+#include <new>
 
 class RCBase 
 {
@@ -36,6 +42,12 @@ class RCBase
   //	Return the reference count.
   unsigned int refCount () const;
 
+  //	Allocation from the arena in scope, if any, else from the heap.
+  static void* operator new (size_t size);
+  static void* operator new (size_t size, std::align_val_t alignment);
+  static void operator delete (void* p);
+  static void operator delete (void* p, std::align_val_t alignment);
+
  protected:
   virtual ~RCBase();
 
@@ -43,9 +55,15 @@ class RCBase
   RCBase(const RCBase &right);
   RCBase & operator=(const RCBase &right);
 
+  //	True if the reference count is to be updated atomically
+  bool isAtomic () const;
+
   //	The reference count
   mutable std::atomic<unsigned> m_count;
 
+  //	The slot of the GeoArena holding the object, 0 if on the heap
+  const unsigned int m_arena;
+
 };
 
 #endif
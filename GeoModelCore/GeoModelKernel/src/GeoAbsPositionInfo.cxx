@@ -8,7 +8,8 @@
 
 GeoAbsPositionInfo::GeoAbsPositionInfo()
   : m_absTransform(nullptr),
-    m_defAbsTransform(nullptr)
+    m_defAbsTransform(nullptr),
+    m_epoch(0)
 {
 }
 
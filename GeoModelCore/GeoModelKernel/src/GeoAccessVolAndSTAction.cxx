@@ -53,8 +53,8 @@ void GeoAccessVolAndSTAction::handlePhysVol(const GeoPhysVol *vol)
     }
     else {
       for(unsigned int t=0; t<m_pendingTransformList.size(); t++) {
-	m_transform = m_transform * m_pendingTransformList[t]->getTransform(nullptr);
-	m_defTransform = m_defTransform * m_pendingTransformList[t]->getDefTransform(nullptr);
+	m_pendingTransformList[t]->accumulateTransform(m_transform);
+	m_pendingTransformList[t]->accumulateDefTransform(m_defTransform);
       }
     }
     terminate ();
@@ -91,8 +91,8 @@ void GeoAccessVolAndSTAction::handleFullPhysVol(const GeoFullPhysVol *vol)
     }
     else {
       for(unsigned int t = 0; t < m_pendingTransformList.size (); t++) {
-	m_transform = m_transform * m_pendingTransformList[t]->getTransform(nullptr);
-	m_defTransform = m_defTransform * m_pendingTransformList[t]->getDefTransform(nullptr);
+	m_pendingTransformList[t]->accumulateTransform(m_transform);
+	m_pendingTransformList[t]->accumulateDefTransform(m_defTransform);
       }
     }
     terminate();
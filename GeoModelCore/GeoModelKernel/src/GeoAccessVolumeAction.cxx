@@ -57,8 +57,8 @@ void GeoAccessVolumeAction::handlePhysVol (const GeoPhysVol *vol)
     }
     else {
       for(unsigned int t = 0; t < m_pendingTransformList.size (); t++) {
-	m_transform = m_transform * m_pendingTransformList[t]->getTransform(m_alignStore);
-	m_defTransform = m_defTransform * m_pendingTransformList[t]->getDefTransform(m_alignStore);
+	m_pendingTransformList[t]->accumulateTransform(m_transform,m_alignStore);
+	m_pendingTransformList[t]->accumulateDefTransform(m_defTransform);
       }
     }
     terminate();
@@ -97,8 +97,8 @@ void GeoAccessVolumeAction::handleFullPhysVol (const GeoFullPhysVol *vol)
     }
     else {
       for(unsigned int t = 0; t < m_pendingTransformList.size (); t++) {
-	m_transform = m_transform * m_pendingTransformList[t]->getTransform(m_alignStore);
-	m_defTransform = m_defTransform * m_pendingTransformList[t]->getDefTransform(m_alignStore);
+	m_pendingTransformList[t]->accumulateTransform(m_transform,m_alignStore);
+	m_pendingTransformList[t]->accumulateDefTransform(m_defTransform);
       }
     }
     terminate();
@@ -168,8 +168,8 @@ void GeoAccessVolumeAction::handleSerialTransformer (const GeoSerialTransformer
     unsigned int copy = m_index - m_counter;
     m_volume = sT->getVolume();
     for(unsigned int t = 0; t < m_pendingTransformList.size (); t++) {
-      m_transform = m_transform * m_pendingTransformList[t]->getTransform(m_alignStore);
-      m_defTransform = m_defTransform * m_pendingTransformList[t]->getDefTransform(m_alignStore);
+      m_pendingTransformList[t]->accumulateTransform(m_transform,m_alignStore);
+      m_pendingTransformList[t]->accumulateDefTransform(m_defTransform);
     }
     m_transform    = m_transform    * sT->getTransform (copy);
     m_defTransform = m_defTransform * sT->getTransform (copy);
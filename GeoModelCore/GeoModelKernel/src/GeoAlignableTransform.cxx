@@ -3,10 +3,13 @@
 */
 
 #include "GeoModelKernel/GeoAlignableTransform.h"
-#include "GeoModelKernel/GeoClearAbsPosAction.h"
 #include "GeoModelKernel/GeoVAlignmentStore.h"
-#include "GeoSelClearAbsPosAction.h"
-#include <set>
+#include "GeoModelKernel/GeoVPhysVol.h"
+#include <stdexcept>
+
+std::atomic<unsigned long long> GeoAlignableTransform::s_epoch{1};
+std::atomic<unsigned long long> GeoAlignableTransform::s_lastChangeEpoch{0};
+std::atomic<unsigned int>       GeoAlignableTransform::s_batchDepth{0};
 
 GeoAlignableTransform::GeoAlignableTransform (const GeoTrf::Transform3D& transform)
   : GeoTransform(transform)
@@ -39,6 +42,22 @@ GeoTrf::Transform3D GeoAlignableTransform::getTransform(const GeoVAlignmentStore
   }
 }
 
+#if defined(FLATTEN) && defined(__GNUC__)
+__attribute__ ((flatten))
+#endif
+void GeoAlignableTransform::accumulateTransform(GeoTrf::Transform3D& x, const GeoVAlignmentStore* store) const
+{
+  accumulateDefTransform(x);
+  if(store) {
+    const GeoTrf::Transform3D* delta = store->getDelta(this);
+    if(delta) x = x * (*delta);
+  }
+  else {
+    std::scoped_lock<std::mutex> guard(m_deltaMutex);
+    if(m_delta) x = x * (*m_delta);
+  }
+}
+
 void GeoAlignableTransform::setDelta (const GeoTrf::Transform3D& delta, GeoVAlignmentStore* store)
 {
   if(store==nullptr) {
@@ -54,14 +73,7 @@ void GeoAlignableTransform::setDelta (const GeoTrf::Transform3D& delta, GeoVAlig
       }
     }
 
-    std::set<GeoGraphNode*> uniqueParents;
-    for(GeoGraphNode* parent : m_parentList) {
-      if(uniqueParents.find(parent)==uniqueParents.end()) {
-	GeoSelClearAbsPosAction cc(this);
-	parent->exec(&cc);
-	uniqueParents.insert(parent);
-      }
-    }
+    markParents();
   } // if(store==nullptr)
   else {
     store->setDelta(this,delta);
@@ -77,18 +89,44 @@ void GeoAlignableTransform::clearDelta(GeoVAlignmentStore* store)
     delete m_delta;
     m_delta = nullptr;
   }
-  
-  std::set<GeoGraphNode*> uniqueParents;
-  for(GeoGraphNode* parent : m_parentList) {
-    if(uniqueParents.find(parent)==uniqueParents.end()) {
-      GeoSelClearAbsPosAction cc(this);
-      parent->exec (&cc);
-      uniqueParents.insert(parent);
-    }
-  }
+
+  markParents();
 }
 
 void GeoAlignableTransform::dockTo(GeoVPhysVol* parent)
 {
   m_parentList.push_back (parent);
 }
+
+void GeoAlignableTransform::markParents() const
+{
+  // Cached positions stamped with this epoch or earlier are now stale
+  unsigned long long epoch = s_epoch.load();
+  for(GeoVPhysVol* parent : m_parentList) parent->setAlignmentEpoch(epoch);
+
+  unsigned long long last = s_lastChangeEpoch.load();
+  while(last < epoch && !s_lastChangeEpoch.compare_exchange_weak(last,epoch)) {}
+
+  if(s_batchDepth.load()==0) s_epoch++;
+}
+
+unsigned long long GeoAlignableTransform::getCurrentEpoch()
+{
+  return s_epoch.load();
+}
+
+unsigned long long GeoAlignableTransform::getLastChangeEpoch()
+{
+  return s_lastChangeEpoch.load();
+}
+
+void GeoAlignableTransform::beginBatchUpdate()
+{
+  s_batchDepth++;
+}
+
+void GeoAlignableTransform::commitBatchUpdate()
+{
+  if(s_batchDepth.load()==0) throw std::runtime_error("GeoAlignableTransform::commitBatchUpdate() called without beginBatchUpdate()");
+  if(--s_batchDepth==0) s_epoch++;
+}
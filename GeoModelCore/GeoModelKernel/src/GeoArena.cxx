@@ -0,0 +1,175 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoModelKernel/GeoArena.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+
+namespace {
+  // Up to 2^28 arenas at a time, in chunks of GeoArena::SLOTS_PER_CHUNK
+  constexpr unsigned int N_CHUNKS = 1 << 16;
+
+  std::mutex                s_slotMutex;
+  std::vector<unsigned int> s_freeSlots;
+  unsigned int              s_nextSlot = 1;
+
+  thread_local GeoArena::Scope* t_scope = nullptr;
+
+  char* alignUp(char* p, size_t alignment)
+  {
+    uintptr_t a = reinterpret_cast<uintptr_t>(p);
+    return p + ((alignment - a % alignment) % alignment);
+  }
+}
+
+std::atomic<std::atomic<GeoArena*>*> GeoArena::s_chunks[N_CHUNKS];
+
+GeoArena::GeoArena(size_t blockSize)
+  : m_blockSize(blockSize)
+  , m_atomic(true)
+  , m_refs(1)
+  , m_nObjects(0)
+  , m_bytes(0)
+{
+  std::scoped_lock<std::mutex> lk(s_slotMutex);
+  if (!s_freeSlots.empty()) {
+    m_slot = s_freeSlots.back();
+    s_freeSlots.pop_back();
+  }
+  else if (s_nextSlot < N_CHUNKS*SLOTS_PER_CHUNK) {
+    m_slot = s_nextSlot++;
+    std::atomic<std::atomic<GeoArena*>*>& chunk = s_chunks[m_slot / SLOTS_PER_CHUNK];
+    if (!chunk.load(std::memory_order_relaxed)) {
+      // Never freed: objects may look up their slot at any time
+      chunk.store(new std::atomic<GeoArena*>[SLOTS_PER_CHUNK](),std::memory_order_release);
+    }
+  }
+  else {
+    throw std::runtime_error("GeoArena: too many arenas");
+  }
+  slotAt(m_slot) = this;
+}
+
+GeoArena::~GeoArena()
+{
+  for (const auto& block : m_blocks) ::operator delete(block.first);
+  std::scoped_lock<std::mutex> lk(s_slotMutex);
+  slotAt(m_slot) = nullptr;
+  s_freeSlots.push_back(m_slot);
+}
+
+void GeoArena::release()
+{
+  unref();
+}
+
+void GeoArena::unref()
+{
+  if (m_refs.fetch_sub(1,std::memory_order_acq_rel) == 1) delete this;
+}
+
+size_t GeoArena::getNBlocks() const
+{
+  std::scoped_lock<std::mutex> lk(m_mutex);
+  return m_blocks.size();
+}
+
+void GeoArena::newBlock(Scope* scope, size_t size)
+{
+  size_t blockSize = std::max(m_blockSize,size);
+  char* block = static_cast<char*>(::operator new(blockSize));
+  {
+    std::scoped_lock<std::mutex> lk(m_mutex);
+    auto position = std::upper_bound(m_blocks.begin(),m_blocks.end(),std::make_pair(block,blockSize));
+    m_blocks.emplace(position,block,blockSize);
+  }
+  scope->m_begin = scope->m_cursor = block;
+  scope->m_end = block + blockSize;
+}
+
+bool GeoArena::owns(const void* p) const
+{
+  const char* c = static_cast<const char*>(p);
+  std::scoped_lock<std::mutex> lk(m_mutex);
+  // The last block starting at or before p
+  auto after = std::upper_bound(m_blocks.begin(),m_blocks.end(),c
+				,[](const char* c, const std::pair<char*,size_t>& block) { return c < block.first; });
+  if (after == m_blocks.begin()) return false;
+  const auto& block = *(after - 1);
+  return c < block.first + block.second;
+}
+
+GeoArena::Scope::Scope(GeoArena* arena)
+  : m_arena(arena)
+  , m_previous(t_scope)
+  , m_begin(nullptr)
+  , m_cursor(nullptr)
+  , m_end(nullptr)
+  , m_last(nullptr)
+  , m_nObjects(0)
+  , m_bytes(0)
+{
+  m_arena->m_refs++;
+  t_scope = this;
+}
+
+GeoArena::Scope::~Scope()
+{
+  t_scope = m_previous;
+  m_arena->m_nObjects += m_nObjects;
+  m_arena->m_bytes += m_bytes;
+  m_arena->unref();
+}
+
+void* GeoArena::allocate(size_t size, size_t alignment)
+{
+  Scope* scope = t_scope;
+  if (!scope) return nullptr;
+  alignment = std::max(alignment,alignof(std::max_align_t));
+  char* p = scope->m_cursor ? alignUp(scope->m_cursor,alignment) : nullptr;
+  if (!p || p + size > scope->m_end) {
+    scope->m_arena->newBlock(scope,size + alignment);
+    p = alignUp(scope->m_cursor,alignment);
+  }
+  scope->m_last = p;
+  scope->m_cursor = p + size;
+  scope->m_nObjects++;
+  scope->m_bytes += size;
+  scope->m_arena->m_refs.fetch_add(1,std::memory_order_relaxed);
+  return p;
+}
+
+unsigned int GeoArena::slotOf(const void* object)
+{
+  Scope* scope = t_scope;
+  if (!scope) return 0;
+  // Usually the object is the last thing allocated in one of the scopes
+  const char* c = static_cast<const char*>(object);
+  for (Scope* s = scope; s; s = s->m_previous) {
+    if (c >= s->m_last && c < s->m_cursor) return s->m_arena->m_slot;
+  }
+  for (; scope; scope = scope->m_previous) {
+    if (scope->m_arena->owns(object)) return scope->m_arena->m_slot;
+  }
+  return 0;
+}
+
+void GeoArena::deallocate(unsigned int slot)
+{
+  slotAt(slot).load(std::memory_order_relaxed)->unref();
+}
+
+bool GeoArena::isInScope(const void* p)
+{
+  for (Scope* scope = t_scope; scope; scope = scope->m_previous) {
+    if (scope->m_arena->owns(p)) {
+      // The object never existed, but was counted
+      scope->m_arena->unref();
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,296 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoModelKernel/GeoBooleanVolume.h"
+#include "GeoModelKernel/GeoShapeUnion.h"
+#include "GeoModelKernel/GeoShapeSubtraction.h"
+#include "GeoModelKernel/GeoShapeIntersection.h"
+#include "GeoModelKernel/GeoShapeShift.h"
+#include "GeoModelKernel/GeoBox.h"
+#include "GeoModelKernel/GeoTrd.h"
+#include "GeoModelKernel/GeoTrap.h"
+#include "GeoModelKernel/GeoPara.h"
+#include "GeoModelKernel/GeoTube.h"
+#include "GeoModelKernel/GeoTubs.h"
+#include "GeoModelKernel/GeoCons.h"
+#include "GeoModelKernel/GeoEllipticalTube.h"
+#include "GeoShapeUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+  // Points sampled from one seed, and blocks sampled between convergence checks
+  constexpr unsigned int BLOCK_SIZE       = 4096;
+  constexpr unsigned int BLOCKS_PER_ROUND = 64;
+
+  std::mutex               s_configMutex;
+  GeoBooleanVolume::Config s_defaultConfig;
+
+  struct Box {
+    double lo[3];
+    double hi[3];
+  };
+
+  Box getBox(const GeoShape* shape)
+  {
+    Box box;
+    shape->extent(box.lo[0],box.lo[1],box.lo[2],box.hi[0],box.hi[1],box.hi[2]);
+    return box;
+  }
+
+  bool disjoint(const Box& a, const Box& b)
+  {
+    for (int k = 0; k < 3; ++k) {
+      if (a.hi[k] <= b.lo[k] || b.hi[k] <= a.lo[k]) return true;
+    }
+    return false;
+  }
+
+  // True for shapes known to be convex, in which a box lies if its corners do
+  bool isConvex(const GeoShape* shape)
+  {
+    ShapeType type = shape->typeID();
+    if (type == GeoBox::getClassTypeID() || type == GeoTrd::getClassTypeID()
+	|| type == GeoTrap::getClassTypeID() || type == GeoPara::getClassTypeID()
+	|| type == GeoEllipticalTube::getClassTypeID()) return true;
+    if (type == GeoTube::getClassTypeID()) {
+      return static_cast<const GeoTube*>(shape)->getRMin() == 0;
+    }
+    if (type == GeoTubs::getClassTypeID()) {
+      const GeoTubs* tubs = static_cast<const GeoTubs*>(shape);
+      return tubs->getRMin() == 0 && (tubs->getDPhi() <= M_PI || GeoShapeUtils::isFullPhi(tubs->getDPhi()));
+    }
+    if (type == GeoCons::getClassTypeID()) {
+      const GeoCons* cons = static_cast<const GeoCons*>(shape);
+      return cons->getRMin1() == 0 && cons->getRMin2() == 0
+	&& (cons->getDPhi() <= M_PI || GeoShapeUtils::isFullPhi(cons->getDPhi()));
+    }
+    if (type == GeoShapeShift::getClassTypeID()) {
+      return isConvex(static_cast<const GeoShapeShift*>(shape)->getOp());
+    }
+    return false;
+  }
+
+  // True if the box is known to lie inside the shape
+  bool encloses(const GeoShape* shape, const Box& box)
+  {
+    if (!isConvex(shape)) return false;
+    for (int corner = 0; corner < 8; ++corner) {
+      GeoTrf::Vector3D p(corner & 1 ? box.hi[0] : box.lo[0]
+			 ,corner & 2 ? box.hi[1] : box.lo[1]
+			 ,corner & 4 ? box.hi[2] : box.lo[2]);
+      if (shape->inside(p) == GeoShape::OUTSIDE) return false;
+    }
+    return true;
+  }
+
+  uint64_t mix(uint64_t z)
+  {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  // Estimates the volume of the overlap of a and b, which lies in the box.
+  // The overlap adds to the volume base with the given sign, and the sampling
+  // stops once its error is small enough with respect to the total.
+  double sampleOverlap(const GeoShape* a, const GeoShape* b, const Box& box
+		       ,double base, double sign
+		       ,const GeoBooleanVolume::Config& config)
+  {
+    double boxVolume = 1;
+    for (int k = 0; k < 3; ++k) boxVolume *= box.hi[k] - box.lo[k];
+
+    // Sampling runs on the calling thread unless more threads are asked for
+    unsigned int nThreads = std::min(std::max(1u,config.nThreads),BLOCKS_PER_ROUND);
+
+    // The blocks of the current round, and the hits found in them
+    unsigned long firstBlock = 0;
+    std::atomic<unsigned int> next(BLOCKS_PER_ROUND);
+    std::atomic<unsigned long> roundHits(0);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto sampleBlocks = [&]() {
+      try {
+	std::vector<double> x(BLOCK_SIZE), y(BLOCK_SIZE), z(BLOCK_SIZE);
+	std::vector<GeoShape::Location> inA(BLOCK_SIZE), inB(BLOCK_SIZE);
+	for (unsigned int i = next++; i < BLOCKS_PER_ROUND; i = next++) {
+	  std::mt19937_64 engine(mix(config.seed*0x9E3779B97F4A7C15ULL + firstBlock + i));
+	  std::uniform_real_distribution<double> u(0,1);
+	  for (unsigned int j = 0; j < BLOCK_SIZE; ++j) {
+	    x[j] = box.lo[0] + (box.hi[0]-box.lo[0])*u(engine);
+	    y[j] = box.lo[1] + (box.hi[1]-box.lo[1])*u(engine);
+	    z[j] = box.lo[2] + (box.hi[2]-box.lo[2])*u(engine);
+	  }
+	  a->inside(BLOCK_SIZE,x.data(),y.data(),z.data(),inA.data());
+	  b->inside(BLOCK_SIZE,x.data(),y.data(),z.data(),inB.data());
+	  unsigned long blockHits = 0;
+	  for (unsigned int j = 0; j < BLOCK_SIZE; ++j) {
+	    blockHits += inA[j] != GeoShape::OUTSIDE && inB[j] != GeoShape::OUTSIDE;
+	  }
+	  roundHits += blockHits;
+	}
+      }
+      catch (...) {
+	std::scoped_lock<std::mutex> lk(errorMutex);
+	if (!error) error = std::current_exception();
+	next = BLOCKS_PER_ROUND;
+      }
+    };
+
+    // The helper threads live for the whole call and are woken up once per round
+    std::mutex roundMutex;
+    std::condition_variable roundStarted, roundDone;
+    unsigned long round = 0;
+    unsigned int busy = 0;
+    bool stop = false;
+
+    auto helper = [&]() {
+      unsigned long done = 0;
+      while (true) {
+	{
+	  std::unique_lock<std::mutex> lk(roundMutex);
+	  roundStarted.wait(lk,[&]{ return stop || round != done; });
+	  if (stop) return;
+	  done = round;
+	}
+	sampleBlocks();
+	std::scoped_lock<std::mutex> lk(roundMutex);
+	if (--busy == 0) roundDone.notify_one();
+      }
+    };
+
+    std::vector<std::thread> pool;
+    auto stopPool = [&]() {
+      {
+	std::scoped_lock<std::mutex> lk(roundMutex);
+	stop = true;
+      }
+      roundStarted.notify_all();
+      for (std::thread& thread : pool) thread.join();
+    };
+
+    unsigned long hits = 0, samples = 0;
+    try {
+      for (unsigned int t = 1; t < nThreads; ++t) pool.emplace_back(helper);
+      while (true) {
+	roundHits = 0;
+	next = 0;
+	if (!pool.empty()) {
+	  {
+	    std::scoped_lock<std::mutex> lk(roundMutex);
+	    busy = pool.size();
+	    ++round;
+	  }
+	  roundStarted.notify_all();
+	}
+	sampleBlocks();
+	if (!pool.empty()) {
+	  std::unique_lock<std::mutex> lk(roundMutex);
+	  roundDone.wait(lk,[&]{ return busy == 0; });
+	}
+	if (error) std::rethrow_exception(error);
+
+	hits += roundHits;
+	samples += BLOCK_SIZE*BLOCKS_PER_ROUND;
+	firstBlock += BLOCKS_PER_ROUND;
+
+	double fraction = double(hits)/samples;
+	double overlap = boxVolume*fraction;
+	double sigma = boxVolume*std::sqrt(fraction*(1-fraction)/samples);
+	if (samples >= config.maxSamples
+	    || (samples >= config.minSamples && sigma <= config.relativeError*std::fabs(base + sign*overlap))) {
+	  stopPool();
+	  return overlap;
+	}
+      }
+    }
+    catch (...) {
+      stopPool();
+      throw;
+    }
+  }
+
+  double volumeOf(const GeoShape* shape, const GeoBooleanVolume::Config& config, bool top, bool cached);
+
+  // The volume of an operand
+  double operandVolume(const GeoShape* shape, const GeoBooleanVolume::Config& config, bool cached)
+  {
+    return cached ? shape->volume() : volumeOf(shape,config,false,false);
+  }
+
+  // The volume of the overlap of two operands
+  double overlapVolume(const GeoShape* a, const GeoShape* b, double base, double sign
+		       ,const GeoBooleanVolume::Config& config, bool cached)
+  {
+    Box boxA = getBox(a), boxB = getBox(b);
+    if (disjoint(boxA,boxB)) return 0;
+    if (encloses(a,boxB)) return operandVolume(b,config,cached);
+    if (encloses(b,boxA)) return operandVolume(a,config,cached);
+    Box box;
+    for (int k = 0; k < 3; ++k) {
+      box.lo[k] = std::max(boxA.lo[k],boxB.lo[k]);
+      box.hi[k] = std::min(boxA.hi[k],boxB.hi[k]);
+    }
+    return sampleOverlap(a,b,box,base,sign,config);
+  }
+
+  double volumeOf(const GeoShape* shape, const GeoBooleanVolume::Config& config, bool top, bool cached)
+  {
+    ShapeType type = shape->typeID();
+    if (type == GeoShapeShift::getClassTypeID()) {
+      return volumeOf(static_cast<const GeoShapeShift*>(shape)->getOp(),config,false,cached);
+    }
+    // Below the top, cached volumes are used when allowed
+    if (cached && !top) return shape->volume();
+
+    if (type == GeoShapeUnion::getClassTypeID()) {
+      const GeoShapeUnion* u = static_cast<const GeoShapeUnion*>(shape);
+      double base = operandVolume(u->getOpA(),config,cached) + operandVolume(u->getOpB(),config,cached);
+      return base - overlapVolume(u->getOpA(),u->getOpB(),base,-1,config,cached);
+    }
+    if (type == GeoShapeSubtraction::getClassTypeID()) {
+      const GeoShapeSubtraction* s = static_cast<const GeoShapeSubtraction*>(shape);
+      double base = operandVolume(s->getOpA(),config,cached);
+      return std::max(0.0,base - overlapVolume(s->getOpA(),s->getOpB(),base,-1,config,cached));
+    }
+    if (type == GeoShapeIntersection::getClassTypeID()) {
+      const GeoShapeIntersection* i = static_cast<const GeoShapeIntersection*>(shape);
+      return overlapVolume(i->getOpA(),i->getOpB(),0,1,config,cached);
+    }
+    return shape->volume();
+  }
+}
+
+double GeoBooleanVolume::compute(const GeoShape* shape, const Config& config)
+{
+  return volumeOf(shape,config,true,false);
+}
+
+GeoBooleanVolume::Config GeoBooleanVolume::getDefaultConfig()
+{
+  std::scoped_lock<std::mutex> lk(s_configMutex);
+  return s_defaultConfig;
+}
+
+void GeoBooleanVolume::setDefaultConfig(const Config& config)
+{
+  std::scoped_lock<std::mutex> lk(s_configMutex);
+  s_defaultConfig = config;
+}
+
+double GeoBooleanVolume::computeFromOperands(const GeoShape* shape, const Config& config)
+{
+  return volumeOf(shape,config,true,true);
+}
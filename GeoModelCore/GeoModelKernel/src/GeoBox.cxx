@@ -4,6 +4,8 @@
 
 #include "GeoModelKernel/GeoBox.h"
 #include "GeoModelKernel/GeoShapeAction.h"
+#include "GeoShapeUtils.h"
+#include <cmath>
 
 const std::string GeoBox::s_classType = "Box";
 const ShapeType GeoBox::s_classTypeID = 0x10;
@@ -38,3 +40,48 @@ void GeoBox::exec (GeoShapeAction *action) const
 {
   action->handleBox(this);
 }
+
+GeoShape::Location GeoBox::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  return GeoShapeUtils::classify(distance(p), tolerance);
+}
+
+void GeoBox::inside (size_t n, const double *x, const double *y, const double *z
+		     , Location *result, double tolerance) const
+{
+  const double dx = m_xHalfLength, dy = m_yHalfLength, dz = m_zHalfLength;
+  for (size_t i = 0; i < n; ++i) {
+    double d = std::max(std::max(std::abs(x[i]) - dx, std::abs(y[i]) - dy), std::abs(z[i]) - dz);
+    result[i] = GeoShapeUtils::classify(d, tolerance);
+  }
+}
+
+void GeoBox::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+			      , RayIntervals &intervals) const
+{
+  RayIntervals slab;
+  GeoShapeUtils::slabIntervals(p.x(), v.x(), -m_xHalfLength, m_xHalfLength, intervals);
+  GeoShapeUtils::slabIntervals(p.y(), v.y(), -m_yHalfLength, m_yHalfLength, slab);
+  GeoShapeUtils::intersectIntervals(intervals, slab, intervals);
+  GeoShapeUtils::slabIntervals(p.z(), v.z(), -m_zHalfLength, m_zHalfLength, slab);
+  GeoShapeUtils::intersectIntervals(intervals, slab, intervals);
+}
+
+double GeoBox::safety (const GeoTrf::Vector3D &p) const
+{
+  return std::abs(distance(p));
+}
+
+double GeoBox::distance (const GeoTrf::Vector3D &p) const
+{
+  return std::max(std::max(std::abs(p.x()) - m_xHalfLength
+			   , std::abs(p.y()) - m_yHalfLength)
+		  , std::abs(p.z()) - m_zHalfLength);
+}
+
+void GeoBox::computeExtent (double &xmin, double &ymin, double &zmin
+			  , double &xmax, double &ymax, double &zmax) const
+{
+  xmin = -m_xHalfLength; ymin = -m_yHalfLength; zmin = -m_zHalfLength;
+  xmax =  m_xHalfLength; ymax =  m_yHalfLength; zmax =  m_zHalfLength;
+}
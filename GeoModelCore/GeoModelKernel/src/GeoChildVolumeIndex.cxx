@@ -0,0 +1,222 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoModelKernel/GeoChildVolumeIndex.h"
+#include "GeoModelKernel/GeoNodeAction.h"
+#include "GeoModelKernel/GeoTransform.h"
+#include "GeoModelKernel/GeoNameTag.h"
+#include "GeoModelKernel/GeoSerialDenominator.h"
+#include "GeoModelKernel/GeoSerialIdentifier.h"
+#include "GeoModelKernel/GeoIdentifierTag.h"
+#include "GeoModelKernel/GeoSerialTransformer.h"
+
+#include <algorithm>
+
+//
+// Visits the daughter nodes of one volume and fills the index.  The naming
+// and identification rules are the same as those of GeoAccessVolumeAction.
+//
+class GeoChildVolumeIndexBuilder final : public GeoNodeAction
+{
+ public:
+  GeoChildVolumeIndexBuilder(GeoChildVolumeIndex* index)
+    : m_index(index)
+  {
+    setDepthLimit(0);
+  }
+
+  virtual void handleTransform(const GeoTransform *xform) override
+  {
+    m_index->m_transforms.push_back(xform);
+  }
+
+  virtual void handlePhysVol(const GeoPhysVol *vol) override
+  {
+    addEntry(vol,nullptr,1);
+  }
+
+  virtual void handleFullPhysVol(const GeoFullPhysVol *vol) override
+  {
+    addEntry(vol,nullptr,1);
+  }
+
+  virtual void handleSerialTransformer(const GeoSerialTransformer *sT) override
+  {
+    addEntry(&*sT->getVolume(),sT,sT->getNCopies());
+  }
+
+  virtual void handleNameTag(const GeoNameTag *nameTag) override
+  {
+    m_nameTag = nameTag;
+    m_serialDenominator = nullptr;
+    m_serialDenomPosition = 0;
+  }
+
+  virtual void handleSerialDenominator(const GeoSerialDenominator *sD) override
+  {
+    m_serialDenominator = sD;
+    m_serialDenomPosition = m_index->m_nChildVols;
+  }
+
+  virtual void handleIdentifierTag(const GeoIdentifierTag *idTag) override
+  {
+    m_idTag = idTag;
+    m_serialIdentifier = nullptr;
+    m_serialIdentPosition = 0;
+  }
+
+  virtual void handleSerialIdentifier(const GeoSerialIdentifier *sI) override
+  {
+    m_serialIdentifier = sI;
+    m_serialIdentPosition = m_index->m_nChildVols;
+  }
+
+ private:
+  void addEntry(const GeoVPhysVol* vol, const GeoSerialTransformer* sT, unsigned int nCopies)
+  {
+    GeoChildVolumeIndex::Entry entry;
+    entry.volume = vol;
+    entry.serialTransformer = sT;
+    entry.nameTag = m_nameTag;
+    entry.serialDenominator = m_nameTag ? nullptr : m_serialDenominator;
+    entry.idTag = m_idTag;
+    entry.serialIdentifier = m_idTag ? nullptr : m_serialIdentifier;
+    entry.firstSlot = m_index->m_nChildVols;
+    entry.serialDenomPosition = m_serialDenomPosition;
+    entry.serialIdentPosition = m_serialIdentPosition;
+    entry.firstTransform = m_firstTransform;
+    entry.nTransforms = m_index->m_transforms.size() - m_firstTransform;
+    m_index->m_entries.push_back(entry);
+    m_index->m_nChildVols += nCopies;
+    if(nCopies!=1) m_index->m_oneSlotPerEntry = false;
+
+    // Once a volume has been placed, the pending transforms and tags are consumed.
+    m_firstTransform = m_index->m_transforms.size();
+    m_nameTag = nullptr;
+    m_idTag = nullptr;
+  }
+
+  GeoChildVolumeIndex* m_index;
+  unsigned int m_firstTransform{0};
+  const GeoNameTag* m_nameTag{nullptr};
+  const GeoSerialDenominator* m_serialDenominator{nullptr};
+  unsigned int m_serialDenomPosition{0};
+  const GeoIdentifierTag* m_idTag{nullptr};
+  const GeoSerialIdentifier* m_serialIdentifier{nullptr};
+  unsigned int m_serialIdentPosition{0};
+};
+
+GeoChildVolumeIndex::GeoChildVolumeIndex()
+  : m_nChildVols(0)
+  , m_oneSlotPerEntry(true)
+  , m_stale(false)
+  , m_retired(nullptr)
+{
+}
+
+GeoChildVolumeIndex::GeoChildVolumeIndex(const GeoVPhysVol* parent)
+  : GeoChildVolumeIndex()
+{
+  rebuild(parent);
+}
+
+GeoChildVolumeIndex::~GeoChildVolumeIndex()
+{
+  // Unlink the retired indices one by one rather than recursively
+  while(m_retired) {
+    GeoChildVolumeIndex* retired = m_retired;
+    m_retired = retired->m_retired;
+    retired->m_retired = nullptr;
+    delete retired;
+  }
+}
+
+size_t GeoChildVolumeIndex::getBytes() const
+{
+  size_t bytes = 0;
+  for(const GeoChildVolumeIndex* index = this; index; index = index->m_retired) {
+    bytes += sizeof(GeoChildVolumeIndex)
+      + index->m_entries.capacity()*sizeof(Entry)
+      + index->m_transforms.capacity()*sizeof(const GeoTransform*);
+  }
+  return bytes;
+}
+
+void GeoChildVolumeIndex::rebuild(const GeoVPhysVol* parent)
+{
+  m_entries.clear();
+  m_transforms.clear();
+  m_nChildVols = 0;
+  m_oneSlotPerEntry = true;
+
+  unsigned int nNodes = parent->getNChildNodes();
+  if(nNodes==0) return;
+
+  GeoChildVolumeIndexBuilder builder(this);
+  const GeoGraphNode * const * node = parent->getChildNode(0);
+  const GeoGraphNode * const * end  = node + nNodes;
+  for(; node!=end; ++node) {
+    (*node)->exec(&builder);
+  }
+}
+
+const GeoChildVolumeIndex::Entry* GeoChildVolumeIndex::findEntry(unsigned int index) const
+{
+  if(index >= m_nChildVols) return nullptr;
+  if(m_oneSlotPerEntry) return &m_entries[index];
+
+  // The last entry starting at or before the slot.  Serial transformers
+  // without copies start at the same slot as the next entry, and are skipped
+  auto entry = std::upper_bound(m_entries.begin(),m_entries.end(),index
+				,[](unsigned int i, const Entry& e) { return i < e.firstSlot; });
+  return &*(entry-1);
+}
+
+GeoTrf::Transform3D GeoChildVolumeIndex::getXToChildVol(unsigned int index, const GeoVAlignmentStore* store) const
+{
+  GeoTrf::Transform3D xform(GeoTrf::Transform3D::Identity());
+  const Entry* entry = findEntry(index);
+  if(!entry) return xform;
+
+  for(unsigned int t = entry->firstTransform; t < entry->firstTransform + entry->nTransforms; ++t) {
+    m_transforms[t]->accumulateTransform(xform,store);
+  }
+  if(entry->serialTransformer) xform = xform * entry->serialTransformer->getTransform(index - entry->firstSlot);
+  return xform;
+}
+
+GeoTrf::Transform3D GeoChildVolumeIndex::getDefXToChildVol(unsigned int index) const
+{
+  GeoTrf::Transform3D xform(GeoTrf::Transform3D::Identity());
+  const Entry* entry = findEntry(index);
+  if(!entry) return xform;
+
+  for(unsigned int t = entry->firstTransform; t < entry->firstTransform + entry->nTransforms; ++t) {
+    m_transforms[t]->accumulateDefTransform(xform);
+  }
+  if(entry->serialTransformer) xform = xform * entry->serialTransformer->getTransform(index - entry->firstSlot);
+  return xform;
+}
+
+std::string GeoChildVolumeIndex::getNameOfChildVol(unsigned int index) const
+{
+  const Entry* entry = findEntry(index);
+  if(!entry) return "ANON";
+  if(entry->nameTag) return entry->nameTag->getName();
+  if(entry->serialDenominator) {
+    return entry->serialDenominator->getBaseName() + std::to_string(index - entry->serialDenomPosition);
+  }
+  return "ANON";
+}
+
+Query<int> GeoChildVolumeIndex::getIdOfChildVol(unsigned int index) const
+{
+  const Entry* entry = findEntry(index);
+  if(!entry) return Query<int>();
+  if(entry->idTag) return Query<int>(entry->idTag->getIdentifier());
+  if(entry->serialIdentifier) {
+    return Query<int>(index - entry->serialIdentPosition + entry->serialIdentifier->getBaseId());
+  }
+  return Query<int>();
+}
@@ -0,0 +1,105 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoModelKernel/GeoCompiledGeometry.h"
+#include "GeoModelKernel/GeoChildVolumeIndex.h"
+#include "GeoModelKernel/GeoLogVol.h"
+#include <memory>
+#include <unordered_map>
+
+GeoCompiledGeometry::GeoCompiledGeometry(PVConstLink top
+					 ,bool expandSerialTransformers
+					 ,const GeoVAlignmentStore* store)
+  : m_top(&*top)
+{
+  m_top->ref();
+
+  std::unordered_map<const GeoLogVol*,unsigned int> logVolIndex;
+
+  auto addNode = [&](const GeoVPhysVol* vol
+		     ,unsigned int parent
+		     ,const GeoTrf::Transform3D& localXf
+		     ,const std::string& name
+		     ,const Query<int>& id
+		     ,const GeoSerialTransformer* sT) {
+    unsigned int node = m_parent.size();
+    auto lv = logVolIndex.emplace(vol->getLogVol(),m_logVols.size());
+    if(lv.second) m_logVols.push_back(vol->getLogVol());
+
+    m_parent.push_back(parent);
+    m_firstChild.push_back(NONE);
+    m_nextSibling.push_back(NONE);
+    m_subtreeEnd.push_back(node+1);
+    m_depth.push_back(parent==NONE ? 0 : m_depth[parent]+1);
+    m_volume.push_back(vol);
+    m_logVolIndex.push_back(lv.first->second);
+    m_localXf.push_back(localXf);
+    m_absXf.push_back(parent==NONE ? localXf : m_absXf[parent]*localXf);
+    m_names.append(name);
+    m_nameOffset.push_back(m_names.size());
+    m_id.push_back(id.isValid() ? int(id) : 0);
+    m_hasId.push_back(id.isValid());
+    if(!expandSerialTransformers) m_serialTransformer.push_back(sT);
+    return node;
+  };
+
+  //
+  // Depth first traversal with an explicit stack. Each frame remembers the next child slot to visit
+  //
+  struct Frame {
+    unsigned int               node;
+    const GeoChildVolumeIndex* children;
+    unsigned int               nextSlot;
+    unsigned int               lastChild;
+  };
+  std::vector<Frame> stack;
+  // The child volumes of the volume of each frame, reused from one volume
+  // to the next at the same depth rather than cached in the volumes
+  std::vector<std::unique_ptr<GeoChildVolumeIndex>> children;
+  auto childrenOf = [&](const GeoVPhysVol* vol) {
+    if(children.size()==stack.size()) children.push_back(std::make_unique<GeoChildVolumeIndex>());
+    children[stack.size()]->rebuild(vol);
+    return children[stack.size()].get();
+  };
+
+  m_nameOffset.push_back(0);
+  addNode(m_top,NONE,GeoTrf::Transform3D::Identity(),m_top->getLogVol()->getName(),Query<int>(),nullptr);
+  stack.push_back(Frame{0,childrenOf(m_top),0,NONE});
+
+  while(!stack.empty()) {
+    Frame& frame = stack.back();
+    if(frame.nextSlot==frame.children->getNChildVols()) {
+      m_subtreeEnd[frame.node] = m_parent.size();
+      stack.pop_back();
+      continue;
+    }
+
+    unsigned int slot = frame.nextSlot++;
+    const GeoSerialTransformer* sT = frame.children->getSerialTransformer(slot);
+    if(sT && !expandSerialTransformers && frame.children->getCopyNumber(slot)!=0) continue;
+
+    const GeoVPhysVol* vol = frame.children->getChildVol(slot);
+    unsigned int node = addNode(vol
+				,frame.node
+				,frame.children->getXToChildVol(slot,store)
+				,frame.children->getNameOfChildVol(slot)
+				,frame.children->getIdOfChildVol(slot)
+				,sT);
+    if(frame.lastChild==NONE) {
+      m_firstChild[frame.node] = node;
+    }
+    else {
+      m_nextSibling[frame.lastChild] = node;
+    }
+    frame.lastChild = node;
+
+    // Invalidates frame
+    stack.push_back(Frame{node,childrenOf(vol),0,NONE});
+  }
+}
+
+GeoCompiledGeometry::~GeoCompiledGeometry()
+{
+  m_top->unref();
+}
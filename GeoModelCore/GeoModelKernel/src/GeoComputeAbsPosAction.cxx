@@ -0,0 +1,161 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoModelKernel/GeoComputeAbsPosAction.h"
+#include "GeoModelKernel/GeoVAlignmentStore.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+GeoComputeAbsPosAction::GeoComputeAbsPosAction(GeoVAlignmentStore* store)
+  : m_store(store)
+  , m_hasStartTransforms(false)
+  , m_nComputed(0)
+  , m_subtrees(nullptr)
+{
+  m_levels.reserve(32);
+}
+
+GeoComputeAbsPosAction::~GeoComputeAbsPosAction()
+{
+}
+
+void GeoComputeAbsPosAction::setStartTransforms(const GeoTrf::Transform3D& absXf, const GeoTrf::Transform3D& defAbsXf)
+{
+  m_levels.clear();
+  m_levels.push_back(Level{absXf,defAbsXf,GeoTrf::Transform3D::Identity(),GeoTrf::Transform3D::Identity(),false});
+  m_hasStartTransforms = true;
+}
+
+void GeoComputeAbsPosAction::handleTransform(const GeoTransform *xform)
+{
+  Level& level = m_levels[getPath()->getLength()-1];
+  xform->accumulateTransform(level.pendingXf,m_store);
+  xform->accumulateDefTransform(level.pendingDefXf);
+}
+
+void GeoComputeAbsPosAction::handlePhysVol(const GeoPhysVol *vol)
+{
+  handleVolume(vol,nullptr);
+}
+
+void GeoComputeAbsPosAction::handleFullPhysVol(const GeoFullPhysVol *vol)
+{
+  handleVolume(vol,vol);
+}
+
+void GeoComputeAbsPosAction::handleSerialTransformer(const GeoSerialTransformer *)
+{
+  // Volumes placed by serial transformers are shared. Just consume the pending transforms
+  Level& level = m_levels[getPath()->getLength()-1];
+  level.pendingXf = level.pendingDefXf = GeoTrf::Transform3D::Identity();
+}
+
+void GeoComputeAbsPosAction::handleVolume(const GeoVPhysVol* vol, const GeoVFullPhysVol* fullVol)
+{
+  unsigned int depth = getPath()->getLength()-1;
+  if(depth==0) {
+    if(!m_hasStartTransforms) {
+      //
+      // Compute the position of the starting volume from the top of the tree
+      //
+      Level start{GeoTrf::Transform3D::Identity(),GeoTrf::Transform3D::Identity()
+	  ,GeoTrf::Transform3D::Identity(),GeoTrf::Transform3D::Identity(),vol->isShared()};
+      PVConstLink child(vol), parent(vol->getParent());
+      while(parent && !start.shared) {
+	start.absXf    = child->getX(m_store) * start.absXf;
+	start.defAbsXf = child->getDefX(m_store) * start.defAbsXf;
+	child = parent;
+	start.shared = child->isShared();
+	parent = child->getParent();
+      }
+      m_levels.clear();
+      m_levels.push_back(start);
+    }
+  }
+  else {
+    Level& parent = m_levels[depth-1];
+    Level level{parent.absXf*parent.pendingXf
+	,parent.defAbsXf*parent.pendingDefXf
+	,GeoTrf::Transform3D::Identity()
+	,GeoTrf::Transform3D::Identity()
+	,parent.shared || vol->isShared()};
+    parent.pendingXf = parent.pendingDefXf = GeoTrf::Transform3D::Identity();
+    if(m_levels.size()>depth) {
+      m_levels[depth] = level;
+    }
+    else {
+      m_levels.push_back(level);
+    }
+  }
+
+  const Level& level = m_levels[depth];
+  if(level.shared) return;
+
+  if(m_subtrees && getDepthLimit().isValid() && depth==getDepthLimit()) {
+    m_subtrees->push_back(Subtree{vol,level.absXf,level.defAbsXf});
+    return;
+  }
+
+  if(fullVol) {
+    // Overwrites cached positions. A dense store keeps the ones it holds
+    if(m_store) {
+      m_store->setAbsPosition(fullVol,level.absXf);
+      m_store->setDefAbsPosition(fullVol,level.defAbsXf);
+    }
+    else {
+      fullVol->setPositionInfo(level.absXf,level.defAbsXf);
+    }
+    m_nComputed++;
+  }
+}
+
+unsigned int GeoComputeAbsPosAction::computeParallel(PVConstLink top
+						     ,GeoVAlignmentStore* store
+						     ,unsigned int nThreads
+						     ,unsigned int splitDepth)
+{
+  //
+  // Handle the volumes above the split depth on this thread, and collect the subtrees
+  //
+  std::vector<Subtree> subtrees;
+  GeoComputeAbsPosAction collector(store);
+  collector.m_subtrees = &subtrees;
+  collector.setDepthLimit(splitDepth);
+  top->exec(&collector);
+
+  if(nThreads==0) nThreads = std::max(1u,std::thread::hardware_concurrency());
+  nThreads = std::min<size_t>(nThreads,subtrees.size());
+
+  std::atomic<size_t> next(0);
+  std::atomic<unsigned int> nComputed(collector.getNComputed());
+  std::exception_ptr error;
+  std::mutex errorMutex;
+
+  auto worker = [&]() {
+    try {
+      for(size_t i = next++; i < subtrees.size(); i = next++) {
+	GeoComputeAbsPosAction action(store);
+	action.setStartTransforms(subtrees[i].absXf,subtrees[i].defAbsXf);
+	subtrees[i].volume->exec(&action);
+	nComputed += action.getNComputed();
+      }
+    }
+    catch(...) {
+      std::scoped_lock<std::mutex> lk(errorMutex);
+      if(!error) error = std::current_exception();
+      next = subtrees.size();
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for(unsigned int t = 1; t < nThreads; ++t) pool.emplace_back(worker);
+  worker();
+  for(std::thread& thread : pool) thread.join();
+
+  if(error) std::rethrow_exception(error);
+  return nComputed;
+}
@@ -4,6 +4,9 @@
 
 #include "GeoModelKernel/GeoCons.h"
 #include "GeoModelKernel/GeoShapeAction.h"
+#include "GeoShapeUtils.h"
+#include <cmath>
+#include <algorithm>
 
 const std::string GeoCons::s_classType = "Cons";
 const ShapeType GeoCons::s_classTypeID = 0x11;
@@ -44,3 +47,53 @@ void GeoCons::exec (GeoShapeAction *action) const
 {
   action->handleCons(this);
 }
+
+GeoShape::Location GeoCons::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  return GeoShapeUtils::intersectPhi(GeoShapeUtils::classify(radialDistance(p), tolerance), p.x(), p.y(), m_sPhi, m_dPhi, tolerance);
+}
+
+void GeoCons::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+			       , RayIntervals &intervals) const
+{
+  // Radii are linear in z: r(z) = (r1+r2)/2 + (r2-r1)/(2dz) z
+  RayIntervals other;
+  GeoShapeUtils::slabIntervals(p.z(), v.z(), -m_dZ, m_dZ, intervals);
+  GeoShapeUtils::coneIntervals(p, v, 0.5 * (m_rMax1 + m_rMax2), (m_rMax2 - m_rMax1) / (2.0 * m_dZ), other);
+  GeoShapeUtils::intersectIntervals(intervals, other, intervals);
+  if (m_rMin1 > 0 || m_rMin2 > 0) {
+    GeoShapeUtils::coneIntervals(p, v, 0.5 * (m_rMin1 + m_rMin2), (m_rMin2 - m_rMin1) / (2.0 * m_dZ), other);
+    GeoShapeUtils::subtractIntervals(intervals, other, intervals);
+  }
+  GeoShapeUtils::phiIntervals(p, v, m_sPhi, m_dPhi, other);
+  GeoShapeUtils::intersectIntervals(intervals, other, intervals);
+}
+
+double GeoCons::safety (const GeoTrf::Vector3D &p) const
+{
+  return std::abs(std::max(radialDistance(p), GeoShapeUtils::phiDistance(p.x(), p.y(), m_sPhi, m_dPhi)));
+}
+
+double GeoCons::radialDistance (const GeoTrf::Vector3D &p) const
+{
+  // Radii at the height of the point, and the slopes which turn radial into normal distances
+  double t = (p.z() + m_dZ) / (2.0 * m_dZ);
+  double rho = std::hypot(p.x(), p.y());
+  double rMax = m_rMax1 + (m_rMax2 - m_rMax1) * t;
+  double d = std::max(std::abs(p.z()) - m_dZ
+		      , (rho - rMax) / std::hypot(1.0, (m_rMax2 - m_rMax1) / (2.0 * m_dZ)));
+  if (m_rMin1 > 0 || m_rMin2 > 0) {
+    double rMin = m_rMin1 + (m_rMin2 - m_rMin1) * t;
+    d = std::max(d, (rMin - rho) / std::hypot(1.0, (m_rMin2 - m_rMin1) / (2.0 * m_dZ)));
+  }
+  return d;
+}
+
+void GeoCons::computeExtent (double &xmin, double &ymin, double &zmin
+			   , double &xmax, double &ymax, double &zmax) const
+{
+  GeoShapeUtils::sectorExtent(std::min(m_rMin1, m_rMin2), std::max(m_rMax1, m_rMax2), m_sPhi, m_dPhi
+			      , xmin, ymin, xmax, ymax);
+  zmin = -m_dZ;
+  zmax =  m_dZ;
+}
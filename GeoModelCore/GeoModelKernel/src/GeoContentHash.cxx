@@ -0,0 +1,118 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoModelKernel/GeoContentHash.h"
+#include "GeoModelKernel/GeoElement.h"
+#include "GeoModelKernel/GeoMaterial.h"
+#include "GeoModelKernel/GeoLogVol.h"
+#include "GeoShapeUtils.h"
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+  typedef GeoShapeUtils::ShapeContent Content;
+
+  size_t shapeHash(const GeoShape* shape, std::unordered_map<const GeoShape*,size_t>& memo)
+  {
+    auto it = memo.find(shape);
+    if (it != memo.end()) return it->second;
+    Content c;
+    GeoShapeUtils::getContent(shape,c);
+    std::vector<size_t> operandHashes;
+    for (const GeoShape* op : c.operands) operandHashes.push_back(shapeHash(op,memo));
+    size_t h = GeoShapeUtils::hashContent(c,operandHashes);
+    memo.emplace(shape,h);
+    return h;
+  }
+
+  size_t stringHash(const std::string& s)
+  {
+    return std::hash<std::string>()(s);
+  }
+
+  size_t doubleHash(double d)
+  {
+    return std::hash<double>()(d);
+  }
+}
+
+size_t GeoContentHash::hash(const GeoShape* shape)
+{
+  if (!shape) return 0;
+  std::unordered_map<const GeoShape*,size_t> memo;
+  return shapeHash(shape,memo);
+}
+
+size_t GeoContentHash::hash(const GeoElement* element)
+{
+  if (!element) return 0;
+  size_t h = stringHash(element->getName());
+  h = GeoShapeUtils::hashCombine(h,stringHash(element->getSymbol()));
+  h = GeoShapeUtils::hashCombine(h,doubleHash(element->getZ()));
+  return GeoShapeUtils::hashCombine(h,doubleHash(element->getA()));
+}
+
+size_t GeoContentHash::hash(const GeoMaterial* material)
+{
+  if (!material) return 0;
+  size_t h = stringHash(material->getName());
+  h = GeoShapeUtils::hashCombine(h,doubleHash(material->getDensity()));
+  for (unsigned int i = 0; i < material->getNumElements(); ++i) {
+    h = GeoShapeUtils::hashCombine(h,hash(material->getElement(i)));
+    h = GeoShapeUtils::hashCombine(h,doubleHash(material->getFraction(i)));
+  }
+  return h;
+}
+
+size_t GeoContentHash::hash(const GeoLogVol* logVol)
+{
+  if (!logVol) return 0;
+  size_t h = stringHash(logVol->getName());
+  h = GeoShapeUtils::hashCombine(h,hash(logVol->getShape()));
+  return GeoShapeUtils::hashCombine(h,hash(logVol->getMaterial()));
+}
+
+bool GeoContentHash::equal(const GeoShape* a, const GeoShape* b)
+{
+  if (a == b) return true;
+  if (!a || !b) return false;
+  Content ca, cb;
+  GeoShapeUtils::getContent(a,ca);
+  GeoShapeUtils::getContent(b,cb);
+  if (!GeoShapeUtils::sameParameters(ca,cb)) return false;
+  for (size_t i = 0; i < ca.operands.size(); ++i) {
+    if (!equal(ca.operands[i],cb.operands[i])) return false;
+  }
+  return true;
+}
+
+bool GeoContentHash::equal(const GeoElement* a, const GeoElement* b)
+{
+  if (a == b) return true;
+  return a && b && *a == *b;
+}
+
+bool GeoContentHash::equal(const GeoMaterial* a, const GeoMaterial* b)
+{
+  if (a == b) return true;
+  if (!a || !b) return false;
+  if (a->getName() != b->getName() || a->getDensity() != b->getDensity()
+      || a->getNumElements() != b->getNumElements()) return false;
+  for (unsigned int i = 0; i < a->getNumElements(); ++i) {
+    if (a->getFraction(i) != b->getFraction(i) || !equal(a->getElement(i),b->getElement(i))) return false;
+  }
+  return true;
+}
+
+bool GeoContentHash::equal(const GeoLogVol* a, const GeoLogVol* b)
+{
+  if (a == b) return true;
+  if (!a || !b) return false;
+  return a->getName() == b->getName()
+    && equal(a->getShape(),b->getShape())
+    && equal(a->getMaterial(),b->getMaterial());
+}
@@ -36,3 +36,13 @@ void GeoCountVolAction::handleSerialTransformer (const GeoSerialTransformer  *st
 {
   m_count += st->getNCopies ();
 }
+
+GeoNodeAction* GeoCountVolAction::clone () const
+{
+  return new GeoCountVolAction;
+}
+
+void GeoCountVolAction::merge (const GeoNodeAction &other)
+{
+  m_count += static_cast<const GeoCountVolAction &>(other).m_count;
+}
@@ -0,0 +1,214 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoModelKernel/GeoDenseAlignmentStore.h"
+#include "GeoModelKernel/GeoNodeAction.h"
+#include "GeoModelKernel/GeoAlignableTransform.h"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+  // States of a slot in a transform array
+  constexpr unsigned char EMPTY   = 0;
+  constexpr unsigned char WRITING = 1;
+  constexpr unsigned char READY   = 2;
+
+  // Collects alignable transforms and full physical volumes, in traversal order
+  class CollectSlotsAction : public GeoNodeAction
+  {
+  public:
+    virtual void handleTransform(const GeoTransform* xf) override {
+      const GeoAlignableTransform* axf = dynamic_cast<const GeoAlignableTransform*>(xf);
+      if(axf) alignables.push_back(axf);
+    }
+    virtual void handleFullPhysVol(const GeoFullPhysVol* vol) override {
+      fullPhysVols.push_back(vol);
+    }
+    std::vector<const GeoAlignableTransform*> alignables;
+    std::vector<const GeoVFullPhysVol*>       fullPhysVols;
+  };
+}
+
+GeoDenseAlignmentStore::GeoDenseAlignmentStore(PVConstLink world)
+{
+  CollectSlotsAction collector;
+  world->exec(&collector);
+  assignSlots(collector.alignables,collector.fullPhysVols);
+}
+
+GeoDenseAlignmentStore::GeoDenseAlignmentStore(const std::vector<const GeoAlignableTransform*>& alignables
+					       ,const std::vector<const GeoVFullPhysVol*>& fullPhysVols)
+{
+  assignSlots(alignables,fullPhysVols);
+}
+
+GeoDenseAlignmentStore::~GeoDenseAlignmentStore()
+{
+}
+
+void GeoDenseAlignmentStore::assignSlots(const std::vector<const GeoAlignableTransform*>& alignables
+					 ,const std::vector<const GeoVFullPhysVol*>& fullPhysVols)
+{
+  // Slots follow the order of first appearance. Shared subtrees may show up more than once
+  auto fill = [](auto& table, const auto& nodes) {
+    using Key = typename std::remove_reference_t<decltype(table)>::value_type::first_type;
+    std::vector<Key> seen(nodes.begin(),nodes.end());
+    std::sort(seen.begin(),seen.end());
+    seen.erase(std::unique(seen.begin(),seen.end()),seen.end());
+    std::vector<bool> assigned(seen.size(),false);
+    table.reserve(seen.size());
+    for(Key node : nodes) {
+      size_t pos = std::lower_bound(seen.begin(),seen.end(),node) - seen.begin();
+      if(assigned[pos]) continue;
+      assigned[pos] = true;
+      table.emplace_back(node,table.size());
+    }
+    std::sort(table.begin(),table.end());
+  };
+  fill(m_deltaSlots,alignables);
+  fill(m_positionSlots,fullPhysVols);
+
+  m_deltas.resize(m_deltaSlots.size());
+  m_absPositions.resize(m_positionSlots.size());
+  m_defAbsPositions.resize(m_positionSlots.size());
+}
+
+template<class T>
+Query<unsigned int> GeoDenseAlignmentStore::findSlot(const SlotTable<T>& table, const T* key)
+{
+  auto it = std::lower_bound(table.begin(),table.end(),key
+			     ,[](const std::pair<const T*,unsigned int>& entry, const T* k) { return entry.first < k; });
+  if(it==table.end() || it->first!=key) return Query<unsigned int>();
+  return it->second;
+}
+
+Query<unsigned int> GeoDenseAlignmentStore::getDeltaSlot(const GeoAlignableTransform* xf) const
+{
+  return findSlot(m_deltaSlots,xf);
+}
+
+Query<unsigned int> GeoDenseAlignmentStore::getPositionSlot(const GeoVFullPhysVol* fpv) const
+{
+  return findSlot(m_positionSlots,fpv);
+}
+
+void GeoDenseAlignmentStore::setDelta(const GeoAlignableTransform* xf, const GeoTrf::Transform3D& delta)
+{
+  Query<unsigned int> slot = getDeltaSlot(xf);
+  if(!slot.isValid()) throw std::runtime_error("GeoDenseAlignmentStore::setDelta(). Alignable transform has no slot in this store");
+  m_deltas.set(slot,delta);
+}
+
+const GeoTrf::Transform3D* GeoDenseAlignmentStore::getDelta(const GeoAlignableTransform* xf) const
+{
+  Query<unsigned int> slot = getDeltaSlot(xf);
+  return slot.isValid() ? m_deltas.get(slot) : nullptr;
+}
+
+void GeoDenseAlignmentStore::setAbsPosition(const GeoVFullPhysVol* fpv, const GeoTrf::Transform3D& xf)
+{
+  Query<unsigned int> slot = getPositionSlot(fpv);
+  if(!slot.isValid()) throw std::runtime_error("GeoDenseAlignmentStore::setAbsPosition(). Full physical volume has no slot in this store");
+  m_absPositions.setOnce(slot,xf);
+}
+
+const GeoTrf::Transform3D* GeoDenseAlignmentStore::getAbsPosition(const GeoVFullPhysVol* fpv) const
+{
+  Query<unsigned int> slot = getPositionSlot(fpv);
+  return slot.isValid() ? m_absPositions.get(slot) : nullptr;
+}
+
+void GeoDenseAlignmentStore::setDefAbsPosition(const GeoVFullPhysVol* fpv, const GeoTrf::Transform3D& xf)
+{
+  Query<unsigned int> slot = getPositionSlot(fpv);
+  if(!slot.isValid()) throw std::runtime_error("GeoDenseAlignmentStore::setDefAbsPosition(). Full physical volume has no slot in this store");
+  m_defAbsPositions.setOnce(slot,xf);
+}
+
+const GeoTrf::Transform3D* GeoDenseAlignmentStore::getDefAbsPosition(const GeoVFullPhysVol* fpv) const
+{
+  Query<unsigned int> slot = getPositionSlot(fpv);
+  return slot.isValid() ? m_defAbsPositions.get(slot) : nullptr;
+}
+
+void GeoDenseAlignmentStore::setDelta(unsigned int slot, const GeoTrf::Transform3D& delta)
+{
+  m_deltas.set(slot,delta);
+}
+
+const GeoTrf::Transform3D* GeoDenseAlignmentStore::getDelta(unsigned int slot) const
+{
+  return m_deltas.get(slot);
+}
+
+void GeoDenseAlignmentStore::setAbsPosition(unsigned int slot, const GeoTrf::Transform3D& xf)
+{
+  m_absPositions.setOnce(slot,xf);
+}
+
+const GeoTrf::Transform3D* GeoDenseAlignmentStore::getAbsPosition(unsigned int slot) const
+{
+  return m_absPositions.get(slot);
+}
+
+void GeoDenseAlignmentStore::setDefAbsPosition(unsigned int slot, const GeoTrf::Transform3D& xf)
+{
+  m_defAbsPositions.setOnce(slot,xf);
+}
+
+const GeoTrf::Transform3D* GeoDenseAlignmentStore::getDefAbsPosition(unsigned int slot) const
+{
+  return m_defAbsPositions.get(slot);
+}
+
+void GeoDenseAlignmentStore::clearPositions()
+{
+  m_absPositions.clear();
+  m_defAbsPositions.clear();
+}
+
+void GeoDenseAlignmentStore::TransformArray::resize(unsigned int n)
+{
+  m_transforms.assign(n,GeoTrf::Transform3D::Identity());
+  std::vector<std::atomic<unsigned char>>(n).swap(m_state);
+}
+
+void GeoDenseAlignmentStore::TransformArray::set(unsigned int slot, const GeoTrf::Transform3D& xf)
+{
+  if(slot>=m_transforms.size()) throw std::out_of_range("GeoDenseAlignmentStore: slot out of range");
+  // Overwrites the slot. Only safe while no other thread reads it
+  m_state[slot].store(WRITING,std::memory_order_relaxed);
+  m_transforms[slot] = xf;
+  m_state[slot].store(READY,std::memory_order_release);
+}
+
+void GeoDenseAlignmentStore::TransformArray::setOnce(unsigned int slot, const GeoTrf::Transform3D& xf)
+{
+  if(slot>=m_transforms.size()) throw std::out_of_range("GeoDenseAlignmentStore: slot out of range");
+  // The first writer wins. A published transform is never written again,
+  // as readers may be copying it through the pointer returned by get()
+  std::atomic<unsigned char>& state = m_state[slot];
+  unsigned char expected = EMPTY;
+  if(state.compare_exchange_strong(expected,WRITING,std::memory_order_acquire)) {
+    m_transforms[slot] = xf;
+    state.store(READY,std::memory_order_release);
+    return;
+  }
+  // A losing writer waits for the winner to publish, for the caller to
+  // find the slot filled. The winner holds it for one transform copy
+  while(state.load(std::memory_order_acquire)==WRITING) std::this_thread::yield();
+}
+
+const GeoTrf::Transform3D* GeoDenseAlignmentStore::TransformArray::get(unsigned int slot) const
+{
+  if(slot>=m_transforms.size()) return nullptr;
+  // Readers never wait, a slot being written reads as empty
+  return m_state[slot].load(std::memory_order_acquire)==READY ? &m_transforms[slot] : nullptr;
+}
+
+void GeoDenseAlignmentStore::TransformArray::clear()
+{
+  for(std::atomic<unsigned char>& state : m_state) state.store(EMPTY,std::memory_order_relaxed);
+}
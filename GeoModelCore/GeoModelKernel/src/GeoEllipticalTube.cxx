@@ -7,6 +7,7 @@
 #include "GeoModelKernel/GeoShapeAction.h"
 
 #include "GeoModelKernel/GeoEllipticalTube.h"
+#include "GeoShapeUtils.h"
 const std::string GeoEllipticalTube::s_classType = "EllipticalTube";
 const ShapeType GeoEllipticalTube::s_classTypeID = 0x22;
 
@@ -46,3 +47,40 @@ void GeoEllipticalTube::exec (GeoShapeAction *action) const
   action->handleEllipticalTube(this);
 }
 
+
+GeoShape::Location GeoEllipticalTube::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  return GeoShapeUtils::classify(distance(p), tolerance);
+}
+
+void GeoEllipticalTube::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+					 , RayIntervals &intervals) const
+{
+  // Inside where (x/a)^2 + (y/b)^2 - 1, quadratic along the line, is negative
+  double px = p.x() / m_xHalfLength, py = p.y() / m_yHalfLength;
+  double vx = v.x() / m_xHalfLength, vy = v.y() / m_yHalfLength;
+  RayIntervals ellipse;
+  GeoShapeUtils::quadraticIntervals(vx * vx + vy * vy, 2.0 * (px * vx + py * vy), px * px + py * py - 1.0, ellipse);
+  GeoShapeUtils::slabIntervals(p.z(), v.z(), -m_zHalfLength, m_zHalfLength, intervals);
+  GeoShapeUtils::intersectIntervals(intervals, ellipse, intervals);
+}
+
+double GeoEllipticalTube::safety (const GeoTrf::Vector3D &p) const
+{
+  return std::abs(distance(p));
+}
+
+double GeoEllipticalTube::distance (const GeoTrf::Vector3D &p) const
+{
+  // Scaled radial distance.  Exact on the axes, conservative elsewhere
+  double xs = p.x() / m_xHalfLength, ys = p.y() / m_yHalfLength;
+  double dr = (std::sqrt(xs * xs + ys * ys) - 1.0) * std::min(m_xHalfLength, m_yHalfLength);
+  return std::max(dr, std::abs(p.z()) - m_zHalfLength);
+}
+
+void GeoEllipticalTube::computeExtent (double &xmin, double &ymin, double &zmin
+				     , double &xmax, double &ymax, double &zmax) const
+{
+  xmin = -m_xHalfLength; ymin = -m_yHalfLength; zmin = -m_zHalfLength;
+  xmax =  m_xHalfLength; ymax =  m_yHalfLength; zmax =  m_zHalfLength;
+}
@@ -13,10 +13,7 @@ GeoTriangularFacet::GeoTriangularFacet(GeoFacetVertex v0
 {
   m_nVertices = 3;
   m_vertexType = type;
-  m_vertices.reserve(3);
-  m_vertices[0] = v0;
-  m_vertices[1] = v1;
-  m_vertices[2] = v2;
+  m_vertices = {v0, v1, v2};
 }
 
 
@@ -34,11 +31,7 @@ GeoQuadrangularFacet::GeoQuadrangularFacet(GeoFacetVertex v0
 {
   m_nVertices = 4;
   m_vertexType = type;
-  m_vertices.reserve(4);
-  m_vertices[0] = v0;
-  m_vertices[1] = v1;
-  m_vertices[2] = v2;
-  m_vertices[3] = v3;
+  m_vertices = {v0, v1, v2, v3};
 }
 
 
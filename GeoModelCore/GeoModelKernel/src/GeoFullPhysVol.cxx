@@ -7,7 +7,7 @@
 #include "GeoModelKernel/GeoNodeAction.h"
 #include "GeoModelKernel/GeoCountVolAction.h"
 #include "GeoModelKernel/GeoCountVolAndSTAction.h"
-#include "GeoModelKernel/GeoAccessVolumeAction.h"
+#include "GeoModelKernel/GeoChildVolumeIndex.h"
 
 #include <algorithm>
 
@@ -30,6 +30,22 @@ void GeoFullPhysVol::add(GeoGraphNode* graphNode)
   m_daughters.push_back(graphNode);
   graphNode->ref();
   graphNode->dockTo(this);
+  clearChildVolumeIndex();
+}
+
+void GeoFullPhysVol::setChildNodes(const std::vector<GeoGraphNode*>& nodes)
+{
+  if(m_cloneOrigin) throw std::runtime_error("Attempt to modify contents of a cloned FPV");
+  std::scoped_lock<std::mutex> guard(m_mutex);
+  std::vector<const GeoGraphNode*> previous;
+  previous.swap(m_daughters);
+  for(GeoGraphNode* node : nodes) {
+    m_daughters.push_back(node);
+    node->ref();
+    if(std::find(previous.begin(),previous.end(),node)==previous.end()) node->dockTo(this);
+  }
+  for(const GeoGraphNode* daughter : previous) daughter->unref();
+  clearChildVolumeIndex();
 }
 
 unsigned int GeoFullPhysVol::getNChildVols() const
@@ -41,23 +57,17 @@ unsigned int GeoFullPhysVol::getNChildVols() const
 
 PVConstLink GeoFullPhysVol::getChildVol(unsigned int index) const
 {
-  GeoAccessVolumeAction av(index,nullptr);
-  exec(&av);
-  return av.getVolume();
+  return getChildVolumeIndex().getChildVol(index);
 }
 
 GeoTrf::Transform3D GeoFullPhysVol::getXToChildVol(unsigned int index, const GeoVAlignmentStore* store) const
 {
-  GeoAccessVolumeAction av(index,store);
-  exec(&av);
-  return av.getTransform();
+  return getChildVolumeIndex().getXToChildVol(index,store);
 }
 
-GeoTrf::Transform3D GeoFullPhysVol::getDefXToChildVol(unsigned int index, const GeoVAlignmentStore* store) const
+GeoTrf::Transform3D GeoFullPhysVol::getDefXToChildVol(unsigned int index, const GeoVAlignmentStore* /*store*/) const
 {
-  GeoAccessVolumeAction av(index,store);
-  exec(&av);
-  return av.getDefTransform();
+  return getChildVolumeIndex().getDefXToChildVol(index);
 }
 
 void GeoFullPhysVol::exec(GeoNodeAction *action) const
@@ -104,16 +114,12 @@ void GeoFullPhysVol::exec(GeoNodeAction *action) const
 
 std::string GeoFullPhysVol::getNameOfChildVol(unsigned int i) const
 {
-  GeoAccessVolumeAction av(i,nullptr);
-  exec(&av);
-  return av.getName();
+  return getChildVolumeIndex().getNameOfChildVol(i);
 }
 
 Query<int> GeoFullPhysVol::getIdOfChildVol(unsigned int i) const
 {
-  GeoAccessVolumeAction av(i,nullptr);
-  exec(&av);
-  return av.getId ();
+  return getChildVolumeIndex().getIdOfChildVol(i);
 }
 
 unsigned int GeoFullPhysVol::getNChildVolAndST() const
@@ -162,6 +168,7 @@ void GeoFullPhysVol::clear()
   for(size_t i=0; i<m_daughters.size(); i++)
     m_daughters[i]->unref();
   m_daughters.clear();
+  clearChildVolumeIndex();
 }
 
 GeoTrf::Transform3D GeoFullPhysVol::getX(const GeoVAlignmentStore* store) const {
@@ -176,29 +183,25 @@ GeoTrf::Transform3D GeoFullPhysVol::getX(const GeoVAlignmentStore* store) const
   const GeoGraphNode * const * fence =  getParent()->getChildNode(0);
   const GeoGraphNode * const * node1 =  getParent()->findChildNode(this);
   
-  for(const GeoGraphNode * const * current = node1 - 1; current>=fence; current--) {
-
-    // If this happens, we are done, compute & return--------------------//
-    //                                                                   //
-    if (dynamic_cast<const GeoVPhysVol *>(*current)) break;              //
-    //-------------------------------------------------------------------//
-
-    // If this happens, we are done, compute & return--------------------//
-    //                                                                   //
-    if (dynamic_cast<const GeoSerialTransformer *>(*current)) break;     //
-    //-------------------------------------------------------------------//
-
+  //
+  // Go back to the previous volume or serial transformer, if any:
+  //
+  const GeoGraphNode * const * current = node1;
+  for( ; current>fence; current--) {
+    if (dynamic_cast<const GeoVPhysVol *>(*(current-1))) break;
+    if (dynamic_cast<const GeoSerialTransformer *>(*(current-1))) break;
+  }
+  //
+  // Accumulate the transforms from there, in order:
+  //
+  for( ; current<node1; current++) {
     const GeoTransform *xf = dynamic_cast<const GeoTransform *> (*current);
-    
-    //-------------------------------------------------------------------//
-    // If this happens, accumulate into transform                        //
-    if (xf) xform  = xf->getTransform(store)*xform;                      //
-    //-------------------------------------------------------------------//
+    if (xf) xf->accumulateTransform(xform,store);
   }
   return xform;  
 }
 
-GeoTrf::Transform3D GeoFullPhysVol::getDefX(const GeoVAlignmentStore* store) const {
+GeoTrf::Transform3D GeoFullPhysVol::getDefX(const GeoVAlignmentStore* /*store*/) const {
   //
   // Check we are not shared:
   //
@@ -210,24 +213,20 @@ GeoTrf::Transform3D GeoFullPhysVol::getDefX(const GeoVAlignmentStore* store) con
   const GeoGraphNode * const * fence =  getParent()->getChildNode(0);
   const GeoGraphNode * const * node1 =  getParent()->findChildNode(this);
   
-  for(const GeoGraphNode * const * current = node1 - 1; current>=fence; current--) {
-
-    // If this happens, we are done, compute & return--------------------//
-    //                                                                   //
-    if (dynamic_cast<const GeoVPhysVol *>(*current)) break;              //
-    //-------------------------------------------------------------------//
-
-    // If this happens, we are done, compute & return--------------------//
-    //                                                                   //
-    if (dynamic_cast<const GeoSerialTransformer *>(*current)) break;     //
-    //-------------------------------------------------------------------//
-
+  //
+  // Go back to the previous volume or serial transformer, if any:
+  //
+  const GeoGraphNode * const * current = node1;
+  for( ; current>fence; current--) {
+    if (dynamic_cast<const GeoVPhysVol *>(*(current-1))) break;
+    if (dynamic_cast<const GeoSerialTransformer *>(*(current-1))) break;
+  }
+  //
+  // Accumulate the transforms from there, in order:
+  //
+  for( ; current<node1; current++) {
     const GeoTransform *xf = dynamic_cast<const GeoTransform *> (*current);
-    
-    //-------------------------------------------------------------------//
-    // If this happens, accumulate into transform                        //
-    if (xf) xform  = xf->getDefTransform(store)*xform;                   //
-    //-------------------------------------------------------------------//
+    if (xf) xf->accumulateDefTransform(xform);
   }
   return xform;
   
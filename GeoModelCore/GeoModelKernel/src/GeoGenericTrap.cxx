@@ -4,6 +4,9 @@
 
 #include "GeoModelKernel/GeoGenericTrap.h"
 #include "GeoModelKernel/GeoShapeAction.h"
+#include "GeoShapeUtils.h"
+#include <cmath>
+#include <algorithm>
 
 const std::string GeoGenericTrap::s_classType = "GenericTrap";
 const ShapeType GeoGenericTrap::s_classTypeID = 0x23;
@@ -60,3 +63,100 @@ const GeoGenericTrapVertices& GeoGenericTrap::getVertices() const
   return m_vertices;
 }
 
+
+GeoShape::Location GeoGenericTrap::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  return GeoShapeUtils::classify(distance(p), tolerance);
+}
+
+void GeoGenericTrap::inside (size_t n, const double *x, const double *y, const double *z
+			     , Location *result, double tolerance) const
+{
+  // The bottom vertices and their slopes in z are the same for all the points, see distance()
+  double x0[4], y0[4], dx[4], dy[4];
+  for (unsigned int k = 0; k < 4; ++k) {
+    x0[k] = m_vertices[k].x();
+    y0[k] = m_vertices[k].y();
+    dx[k] = m_vertices[k+4].x() - x0[k];
+    dy[k] = m_vertices[k+4].y() - y0[k];
+  }
+  const double scale = 1.0 / (2.0 * m_zHalfLength);
+  double xs[4], ys[4];
+  for (size_t i = 0; i < n; ++i) {
+    double t = std::min(1.0, std::max(0.0, (z[i] + m_zHalfLength) * scale));
+    for (unsigned int k = 0; k < 4; ++k) {
+      xs[k] = x0[k] + dx[k] * t;
+      ys[k] = y0[k] + dy[k] * t;
+    }
+    double dist = std::max(GeoShapeUtils::polygonDistance(x[i], y[i], xs, ys, 4), std::abs(z[i]) - m_zHalfLength);
+    result[i] = GeoShapeUtils::classify(dist, tolerance);
+  }
+}
+
+void GeoGenericTrap::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+				      , RayIntervals &intervals) const
+{
+  // The sections are taken to be convex.  Inside them the point is on the inner
+  // side of every edge.  The edge vertices and the point are linear in t, so the
+  // cross product telling the side is quadratic in t, and three samples fix it
+  double area = 0;
+  for (unsigned int i = 0, j = 3; i < 4; j = i++) {
+    area += m_vertices[j].x() * m_vertices[i].y() - m_vertices[i].x() * m_vertices[j].y();
+    area += m_vertices[j+4].x() * m_vertices[i+4].y() - m_vertices[i+4].x() * m_vertices[j+4].y();
+  }
+  double orientation = area < 0 ? 1.0 : -1.0;
+
+  auto outwardness = [&](unsigned int i, unsigned int j, double t) {
+    GeoTrf::Vector3D q = p + t * v;
+    double s = (q.z() + m_zHalfLength) / (2.0 * m_zHalfLength);
+    GeoTwoVector a = m_vertices[i] + (m_vertices[i+4] - m_vertices[i]) * s;
+    GeoTwoVector b = m_vertices[j] + (m_vertices[j+4] - m_vertices[j]) * s;
+    return orientation * ((b.x() - a.x()) * (q.y() - a.y()) - (b.y() - a.y()) * (q.x() - a.x()));
+  };
+
+  RayIntervals side;
+  GeoShapeUtils::slabIntervals(p.z(), v.z(), -m_zHalfLength, m_zHalfLength, intervals);
+  for (unsigned int i = 3, j = 0; j < 4 && !intervals.empty(); i = j++) {
+    double f0 = outwardness(i, j, 0.0), fp = outwardness(i, j, 1.0), fm = outwardness(i, j, -1.0);
+    GeoShapeUtils::quadraticIntervals(0.5 * (fp + fm) - f0, 0.5 * (fp - fm), f0, side);
+    GeoShapeUtils::intersectIntervals(intervals, side, intervals);
+  }
+}
+
+double GeoGenericTrap::safety (const GeoTrf::Vector3D &p) const
+{
+  // The distance in the section overestimates the distance to a slanted face.
+  // Scale it down by the steepest slope of the lateral edges
+  double slope = 0;
+  for (unsigned int i = 0; i < 4; ++i) {
+    slope = std::max(slope, (m_vertices[i+4] - m_vertices[i]).norm() / (2.0 * m_zHalfLength));
+  }
+  return std::abs(distance(p)) / std::hypot(1.0, slope);
+}
+
+double GeoGenericTrap::distance (const GeoTrf::Vector3D &p) const
+{
+  // The section at the height of the point is the quadrilateral interpolated between the
+  // bottom and the top ones
+  double t = (p.z() + m_zHalfLength) / (2.0 * m_zHalfLength);
+  t = std::min(1.0, std::max(0.0, t));
+  double xs[4], ys[4];
+  for (unsigned int i = 0; i < 4; ++i) {
+    xs[i] = m_vertices[i].x() + (m_vertices[i+4].x() - m_vertices[i].x()) * t;
+    ys[i] = m_vertices[i].y() + (m_vertices[i+4].y() - m_vertices[i].y()) * t;
+  }
+  return std::max(GeoShapeUtils::polygonDistance(p.x(), p.y(), xs, ys, 4), std::abs(p.z()) - m_zHalfLength);
+}
+
+void GeoGenericTrap::computeExtent (double &xmin, double &ymin, double &zmin
+				  , double &xmax, double &ymax, double &zmax) const
+{
+  xmin = ymin = HUGE_VAL;
+  xmax = ymax = -HUGE_VAL;
+  for (const GeoTwoVector &v : m_vertices) {
+    xmin = std::min(xmin, v.x()); xmax = std::max(xmax, v.x());
+    ymin = std::min(ymin, v.y()); ymax = std::max(ymax, v.y());
+  }
+  zmin = -m_zHalfLength;
+  zmax =  m_zHalfLength;
+}
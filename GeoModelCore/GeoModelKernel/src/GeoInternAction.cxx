@@ -0,0 +1,108 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoModelKernel/GeoInternAction.h"
+#include "GeoModelKernel/GeoInternRegistry.h"
+#include "GeoShapeUtils.h"
+
+GeoInternAction::GeoInternAction(GeoInternRegistry& registry)
+  : m_registry(registry)
+{
+}
+
+GeoInternAction::~GeoInternAction()
+{
+  for (const RCBase* node : m_seen) node->unref();
+}
+
+void GeoInternAction::handlePhysVol(const GeoPhysVol *vol)
+{
+  replace(vol);
+}
+
+void GeoInternAction::handleFullPhysVol(const GeoFullPhysVol *vol)
+{
+  replace(vol);
+}
+
+void GeoInternAction::handleSerialTransformer(const GeoSerialTransformer *sT)
+{
+  // The volume replicated is not a child of the serial transformer
+  replace(&*sT->getVolume());
+  sT->getVolume()->exec(this);
+}
+
+void GeoInternAction::replace(const GeoVPhysVol* vol)
+{
+  const GeoLogVol* logVol = vol->getLogVol();
+  if (!logVol) return;
+
+  auto it = m_canonical.find(logVol);
+  if (it == m_canonical.end()) {
+    const GeoLogVol* canonical = m_registry.intern(logVol);
+    see(logVol);
+    m_stats.nLogVols++;
+    if (canonical != logVol) {
+      m_stats.nReplacedLogVols++;
+      account(GeoShapeUtils::nodeBytes(logVol),canonical,GeoShapeUtils::nodeBytes(canonical));
+    }
+    count(logVol->getShape());
+    count(logVol->getMaterial());
+    it = m_canonical.emplace(logVol,canonical).first;
+    // Volumes visited again already have the canonical instance
+    m_canonical.emplace(canonical,canonical);
+  }
+  if (it->second != logVol) const_cast<GeoVPhysVol*>(vol)->setLogVol(it->second);
+}
+
+void GeoInternAction::count(const GeoShape* shape)
+{
+  if (!shape || !see(shape)) return;
+  m_stats.nShapes++;
+  GeoShapeUtils::ShapeContent content;
+  GeoShapeUtils::getContent(shape,content);
+  const GeoShape* canonical = m_registry.intern(shape);
+  if (canonical != shape) {
+    m_stats.nReplacedShapes++;
+    account(content.bytes,canonical,GeoShapeUtils::nodeBytes(canonical));
+  }
+  for (const GeoShape* op : content.operands) count(op);
+}
+
+void GeoInternAction::count(const GeoMaterial* material)
+{
+  if (!material || !see(material)) return;
+  m_stats.nMaterials++;
+  const GeoMaterial* canonical = m_registry.intern(material);
+  if (canonical != material) {
+    m_stats.nReplacedMaterials++;
+    account(GeoShapeUtils::nodeBytes(material),canonical,GeoShapeUtils::nodeBytes(canonical));
+  }
+  for (unsigned int i = 0; i < material->getNumElements(); ++i) count(material->getElement(i));
+}
+
+void GeoInternAction::count(const GeoElement* element)
+{
+  if (!element || !see(element)) return;
+  m_stats.nElements++;
+  const GeoElement* canonical = m_registry.intern(element);
+  if (canonical != element) {
+    m_stats.nReplacedElements++;
+    account(GeoShapeUtils::nodeBytes(element),canonical,GeoShapeUtils::nodeBytes(canonical));
+  }
+}
+
+bool GeoInternAction::see(const RCBase* node)
+{
+  if (!m_seen.insert(node).second) return false;
+  node->ref();
+  return true;
+}
+
+void GeoInternAction::account(size_t bytes, const RCBase* canonical, size_t canonicalBytes)
+{
+  m_stats.bytesSaved += bytes;
+  // A canonical instance built for this tree costs memory, once
+  if (m_registry.isRebuilt(canonical) && see(canonical)) m_stats.bytesSaved -= canonicalBytes;
+}
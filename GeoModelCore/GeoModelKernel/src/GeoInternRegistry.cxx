@@ -0,0 +1,260 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoModelKernel/GeoInternRegistry.h"
+#include "GeoModelKernel/GeoContentHash.h"
+#include "GeoModelKernel/GeoShapeShift.h"
+#include "GeoModelKernel/GeoShapeUnion.h"
+#include "GeoModelKernel/GeoShapeSubtraction.h"
+#include "GeoModelKernel/GeoShapeIntersection.h"
+#include "GeoModelKernel/GeoElement.h"
+#include "GeoModelKernel/GeoMaterial.h"
+#include "GeoModelKernel/GeoLogVol.h"
+#include "GeoShapeUtils.h"
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // A copy of a boolean or shifted shape on other operands
+  const GeoShape* rebuild(const GeoShape* shape, const std::vector<const GeoShape*>& ops)
+  {
+    ShapeType type = shape->typeID();
+    if (type == GeoShapeShift::getClassTypeID()) {
+      return new GeoShapeShift(ops[0],static_cast<const GeoShapeShift*>(shape)->getX());
+    }
+    if (type == GeoShapeUnion::getClassTypeID()) return new GeoShapeUnion(ops[0],ops[1]);
+    if (type == GeoShapeSubtraction::getClassTypeID()) return new GeoShapeSubtraction(ops[0],ops[1]);
+    return new GeoShapeIntersection(ops[0],ops[1]);
+  }
+
+  template <class T>
+  void release(std::unordered_map<const T*,size_t>& hashOf)
+  {
+    for (const auto& entry : hashOf) entry.first->unref();
+  }
+}
+
+GeoInternRegistry::GeoInternRegistry()
+{
+}
+
+GeoInternRegistry::~GeoInternRegistry()
+{
+  clear();
+}
+
+template <class T>
+void GeoInternRegistry::insert(Table<T>& table, const T* node, size_t hash)
+{
+  node->ref();
+  table.byHash.emplace(hash,node);
+  table.hashOf.emplace(node,hash);
+}
+
+const GeoShape* GeoInternRegistry::internShape(const GeoShape* shape, size_t& hash)
+{
+  auto known = m_shapes.hashOf.find(shape);
+  if (known != m_shapes.hashOf.end()) {
+    hash = known->second;
+    return shape;
+  }
+
+  GeoShapeUtils::ShapeContent content;
+  GeoShapeUtils::getContent(shape,content);
+  std::vector<const GeoShape*> ops;
+  std::vector<size_t> opHashes;
+  for (const GeoShape* op : content.operands) {
+    size_t opHash;
+    ops.push_back(internShape(op,opHash));
+    opHashes.push_back(opHash);
+  }
+  hash = GeoShapeUtils::hashContent(content,opHashes);
+
+  // Operands are canonical on both sides, so they compare by address
+  GeoShapeUtils::ShapeContent other;
+  auto range = m_shapes.byHash.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    GeoShapeUtils::getContent(it->second,other);
+    if (GeoShapeUtils::sameParameters(content,other) && other.operands == ops) return it->second;
+  }
+
+  const GeoShape* canonical = shape;
+  if (ops != content.operands) {
+    canonical = rebuild(shape,ops);
+    m_rebuilt.insert(canonical);
+  }
+  insert(m_shapes,canonical,hash);
+  return canonical;
+}
+
+const GeoElement* GeoInternRegistry::internElement(const GeoElement* element, size_t& hash)
+{
+  auto known = m_elements.hashOf.find(element);
+  if (known != m_elements.hashOf.end()) {
+    hash = known->second;
+    return element;
+  }
+  hash = GeoContentHash::hash(element);
+  auto range = m_elements.byHash.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (*it->second == *element) return it->second;
+  }
+  insert(m_elements,element,hash);
+  return element;
+}
+
+const GeoMaterial* GeoInternRegistry::internMaterial(const GeoMaterial* material, size_t& hash)
+{
+  auto known = m_materials.hashOf.find(material);
+  if (known != m_materials.hashOf.end()) {
+    hash = known->second;
+    return material;
+  }
+
+  std::vector<const GeoElement*> elements;
+  bool same = true;
+  hash = GeoShapeUtils::hashCombine(std::hash<std::string>()(material->getName()),std::hash<double>()(material->getDensity()));
+  for (unsigned int i = 0; i < material->getNumElements(); ++i) {
+    size_t elementHash;
+    elements.push_back(internElement(material->getElement(i),elementHash));
+    same = same && elements.back() == material->getElement(i);
+    hash = GeoShapeUtils::hashCombine(hash,elementHash);
+    hash = GeoShapeUtils::hashCombine(hash,std::hash<double>()(material->getFraction(i)));
+  }
+
+  auto range = m_materials.byHash.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const GeoMaterial* other = it->second;
+    if (other->getName() != material->getName() || other->getDensity() != material->getDensity()
+	|| other->getNumElements() != elements.size()) continue;
+    bool match = true;
+    for (unsigned int i = 0; match && i < elements.size(); ++i) {
+      match = other->getElement(i) == elements[i] && other->getFraction(i) == material->getFraction(i);
+    }
+    if (match) return other;
+  }
+
+  // A material listing equal elements separately is kept as it is, since
+  // adding the canonical element twice would merge the entries
+  std::vector<const GeoElement*> sorted(elements);
+  std::sort(sorted.begin(),sorted.end());
+  if (std::adjacent_find(sorted.begin(),sorted.end()) != sorted.end()) same = true;
+
+  const GeoMaterial* canonical = material;
+  if (!same) {
+    GeoMaterial* copy = new GeoMaterial(material->getName(),material->getDensity());
+    for (unsigned int i = 0; i < elements.size(); ++i) copy->add(elements[i],material->getFraction(i));
+    copy->lock();
+    canonical = copy;
+    m_rebuilt.insert(canonical);
+  }
+  insert(m_materials,canonical,hash);
+  return canonical;
+}
+
+const GeoShape* GeoInternRegistry::intern(const GeoShape* shape)
+{
+  if (!shape) return shape;
+  std::scoped_lock<std::mutex> lk(m_mutex);
+  size_t hash;
+  return internShape(shape,hash);
+}
+
+const GeoElement* GeoInternRegistry::intern(const GeoElement* element)
+{
+  if (!element) return element;
+  std::scoped_lock<std::mutex> lk(m_mutex);
+  size_t hash;
+  return internElement(element,hash);
+}
+
+const GeoMaterial* GeoInternRegistry::intern(const GeoMaterial* material)
+{
+  if (!material) return material;
+  std::scoped_lock<std::mutex> lk(m_mutex);
+  size_t hash;
+  return internMaterial(material,hash);
+}
+
+const GeoLogVol* GeoInternRegistry::intern(const GeoLogVol* logVol)
+{
+  if (!logVol) return logVol;
+  std::scoped_lock<std::mutex> lk(m_mutex);
+  if (m_logVols.hashOf.count(logVol)) return logVol;
+
+  size_t shapeHash = 0, materialHash = 0;
+  const GeoShape* shape = logVol->getShape() ? internShape(logVol->getShape(),shapeHash) : nullptr;
+  const GeoMaterial* material = logVol->getMaterial() ? internMaterial(logVol->getMaterial(),materialHash) : nullptr;
+  size_t hash = std::hash<std::string>()(logVol->getName());
+  hash = GeoShapeUtils::hashCombine(GeoShapeUtils::hashCombine(hash,shapeHash),materialHash);
+
+  auto range = m_logVols.byHash.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const GeoLogVol* other = it->second;
+    if (other->getShape() == shape && other->getMaterial() == material
+	&& other->getName() == logVol->getName()) return other;
+  }
+
+  const GeoLogVol* canonical = logVol;
+  if (shape != logVol->getShape() || material != logVol->getMaterial()) {
+    canonical = new GeoLogVol(logVol->getName(),shape,material);
+    m_rebuilt.insert(canonical);
+  }
+  insert(m_logVols,canonical,hash);
+  return canonical;
+}
+
+bool GeoInternRegistry::isRebuilt(const RCBase* node) const
+{
+  std::scoped_lock<std::mutex> lk(m_mutex);
+  return m_rebuilt.count(node) != 0;
+}
+
+size_t GeoInternRegistry::getNShapes() const
+{
+  std::scoped_lock<std::mutex> lk(m_mutex);
+  return m_shapes.hashOf.size();
+}
+
+size_t GeoInternRegistry::getNElements() const
+{
+  std::scoped_lock<std::mutex> lk(m_mutex);
+  return m_elements.hashOf.size();
+}
+
+size_t GeoInternRegistry::getNMaterials() const
+{
+  std::scoped_lock<std::mutex> lk(m_mutex);
+  return m_materials.hashOf.size();
+}
+
+size_t GeoInternRegistry::getNLogVols() const
+{
+  std::scoped_lock<std::mutex> lk(m_mutex);
+  return m_logVols.hashOf.size();
+}
+
+void GeoInternRegistry::clear()
+{
+  Table<GeoShape> shapes;
+  Table<GeoElement> elements;
+  Table<GeoMaterial> materials;
+  Table<GeoLogVol> logVols;
+  {
+    std::scoped_lock<std::mutex> lk(m_mutex);
+    std::swap(shapes,m_shapes);
+    std::swap(elements,m_elements);
+    std::swap(materials,m_materials);
+    std::swap(logVols,m_logVols);
+    m_rebuilt.clear();
+  }
+  // Released outside the lock, in case a node goes
+  release(logVols.hashOf);
+  release(materials.hashOf);
+  release(elements.hashOf);
+  release(shapes.hashOf);
+}
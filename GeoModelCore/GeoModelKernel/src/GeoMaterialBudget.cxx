@@ -0,0 +1,376 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoModelKernel/GeoMaterialBudget.h"
+#include "GeoModelKernel/GeoChildVolumeIndex.h"
+#include "GeoModelKernel/GeoLogVol.h"
+#include "GeoModelKernel/GeoMaterial.h"
+#include "GeoModelKernel/GeoElement.h"
+#include "GeoModelKernel/Units.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <unordered_set>
+
+namespace {
+  // The profiles filled for each key
+  enum Kind { ETA_RL, ETA_IL, PHI_RL, PHI_IL, RZ_RL, RZ_IL, XY_RL, XY_IL, N_KINDS };
+
+  // Rays handed to a worker at a time
+  constexpr unsigned long CHUNK_SIZE = 256;
+
+  // Binnings of the geantinoMaps histograms
+  constexpr unsigned int N_ETA_BINS     = 500;
+  constexpr unsigned int N_PHI_BINS     = 500;
+  constexpr unsigned int N_RZ_BINS_Z    = 3000;
+  constexpr unsigned int N_RZ_BINS_R    = 2000;
+  constexpr unsigned int N_MAP_BINS     = 1000;
+
+  // Random numbers in [0,1) which depend only on the seed and on the ray, see splitmix64
+  inline double uniform(unsigned long seed, unsigned long ray, unsigned int which)
+  {
+    uint64_t z = seed*0x9E3779B97F4A7C15ULL + ray*2 + which + 1;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return (z >> 11) * (1.0/9007199254740992.0);
+  }
+}
+
+//
+// Profile
+//
+
+GeoMaterialBudget::Profile::Profile(unsigned int nX, double xMin, double xMax
+				    ,unsigned int nY, double yMin, double yMax)
+  : m_nX(nX)
+  , m_nY(nY)
+  , m_xMin(xMin)
+  , m_xMax(xMax)
+  , m_yMin(yMin)
+  , m_yMax(yMax)
+{
+}
+
+void GeoMaterialBudget::Profile::fill(double x, double value)
+{
+  fill(x,m_yMin,value);
+}
+
+void GeoMaterialBudget::Profile::fill(double x, double y, double value)
+{
+  // Values outside the range are dropped
+  double fx = (x-m_xMin)/(m_xMax-m_xMin)*m_nX;
+  double fy = m_nY==1 ? 0 : (y-m_yMin)/(m_yMax-m_yMin)*m_nY;
+  if (!(fx >= 0 && fx < m_nX && fy >= 0 && fy < m_nY)) return;
+  Bin& bin = m_bins[unsigned(fy)*m_nX + unsigned(fx)];
+  bin.sum += value;
+  bin.entries++;
+}
+
+void GeoMaterialBudget::Profile::merge(const Profile& other)
+{
+  for (const auto& bin : other.m_bins) {
+    Bin& mine = m_bins[bin.first];
+    mine.sum += bin.second.sum;
+    mine.entries += bin.second.entries;
+  }
+}
+
+unsigned long GeoMaterialBudget::Profile::getEntries(unsigned int ix, unsigned int iy) const
+{
+  auto it = m_bins.find(iy*m_nX + ix);
+  return it==m_bins.end() ? 0 : it->second.entries;
+}
+
+double GeoMaterialBudget::Profile::getMean(unsigned int ix, unsigned int iy) const
+{
+  auto it = m_bins.find(iy*m_nX + ix);
+  return it==m_bins.end() ? 0 : it->second.sum/it->second.entries;
+}
+
+void GeoMaterialBudget::Profile::write(std::ostream& out) const
+{
+  std::vector<unsigned int> filled;
+  filled.reserve(m_bins.size());
+  for (const auto& bin : m_bins) filled.push_back(bin.first);
+  std::sort(filled.begin(),filled.end());
+  for (unsigned int index : filled) {
+    const Bin& bin = m_bins.at(index);
+    unsigned int ix = index % m_nX, iy = index / m_nX;
+    out << ix << " " << iy
+	<< " " << m_xMin + (ix+0.5)*(m_xMax-m_xMin)/m_nX
+	<< " " << m_yMin + (iy+0.5)*(m_yMax-m_yMin)/m_nY
+	<< " " << bin.entries << " " << bin.sum/bin.entries << "\n";
+  }
+}
+
+//
+// GeoMaterialBudget
+//
+
+struct GeoMaterialBudget::Worker {
+  /// Thicknesses along the current ray, by key, and the keys which have any.
+  std::vector<Thickness>    sums;
+  std::vector<char>         isTouched;
+  std::vector<unsigned int> touched;
+  std::vector<GeoVolumeBVH::Segment> segments;
+  /// The profiles of this worker, and shortcuts to them by kind and key.
+  Maps                      maps;
+  std::vector<Profile*>     profiles[N_KINDS];
+  Profile*                  etaRadLen = nullptr;
+  Profile*                  etaIntLen = nullptr;
+  Profile*                  rzRadLen  = nullptr;
+  Profile*                  rzIntLen  = nullptr;
+
+  /// Returns a profile of a key, creating it on first use.
+  Profile& profile(Kind kind, unsigned int key, const std::vector<std::string>& keys, const Config& config)
+  {
+    std::vector<Profile*>& byKey = profiles[kind];
+    if (byKey.size() <= key) byKey.resize(keys.size(),nullptr);
+    if (byKey[key]) return *byKey[key];
+
+    const std::string& name = keys[key];
+    Profile eta(N_ETA_BINS,config.etaMin,config.etaMax), phi(N_PHI_BINS,config.phiMin,config.phiMax);
+    Profile rz(N_MAP_BINS,config.zMin,config.zMax,N_MAP_BINS,config.rMin,config.rMax);
+    Profile xy(N_MAP_BINS,config.xMin,config.xMax,N_MAP_BINS,config.yMin,config.yMax);
+    switch (kind) {
+    case ETA_RL: byKey[key] = &maps.emplace(name+"_RL",eta).first->second; break;
+    case ETA_IL: byKey[key] = &maps.emplace(name+"_IL",eta).first->second; break;
+    case PHI_RL: byKey[key] = &maps.emplace(name+"Phi_RL",phi).first->second; break;
+    case PHI_IL: byKey[key] = &maps.emplace(name+"Phi_IL",phi).first->second; break;
+    case RZ_RL:  byKey[key] = &maps.emplace("RZRadLen_"+name,rz).first->second; break;
+    case RZ_IL:  byKey[key] = &maps.emplace("RZIntLen_"+name,rz).first->second; break;
+    case XY_RL:  byKey[key] = &maps.emplace("XYRadLen_"+name,xy).first->second; break;
+    default:     byKey[key] = &maps.emplace("XYIntLen_"+name,xy).first->second; break;
+    }
+    return *byKey[key];
+  }
+};
+
+GeoMaterialBudget::GeoMaterialBudget(PVConstLink world, const GeoVAlignmentStore* store)
+  : m_bvh(world,store)
+{
+  // Precompute the keys and the thicknesses per unit length of every logical volume
+  const double lambda0 = 35*GeoModelKernelUnits::gram/GeoModelKernelUnits::cm2;
+  unsigned int total = getKey("Total_X0");
+
+  std::unordered_set<const GeoVPhysVol*> visited;
+  std::vector<const GeoVPhysVol*> pending(1,&*world);
+  while (!pending.empty()) {
+    const GeoVPhysVol* vol = pending.back();
+    pending.pop_back();
+    if (!visited.insert(vol).second) continue;
+    // A local index, so that the volumes do not keep one each
+    GeoChildVolumeIndex children(vol);
+    unsigned int nChildren = children.getNChildVols();
+    for (unsigned int i = 0; i < nChildren; ++i) pending.push_back(children.getChildVol(i));
+
+    // Volumes without a material add nothing to the budget
+    const GeoLogVol* lv = vol->getLogVol();
+    const GeoMaterial* mat = lv->getMaterial();
+    if (!mat || m_terms.count(lv)) continue;
+    LogVolTerms& terms = m_terms[lv];
+
+    const std::string& matName = mat->getName();
+    std::string detName = lv->getName().substr(0,lv->getName().find("::"));
+    double x0 = mat->getRadLength() ? 100.0/mat->getRadLength() : 0;
+    double lambda = mat->getIntLength() ? 1.0/mat->getIntLength() : 0;
+    // The first three are the keys of the detector and material maps
+    terms.material = { Term{total,x0,lambda}
+		       , Term{getKey("D_"+detName),x0,lambda}
+		       , Term{getKey("M_"+matName),x0,lambda}
+		       , Term{getKey("DM_"+detName+"_"+matName),x0,lambda} };
+
+    // Per element, the terms GeoMaterial::lock() sums into the lengths. E_ keys come first in each triplet
+    for (unsigned int e = 0; e < mat->getNumElements(); ++e) {
+      const GeoElement* element = mat->getElement(e);
+      double n = element->getA() ? GeoModelKernelUnits::Avogadro*mat->getDensity()*mat->getFraction(e)/element->getA() : 0;
+      double elX0 = n*element->getRadTsai()*100.0;
+      double elLambda = n*std::pow(element->getN(),2.0/3.0)*GeoModelKernelUnits::amu/lambda0;
+      const std::string& elName = element->getName();
+      terms.elements.push_back(Term{getKey("E_"+elName),elX0,elLambda});
+      terms.elements.push_back(Term{getKey("ME_"+matName+"_"+elName),elX0,elLambda});
+      terms.elements.push_back(Term{getKey("DE_"+detName+"_"+elName),elX0,elLambda});
+    }
+  }
+}
+
+GeoMaterialBudget::~GeoMaterialBudget()
+{
+}
+
+unsigned int GeoMaterialBudget::getKey(const std::string& name)
+{
+  auto it = m_keyIndex.emplace(name,m_keys.size());
+  if (it.second) m_keys.push_back(name);
+  return it.first->second;
+}
+
+void GeoMaterialBudget::integrate(const GeoTrf::Vector3D& origin
+				  ,const GeoTrf::Vector3D& direction
+				  ,Breakdown& breakdown
+				  ,double tMax) const
+{
+  Worker worker;
+  integrate(origin,direction,tMax,nullptr,worker);
+  for (unsigned int key : worker.touched) {
+    Thickness& thickness = breakdown[m_keys[key]];
+    thickness.x0 += worker.sums[key].x0;
+    thickness.lambda += worker.sums[key].lambda;
+  }
+}
+
+void GeoMaterialBudget::integrate(const GeoTrf::Vector3D& origin
+				  ,const GeoTrf::Vector3D& direction
+				  ,double tMax
+				  ,const Config* config
+				  ,Worker& worker) const
+{
+  if (worker.sums.size() != m_keys.size()) {
+    worker.sums.assign(m_keys.size(),Thickness());
+    worker.isTouched.assign(m_keys.size(),0);
+  }
+  for (unsigned int key : worker.touched) {
+    worker.sums[key] = Thickness();
+    worker.isTouched[key] = 0;
+  }
+  worker.touched.clear();
+
+  auto add = [&worker](const Term& term, double length) {
+    Thickness& sum = worker.sums[term.key];
+    if (!worker.isTouched[term.key]) {
+      worker.isTouched[term.key] = 1;
+      worker.touched.push_back(term.key);
+    }
+    sum.x0 += length*term.x0;
+    sum.lambda += length*term.lambda;
+  };
+
+  auto fillMaps = [&](Kind rz, Kind xy, unsigned int key
+		      ,const GeoTrf::Vector3D& pre, const GeoTrf::Vector3D& post, double value) {
+    Profile& rzProfile = worker.profile(rz,key,m_keys,*config);
+    rzProfile.fill(pre.z(),std::hypot(pre.x(),pre.y()),value);
+    rzProfile.fill(post.z(),std::hypot(post.x(),post.y()),value);
+    Profile& xyProfile = worker.profile(xy,key,m_keys,*config);
+    xyProfile.fill(pre.x(),pre.y(),value);
+    xyProfile.fill(post.x(),post.y(),value);
+  };
+
+  m_bvh.getSegments(origin,direction,worker.segments,tMax);
+  for (const GeoVolumeBVH::Segment& step : worker.segments) {
+    auto it = m_terms.find(step.volume->getLogVol());
+    if (it==m_terms.end()) continue;
+    const LogVolTerms& terms = it->second;
+    double length = step.tOut - step.tIn;
+    GeoTrf::Vector3D pre = origin + step.tIn*direction, post = origin + step.tOut*direction;
+    double rPre = std::hypot(pre.x(),pre.y());
+
+    // Like the geantino maps, count the steps which start in the window
+    if (!config || (pre.z() >= config->zMin && pre.z() <= config->zMax && rPre >= config->rMin && rPre <= config->rMax)) {
+      for (const Term& term : terms.material) add(term,length);
+      for (const Term& term : terms.elements) add(term,length);
+    }
+    if (!config) continue;
+
+    // But fill the position maps with every step
+    const Term& total = terms.material[0];
+    worker.rzRadLen->fill(pre.z(),rPre,length*total.x0);
+    worker.rzRadLen->fill(post.z(),std::hypot(post.x(),post.y()),length*total.x0);
+    worker.rzIntLen->fill(pre.z(),rPre,length*total.lambda);
+    worker.rzIntLen->fill(post.z(),std::hypot(post.x(),post.y()),length*total.lambda);
+    if (config->detectorsMaps || config->materialsMaps) {
+      for (unsigned int i = 0; i < 3; ++i) {
+	const Term& term = terms.material[i];
+	fillMaps(RZ_RL,XY_RL,term.key,pre,post,length*term.x0);
+	fillMaps(RZ_IL,XY_IL,term.key,pre,post,length*term.lambda);
+      }
+    }
+    if (config->elementsMaps) {
+      for (unsigned int i = 0; i < terms.elements.size(); i += 3) {
+	const Term& term = terms.elements[i];
+	fillMaps(RZ_RL,XY_RL,term.key,pre,post,length*term.x0);
+	fillMaps(RZ_IL,XY_IL,term.key,pre,post,length*term.lambda);
+      }
+    }
+  }
+}
+
+GeoMaterialBudget::Maps GeoMaterialBudget::scan(const Config& config) const
+{
+  Maps result;
+  std::mutex resultMutex;
+  std::atomic<unsigned long> next(0);
+  std::exception_ptr error;
+  unsigned long nChunks = (config.nRays + CHUNK_SIZE - 1)/CHUNK_SIZE;
+
+  auto worker = [&]() {
+    try {
+      Worker w;
+      w.etaRadLen = &w.maps.emplace("etaRadLen",Profile(N_ETA_BINS,config.etaMin,config.etaMax)).first->second;
+      w.etaIntLen = &w.maps.emplace("etaIntLen",Profile(N_ETA_BINS,config.etaMin,config.etaMax)).first->second;
+      w.rzRadLen = &w.maps.emplace("RZRadLen",Profile(N_RZ_BINS_Z,config.zMin,config.zMax,N_RZ_BINS_R,config.rMin,config.rMax)).first->second;
+      w.rzIntLen = &w.maps.emplace("RZIntLen",Profile(N_RZ_BINS_Z,config.zMin,config.zMax,N_RZ_BINS_R,config.rMin,config.rMax)).first->second;
+
+      for (unsigned long chunk = next++; chunk < nChunks; chunk = next++) {
+	unsigned long end = std::min(config.nRays,(chunk+1)*CHUNK_SIZE);
+	for (unsigned long ray = chunk*CHUNK_SIZE; ray < end; ++ray) {
+	  double eta = config.etaMin + (config.etaMax-config.etaMin)*uniform(config.seed,ray,0);
+	  double phi = config.phiMin + (config.phiMax-config.phiMin)*uniform(config.seed,ray,1);
+	  double theta = 2.0*std::atan(std::exp(-eta));
+	  GeoTrf::Vector3D direction(std::sin(theta)*std::cos(phi),std::sin(theta)*std::sin(phi),std::cos(theta));
+	  integrate(config.vertex,direction,HUGE_VAL,&config,w);
+
+	  // Totals per ray, like at the end of a geantino event
+	  const Thickness& total = w.sums[0];
+	  if (w.touched.empty()) continue;
+	  w.etaRadLen->fill(eta,total.x0);
+	  w.etaIntLen->fill(eta,total.lambda);
+	  if (!config.etaPhiMaps) continue;
+	  for (unsigned int key : w.touched) {
+	    const Thickness& sum = w.sums[key];
+	    w.profile(ETA_RL,key,m_keys,config).fill(eta,sum.x0);
+	    w.profile(ETA_IL,key,m_keys,config).fill(eta,sum.lambda);
+	    w.profile(PHI_RL,key,m_keys,config).fill(phi,sum.x0);
+	    w.profile(PHI_IL,key,m_keys,config).fill(phi,sum.lambda);
+	  }
+	}
+      }
+
+      std::scoped_lock<std::mutex> lk(resultMutex);
+      for (auto& profile : w.maps) {
+	auto it = result.find(profile.first);
+	if (it==result.end()) result.emplace(profile.first,std::move(profile.second));
+	else it->second.merge(profile.second);
+      }
+    }
+    catch(...) {
+      std::scoped_lock<std::mutex> lk(resultMutex);
+      if (!error) error = std::current_exception();
+      next = nChunks;
+    }
+  };
+
+  unsigned int nThreads = config.nThreads ? config.nThreads : std::max(1u,std::thread::hardware_concurrency());
+  nThreads = std::min<unsigned long>(nThreads,std::max(1ul,nChunks));
+  std::vector<std::thread> pool;
+  for (unsigned int t = 1; t < nThreads; ++t) pool.emplace_back(worker);
+  worker();
+  for (std::thread& thread : pool) thread.join();
+
+  if (error) std::rethrow_exception(error);
+  return result;
+}
+
+void GeoMaterialBudget::write(const Maps& maps, std::ostream& out)
+{
+  for (const auto& profile : maps) {
+    out << "# " << profile.first << "\n";
+    profile.second.write(out);
+  }
+}
@@ -0,0 +1,107 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoModelKernel/GeoMaterialRegistry.h"
+#include "GeoModelKernel/GeoMaterial.h"
+#include "GeoModelKernel/GeoLogVol.h"
+#include "GeoModelKernel/GeoSerialTransformer.h"
+#include <stdexcept>
+#include <unordered_set>
+
+GeoMaterialRegistry::GeoMaterialRegistry()
+  : m_firstElement(1,0)
+{
+}
+
+GeoMaterialRegistry::GeoMaterialRegistry(PVConstLink top)
+  : m_firstElement(1,0)
+{
+  addTree(top);
+}
+
+GeoMaterialRegistry::~GeoMaterialRegistry()
+{
+  for (const GeoMaterial* material : m_materials) material->unref();
+  for (const auto& logVol : m_logVolId) logVol.first->unref();
+}
+
+unsigned int GeoMaterialRegistry::add(const GeoMaterial* material)
+{
+  if (!material) throw std::runtime_error("GeoMaterialRegistry::add(). Null material");
+  auto found = m_materialId.find(material);
+  if (found != m_materialId.end()) return found->second;
+
+  // Read everything first: an unlocked material throws, leaving the registry as it was
+  unsigned int nElements = material->getNumElements();
+  double radLength = material->getRadLength();
+  double intLength = material->getIntLength();
+  double deDxConstant = material->getDeDxConstant();
+  double deDxI0 = material->getDeDxI0();
+
+  unsigned int id = m_materials.size();
+  material->ref();
+  m_materials.push_back(material);
+  m_materialId.emplace(material,id);
+  m_density.push_back(material->getDensity());
+  m_radLength.push_back(radLength);
+  m_intLength.push_back(intLength);
+  m_deDxConstant.push_back(deDxConstant);
+  m_deDxI0.push_back(deDxI0);
+  for (unsigned int i = 0; i < nElements; ++i) {
+    const GeoElement* element = material->getElement(i);
+    m_elementZ.push_back(element->getZ());
+    m_elementA.push_back(element->getA());
+    m_elementFraction.push_back(material->getFraction(i));
+  }
+  m_firstElement.push_back(m_elementZ.size());
+  return id;
+}
+
+unsigned int GeoMaterialRegistry::add(const GeoLogVol* logVol)
+{
+  auto found = m_logVolId.find(logVol);
+  if (found != m_logVolId.end()) return found->second;
+
+  if (!logVol->getMaterial()) {
+    throw std::runtime_error("GeoMaterialRegistry::add(). Logical volume " + logVol->getName() + " has no material");
+  }
+  unsigned int id = add(logVol->getMaterial());
+  logVol->ref();
+  m_logVolId.emplace(logVol,id);
+  return id;
+}
+
+void GeoMaterialRegistry::addTree(PVConstLink top)
+{
+  // Shared volumes are visited once
+  std::unordered_set<const GeoVPhysVol*> seen;
+  std::vector<const GeoVPhysVol*> stack{&*top};
+  while (!stack.empty()) {
+    const GeoVPhysVol* vol = stack.back();
+    stack.pop_back();
+    if (!seen.insert(vol).second) continue;
+    if (vol->getLogVol()) add(vol->getLogVol());
+    for (unsigned int i = vol->getNChildNodes(); i-- > 0;) {
+      const GeoGraphNode* node = *vol->getChildNode(i);
+      if (const GeoVPhysVol* child = dynamic_cast<const GeoVPhysVol*>(node)) {
+	stack.push_back(child);
+      }
+      else if (const GeoSerialTransformer* sT = dynamic_cast<const GeoSerialTransformer*>(node)) {
+	stack.push_back(&*sT->getVolume());
+      }
+    }
+  }
+}
+
+unsigned int GeoMaterialRegistry::getId(const GeoMaterial* material) const
+{
+  auto found = m_materialId.find(material);
+  return found == m_materialId.end() ? NONE : found->second;
+}
+
+unsigned int GeoMaterialRegistry::getId(const GeoLogVol* logVol) const
+{
+  auto found = m_logVolId.find(logVol);
+  return found == m_logVolId.end() ? NONE : found->second;
+}
@@ -0,0 +1,304 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoModelKernel/GeoMemoryAccountAction.h"
+#include "GeoModelKernel/GeoPhysVol.h"
+#include "GeoModelKernel/GeoFullPhysVol.h"
+#include "GeoModelKernel/GeoAlignableTransform.h"
+#include "GeoModelKernel/GeoNameTag.h"
+#include "GeoModelKernel/GeoIdentifierTag.h"
+#include "GeoModelKernel/GeoSerialDenominator.h"
+#include "GeoModelKernel/GeoSerialIdentifier.h"
+#include "GeoModelKernel/GeoSerialTransformer.h"
+#include "GeoModelKernel/GeoLogVol.h"
+#include "GeoModelKernel/GeoMaterial.h"
+#include "GeoModelKernel/GeoXF.h"
+#include "GeoGenericFunctions/Variable.h"
+#include "GeoShapeUtils.h"
+#include <cstdio>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+
+  size_t transformBytes(const GeoTransform* xform, size_t size)
+  {
+    // General rotations are kept in a matrix on the heap
+    return size + (xform->getKind() == GeoTransform::GENERAL ? 9*sizeof(double) : 0);
+  }
+
+  void writeString(std::ostream& out, const std::string& s)
+  {
+    out << '"';
+    for (char c : s) {
+      if (c == '"' || c == '\\') {
+	out << '\\' << c;
+      }
+      else if (static_cast<unsigned char>(c) < 0x20) {
+	char buffer[8];
+	std::snprintf(buffer,sizeof(buffer),"\\u%04x",static_cast<unsigned int>(c));
+	out << buffer;
+      }
+      else {
+	out << c;
+      }
+    }
+    out << '"';
+  }
+
+  void writeUsage(std::ostream& out, const GeoMemoryAccountAction::Usage& usage)
+  {
+    out << "\"count\": " << usage.count << ", \"bytes\": " << usage.bytes;
+  }
+
+  void writeUsageMap(std::ostream& out, const std::map<std::string,GeoMemoryAccountAction::Usage>& usages)
+  {
+    out << "{";
+    const char* separator = "\n";
+    for (const auto& usage : usages) {
+      out << separator << "    ";
+      writeString(out,usage.first);
+      out << ": {";
+      writeUsage(out,usage.second);
+      out << "}";
+      separator = ",\n";
+    }
+    out << "\n  }";
+  }
+}
+
+GeoMemoryAccountAction::GeoMemoryAccountAction()
+  : m_multiplicity(1)
+{
+}
+
+GeoMemoryAccountAction::~GeoMemoryAccountAction()
+{
+}
+
+void GeoMemoryAccountAction::handleTransform(const GeoTransform *xform)
+{
+  if (dynamic_cast<const GeoAlignableTransform*>(xform)) {
+    account(xform,"GeoAlignableTransform",transformBytes(xform,sizeof(GeoAlignableTransform)));
+  }
+  else {
+    account(xform,"GeoTransform",transformBytes(xform,sizeof(GeoTransform)));
+  }
+}
+
+void GeoMemoryAccountAction::handlePhysVol(const GeoPhysVol *vol)
+{
+  if (!accountVolume(vol,"GeoPhysVol",sizeof(GeoPhysVol) + vol->getNChildNodes()*sizeof(const GeoGraphNode*))) return;
+  accountCache("GeoChildVolumeIndex",vol->getChildVolumeIndexBytes());
+}
+
+void GeoMemoryAccountAction::handleFullPhysVol(const GeoFullPhysVol *vol)
+{
+  if (!accountVolume(vol,"GeoFullPhysVol",sizeof(GeoFullPhysVol) + vol->getNChildNodes()*sizeof(const GeoGraphNode*))) return;
+  accountCache("GeoChildVolumeIndex",vol->getChildVolumeIndexBytes());
+  accountCache("GeoFullPhysVol position",vol->getPositionInfoBytes());
+}
+
+void GeoMemoryAccountAction::handleNameTag(const GeoNameTag *nameTag)
+{
+  account(nameTag,"GeoNameTag",sizeof(GeoNameTag) + GeoShapeUtils::heapBytes(nameTag->getName()));
+}
+
+void GeoMemoryAccountAction::handleSerialDenominator(const GeoSerialDenominator *sD)
+{
+  account(sD,"GeoSerialDenominator",sizeof(GeoSerialDenominator) + GeoShapeUtils::heapBytes(sD->getBaseName()));
+}
+
+void GeoMemoryAccountAction::handleSerialTransformer(const GeoSerialTransformer *sT)
+{
+  if (account(sT,"GeoSerialTransformer",sizeof(GeoSerialTransformer))) {
+    accountFunction(sT->getFunction());
+    accountCache("GeoSerialTransformer table",sT->getTableBytes());
+  }
+  // The volume replicated is not a child of the serial transformer
+  unsigned long multiplicity = m_multiplicity;
+  m_multiplicity *= sT->getNCopies();
+  sT->getVolume()->exec(this);
+  m_multiplicity = multiplicity;
+}
+
+void GeoMemoryAccountAction::handleIdentifierTag(const GeoIdentifierTag *idTag)
+{
+  account(idTag,"GeoIdentifierTag",sizeof(GeoIdentifierTag));
+}
+
+void GeoMemoryAccountAction::handleSerialIdentifier(const GeoSerialIdentifier *sI)
+{
+  account(sI,"GeoSerialIdentifier",sizeof(GeoSerialIdentifier));
+}
+
+bool GeoMemoryAccountAction::account(const void* node, const char* className, size_t bytes)
+{
+  if (!m_seen.insert(node).second) return false;
+  m_total.count++;
+  m_total.bytes += bytes;
+  Usage& usage = m_classes[className];
+  usage.count++;
+  usage.bytes += bytes;
+  if (SubtreeUsage* subtree = currentSubtree()) {
+    subtree->usage.count++;
+    subtree->usage.bytes += bytes;
+  }
+  return true;
+}
+
+GeoMemoryAccountAction::SubtreeUsage* GeoMemoryAccountAction::currentSubtree()
+{
+  // The path starts with the top volume
+  const GeoNodePath* path = getPath();
+  if (path->getLength() < 2) return nullptr;
+  const GeoVPhysVol* root = path->getItem(1);
+  auto index = m_subtreeIndex.emplace(root,m_subtrees.size());
+  if (index.second) m_subtrees.push_back(SubtreeUsage{root,Usage()});
+  return &m_subtrees[index.first->second];
+}
+
+void GeoMemoryAccountAction::accountCache(const char* kind, size_t bytes)
+{
+  if (!bytes) return;
+  Usage& usage = m_caches[kind];
+  usage.count++;
+  usage.bytes += bytes;
+}
+
+bool GeoMemoryAccountAction::accountVolume(const GeoVPhysVol* vol, const char* className, size_t bytes)
+{
+  bool first = account(vol,className,bytes);
+  const GeoLogVol* logVol = vol->getLogVol();
+  if (!logVol) return first;
+
+  auto index = m_logVolIndex.emplace(logVol,m_logVols.size());
+  if (index.second) {
+    m_logVols.push_back(LogVolSharing{logVol});
+    account(logVol,"GeoLogVol",GeoShapeUtils::nodeBytes(logVol));
+    if (logVol->getShape()) accountShape(logVol->getShape());
+    if (logVol->getMaterial()) accountMaterial(logVol->getMaterial());
+  }
+  LogVolSharing& sharing = m_logVols[index.first->second];
+  if (first) sharing.volumes++;
+  sharing.placements += m_multiplicity;
+  return first;
+}
+
+void GeoMemoryAccountAction::accountFunction(const GeoXF::Function* function)
+{
+  if (const GeoXF::Pow* pow = dynamic_cast<const GeoXF::Pow*>(function)) {
+    if (!account(pow,"GeoXF::Function",sizeof(GeoXF::Pow))) return;
+    // Only the outermost object of a generic function is known
+    const GeoGenfun::AbsFunction* exponent = pow->function();
+    account(exponent,"GeoGenfun::AbsFunction",dynamic_cast<const GeoGenfun::Variable*>(exponent) ? sizeof(GeoGenfun::Variable) : sizeof(GeoGenfun::AbsFunction));
+  }
+  else if (const GeoXF::Product* product = dynamic_cast<const GeoXF::Product*>(function)) {
+    if (!account(product,"GeoXF::Function",sizeof(GeoXF::Product))) return;
+    accountFunction(product->arg1());
+    accountFunction(product->arg2());
+  }
+  else if (const GeoXF::PreMult* preMult = dynamic_cast<const GeoXF::PreMult*>(function)) {
+    if (!account(preMult,"GeoXF::Function",sizeof(GeoXF::PreMult))) return;
+    accountFunction(preMult->arg2());
+  }
+  else if (const GeoXF::PostMult* postMult = dynamic_cast<const GeoXF::PostMult*>(function)) {
+    if (!account(postMult,"GeoXF::Function",sizeof(GeoXF::PostMult))) return;
+    accountFunction(postMult->arg1());
+  }
+  else if (function) {
+    // A function type unknown to the kernel: only its base is known
+    account(function,"GeoXF::Function",sizeof(GeoXF::Function));
+  }
+}
+
+void GeoMemoryAccountAction::accountShape(const GeoShape* shape)
+{
+  auto index = m_shapeIndex.emplace(shape,m_shapes.size());
+  if (!index.second) {
+    m_shapes[index.first->second].users++;
+    return;
+  }
+
+  GeoShapeUtils::ShapeContent content;
+  try {
+    GeoShapeUtils::getContent(shape,content);
+  }
+  catch (const std::runtime_error&) {
+    // A shape type unknown to the kernel: only its base is known
+    content.bytes = sizeof(GeoShape);
+  }
+  m_shapes.push_back(ShapeSharing{shape,1,content.bytes});
+  account(shape,"GeoShape",content.bytes);
+  Usage& usage = m_shapeTypes[shape->type()];
+  usage.count++;
+  usage.bytes += content.bytes;
+  for (const GeoShape* operand : content.operands) accountShape(operand);
+}
+
+void GeoMemoryAccountAction::accountMaterial(const GeoMaterial* material)
+{
+  size_t bytes;
+  unsigned int nElements;
+  try {
+    bytes = GeoShapeUtils::nodeBytes(material);
+    nElements = material->getNumElements();
+  }
+  catch (const std::out_of_range&) {
+    // Not locked: its elements cannot be listed
+    bytes = sizeof(GeoMaterial) + GeoShapeUtils::heapBytes(material->getName());
+    nElements = 0;
+  }
+  if (!account(material,"GeoMaterial",bytes)) return;
+  for (unsigned int i = 0; i < nElements; ++i) accountElement(material->getElement(i));
+}
+
+void GeoMemoryAccountAction::accountElement(const GeoElement* element)
+{
+  account(element,"GeoElement",GeoShapeUtils::nodeBytes(element));
+}
+
+void GeoMemoryAccountAction::writeJSON(std::ostream& out) const
+{
+  out << "{\n  \"total\": {";
+  writeUsage(out,m_total);
+  out << "},\n  \"classes\": ";
+  writeUsageMap(out,m_classes);
+  out << ",\n  \"shapeTypes\": ";
+  writeUsageMap(out,m_shapeTypes);
+  out << ",\n  \"caches\": ";
+  writeUsageMap(out,m_caches);
+
+  out << ",\n  \"subtrees\": [";
+  const char* separator = "\n";
+  for (const SubtreeUsage& subtree : m_subtrees) {
+    out << separator << "    {\"name\": ";
+    writeString(out,subtree.volume->getLogVol() ? subtree.volume->getLogVol()->getName() : std::string());
+    out << ", ";
+    writeUsage(out,subtree.usage);
+    out << "}";
+    separator = ",\n";
+  }
+
+  out << "\n  ],\n  \"logVols\": [";
+  separator = "\n";
+  for (const LogVolSharing& sharing : m_logVols) {
+    out << separator << "    {\"name\": ";
+    writeString(out,sharing.logVol->getName());
+    out << ", \"volumes\": " << sharing.volumes
+	<< ", \"placements\": " << sharing.placements
+	<< ", \"bytes\": " << GeoShapeUtils::nodeBytes(sharing.logVol) << "}";
+    separator = ",\n";
+  }
+
+  out << "\n  ],\n  \"shapes\": [";
+  separator = "\n";
+  for (const ShapeSharing& sharing : m_shapes) {
+    out << separator << "    {\"type\": ";
+    writeString(out,sharing.shape->type());
+    out << ", \"users\": " << sharing.users << ", \"bytes\": " << sharing.bytes << "}";
+    separator = ",\n";
+  }
+  out << "\n  ]\n}\n";
+}
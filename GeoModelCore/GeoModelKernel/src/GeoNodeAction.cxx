@@ -80,3 +80,12 @@ void GeoNodeAction::handleIdentifierTag (const GeoIdentifierTag *)
 void GeoNodeAction::handleSerialIdentifier(const GeoSerialIdentifier *)
 {
 }
+
+GeoNodeAction* GeoNodeAction::clone () const
+{
+  return nullptr;
+}
+
+void GeoNodeAction::merge (const GeoNodeAction &)
+{
+}
@@ -6,6 +6,7 @@
 #include "GeoModelKernel/GeoDefinitions.h"
 #include "GeoModelKernel/GeoShapeAction.h"
 #include "GeoModelKernel/GeoPara.h"
+#include "GeoShapeUtils.h"
 
 const std::string GeoPara::s_classType = "Para";
 const ShapeType GeoPara::s_classTypeID = 0x12;
@@ -42,3 +43,71 @@ void GeoPara::exec (GeoShapeAction *action) const
 	action->handlePara(this);
 }
 
+
+GeoShape::Location GeoPara::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  return GeoShapeUtils::classify(distance(p), tolerance);
+}
+
+void GeoPara::inside (size_t n, const double *x, const double *y, const double *z
+		      , Location *result, double tolerance) const
+{
+  // The shear and the norms of the face normals, see distance(), are the same for all the points
+  const double tAlpha = std::tan(m_alpha);
+  const double tx = std::tan(m_theta) * std::cos(m_phi), ty = std::tan(m_theta) * std::sin(m_phi);
+  const double nu = 1.0 / std::sqrt(1.0 + tAlpha * tAlpha + std::pow(tAlpha * ty - tx, 2));
+  const double nv = 1.0 / std::sqrt(1.0 + ty * ty);
+  for (size_t i = 0; i < n; ++i) {
+    double v = y[i] - z[i] * ty;
+    double u = x[i] - v * tAlpha - z[i] * tx;
+    double du = (std::abs(u) - m_xHalfLength) * nu;
+    double dv = (std::abs(v) - m_yHalfLength) * nv;
+    result[i] = GeoShapeUtils::classify(std::max(std::max(du, dv), std::abs(z[i]) - m_zHalfLength), tolerance);
+  }
+}
+
+void GeoPara::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+			       , RayIntervals &intervals) const
+{
+  // The sheared coordinates u and v (see distance()) are linear in the point
+  double tAlpha = std::tan(m_alpha);
+  double tx = std::tan(m_theta) * std::cos(m_phi), ty = std::tan(m_theta) * std::sin(m_phi);
+  GeoTrf::Vector3D nu(1, -tAlpha, tAlpha * ty - tx), nv(0, 1, -ty);
+  RayIntervals side;
+  GeoShapeUtils::slabIntervals(p.z(), v.z(), -m_zHalfLength, m_zHalfLength, intervals);
+  GeoShapeUtils::slabIntervals(nu.dot(p), nu.dot(v), -m_xHalfLength, m_xHalfLength, side);
+  GeoShapeUtils::intersectIntervals(intervals, side, intervals);
+  GeoShapeUtils::slabIntervals(nv.dot(p), nv.dot(v), -m_yHalfLength, m_yHalfLength, side);
+  GeoShapeUtils::intersectIntervals(intervals, side, intervals);
+}
+
+double GeoPara::safety (const GeoTrf::Vector3D &p) const
+{
+  return std::abs(distance(p));
+}
+
+double GeoPara::distance (const GeoTrf::Vector3D &p) const
+{
+  // Undo the shear.  The faces are the planes u=+-dx, v=+-dy and z=+-dz, where
+  //   v = y - z tan(theta) sin(phi)
+  //   u = x - v tan(alpha) - z tan(theta) cos(phi)
+  double tAlpha = std::tan(m_alpha);
+  double tx = std::tan(m_theta) * std::cos(m_phi), ty = std::tan(m_theta) * std::sin(m_phi);
+  double v = p.y() - p.z() * ty;
+  double u = p.x() - v * tAlpha - p.z() * tx;
+  double du = (std::abs(u) - m_xHalfLength) / std::sqrt(1.0 + tAlpha * tAlpha + std::pow(tAlpha * ty - tx, 2));
+  double dv = (std::abs(v) - m_yHalfLength) / std::sqrt(1.0 + ty * ty);
+  return std::max(std::max(du, dv), std::abs(p.z()) - m_zHalfLength);
+}
+
+void GeoPara::computeExtent (double &xmin, double &ymin, double &zmin
+			   , double &xmax, double &ymax, double &zmax) const
+{
+  double tAlpha = std::tan(m_alpha);
+  double tx = std::tan(m_theta) * std::cos(m_phi), ty = std::tan(m_theta) * std::sin(m_phi);
+  // The extreme corners, see inside()
+  xmax = m_xHalfLength + std::abs(m_yHalfLength * tAlpha) + std::abs(m_zHalfLength * tx);
+  ymax = m_yHalfLength + std::abs(m_zHalfLength * ty);
+  zmax = m_zHalfLength;
+  xmin = -xmax; ymin = -ymax; zmin = -zmax;
+}
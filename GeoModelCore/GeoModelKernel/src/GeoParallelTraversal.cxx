@@ -0,0 +1,142 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoModelKernel/GeoParallelTraversal.h"
+#include "GeoModelKernel/GeoNodeAction.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+  // A run of consecutive child nodes of a volume, ending with at most one
+  // volume or serial transformer, or the top volume itself.
+  struct Task {
+    /// The ancestors of the nodes, from the top volume to their parent.
+    std::vector<const GeoVPhysVol*> path;
+    /// The parent, or nullptr for the top volume.
+    const GeoVPhysVol* parent;
+    unsigned int first;
+    unsigned int last;
+    /// False for a volume above the split depth, visited without its children.
+    bool descend;
+  };
+
+  class TaskBuilder
+  {
+  public:
+    TaskBuilder(std::vector<Task>& tasks, const Query<unsigned int>& depthLimit, unsigned int splitDepth)
+      : m_tasks(tasks)
+      , m_depthLimit(depthLimit)
+      , m_splitDepth(splitDepth)
+    {
+    }
+
+    // Divides the children of a volume at a given depth into tasks.  The
+    // path holds the volume and its ancestors.
+    void split(std::vector<const GeoVPhysVol*>& path, unsigned int depth)
+    {
+      const GeoVPhysVol* vol = path.back();
+      if(m_depthLimit.isValid() && depth+1 > m_depthLimit) return;
+
+      unsigned int nNodes = vol->getNChildNodes();
+      unsigned int first = 0;
+      for(unsigned int i = 0; i < nNodes; ++i) {
+	const GeoGraphNode* node = *vol->getChildNode(i);
+	const GeoVPhysVol* child = dynamic_cast<const GeoVPhysVol*>(node);
+	if(child && depth+1 < m_splitDepth) {
+	  m_tasks.push_back(Task{path,vol,first,i,false});
+	  path.push_back(child);
+	  split(path,depth+1);
+	  path.pop_back();
+	  first = i+1;
+	}
+	else if(child || dynamic_cast<const GeoSerialTransformer*>(node)) {
+	  m_tasks.push_back(Task{path,vol,first,i,true});
+	  first = i+1;
+	}
+      }
+      if(first < nNodes) m_tasks.push_back(Task{path,vol,first,nNodes-1,true});
+    }
+
+  private:
+    std::vector<Task>&         m_tasks;
+    const Query<unsigned int>  m_depthLimit;
+    unsigned int               m_splitDepth;
+  };
+}
+
+void GeoParallelTraversal::exec(PVConstLink top
+				,GeoNodeAction* action
+				,unsigned int nThreads
+				,unsigned int splitDepth)
+{
+  // The clone of the first task tells whether the action can be cloned
+  std::unique_ptr<GeoNodeAction> firstClone(action->clone());
+  if(!firstClone) throw std::runtime_error("GeoParallelTraversal::exec(). The action cannot be cloned, it must be executed serially");
+
+  const Query<unsigned int> depthLimit = action->getDepthLimit();
+  if(splitDepth==0) {
+    top->exec(action);
+    return;
+  }
+
+  //
+  // Divide the graph into tasks, in the order of a serial traversal
+  //
+  std::vector<Task> tasks;
+  tasks.push_back(Task{{},nullptr,0,0,false});
+  std::vector<const GeoVPhysVol*> path(1,&*top);
+  TaskBuilder(tasks,depthLimit,splitDepth).split(path,0);
+
+  if(nThreads==0) nThreads = std::max(1u,std::thread::hardware_concurrency());
+  nThreads = std::min<size_t>(nThreads,tasks.size());
+
+  // One clone per task, to be merged in order
+  std::vector<std::unique_ptr<GeoNodeAction>> clones(tasks.size());
+  clones[0] = std::move(firstClone);
+  std::atomic<size_t> next(0);
+  std::exception_ptr error;
+  std::mutex errorMutex;
+
+  auto worker = [&]() {
+    try {
+      for(size_t t = next++; t < tasks.size(); t = next++) {
+	const Task& task = tasks[t];
+	if(!clones[t]) clones[t].reset(action->clone());
+	GeoNodeAction* clone = clones[t].get();
+	if(!task.descend) clone->setDepthLimit(task.path.size());
+	else if(depthLimit.isValid()) clone->setDepthLimit(depthLimit);
+	else clone->clearDepthLimit();
+
+	for(const GeoVPhysVol* vol : task.path) clone->getPath()->push(vol);
+	if(!task.parent) {
+	  top->exec(clone);
+	  continue;
+	}
+	for(unsigned int i = task.first; i <= task.last && !clone->shouldTerminate(); ++i) {
+	  (*task.parent->getChildNode(i))->exec(clone);
+	}
+      }
+    }
+    catch(...) {
+      std::scoped_lock<std::mutex> lk(errorMutex);
+      if(!error) error = std::current_exception();
+      next = tasks.size();
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for(unsigned int t = 1; t < nThreads; ++t) pool.emplace_back(worker);
+  worker();
+  for(std::thread& thread : pool) thread.join();
+
+  if(error) std::rethrow_exception(error);
+  for(const std::unique_ptr<GeoNodeAction>& clone : clones) action->merge(*clone);
+}
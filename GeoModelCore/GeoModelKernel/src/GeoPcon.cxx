@@ -6,6 +6,8 @@
 #include "GeoModelKernel/GeoShapeAction.h"
 #include <cmath>
 #include <stdexcept>
+#include "GeoShapeUtils.h"
+#include <algorithm>
 
 const std::string GeoPcon::s_classType = "Pcon";
 const ShapeType GeoPcon::s_classTypeID = 0x13;
@@ -55,6 +57,7 @@ void GeoPcon::addPlane (double ZPlane, double RMinPlane, double RMaxPlane)
   m_zPlane.push_back (ZPlane);
   m_rMinPlane.push_back (RMinPlane);
   m_rMaxPlane.push_back (RMaxPlane);
+  invalidateExtent ();
 }
 
 void GeoPcon::exec (GeoShapeAction *action) const
@@ -62,3 +65,95 @@ void GeoPcon::exec (GeoShapeAction *action) const
   action->handlePcon(this);
 }
 
+
+GeoShape::Location GeoPcon::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  if (!isValid())
+    throw std::runtime_error ("Point classification requested for incomplete polycone");
+  double rho = std::hypot(p.x(), p.y());
+  GeoShapeUtils::SliceUnion slices;
+  for (size_t k = 0; k + 1 < m_zPlane.size(); ++k) {
+    size_t lo = k, hi = k + 1;
+    if (m_zPlane[lo] > m_zPlane[hi]) std::swap(lo, hi);
+    double dz = m_zPlane[hi] - m_zPlane[lo];
+    if (dz <= 0 || p.z() < m_zPlane[lo] - tolerance || p.z() > m_zPlane[hi] + tolerance) continue;
+
+    double t = std::min(1.0, std::max(0.0, (p.z() - m_zPlane[lo]) / dz));
+    double rMax = m_rMaxPlane[lo] + (m_rMaxPlane[hi] - m_rMaxPlane[lo]) * t;
+    double dRadial = (rho - rMax) / std::hypot(1.0, (m_rMaxPlane[hi] - m_rMaxPlane[lo]) / dz);
+    if (m_rMinPlane[lo] > 0 || m_rMinPlane[hi] > 0) {
+      double rMin = m_rMinPlane[lo] + (m_rMinPlane[hi] - m_rMinPlane[lo]) * t;
+      dRadial = std::max(dRadial, (rMin - rho) / std::hypot(1.0, (m_rMinPlane[hi] - m_rMinPlane[lo]) / dz));
+    }
+    slices.add(dRadial, m_zPlane[lo] - p.z(), p.z() - m_zPlane[hi], tolerance);
+  }
+  return GeoShapeUtils::intersectPhi(slices.location(), p.x(), p.y(), m_sPhi, m_dPhi, tolerance);
+}
+
+void GeoPcon::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+			       , RayIntervals &intervals) const
+{
+  if (!isValid())
+    throw std::runtime_error ("Ray intersection requested for incomplete polycone");
+  // Union of the sections, each one a hollow cone between two planes
+  RayIntervals section, other;
+  intervals.clear();
+  for (size_t k = 0; k + 1 < m_zPlane.size(); ++k) {
+    size_t lo = k, hi = k + 1;
+    if (m_zPlane[lo] > m_zPlane[hi]) std::swap(lo, hi);
+    double dz = m_zPlane[hi] - m_zPlane[lo];
+    if (dz <= 0) continue;
+
+    GeoShapeUtils::slabIntervals(p.z(), v.z(), m_zPlane[lo], m_zPlane[hi], section);
+    double slope = (m_rMaxPlane[hi] - m_rMaxPlane[lo]) / dz;
+    GeoShapeUtils::coneIntervals(p, v, m_rMaxPlane[lo] - slope * m_zPlane[lo], slope, other);
+    GeoShapeUtils::intersectIntervals(section, other, section);
+    if (m_rMinPlane[lo] > 0 || m_rMinPlane[hi] > 0) {
+      slope = (m_rMinPlane[hi] - m_rMinPlane[lo]) / dz;
+      GeoShapeUtils::coneIntervals(p, v, m_rMinPlane[lo] - slope * m_zPlane[lo], slope, other);
+      GeoShapeUtils::subtractIntervals(section, other, section);
+    }
+    GeoShapeUtils::uniteIntervals(intervals, section, intervals);
+  }
+  GeoShapeUtils::phiIntervals(p, v, m_sPhi, m_dPhi, other);
+  GeoShapeUtils::intersectIntervals(intervals, other, intervals);
+}
+
+double GeoPcon::safety (const GeoTrf::Vector3D &p) const
+{
+  if (!isValid())
+    throw std::runtime_error ("Safety distance requested for incomplete polycone");
+  // The union of the sections is as far as the nearest one. The cone surfaces
+  // are extended beyond each section, which keeps the distances lower bounds
+  double rho = std::hypot(p.x(), p.y());
+  double d = HUGE_VAL;
+  for (size_t k = 0; k + 1 < m_zPlane.size(); ++k) {
+    size_t lo = k, hi = k + 1;
+    if (m_zPlane[lo] > m_zPlane[hi]) std::swap(lo, hi);
+    double dz = m_zPlane[hi] - m_zPlane[lo];
+    if (dz <= 0) continue;
+
+    double t = (p.z() - m_zPlane[lo]) / dz;
+    double rMax = m_rMaxPlane[lo] + (m_rMaxPlane[hi] - m_rMaxPlane[lo]) * t;
+    double dSection = (rho - rMax) / std::hypot(1.0, (m_rMaxPlane[hi] - m_rMaxPlane[lo]) / dz);
+    if (m_rMinPlane[lo] > 0 || m_rMinPlane[hi] > 0) {
+      double rMin = m_rMinPlane[lo] + (m_rMinPlane[hi] - m_rMinPlane[lo]) * t;
+      dSection = std::max(dSection, (rMin - rho) / std::hypot(1.0, (m_rMinPlane[hi] - m_rMinPlane[lo]) / dz));
+    }
+    dSection = std::max(dSection, std::max(m_zPlane[lo] - p.z(), p.z() - m_zPlane[hi]));
+    d = std::min(d, dSection);
+  }
+  return std::abs(std::max(d, GeoShapeUtils::phiDistance(p.x(), p.y(), m_sPhi, m_dPhi)));
+}
+
+void GeoPcon::computeExtent (double &xmin, double &ymin, double &zmin
+			   , double &xmax, double &ymax, double &zmax) const
+{
+  if (!isValid())
+    throw std::runtime_error ("Extent requested for incomplete polycone");
+  double rMin = *std::min_element(m_rMinPlane.begin(), m_rMinPlane.end());
+  double rMax = *std::max_element(m_rMaxPlane.begin(), m_rMaxPlane.end());
+  GeoShapeUtils::sectorExtent(rMin, rMax, m_sPhi, m_dPhi, xmin, ymin, xmax, ymax);
+  zmin = *std::min_element(m_zPlane.begin(), m_zPlane.end());
+  zmax = *std::max_element(m_zPlane.begin(), m_zPlane.end());
+}
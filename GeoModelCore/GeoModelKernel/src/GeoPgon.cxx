@@ -6,6 +6,8 @@
 #include "GeoModelKernel/GeoShapeAction.h"
 #include <cmath>
 #include <stdexcept>
+#include "GeoShapeUtils.h"
+#include <algorithm>
 
 const std::string GeoPgon::s_classType = "Pgon";
 const ShapeType GeoPgon::s_classTypeID = 0x14;
@@ -57,9 +59,142 @@ void GeoPgon::addPlane (double ZPlane, double RMinPlane, double RMaxPlane)
   m_zPlane.push_back (ZPlane);
   m_rMinPlane.push_back (RMinPlane);
   m_rMaxPlane.push_back (RMaxPlane);
+  invalidateExtent ();
 }
 
 void GeoPgon::exec (GeoShapeAction *action) const
 {
   action->handlePgon(this);
 }
+
+GeoShape::Location GeoPgon::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  if (!isValid())
+    throw std::runtime_error ("Point classification requested for incomplete polygon");
+  // The radii are measured to the flat sides.  The polygon is bounded by the side
+  // plane facing the point most
+  double dSide = m_dPhi / m_nSides;
+  double u = -HUGE_VAL;
+  for (unsigned int k = 0; k < m_nSides; ++k) {
+    double phi = m_sPhi + (k + 0.5) * dSide;
+    u = std::max(u, p.x() * std::cos(phi) + p.y() * std::sin(phi));
+  }
+
+  GeoShapeUtils::SliceUnion slices;
+  for (size_t k = 0; k + 1 < m_zPlane.size(); ++k) {
+    size_t lo = k, hi = k + 1;
+    if (m_zPlane[lo] > m_zPlane[hi]) std::swap(lo, hi);
+    double dz = m_zPlane[hi] - m_zPlane[lo];
+    if (dz <= 0 || p.z() < m_zPlane[lo] - tolerance || p.z() > m_zPlane[hi] + tolerance) continue;
+
+    double t = std::min(1.0, std::max(0.0, (p.z() - m_zPlane[lo]) / dz));
+    double rMax = m_rMaxPlane[lo] + (m_rMaxPlane[hi] - m_rMaxPlane[lo]) * t;
+    double dRadial = (u - rMax) / std::hypot(1.0, (m_rMaxPlane[hi] - m_rMaxPlane[lo]) / dz);
+    if (m_rMinPlane[lo] > 0 || m_rMinPlane[hi] > 0) {
+      double rMin = m_rMinPlane[lo] + (m_rMinPlane[hi] - m_rMinPlane[lo]) * t;
+      dRadial = std::max(dRadial, (rMin - u) / std::hypot(1.0, (m_rMinPlane[hi] - m_rMinPlane[lo]) / dz));
+    }
+    slices.add(dRadial, m_zPlane[lo] - p.z(), p.z() - m_zPlane[hi], tolerance);
+  }
+  return GeoShapeUtils::intersectPhi(slices.location(), p.x(), p.y(), m_sPhi, m_dPhi, tolerance);
+}
+
+void GeoPgon::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+			       , RayIntervals &intervals) const
+{
+  if (!isValid())
+    throw std::runtime_error ("Ray intersection requested for incomplete polygon");
+  double dSide = m_dPhi / m_nSides;
+
+  // Intervals inside all side planes at the distance a + b*z from the axis
+  RayIntervals side;
+  auto prism = [&](double a, double b, RayIntervals &out) {
+    out.assign(1, std::make_pair(-HUGE_VAL, HUGE_VAL));
+    for (unsigned int s = 0; s < m_nSides && !out.empty(); ++s) {
+      double phi = m_sPhi + (s + 0.5) * dSide;
+      GeoShapeUtils::halfSpaceIntervals(p, v, GeoTrf::Vector3D(std::cos(phi), std::sin(phi), -b), a, side);
+      GeoShapeUtils::intersectIntervals(out, side, out);
+    }
+  };
+
+  // Union of the sections, each one a hollow prism between two planes
+  RayIntervals section, other;
+  intervals.clear();
+  for (size_t k = 0; k + 1 < m_zPlane.size(); ++k) {
+    size_t lo = k, hi = k + 1;
+    if (m_zPlane[lo] > m_zPlane[hi]) std::swap(lo, hi);
+    double dz = m_zPlane[hi] - m_zPlane[lo];
+    if (dz <= 0) continue;
+
+    GeoShapeUtils::slabIntervals(p.z(), v.z(), m_zPlane[lo], m_zPlane[hi], section);
+    double slope = (m_rMaxPlane[hi] - m_rMaxPlane[lo]) / dz;
+    prism(m_rMaxPlane[lo] - slope * m_zPlane[lo], slope, other);
+    GeoShapeUtils::intersectIntervals(section, other, section);
+    if (m_rMinPlane[lo] > 0 || m_rMinPlane[hi] > 0) {
+      slope = (m_rMinPlane[hi] - m_rMinPlane[lo]) / dz;
+      prism(m_rMinPlane[lo] - slope * m_zPlane[lo], slope, other);
+      GeoShapeUtils::subtractIntervals(section, other, section);
+    }
+    GeoShapeUtils::uniteIntervals(intervals, section, intervals);
+  }
+  GeoShapeUtils::phiIntervals(p, v, m_sPhi, m_dPhi, other);
+  GeoShapeUtils::intersectIntervals(intervals, other, intervals);
+}
+
+double GeoPgon::safety (const GeoTrf::Vector3D &p) const
+{
+  if (!isValid())
+    throw std::runtime_error ("Safety distance requested for incomplete polygon");
+  double dSide = m_dPhi / m_nSides;
+  double u = -HUGE_VAL;
+  for (unsigned int k = 0; k < m_nSides; ++k) {
+    double phi = m_sPhi + (k + 0.5) * dSide;
+    u = std::max(u, p.x() * std::cos(phi) + p.y() * std::sin(phi));
+  }
+
+  // The union of the sections is as far as the nearest one. The side planes
+  // are extended beyond each section, which keeps the distances lower bounds
+  double d = HUGE_VAL;
+  for (size_t k = 0; k + 1 < m_zPlane.size(); ++k) {
+    size_t lo = k, hi = k + 1;
+    if (m_zPlane[lo] > m_zPlane[hi]) std::swap(lo, hi);
+    double dz = m_zPlane[hi] - m_zPlane[lo];
+    if (dz <= 0) continue;
+
+    double t = (p.z() - m_zPlane[lo]) / dz;
+    double rMax = m_rMaxPlane[lo] + (m_rMaxPlane[hi] - m_rMaxPlane[lo]) * t;
+    double dSection = (u - rMax) / std::hypot(1.0, (m_rMaxPlane[hi] - m_rMaxPlane[lo]) / dz);
+    if (m_rMinPlane[lo] > 0 || m_rMinPlane[hi] > 0) {
+      double rMin = m_rMinPlane[lo] + (m_rMinPlane[hi] - m_rMinPlane[lo]) * t;
+      dSection = std::max(dSection, (rMin - u) / std::hypot(1.0, (m_rMinPlane[hi] - m_rMinPlane[lo]) / dz));
+    }
+    dSection = std::max(dSection, std::max(m_zPlane[lo] - p.z(), p.z() - m_zPlane[hi]));
+    d = std::min(d, dSection);
+  }
+  return std::abs(std::max(d, GeoShapeUtils::phiDistance(p.x(), p.y(), m_sPhi, m_dPhi)));
+}
+
+void GeoPgon::computeExtent (double &xmin, double &ymin, double &zmin
+			   , double &xmax, double &ymax, double &zmax) const
+{
+  if (!isValid())
+    throw std::runtime_error ("Extent requested for incomplete polygon");
+  // The radii are measured to the sides. The corners are further out
+  double dSide = m_dPhi / m_nSides;
+  double rMin = *std::min_element(m_rMinPlane.begin(), m_rMinPlane.end()) / std::cos(0.5 * dSide);
+  double rMax = *std::max_element(m_rMaxPlane.begin(), m_rMaxPlane.end()) / std::cos(0.5 * dSide);
+  xmin = ymin = HUGE_VAL;
+  xmax = ymax = -HUGE_VAL;
+  auto addCorner = [&](double r, double phi) {
+    double x = r * std::cos(phi), y = r * std::sin(phi);
+    xmin = std::min(xmin, x); xmax = std::max(xmax, x);
+    ymin = std::min(ymin, y); ymax = std::max(ymax, y);
+  };
+  for (unsigned int k = 0; k <= m_nSides; ++k) addCorner(rMax, m_sPhi + k * dSide);
+  if (!GeoShapeUtils::isFullPhi(m_dPhi)) {
+    addCorner(rMin, m_sPhi);
+    addCorner(rMin, m_sPhi + m_dPhi);
+  }
+  zmin = *std::min_element(m_zPlane.begin(), m_zPlane.end());
+  zmax = *std::max_element(m_zPlane.begin(), m_zPlane.end());
+}
@@ -7,7 +7,7 @@
 #include "GeoModelKernel/GeoTransform.h"
 #include "GeoModelKernel/GeoCountVolAction.h"
 #include "GeoModelKernel/GeoCountVolAndSTAction.h"
-#include "GeoModelKernel/GeoAccessVolumeAction.h"
+#include "GeoModelKernel/GeoChildVolumeIndex.h"
 
 #include <algorithm>
 
@@ -29,36 +29,45 @@ void GeoPhysVol::add(GeoGraphNode* graphNode)
   m_daughters.push_back(graphNode);
   graphNode->ref();
   graphNode->dockTo(this);
+  clearChildVolumeIndex();
+}
+
+void GeoPhysVol::setChildNodes(const std::vector<GeoGraphNode*>& nodes)
+{
+  std::scoped_lock<std::mutex> lk(m_muxVec);
+  std::vector<const GeoGraphNode*> previous;
+  previous.swap(m_daughters);
+  for(GeoGraphNode* node : nodes) {
+    m_daughters.push_back(node);
+    node->ref();
+    if(std::find(previous.begin(),previous.end(),node)==previous.end()) node->dockTo(this);
+  }
+  for(const GeoGraphNode* daughter : previous) daughter->unref();
+  clearChildVolumeIndex();
 }
 
 unsigned int GeoPhysVol::getNChildVols() const
 {
   GeoCountVolAction cv;
   exec(&cv);
-  return cv.getCount ();
+  return cv.getCount();
 }
 
 PVConstLink GeoPhysVol::getChildVol(unsigned int index) const
 {
-  GeoAccessVolumeAction av(index,nullptr);
-  exec(&av);
-  return av.getVolume();
+  return getChildVolumeIndex().getChildVol(index);
 }
 
 GeoTrf::Transform3D GeoPhysVol::getXToChildVol(unsigned int index
 				       ,const GeoVAlignmentStore* store) const
 {
-  GeoAccessVolumeAction av(index,store);
-  exec(&av);
-  return av.getTransform();
+  return getChildVolumeIndex().getXToChildVol(index,store);
 }
 
 GeoTrf::Transform3D GeoPhysVol::getDefXToChildVol(unsigned int index
-					  ,const GeoVAlignmentStore* store) const
+					  ,const GeoVAlignmentStore* /*store*/) const
 {
-  GeoAccessVolumeAction av(index,store);
-  exec(&av);
-  return av.getDefTransform();
+  return getChildVolumeIndex().getDefXToChildVol(index);
 }
 
 void GeoPhysVol::exec(GeoNodeAction *action) const
@@ -106,16 +115,12 @@ void GeoPhysVol::exec(GeoNodeAction *action) const
 
 std::string GeoPhysVol::getNameOfChildVol(unsigned int i) const
 {
-  GeoAccessVolumeAction av(i,nullptr);
-  exec(&av);
-  return av.getName();
+  return getChildVolumeIndex().getNameOfChildVol(i);
 }
 
 Query<int> GeoPhysVol::getIdOfChildVol(unsigned int i) const
 {
-  GeoAccessVolumeAction	av(i,nullptr);
-  exec(&av);
-  return av.getId();
+  return getChildVolumeIndex().getIdOfChildVol(i);
 }
 
 unsigned int GeoPhysVol::getNChildVolAndST() const
@@ -137,29 +142,25 @@ GeoTrf::Transform3D GeoPhysVol::getX(const GeoVAlignmentStore* store) const {
   const GeoGraphNode * const * fence =  getParent()->getChildNode(0);
   const GeoGraphNode * const * node1 =  getParent()->findChildNode(this);
   
-  for(const GeoGraphNode * const * current = node1 - 1; current>=fence; current--) {
-
-    // If this happens, we are done, compute & return--------------------//
-    //                                                                   //
-    if(dynamic_cast<const GeoVPhysVol *>(*current)) break;               //
-    //-------------------------------------------------------------------//
-
-    // If this happens, we are done, compute & return--------------------//
-    //                                                                   //
-    if(dynamic_cast<const GeoSerialTransformer *>(*current)) break;      //
-    //-------------------------------------------------------------------//
-
+  //
+  // Go back to the previous volume or serial transformer, if any:
+  //
+  const GeoGraphNode * const * current = node1;
+  for( ; current>fence; current--) {
+    if (dynamic_cast<const GeoVPhysVol *>(*(current-1))) break;
+    if (dynamic_cast<const GeoSerialTransformer *>(*(current-1))) break;
+  }
+  //
+  // Accumulate the transforms from there, in order:
+  //
+  for( ; current<node1; current++) {
     const GeoTransform *xf = dynamic_cast<const GeoTransform *> (*current);
-    
-    //-------------------------------------------------------------------//
-    // If this happens, accumulate into transform                        //
-    if (xf) xform  = xf->getTransform(store)*xform;                      //
-    //-------------------------------------------------------------------//
+    if (xf) xf->accumulateTransform(xform,store);
   }
   return xform;  
 }
 
-GeoTrf::Transform3D GeoPhysVol::getDefX(const GeoVAlignmentStore* store) const {
+GeoTrf::Transform3D GeoPhysVol::getDefX(const GeoVAlignmentStore* /*store*/) const {
   //
   // Check we are not shared:
   //
@@ -171,24 +172,20 @@ GeoTrf::Transform3D GeoPhysVol::getDefX(const GeoVAlignmentStore* store) const {
   const GeoGraphNode * const * fence =  getParent()->getChildNode(0);
   const GeoGraphNode * const * node1 =  getParent()->findChildNode(this);
   
-  for(const GeoGraphNode * const * current = node1 - 1; current>=fence; current--) {
-
-    // If this happens, we are done, compute & return--------------------//
-    //                                                                   //
-    if (dynamic_cast<const GeoVPhysVol *>(*current)) break;              //
-    //-------------------------------------------------------------------//
-
-    // If this happens, we are done, compute & return--------------------//
-    //                                                                   //
-    if (dynamic_cast<const GeoSerialTransformer *>(*current)) break;     //
-    //-------------------------------------------------------------------//
-
+  //
+  // Go back to the previous volume or serial transformer, if any:
+  //
+  const GeoGraphNode * const * current = node1;
+  for( ; current>fence; current--) {
+    if (dynamic_cast<const GeoVPhysVol *>(*(current-1))) break;
+    if (dynamic_cast<const GeoSerialTransformer *>(*(current-1))) break;
+  }
+  //
+  // Accumulate the transforms from there, in order:
+  //
+  for( ; current<node1; current++) {
     const GeoTransform *xf = dynamic_cast<const GeoTransform *> (*current);
-    
-    //-------------------------------------------------------------------//
-    // If this happens, accumulate into transform                        //
-    if (xf) xform  = xf->getDefTransform(store)*xform;                   //
-    //-------------------------------------------------------------------//
+    if (xf) xf->accumulateDefTransform(xform);
   }
   return xform;  
 }
@@ -4,6 +4,7 @@
 
 #include "GeoModelKernel/GeoPolyhedrizeAction.h"
 #include "GeoModelKernel/GeoPolyhedron.h"
+#include "GeoModelKernel/GeoPolyhedronCache.h"
 #include "GeoModelKernel/GeoShapeShift.h"
 #include "GeoModelKernel/GeoShapeIntersection.h"
 #include "GeoModelKernel/GeoShapeUnion.h"
@@ -18,9 +19,14 @@
 #include "GeoModelKernel/GeoTube.h"
 #include "GeoModelKernel/GeoTubs.h"
 #include "GeoModelKernel/GeoPara.h"
+#include "GeoModelKernel/GeoTessellatedSolid.h"
+#include <array>
+#include <map>
 
-GeoPolyhedrizeAction::GeoPolyhedrizeAction()
+GeoPolyhedrizeAction::GeoPolyhedrizeAction(int nRotationSteps, GeoPolyhedronCache *cache)
   : m_polyhedron(nullptr)
+  , m_nRotationSteps(nRotationSteps)
+  , m_cache(cache)
 {
   setDepthLimit(0);
 }
@@ -32,13 +38,15 @@ GeoPolyhedrizeAction::~GeoPolyhedrizeAction()
 
 void GeoPolyhedrizeAction::handleShift (const GeoShapeShift *shift)
 {
+  if (getCached(shift)) return;
   shift->getOp()->exec(this);
   m_polyhedron->Transform (shift->getX().matrix().block<3,3>(0,0), shift->getX().translation());
 }
 
 void GeoPolyhedrizeAction::handleUnion (const GeoShapeUnion *unio)
 {
-  GeoPolyhedrizeAction auxA,auxB;
+  if (getCached(unio)) return;
+  GeoPolyhedrizeAction auxA(m_nRotationSteps),auxB(m_nRotationSteps);
   unio->getOpA()->exec(&auxA);
   unio->getOpB()->exec(&auxB);
   m_polyhedron = new GeoPolyhedron(auxA.getPolyhedron()->add(*auxB.getPolyhedron()));
@@ -46,7 +54,8 @@ void GeoPolyhedrizeAction::handleUnion (const GeoShapeUnion *unio)
 
 void GeoPolyhedrizeAction::handleIntersection (const GeoShapeIntersection *isect)
 {
-  GeoPolyhedrizeAction auxA,auxB;
+  if (getCached(isect)) return;
+  GeoPolyhedrizeAction auxA(m_nRotationSteps),auxB(m_nRotationSteps);
   isect->getOpA()->exec(&auxA);
   isect->getOpB()->exec(&auxB);
   m_polyhedron=new GeoPolyhedron(auxA.getPolyhedron()->intersect(*auxB.getPolyhedron()));
@@ -54,7 +63,8 @@ void GeoPolyhedrizeAction::handleIntersection (const GeoShapeIntersection *isect
 
 void GeoPolyhedrizeAction::handleSubtraction (const GeoShapeSubtraction *subtract)
 {
-  GeoPolyhedrizeAction auxA,auxB;
+  if (getCached(subtract)) return;
+  GeoPolyhedrizeAction auxA(m_nRotationSteps),auxB(m_nRotationSteps);
   subtract->getOpA()->exec(&auxA);
   subtract->getOpB()->exec(&auxB);
   m_polyhedron=new GeoPolyhedron(auxA.getPolyhedron()->subtract(*auxB.getPolyhedron()));
@@ -75,7 +85,8 @@ void GeoPolyhedrizeAction::handleCons (const GeoCons *cons)
           cons->getRMax2(),
           cons->getDZ(),
           cons->getSPhi(),
-          cons->getDPhi());
+          cons->getDPhi(),
+          m_nRotationSteps);
 }
 
 void GeoPolyhedrizeAction::handlePara (const GeoPara *para)
@@ -100,7 +111,7 @@ void GeoPolyhedrizeAction::handlePcon (const GeoPcon *pcon)
       rmn[s] = pcon->getRMinPlane (s);
       rmx[s] = pcon->getRMaxPlane (s);
     }
-  m_polyhedron = new GeoPolyhedronPcon (pcon->getSPhi(), pcon->getDPhi(), pcon->getNPlanes (), z, rmn, rmx);
+  m_polyhedron = new GeoPolyhedronPcon (pcon->getSPhi(), pcon->getDPhi(), pcon->getNPlanes (), z, rmn, rmx, m_nRotationSteps);
 
   delete[]z;
   delete[]rmn;
@@ -119,7 +130,7 @@ void GeoPolyhedrizeAction::handlePgon (const GeoPgon *pgon)
       rmn[s] = pgon->getRMinPlane (s);
       rmx[s] = pgon->getRMaxPlane (s);
     }
-  m_polyhedron = new GeoPolyhedronPgon (pgon->getSPhi(), pgon->getDPhi(), pgon->getNSides(), pgon->getNPlanes (), z, rmn, rmx);
+  m_polyhedron = new GeoPolyhedronPgon (pgon->getSPhi(), pgon->getDPhi(), pgon->getNSides(), pgon->getNPlanes (), z, rmn, rmx, m_nRotationSteps);
 
   delete[]z;
   delete[]rmn;
@@ -167,7 +178,8 @@ void GeoPolyhedrizeAction::handleTube (const GeoTube *tube)
 {
   m_polyhedron = new GeoPolyhedronTube (tube->getRMin(),
           tube->getRMax(),
-          tube->getZHalfLength());
+          tube->getZHalfLength(),
+          m_nRotationSteps);
 }
 
 void GeoPolyhedrizeAction::handleTubs (const GeoTubs *tubs)
@@ -176,10 +188,62 @@ void GeoPolyhedrizeAction::handleTubs (const GeoTubs *tubs)
                tubs->getRMax(),
                tubs->getZHalfLength(),
                tubs->getSPhi(),
-               tubs->getDPhi());
+               tubs->getDPhi(),
+               m_nRotationSteps);
+}
+
+void GeoPolyhedrizeAction::handleTessellatedSolid (const GeoTessellatedSolid *tessellated)
+{
+  GeoPolyhedronArbitrary *polyhedron;
+  if (tessellated->isIndexed ()) {
+    const std::vector<GeoFacetVertex> &vertices = tessellated->getVertices ();
+    const std::vector<unsigned int> &indices = tessellated->getIndices ();
+    const unsigned int n = tessellated->getVerticesPerFacet ();
+    polyhedron = new GeoPolyhedronArbitrary (vertices.size (), tessellated->getNumberOfFacets ());
+    for (const GeoFacetVertex &v : vertices) polyhedron->AddVertex (v);
+    for (size_t i = 0; i < indices.size (); i += n) {
+      bool quad = n == 4 && indices[i+3] != GeoTessellatedSolid::NO_VERTEX;
+      polyhedron->AddFacet (indices[i] + 1, indices[i+1] + 1, indices[i+2] + 1, quad ? indices[i+3] + 1 : 0);
+    }
+  }
+  else {
+    // Facets only share vertices with the same coordinates
+    std::map<std::array<double,3>,int> vertexNumber;
+    std::vector<GeoFacetVertex> vertices;
+    std::vector<std::array<int,4> > facets (tessellated->getNumberOfFacets ());
+    GeoFacetVertex v[4];
+    for (size_t i = 0; i < facets.size (); ++i) {
+      size_t nv = tessellated->getFacetVertices (i, v);
+      facets[i][3] = 0;
+      for (size_t j = 0; j < nv; ++j) {
+	auto inserted = vertexNumber.emplace (std::array<double,3>{v[j].x (), v[j].y (), v[j].z ()}, vertices.size () + 1);
+	if (inserted.second) vertices.push_back (v[j]);
+	facets[i][j] = inserted.first->second;
+      }
+    }
+    polyhedron = new GeoPolyhedronArbitrary (vertices.size (), facets.size ());
+    for (const GeoFacetVertex &vertex : vertices) polyhedron->AddVertex (vertex);
+    for (const std::array<int,4> &facet : facets) polyhedron->AddFacet (facet[0], facet[1], facet[2], facet[3]);
+  }
+  polyhedron->Finalize ();
+  m_polyhedron = polyhedron;
 }
 
 const GeoPolyhedron * GeoPolyhedrizeAction::getPolyhedron () const
 {
   return m_polyhedron;
 }
+
+int GeoPolyhedrizeAction::getNumberOfRotationSteps () const
+{
+  return m_nRotationSteps;
+}
+
+bool GeoPolyhedrizeAction::getCached (const GeoShape *shape)
+{
+  // A shape nobody refers to yet is not cached, as the cache would own it
+  if (!m_cache || shape->refCount() == 0) return false;
+  std::shared_ptr<const GeoPolyhedron> polyhedron = m_cache->get(shape, m_nRotationSteps);
+  m_polyhedron = polyhedron ? new GeoPolyhedron(*polyhedron) : nullptr;
+  return true;
+}
@@ -1,6 +1,7 @@
 
 #include "GeoModelKernel/GeoPolyhedron.h"
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
@@ -272,14 +273,29 @@ GeoPolyhedron::SetNumberOfRotationSteps (int n)
   << "GeoPolyhedron::SetNumberOfRotationSteps: attempt to set the\n"
   << "number of steps per circle < " << nMin << "; forced to " << nMin
   << std::endl;
-      s_fNumberOfRotationSteps = nMin;
+      s_fNumberOfRotationSteps.store (nMin, std::memory_order_relaxed);
     }
   else
     {
-      s_fNumberOfRotationSteps = n;
+      s_fNumberOfRotationSteps.store (n, std::memory_order_relaxed);
     }
 }
 
+int
+GeoPolyhedron::GetNumberOfRotationSteps (int n)
+/***********************************************************************
+ *                                                                     *
+ * Name: GeoPolyhedron::GetNumberOfRotationSteps                       *
+ *                                                                     *
+ * Function: Number of steps for whole circle given to a constructor,  *
+ *           or the default if not positive                            *
+ *                                                                     *
+ ***********************************************************************/
+{
+  const int nMin = 3;
+  return n > 0 ? std::max (n, nMin) : GetNumberOfRotationSteps ();
+}
+
 void
 GeoPolyhedron::AllocateMemory (int Nvert, int Nface)
 /***********************************************************************
@@ -512,7 +528,7 @@ void
 GeoPolyhedron::RotateAroundZ (int nstep, double phi, double dphi,
             int np1, int np2,
             const double *z, double *r,
-            int nodeVis, int edgeVis)
+            int nodeVis, int edgeVis, int nRotationSteps)
 /***********************************************************************
  *                                                                     *
  * Name: GeoPolyhedron::RotateAroundZ                Date:    27.11.96 *
@@ -532,6 +548,8 @@ GeoPolyhedron::RotateAroundZ (int nstep, double phi, double dphi,
  *        nodeVis - how to Draw edges joing consecutive positions of   *
  *                  node during rotation                               *
  *        edgeVis - how to Draw edges                                  *
+ *        nRotationSteps - number of steps for whole circle, if 0 then *
+ *                  default                                            *
  *                                                                     *
  ***********************************************************************/
 {
@@ -543,7 +561,7 @@ GeoPolyhedron::RotateAroundZ (int nstep, double phi, double dphi,
     true : false;
   double delPhi = ifWholeCircle ? wholeCircle : dphi;
   int nSphi = (nstep > 0) ?
-    nstep : int (delPhi * GetNumberOfRotationSteps () / wholeCircle + .5);
+    nstep : int (delPhi * GetNumberOfRotationSteps (nRotationSteps) / wholeCircle + .5);
   if (nSphi == 0)
     nSphi = 1;
   int nVphi = ifWholeCircle ? nSphi : nSphi + 1;
@@ -1050,10 +1068,10 @@ bool GeoPolyhedron::GetNextVertexIndex (int &index, int &edgeFlag) const
  *                                                                     *
  ***********************************************************************/
 {
-  static int
+  static thread_local int
     iFace =
     1;
-  static int
+  static thread_local int
     iQVertex =
     0;
   int
@@ -1132,8 +1150,8 @@ bool
  *                                                                     *
  ***********************************************************************/
 {
-  static int iFace = 1;
-  static int iNode = 0;
+  static thread_local int iFace = 1;
+  static thread_local int iNode = 0;
 
   if (m_nface == 0)
     return false;    // empty polyhedron
@@ -1178,9 +1196,9 @@ bool
  *                                                                     *
  ***********************************************************************/
 {
-  static int iFace = 1;
-  static int iQVertex = 0;
-  static int iOrder = 1;
+  static thread_local int iFace = 1;
+  static thread_local int iQVertex = 0;
+  static thread_local int iOrder = 1;
   int k1, k2, kflag, kface1, kface2;
 
   if (iFace == 1 && iQVertex == 0)
@@ -1372,7 +1390,7 @@ bool
  *                                                                     *
  ***********************************************************************/
 {
-  static int iFace = 1;
+  static thread_local int iFace = 1;
 
   if (edgeFlags == 0)
     {
@@ -1482,7 +1500,7 @@ bool GeoPolyhedron::GetNextNormal (GeoTrf::Vector3D & normal) const
  *                                                                     *
  ***********************************************************************/
 {
-  static int
+  static thread_local int
     iFace =
     1;
   normal = GetNormal (iFace);
@@ -1844,7 +1862,8 @@ GeoPolyhedronCons::GeoPolyhedronCons (double Rmn1,
               double Rmx1,
               double Rmn2,
               double Rmx2,
-              double Dz, double Phi1, double Dphi)
+              double Dz, double Phi1, double Dphi,
+              int nRotationSteps)
 /***********************************************************************
  *                                                                     *
  * Name: GeoPolyhedronCons::GeoPolyhedronCons        Date:    15.12.96 *
@@ -1857,6 +1876,8 @@ GeoPolyhedronCons::GeoPolyhedronCons (double Rmn1,
  *        Dz         - half length in Z                                *
  *        Phi1       - starting angle of the segment                   *
  *        Dphi       - segment range                                   *
+ *        nRotationSteps - number of steps for whole circle, if 0 then *
+ *                     default                                         *
  *                                                                     *
  ***********************************************************************/
 {
@@ -1928,7 +1949,7 @@ GeoPolyhedronCons::GeoPolyhedronCons (double Rmn1,
 
   //   R O T A T E    P O L Y L I N E S
 
-  RotateAroundZ (0, phi1, dphi, 2, 2, zz, rr, -1, -1);
+  RotateAroundZ (0, phi1, dphi, 2, 2, zz, rr, -1, -1, nRotationSteps);
   SetReferences ();
 }
 
@@ -1937,8 +1958,9 @@ GeoPolyhedronCons::~GeoPolyhedronCons ()
 }
 
 GeoPolyhedronCone::GeoPolyhedronCone (double Rmn1, double Rmx1,
-              double Rmn2, double Rmx2, double Dz):
-GeoPolyhedronCons (Rmn1, Rmx1, Rmn2, Rmx2, Dz, 0 * deg, 360 * deg)
+              double Rmn2, double Rmx2, double Dz,
+              int nRotationSteps):
+GeoPolyhedronCons (Rmn1, Rmx1, Rmn2, Rmx2, Dz, 0 * deg, 360 * deg, nRotationSteps)
 {
 }
 
@@ -1947,8 +1969,9 @@ GeoPolyhedronCone::~GeoPolyhedronCone ()
 }
 
 GeoPolyhedronTubs::GeoPolyhedronTubs (double Rmin, double Rmax,
-              double Dz, double Phi1, double Dphi):
-GeoPolyhedronCons (Rmin, Rmax, Rmin, Rmax, Dz, Phi1, Dphi)
+              double Dz, double Phi1, double Dphi,
+              int nRotationSteps):
+GeoPolyhedronCons (Rmin, Rmax, Rmin, Rmax, Dz, Phi1, Dphi, nRotationSteps)
 {
 }
 
@@ -1956,8 +1979,9 @@ GeoPolyhedronTubs::~GeoPolyhedronTubs ()
 {
 }
 
-GeoPolyhedronTube::GeoPolyhedronTube (double Rmin, double Rmax, double Dz):
-GeoPolyhedronCons (Rmin, Rmax, Rmin, Rmax, Dz, 0 * deg, 360 * deg)
+GeoPolyhedronTube::GeoPolyhedronTube (double Rmin, double Rmax, double Dz,
+              int nRotationSteps):
+GeoPolyhedronCons (Rmin, Rmax, Rmin, Rmax, Dz, 0 * deg, 360 * deg, nRotationSteps)
 {
 }
 
@@ -1970,7 +1994,8 @@ GeoPolyhedronPgon::GeoPolyhedronPgon (double phi,
               int npdv,
               int nz,
               const double *z,
-              const double *rmin, const double *rmax)
+              const double *rmin, const double *rmax,
+              int nRotationSteps)
 /***********************************************************************
  *                                                                     *
  * Name: GeoPolyhedronPgon                           Date:    09.12.96 *
@@ -2054,7 +2079,8 @@ GeoPolyhedronPgon::GeoPolyhedronPgon (double phi,
 
   //   R O T A T E    P O L Y L I N E S
 
-  RotateAroundZ (npdv, phi, dphi, nz, nz, zz, rr, -1, (npdv == 0) ? -1 : 1);
+  RotateAroundZ (npdv, phi, dphi, nz, nz, zz, rr, -1, (npdv == 0) ? -1 : 1,
+                 nRotationSteps);
   SetReferences ();
 
   delete[]zz;
@@ -2067,8 +2093,9 @@ GeoPolyhedronPgon::~GeoPolyhedronPgon ()
 
 GeoPolyhedronPcon::GeoPolyhedronPcon (double phi, double dphi, int nz,
               const double *z,
-              const double *rmin, const double *rmax):
-GeoPolyhedronPgon (phi, dphi, 0, nz, z, rmin, rmax)
+              const double *rmin, const double *rmax,
+              int nRotationSteps):
+GeoPolyhedronPgon (phi, dphi, 0, nz, z, rmin, rmax, nRotationSteps)
 {
 }
 
@@ -2078,7 +2105,8 @@ GeoPolyhedronPcon::~GeoPolyhedronPcon ()
 
 GeoPolyhedronSphere::GeoPolyhedronSphere (double rmin, double rmax,
             double phi, double dphi,
-            double the, double dthe)
+            double the, double dthe,
+            int nRotationSteps)
 /***********************************************************************
  *                                                                     *
  * Name: GeoPolyhedronSphere                         Date:    11.12.96 *
@@ -2138,7 +2166,7 @@ GeoPolyhedronSphere::GeoPolyhedronSphere (double rmin, double rmax,
 
   //   P R E P A R E   T W O   P O L Y L I N E S
 
-  int ns = (GetNumberOfRotationSteps () + 1) / 2;
+  int ns = (GetNumberOfRotationSteps (nRotationSteps) + 1) / 2;
   int np1 = int (dthe * ns * M_1_PI + .5) + 1;
   if (np1 <= 1)
     np1 = 2;
@@ -2170,7 +2198,7 @@ GeoPolyhedronSphere::GeoPolyhedronSphere (double rmin, double rmax,
 
   //   R O T A T E    P O L Y L I N E S
 
-  RotateAroundZ (0, phi, dphi, np1, np2, zz, rr, -1, -1);
+  RotateAroundZ (0, phi, dphi, np1, np2, zz, rr, -1, -1, nRotationSteps);
   SetReferences ();
 
   delete[]zz;
@@ -2183,7 +2211,8 @@ GeoPolyhedronSphere::~GeoPolyhedronSphere ()
 
 GeoPolyhedronTorus::GeoPolyhedronTorus (double rmin,
           double rmax,
-          double rtor, double phi, double dphi)
+          double rtor, double phi, double dphi,
+          int nRotationSteps)
 /***********************************************************************
  *                                                                     *
  * Name: GeoPolyhedronTorus                          Date:    11.12.96 *
@@ -2219,7 +2248,7 @@ GeoPolyhedronTorus::GeoPolyhedronTorus (double rmin,
 
   //   P R E P A R E   T W O   P O L Y L I N E S
 
-  int np1 = GetNumberOfRotationSteps ();
+  int np1 = GetNumberOfRotationSteps (nRotationSteps);
   int np2 = rmin < perMillion ? 1 : np1;
 
   std::vector<double> rr (np1+np2, 0);
@@ -2248,7 +2277,8 @@ GeoPolyhedronTorus::GeoPolyhedronTorus (double rmin,
 
   //   R O T A T E    P O L Y L I N E S
 
-  RotateAroundZ (0, phi, dphi, -np1, -np2, zz.data(), rr.data(), -1, -1);
+  RotateAroundZ (0, phi, dphi, -np1, -np2, zz.data(), rr.data(), -1, -1,
+                 nRotationSteps);
   SetReferences ();
 }
 
@@ -2256,9 +2286,54 @@ GeoPolyhedronTorus::~GeoPolyhedronTorus ()
 {
 }
 
-int
-  GeoPolyhedron::s_fNumberOfRotationSteps =
-  DEFAULT_NUMBER_OF_STEPS;
+GeoPolyhedronArbitrary::GeoPolyhedronArbitrary (int nvert, int nface)
+  : m_nVertexCount (0)
+  , m_nFacetCount (0)
+/***********************************************************************
+ *                                                                     *
+ * Function: Create polyhedron with room for nvert vertices and nface  *
+ *           facets, to be added with AddVertex and AddFacet           *
+ *                                                                     *
+ ***********************************************************************/
+{
+  AllocateMemory (nvert, nface);
+}
+
+GeoPolyhedronArbitrary::~GeoPolyhedronArbitrary ()
+{
+}
+
+void
+GeoPolyhedronArbitrary::AddVertex (const GeoTrf::Vector3D & v)
+{
+  if (m_nVertexCount == m_nvert)
+    {
+      std::cerr << "GeoPolyhedronArbitrary::AddVertex: too many vertices" << std::endl;
+      return;
+    }
+  m_pV[++m_nVertexCount] = v;
+}
+
+void
+GeoPolyhedronArbitrary::AddFacet (int iv1, int iv2, int iv3, int iv4)
+{
+  if (m_nFacetCount == m_nface)
+    {
+      std::cerr << "GeoPolyhedronArbitrary::AddFacet: too many facets" << std::endl;
+      return;
+    }
+  m_pF[++m_nFacetCount] = GeoFacet (iv1, 0, iv2, 0, iv3, 0, iv4, 0);
+}
+
+void
+GeoPolyhedronArbitrary::Finalize ()
+{
+  SetReferences ();
+}
+
+std::atomic<int>
+  GeoPolyhedron::s_fNumberOfRotationSteps
+  (DEFAULT_NUMBER_OF_STEPS);
 /***********************************************************************
  *                                                                     *
  * Name: GeoPolyhedron::s_fNumberOfRotationSteps     Date:    24.06.97 *
@@ -2269,7 +2344,8 @@ int
  ***********************************************************************/
 
 #include "BooleanProcessor.src"
-static
+// One processor per thread, as it keeps the state of the operation
+static thread_local
   Geo_BooleanProcessor
   processor;
 
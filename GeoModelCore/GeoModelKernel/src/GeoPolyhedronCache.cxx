@@ -0,0 +1,162 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoModelKernel/GeoPolyhedronCache.h"
+#include "GeoModelKernel/GeoPolyhedron.h"
+#include "GeoModelKernel/GeoPolyhedrizeAction.h"
+#include "GeoModelKernel/GeoShapeShift.h"
+#include "GeoModelKernel/GeoShapeUnion.h"
+#include "GeoModelKernel/GeoShapeIntersection.h"
+#include "GeoModelKernel/GeoShapeSubtraction.h"
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+
+namespace {
+  constexpr size_t N_SHARDS = 16;
+}
+
+size_t GeoPolyhedronCache::KeyHash::operator()(const Key& key) const
+{
+  return std::hash<const GeoShape*>()(key.first) ^ (size_t(key.second) * 0x9E3779B97F4A7C15ULL);
+}
+
+GeoPolyhedronCache::GeoPolyhedronCache(size_t maxSize)
+  : m_maxSize(maxSize)
+  , m_shardSize(std::max<size_t>(1,(maxSize + N_SHARDS - 1)/N_SHARDS))
+  , m_hits(0)
+  , m_misses(0)
+  , m_evictions(0)
+{
+  for (size_t i = 0; i < N_SHARDS; ++i) m_shards.emplace_back(new Shard);
+}
+
+GeoPolyhedronCache::~GeoPolyhedronCache()
+{
+  clear();
+}
+
+std::shared_ptr<const GeoPolyhedron> GeoPolyhedronCache::get(const GeoShape* shape, int nRotationSteps)
+{
+  // The reference taken below must never be the last one
+  if (shape->refCount() == 0) {
+    throw std::runtime_error("GeoPolyhedronCache::get(). The shape " + shape->type() + " must be referenced by the caller");
+  }
+  Key key(shape, nRotationSteps > 0 ? nRotationSteps : GeoPolyhedron::GetNumberOfRotationSteps());
+  Shard& shard = *m_shards[KeyHash()(key) % N_SHARDS];
+
+  std::promise<std::shared_ptr<const GeoPolyhedron>> promise;
+  Result result;
+  bool miss = false;
+  std::vector<const GeoShape*> dropped;
+  {
+    std::scoped_lock<std::mutex> lk(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+      result = it->second->second;
+      m_hits++;
+    }
+    else {
+      // Insert a pending entry, so that other threads wait for this one to build it
+      result = promise.get_future().share();
+      shard.entries.emplace_front(key, result);
+      shard.index.emplace(key, shard.entries.begin());
+      shape->ref();
+      m_misses++;
+      miss = true;
+      while (shard.entries.size() > m_shardSize) {
+	dropped.push_back(shard.entries.back().first.first);
+	shard.index.erase(shard.entries.back().first);
+	shard.entries.pop_back();
+	m_evictions++;
+      }
+    }
+  }
+  // Released outside the lock, in case a shape goes
+  for (const GeoShape* s : dropped) s->unref();
+
+  if (miss) {
+    try {
+      promise.set_value(std::shared_ptr<const GeoPolyhedron>(build(shape, key.second)));
+    }
+    catch (...) {
+      promise.set_exception(std::current_exception());
+      bool erased = false;
+      {
+	std::scoped_lock<std::mutex> lk(shard.mutex);
+	auto it = shard.index.find(key);
+	if (it != shard.index.end()) {
+	  shard.entries.erase(it->second);
+	  shard.index.erase(it);
+	  erased = true;
+	}
+      }
+      if (erased) shape->unref();
+    }
+  }
+  return result.get();
+}
+
+GeoPolyhedron* GeoPolyhedronCache::build(const GeoShape* shape, int nRotationSteps)
+{
+  ShapeType type = shape->typeID();
+  if (type == GeoShapeShift::getClassTypeID()) {
+    const GeoShapeShift* shift = static_cast<const GeoShapeShift*>(shape);
+    std::shared_ptr<const GeoPolyhedron> op = get(shift->getOp(), nRotationSteps);
+    if (!op) return nullptr;
+    GeoPolyhedron* polyhedron = new GeoPolyhedron(*op);
+    polyhedron->Transform(shift->getX().matrix().block<3,3>(0,0), shift->getX().translation());
+    return polyhedron;
+  }
+
+  const GeoShape *opA = nullptr, *opB = nullptr;
+  if (type == GeoShapeUnion::getClassTypeID()) {
+    opA = static_cast<const GeoShapeUnion*>(shape)->getOpA();
+    opB = static_cast<const GeoShapeUnion*>(shape)->getOpB();
+  }
+  else if (type == GeoShapeIntersection::getClassTypeID()) {
+    opA = static_cast<const GeoShapeIntersection*>(shape)->getOpA();
+    opB = static_cast<const GeoShapeIntersection*>(shape)->getOpB();
+  }
+  else if (type == GeoShapeSubtraction::getClassTypeID()) {
+    opA = static_cast<const GeoShapeSubtraction*>(shape)->getOpA();
+    opB = static_cast<const GeoShapeSubtraction*>(shape)->getOpB();
+  }
+  else {
+    GeoPolyhedrizeAction action(nRotationSteps);
+    shape->exec(&action);
+    const GeoPolyhedron* polyhedron = action.getPolyhedron();
+    return polyhedron ? new GeoPolyhedron(*polyhedron) : nullptr;
+  }
+
+  std::shared_ptr<const GeoPolyhedron> a = get(opA, nRotationSteps), b = get(opB, nRotationSteps);
+  if (!a || !b) return nullptr;
+  if (type == GeoShapeUnion::getClassTypeID()) return new GeoPolyhedron(a->add(*b));
+  if (type == GeoShapeIntersection::getClassTypeID()) return new GeoPolyhedron(a->intersect(*b));
+  return new GeoPolyhedron(a->subtract(*b));
+}
+
+void GeoPolyhedronCache::clear()
+{
+  std::vector<const GeoShape*> dropped;
+  for (auto& shard : m_shards) {
+    std::scoped_lock<std::mutex> lk(shard->mutex);
+    for (const auto& entry : shard->entries) dropped.push_back(entry.first.first);
+    shard->entries.clear();
+    shard->index.clear();
+  }
+  for (const GeoShape* s : dropped) s->unref();
+}
+
+size_t GeoPolyhedronCache::size() const
+{
+  size_t n = 0;
+  for (const auto& shard : m_shards) {
+    std::scoped_lock<std::mutex> lk(shard->mutex);
+    n += shard->entries.size();
+  }
+  return n;
+}
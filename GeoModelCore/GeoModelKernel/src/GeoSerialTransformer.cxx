@@ -4,11 +4,18 @@
 
 #include "GeoModelKernel/GeoSerialTransformer.h"
 #include "GeoModelKernel/GeoNodeAction.h"
+#include <algorithm>
+#include <limits>
+
+std::atomic<unsigned int> GeoSerialTransformer::s_tableThreshold{std::numeric_limits<unsigned int>::max()};
 
 GeoSerialTransformer::GeoSerialTransformer (const GeoVPhysVol *volume, const GeoXF::Function *func, unsigned int copies)
   : m_nCopies (copies)
   , m_function (func->clone ())
+  , m_compiled (*m_function)
   , m_physVol (volume)
+  , m_table (nullptr)
+  , m_tableOnGet (copies >= s_tableThreshold.load ())
 {
   m_physVol->ref ();
 }
@@ -17,6 +24,47 @@ GeoSerialTransformer::~GeoSerialTransformer()
 {
   m_physVol->unref ();
   delete m_function;
+  delete [] m_table.load ();
+}
+
+const GeoSerialTransformer::CompactTransform3D* GeoSerialTransformer::getTable () const
+{
+  const CompactTransform3D* table = m_table.load(std::memory_order_acquire);
+  if (table) return table;
+
+  // Build a new table. If another thread got there first, use its table instead
+  CompactTransform3D* newTable = new CompactTransform3D[m_nCopies];
+  if (m_compiled.isValid()) {
+    for (unsigned int i = 0; i < m_nCopies; ++i) newTable[i] = CompactTransform3D(m_compiled (i));
+  }
+  else {
+    for (unsigned int i = 0; i < m_nCopies; ++i) newTable[i] = CompactTransform3D((*m_function) (i));
+  }
+  if (m_table.compare_exchange_strong(table,newTable,std::memory_order_acq_rel)) return newTable;
+  delete [] newTable;
+  return table;
+}
+
+GeoSerialTransformer::TransformSpan GeoSerialTransformer::getTransforms (unsigned int first, unsigned int n) const
+{
+  if (first >= m_nCopies) return TransformSpan(nullptr,0);
+  return TransformSpan(getTable() + first,std::min(n,m_nCopies - first));
+}
+
+void GeoSerialTransformer::setTableThreshold (unsigned int nCopies)
+{
+  s_tableThreshold = nCopies ? nCopies : std::numeric_limits<unsigned int>::max();
+}
+
+unsigned int GeoSerialTransformer::getTableThreshold ()
+{
+  unsigned int threshold = s_tableThreshold.load();
+  return threshold == std::numeric_limits<unsigned int>::max() ? 0 : threshold;
+}
+
+size_t GeoSerialTransformer::getTableBytes () const
+{
+  return m_table.load(std::memory_order_acquire) ? m_nCopies*sizeof(CompactTransform3D) : 0;
 }
 
 void GeoSerialTransformer::exec (GeoNodeAction *action) const
@@ -7,8 +7,19 @@
 #include "GeoModelKernel/GeoShapeUnion.h"
 #include "GeoModelKernel/GeoShapeSubtraction.h"
 #include "GeoModelKernel/GeoShapeShift.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+  // States of the cached extent
+  constexpr unsigned char EXTENT_EMPTY   = 0;
+  constexpr unsigned char EXTENT_WRITING = 1;
+  constexpr unsigned char EXTENT_READY   = 2;
+}
 
 GeoShape::GeoShape ()
+  : m_extentState (EXTENT_EMPTY)
 {
 }
 
@@ -39,3 +50,78 @@ const GeoShapeShift & GeoShape::operator << (const GeoTrf::Transform3D &shift) c
   GeoShapeShift *shiftNode = new GeoShapeShift (this, shift);
   return *shiftNode;
 }
+
+GeoShape::Location GeoShape::inside (const GeoTrf::Vector3D &, double) const
+{
+  throw std::runtime_error("Point classification is not available for shapes of type " + type());
+}
+
+void GeoShape::inside (size_t n, const double *x, const double *y, const double *z
+		       , Location *result, double tolerance) const
+{
+  for (size_t i = 0; i < n; ++i) {
+    result[i] = inside(GeoTrf::Vector3D(x[i],y[i],z[i]),tolerance);
+  }
+}
+
+void GeoShape::getRayIntervals (const GeoTrf::Vector3D &, const GeoTrf::Vector3D &
+				, RayIntervals &) const
+{
+  throw std::runtime_error("Ray intersection is not available for shapes of type " + type());
+}
+
+double GeoShape::distanceToIn (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v) const
+{
+  RayIntervals intervals;
+  getRayIntervals(p, v, intervals);
+  // Intervals thinner than the surface are grazing hits, and are ignored
+  for (const auto& iv : intervals) {
+    if (iv.second > TOLERANCE && iv.second - iv.first > TOLERANCE) return std::max(iv.first, 0.0);
+  }
+  return HUGE_VAL;
+}
+
+double GeoShape::distanceToOut (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v) const
+{
+  RayIntervals intervals;
+  getRayIntervals(p, v, intervals);
+  for (const auto& iv : intervals) {
+    if (iv.first <= TOLERANCE && iv.second >= -TOLERANCE) return std::max(iv.second, 0.0);
+  }
+  return 0;
+}
+
+double GeoShape::safety (const GeoTrf::Vector3D &) const
+{
+  throw std::runtime_error("Safety distances are not available for shapes of type " + type());
+}
+
+void GeoShape::extent (double &xmin, double &ymin, double &zmin
+		       , double &xmax, double &ymax, double &zmax) const
+{
+  if (m_extentState.load(std::memory_order_acquire) == EXTENT_READY) {
+    xmin = m_extent[0]; ymin = m_extent[1]; zmin = m_extent[2];
+    xmax = m_extent[3]; ymax = m_extent[4]; zmax = m_extent[5];
+    return;
+  }
+
+  computeExtent(xmin, ymin, zmin, xmax, ymax, zmax);
+
+  // Publish the result, unless another thread is already doing so
+  unsigned char expected = EXTENT_EMPTY;
+  if (m_extentState.compare_exchange_strong(expected, EXTENT_WRITING, std::memory_order_acquire)) {
+    m_extent[0] = xmin; m_extent[1] = ymin; m_extent[2] = zmin;
+    m_extent[3] = xmax; m_extent[4] = ymax; m_extent[5] = zmax;
+    m_extentState.store(EXTENT_READY, std::memory_order_release);
+  }
+}
+
+void GeoShape::computeExtent (double &, double &, double &, double &, double &, double &) const
+{
+  throw std::runtime_error("The extent is not available for shapes of type " + type());
+}
+
+void GeoShape::invalidateExtent ()
+{
+  m_extentState.store(EXTENT_EMPTY, std::memory_order_release);
+}
@@ -3,10 +3,11 @@
 */
 
 #include "GeoModelKernel/GeoShapeIntersection.h"
-#include "GeoModelKernel/GeoPolyhedron.h"
-#include "GeoModelKernel/GeoPolyhedrizeAction.h"
 #include "GeoModelKernel/GeoShapeAction.h"
+#include "GeoShapeUtils.h"
 #include <stdexcept>
+#include <algorithm>
+#include <vector>
 
 const std::string GeoShapeIntersection::s_classType = "Intersection";
 const ShapeType GeoShapeIntersection::s_classTypeID = 0x00;
@@ -27,10 +28,11 @@ GeoShapeIntersection::~GeoShapeIntersection()
 
 double GeoShapeIntersection::volume () const
 {
-  GeoPolyhedrizeAction a;
-  exec(&a);
-  const GeoPolyhedron *poly = a.getPolyhedron();
-  double vol = poly->GetVolume ();
+  double vol = m_volume.load(std::memory_order_acquire);
+  if (vol < 0) {
+    vol = GeoShapeUtils::booleanVolume(this);
+    m_volume.store(vol, std::memory_order_release);
+  }
   return vol;
 }
 
@@ -86,3 +88,51 @@ void GeoShapeIntersection::exec (GeoShapeAction *action) const
   }
   action->getPath()->pop();
 }
+
+GeoShape::Location GeoShapeIntersection::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  Location a = m_opA->inside(p, tolerance);
+  if (a == OUTSIDE) return OUTSIDE;
+  return std::min(a, m_opB->inside(p, tolerance));
+}
+
+void GeoShapeIntersection::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+					    , RayIntervals &intervals) const
+{
+  m_opA->getRayIntervals(p, v, intervals);
+  if (intervals.empty()) return;
+  RayIntervals b;
+  m_opB->getRayIntervals(p, v, b);
+  GeoShapeUtils::intersectIntervals(intervals, b, intervals);
+}
+
+double GeoShapeIntersection::safety (const GeoTrf::Vector3D &p) const
+{
+  // Inside, the nearer surface bounds the distance. Outside, any operand
+  // not containing the point does
+  bool inA = m_opA->inside(p) != OUTSIDE, inB = m_opB->inside(p) != OUTSIDE;
+  double a = m_opA->safety(p), b = m_opB->safety(p);
+  if (inA && inB) return std::min(a, b);
+  return std::max(inA ? 0.0 : a, inB ? 0.0 : b);
+}
+
+void GeoShapeIntersection::inside (size_t n, const double *x, const double *y, const double *z
+				   , Location *result, double tolerance) const
+{
+  std::vector<Location> b(n);
+  m_opA->inside(n, x, y, z, result, tolerance);
+  m_opB->inside(n, x, y, z, b.data(), tolerance);
+  for (size_t i = 0; i < n; ++i) result[i] = std::min(result[i], b[i]);
+}
+
+void GeoShapeIntersection::computeExtent (double &xmin, double &ymin, double &zmin
+					, double &xmax, double &ymax, double &zmax) const
+{
+  double bxmin, bymin, bzmin, bxmax, bymax, bzmax;
+  m_opA->extent(xmin, ymin, zmin, xmax, ymax, zmax);
+  m_opB->extent(bxmin, bymin, bzmin, bxmax, bymax, bzmax);
+  xmin = std::max(xmin, bxmin); ymin = std::max(ymin, bymin); zmin = std::max(zmin, bzmin);
+  xmax = std::min(xmax, bxmax); ymax = std::min(ymax, bymax); zmax = std::min(zmax, bzmax);
+  // Disjoint operands leave an empty shape. Collapse the box rather than invert it
+  xmax = std::max(xmin, xmax); ymax = std::max(ymin, ymax); zmax = std::max(zmin, zmax);
+}
@@ -4,6 +4,8 @@
 
 #include "GeoModelKernel/GeoShapeShift.h"
 #include "GeoModelKernel/GeoShapeAction.h"
+#include <vector>
+#include <cmath>
 
 const std::string GeoShapeShift::s_classType = "Shift";
 const ShapeType GeoShapeShift::s_classTypeID = 0x03;
@@ -11,6 +13,7 @@ const ShapeType GeoShapeShift::s_classTypeID = 0x03;
 GeoShapeShift::GeoShapeShift (const GeoShape* A, const GeoTrf::Transform3D &X)
   : m_op (A)
   , m_shift (X)
+  , m_invShift (X.inverse())
 {
   m_op->ref ();
 }
@@ -71,3 +74,50 @@ void GeoShapeShift::exec (GeoShapeAction *action) const
   }
   action->getPath()->pop();
 }
+
+GeoShape::Location GeoShapeShift::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  return m_op->inside(m_invShift * p, tolerance);
+}
+
+void GeoShapeShift::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+				     , RayIntervals &intervals) const
+{
+  // The ray parameter is the same in the frame of the operand
+  m_op->getRayIntervals(m_invShift * p, m_invShift.linear() * v, intervals);
+}
+
+double GeoShapeShift::safety (const GeoTrf::Vector3D &p) const
+{
+  return m_op->safety(m_invShift * p);
+}
+
+void GeoShapeShift::inside (size_t n, const double *x, const double *y, const double *z
+			    , Location *result, double tolerance) const
+{
+  std::vector<double> xs(n), ys(n), zs(n);
+  const GeoTrf::Transform3D::LinearMatrixType r = m_invShift.linear();
+  const GeoTrf::Vector3D t = m_invShift.translation();
+  for (size_t i = 0; i < n; ++i) {
+    xs[i] = r(0,0) * x[i] + r(0,1) * y[i] + r(0,2) * z[i] + t.x();
+    ys[i] = r(1,0) * x[i] + r(1,1) * y[i] + r(1,2) * z[i] + t.y();
+    zs[i] = r(2,0) * x[i] + r(2,1) * y[i] + r(2,2) * z[i] + t.z();
+  }
+  m_op->inside(n, xs.data(), ys.data(), zs.data(), result, tolerance);
+}
+
+void GeoShapeShift::computeExtent (double &xmin, double &ymin, double &zmin
+				 , double &xmax, double &ymax, double &zmax) const
+{
+  // Box around the shifted corners of the box of the operand
+  double lo[3], hi[3];
+  m_op->extent(lo[0], lo[1], lo[2], hi[0], hi[1], hi[2]);
+  GeoTrf::Vector3D bmin(HUGE_VAL, HUGE_VAL, HUGE_VAL), bmax(-HUGE_VAL, -HUGE_VAL, -HUGE_VAL);
+  for (unsigned int i = 0; i < 8; ++i) {
+    GeoTrf::Vector3D corner = m_shift * GeoTrf::Vector3D(i & 1 ? hi[0] : lo[0], i & 2 ? hi[1] : lo[1], i & 4 ? hi[2] : lo[2]);
+    bmin = bmin.cwiseMin(corner);
+    bmax = bmax.cwiseMax(corner);
+  }
+  xmin = bmin.x(); ymin = bmin.y(); zmin = bmin.z();
+  xmax = bmax.x(); ymax = bmax.y(); zmax = bmax.z();
+}
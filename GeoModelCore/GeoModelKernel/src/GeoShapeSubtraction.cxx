@@ -4,9 +4,10 @@
 
 #include "GeoModelKernel/GeoShapeSubtraction.h"
 #include "GeoModelKernel/GeoShapeAction.h"
-#include "GeoModelKernel/GeoPolyhedrizeAction.h"
-#include "GeoModelKernel/GeoPolyhedron.h"
+#include "GeoShapeUtils.h"
 #include <stdexcept>
+#include <algorithm>
+#include <vector>
 
 const std::string GeoShapeSubtraction::s_classType = "Subtraction";
 const ShapeType GeoShapeSubtraction::s_classTypeID = 0x02;
@@ -27,10 +28,11 @@ GeoShapeSubtraction::~GeoShapeSubtraction()
 
 double GeoShapeSubtraction::volume () const
 {
-  GeoPolyhedrizeAction a;
-  exec(&a);
-  const GeoPolyhedron *poly = a.getPolyhedron();
-  double vol = poly->GetVolume ();
+  double vol = m_volume.load(std::memory_order_acquire);
+  if (vol < 0) {
+    vol = GeoShapeUtils::booleanVolume(this);
+    m_volume.store(vol, std::memory_order_release);
+  }
   return vol;
 }
 
@@ -86,3 +88,54 @@ void GeoShapeSubtraction::exec (GeoShapeAction *action) const
   }
   action->getPath()->pop();
 }
+
+namespace {
+  // A minus B: outside B is kept as it is, the surface of B bounds the result
+  inline GeoShape::Location subtractLocation(GeoShape::Location a, GeoShape::Location b)
+  {
+    if (a == GeoShape::OUTSIDE || b == GeoShape::INSIDE) return GeoShape::OUTSIDE;
+    return b == GeoShape::SURFACE ? GeoShape::SURFACE : a;
+  }
+}
+
+GeoShape::Location GeoShapeSubtraction::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  Location a = m_opA->inside(p, tolerance);
+  if (a == OUTSIDE) return OUTSIDE;
+  return subtractLocation(a, m_opB->inside(p, tolerance));
+}
+
+void GeoShapeSubtraction::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+					   , RayIntervals &intervals) const
+{
+  m_opA->getRayIntervals(p, v, intervals);
+  if (intervals.empty()) return;
+  RayIntervals b;
+  m_opB->getRayIntervals(p, v, b);
+  GeoShapeUtils::subtractIntervals(intervals, b, intervals);
+}
+
+double GeoShapeSubtraction::safety (const GeoTrf::Vector3D &p) const
+{
+  // The result is the intersection of the first operand with the complement of the second
+  bool inA = m_opA->inside(p) != OUTSIDE, inB = m_opB->inside(p) == INSIDE;
+  double a = m_opA->safety(p), b = m_opB->safety(p);
+  if (inA && !inB) return std::min(a, b);
+  return std::max(inA ? 0.0 : a, inB ? b : 0.0);
+}
+
+void GeoShapeSubtraction::inside (size_t n, const double *x, const double *y, const double *z
+				  , Location *result, double tolerance) const
+{
+  std::vector<Location> b(n);
+  m_opA->inside(n, x, y, z, result, tolerance);
+  m_opB->inside(n, x, y, z, b.data(), tolerance);
+  for (size_t i = 0; i < n; ++i) result[i] = subtractLocation(result[i], b[i]);
+}
+
+void GeoShapeSubtraction::computeExtent (double &xmin, double &ymin, double &zmin
+				       , double &xmax, double &ymax, double &zmax) const
+{
+  // Whatever is subtracted, the result is within the first operand
+  m_opA->extent(xmin, ymin, zmin, xmax, ymax, zmax);
+}
@@ -4,9 +4,10 @@
 
 #include "GeoModelKernel/GeoShapeUnion.h"
 #include "GeoModelKernel/GeoShapeAction.h"
-#include "GeoModelKernel/GeoPolyhedron.h"
-#include "GeoModelKernel/GeoPolyhedrizeAction.h"
+#include "GeoShapeUtils.h"
 #include <stdexcept>
+#include <algorithm>
+#include <vector>
 
 const std::string GeoShapeUnion::s_classType = "Union";
 const ShapeType GeoShapeUnion::s_classTypeID = 0x01;
@@ -27,10 +28,11 @@ GeoShapeUnion::~GeoShapeUnion()
 
 double GeoShapeUnion::volume () const
 {
-  GeoPolyhedrizeAction a;
-  exec (&a);
-  const GeoPolyhedron *poly = a.getPolyhedron ();
-  double vol = poly->GetVolume ();
+  double vol = m_volume.load(std::memory_order_acquire);
+  if (vol < 0) {
+    vol = GeoShapeUtils::booleanVolume(this);
+    m_volume.store(vol, std::memory_order_release);
+  }
   return vol;
 }
 
@@ -87,3 +89,51 @@ void GeoShapeUnion::exec (GeoShapeAction *action) const
   action->getPath()->pop();
 }
 
+
+GeoShape::Location GeoShapeUnion::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  // Points where the surfaces of both operands touch are reported on the surface
+  Location a = m_opA->inside(p, tolerance);
+  if (a == INSIDE) return INSIDE;
+  Location b = m_opB->inside(p, tolerance);
+  if (b == INSIDE) return INSIDE;
+  return (a == SURFACE || b == SURFACE) ? SURFACE : OUTSIDE;
+}
+
+void GeoShapeUnion::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+				     , RayIntervals &intervals) const
+{
+  RayIntervals b;
+  m_opA->getRayIntervals(p, v, intervals);
+  m_opB->getRayIntervals(p, v, b);
+  GeoShapeUtils::uniteIntervals(intervals, b, intervals);
+}
+
+double GeoShapeUnion::safety (const GeoTrf::Vector3D &p) const
+{
+  // Outside, the nearest operand bounds the distance. Inside, any operand
+  // containing the point does
+  bool inA = m_opA->inside(p) != OUTSIDE, inB = m_opB->inside(p) != OUTSIDE;
+  double a = m_opA->safety(p), b = m_opB->safety(p);
+  if (!inA && !inB) return std::min(a, b);
+  return std::max(inA ? a : 0.0, inB ? b : 0.0);
+}
+
+void GeoShapeUnion::inside (size_t n, const double *x, const double *y, const double *z
+			    , Location *result, double tolerance) const
+{
+  std::vector<Location> b(n);
+  m_opA->inside(n, x, y, z, result, tolerance);
+  m_opB->inside(n, x, y, z, b.data(), tolerance);
+  for (size_t i = 0; i < n; ++i) result[i] = std::max(result[i], b[i]);
+}
+
+void GeoShapeUnion::computeExtent (double &xmin, double &ymin, double &zmin
+				 , double &xmax, double &ymax, double &zmax) const
+{
+  double bxmin, bymin, bzmin, bxmax, bymax, bzmax;
+  m_opA->extent(xmin, ymin, zmin, xmax, ymax, zmax);
+  m_opB->extent(bxmin, bymin, bzmin, bxmax, bymax, bzmax);
+  xmin = std::min(xmin, bxmin); ymin = std::min(ymin, bymin); zmin = std::min(zmin, bzmin);
+  xmax = std::max(xmax, bxmax); ymax = std::max(ymax, bymax); zmax = std::max(zmax, bzmax);
+}
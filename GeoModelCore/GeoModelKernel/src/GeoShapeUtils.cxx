@@ -0,0 +1,237 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoShapeUtils.h"
+#include "GeoModelKernel/GeoBooleanVolume.h"
+#include "GeoModelKernel/GeoBox.h"
+#include "GeoModelKernel/GeoCons.h"
+#include "GeoModelKernel/GeoEllipticalTube.h"
+#include "GeoModelKernel/GeoGenericTrap.h"
+#include "GeoModelKernel/GeoPara.h"
+#include "GeoModelKernel/GeoPcon.h"
+#include "GeoModelKernel/GeoPgon.h"
+#include "GeoModelKernel/GeoSimplePolygonBrep.h"
+#include "GeoModelKernel/GeoTessellatedSolid.h"
+#include "GeoModelKernel/GeoTorus.h"
+#include "GeoModelKernel/GeoTrap.h"
+#include "GeoModelKernel/GeoTrd.h"
+#include "GeoModelKernel/GeoTube.h"
+#include "GeoModelKernel/GeoTubs.h"
+#include "GeoModelKernel/GeoTwistedTrap.h"
+#include "GeoModelKernel/GeoUnidentifiedShape.h"
+#include "GeoModelKernel/GeoShapeShift.h"
+#include "GeoModelKernel/GeoShapeUnion.h"
+#include "GeoModelKernel/GeoShapeSubtraction.h"
+#include "GeoModelKernel/GeoShapeIntersection.h"
+#include "GeoModelKernel/GeoElement.h"
+#include "GeoModelKernel/GeoMaterial.h"
+#include "GeoModelKernel/GeoLogVol.h"
+#include "GeoModelKernel/GeoPolyhedron.h"
+#include "GeoModelKernel/GeoPolyhedrizeAction.h"
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+double GeoShapeUtils::booleanVolume(const GeoShape* shape)
+{
+  try {
+    return GeoBooleanVolume::computeFromOperands(shape,GeoBooleanVolume::getDefaultConfig());
+  }
+  catch (const std::exception&) {
+    // Some operand cannot be sampled: fall back to polyhedral booleans
+    GeoPolyhedrizeAction a;
+    shape->exec(&a);
+    return a.getPolyhedron()->GetVolume();
+  }
+}
+
+void GeoShapeUtils::getContent(const GeoShape* shape, ShapeContent& c)
+{
+  c.type = shape->typeID();
+  c.values.clear();
+  c.strings.clear();
+  c.operands.clear();
+
+  if (c.type == GeoBox::getClassTypeID()) {
+    const GeoBox* s = static_cast<const GeoBox*>(shape);
+    c.values = {s->getXHalfLength(),s->getYHalfLength(),s->getZHalfLength()};
+    c.bytes = sizeof(GeoBox);
+  }
+  else if (c.type == GeoCons::getClassTypeID()) {
+    const GeoCons* s = static_cast<const GeoCons*>(shape);
+    c.values = {s->getRMin1(),s->getRMin2(),s->getRMax1(),s->getRMax2(),s->getDZ(),s->getSPhi(),s->getDPhi()};
+    c.bytes = sizeof(GeoCons);
+  }
+  else if (c.type == GeoEllipticalTube::getClassTypeID()) {
+    const GeoEllipticalTube* s = static_cast<const GeoEllipticalTube*>(shape);
+    c.values = {s->getXHalfLength(),s->getYHalfLength(),s->getZHalfLength()};
+    c.bytes = sizeof(GeoEllipticalTube);
+  }
+  else if (c.type == GeoGenericTrap::getClassTypeID()) {
+    const GeoGenericTrap* s = static_cast<const GeoGenericTrap*>(shape);
+    c.values = {s->getZHalfLength()};
+    for (const GeoTwoVector& v : s->getVertices()) c.values.insert(c.values.end(),{v.x(),v.y()});
+    c.bytes = sizeof(GeoGenericTrap) + s->getVertices().size()*sizeof(GeoTwoVector);
+  }
+  else if (c.type == GeoPara::getClassTypeID()) {
+    const GeoPara* s = static_cast<const GeoPara*>(shape);
+    c.values = {s->getXHalfLength(),s->getYHalfLength(),s->getZHalfLength(),s->getTheta(),s->getAlpha(),s->getPhi()};
+    c.bytes = sizeof(GeoPara);
+  }
+  else if (c.type == GeoPcon::getClassTypeID()) {
+    const GeoPcon* s = static_cast<const GeoPcon*>(shape);
+    c.values = {s->getSPhi(),s->getDPhi()};
+    for (unsigned int i = 0; i < s->getNPlanes(); ++i) {
+      c.values.insert(c.values.end(),{s->getZPlane(i),s->getRMinPlane(i),s->getRMaxPlane(i)});
+    }
+    c.bytes = sizeof(GeoPcon) + s->getNPlanes()*3*sizeof(double);
+  }
+  else if (c.type == GeoPgon::getClassTypeID()) {
+    const GeoPgon* s = static_cast<const GeoPgon*>(shape);
+    c.values = {double(s->getNSides()),s->getSPhi(),s->getDPhi()};
+    for (unsigned int i = 0; i < s->getNPlanes(); ++i) {
+      c.values.insert(c.values.end(),{s->getZPlane(i),s->getRMinPlane(i),s->getRMaxPlane(i)});
+    }
+    c.bytes = sizeof(GeoPgon) + s->getNPlanes()*3*sizeof(double);
+  }
+  else if (c.type == GeoSimplePolygonBrep::getClassTypeID()) {
+    const GeoSimplePolygonBrep* s = static_cast<const GeoSimplePolygonBrep*>(shape);
+    c.values = {s->getDZ()};
+    for (unsigned int i = 0; i < s->getNVertices(); ++i) {
+      c.values.insert(c.values.end(),{s->getXVertex(i),s->getYVertex(i)});
+    }
+    c.bytes = sizeof(GeoSimplePolygonBrep) + s->getNVertices()*2*sizeof(double);
+  }
+  else if (c.type == GeoTessellatedSolid::getClassTypeID()) {
+    const GeoTessellatedSolid* s = static_cast<const GeoTessellatedSolid*>(shape);
+    c.bytes = sizeof(GeoTessellatedSolid);
+    if (s->isIndexed()) {
+      // A mesh differs from the same facets added one by one
+      c.values.push_back(s->getVerticesPerFacet());
+      c.values.push_back(s->getVertices().size());
+      for (const GeoFacetVertex& v : s->getVertices()) c.values.insert(c.values.end(),{v.x(),v.y(),v.z()});
+      c.values.insert(c.values.end(),s->getIndices().begin(),s->getIndices().end());
+      c.bytes += s->getVertices().size()*sizeof(GeoFacetVertex) + s->getIndices().size()*sizeof(unsigned int);
+    }
+    else {
+      for (size_t i = 0; i < s->getNumberOfFacets(); ++i) {
+	const GeoFacet* facet = s->getFacet(i);
+	c.values.push_back(facet->getNumberOfVertices());
+	c.values.push_back(facet->getVertexType());
+	for (size_t j = 0; j < facet->getNumberOfVertices(); ++j) {
+	  GeoFacetVertex v = facet->getVertex(j);
+	  c.values.insert(c.values.end(),{v.x(),v.y(),v.z()});
+	}
+	c.bytes += sizeof(GeoFacet*) + sizeof(GeoFacet) + facet->getNumberOfVertices()*sizeof(GeoFacetVertex);
+      }
+    }
+  }
+  else if (c.type == GeoTorus::getClassTypeID()) {
+    const GeoTorus* s = static_cast<const GeoTorus*>(shape);
+    c.values = {s->getRMin(),s->getRMax(),s->getRTor(),s->getSPhi(),s->getDPhi()};
+    c.bytes = sizeof(GeoTorus);
+  }
+  else if (c.type == GeoTrap::getClassTypeID()) {
+    const GeoTrap* s = static_cast<const GeoTrap*>(shape);
+    c.values = {s->getZHalfLength(),s->getTheta(),s->getPhi()
+		,s->getDydzn(),s->getDxdyndzn(),s->getDxdypdzn(),s->getAngleydzn()
+		,s->getDydzp(),s->getDxdyndzp(),s->getDxdypdzp(),s->getAngleydzp()};
+    c.bytes = sizeof(GeoTrap);
+  }
+  else if (c.type == GeoTrd::getClassTypeID()) {
+    const GeoTrd* s = static_cast<const GeoTrd*>(shape);
+    c.values = {s->getXHalfLength1(),s->getXHalfLength2(),s->getYHalfLength1(),s->getYHalfLength2(),s->getZHalfLength()};
+    c.bytes = sizeof(GeoTrd);
+  }
+  else if (c.type == GeoTube::getClassTypeID()) {
+    const GeoTube* s = static_cast<const GeoTube*>(shape);
+    c.values = {s->getRMin(),s->getRMax(),s->getZHalfLength()};
+    c.bytes = sizeof(GeoTube);
+  }
+  else if (c.type == GeoTubs::getClassTypeID()) {
+    const GeoTubs* s = static_cast<const GeoTubs*>(shape);
+    c.values = {s->getRMin(),s->getRMax(),s->getZHalfLength(),s->getSPhi(),s->getDPhi()};
+    c.bytes = sizeof(GeoTubs);
+  }
+  else if (c.type == GeoTwistedTrap::getClassTypeID()) {
+    const GeoTwistedTrap* s = static_cast<const GeoTwistedTrap*>(shape);
+    c.values = {s->getPhiTwist(),s->getZHalfLength(),s->getTheta(),s->getPhi()
+		,s->getY1HalfLength(),s->getX1HalfLength(),s->getX2HalfLength()
+		,s->getY2HalfLength(),s->getX3HalfLength(),s->getX4HalfLength()
+		,s->getTiltAngleAlpha()};
+    c.bytes = sizeof(GeoTwistedTrap);
+  }
+  else if (c.type == GeoUnidentifiedShape::getClassTypeID()) {
+    const GeoUnidentifiedShape* s = static_cast<const GeoUnidentifiedShape*>(shape);
+    c.strings = {s->name(),s->asciiData()};
+    // The volume is optional
+    try {
+      c.values = {1,s->volume()};
+    }
+    catch (const std::range_error&) {
+      c.values = {0};
+    }
+    c.bytes = sizeof(GeoUnidentifiedShape) + heapBytes(s->name()) + heapBytes(s->asciiData());
+  }
+  else if (c.type == GeoShapeShift::getClassTypeID()) {
+    const GeoShapeShift* s = static_cast<const GeoShapeShift*>(shape);
+    const GeoTrf::Transform3D& x = s->getX();
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 4; ++j) c.values.push_back(x(i,j));
+    }
+    c.operands = {s->getOp()};
+    c.bytes = sizeof(GeoShapeShift);
+  }
+  else if (c.type == GeoShapeUnion::getClassTypeID()) {
+    const GeoShapeUnion* s = static_cast<const GeoShapeUnion*>(shape);
+    c.operands = {s->getOpA(),s->getOpB()};
+    c.bytes = sizeof(GeoShapeUnion);
+  }
+  else if (c.type == GeoShapeSubtraction::getClassTypeID()) {
+    const GeoShapeSubtraction* s = static_cast<const GeoShapeSubtraction*>(shape);
+    c.operands = {s->getOpA(),s->getOpB()};
+    c.bytes = sizeof(GeoShapeSubtraction);
+  }
+  else if (c.type == GeoShapeIntersection::getClassTypeID()) {
+    const GeoShapeIntersection* s = static_cast<const GeoShapeIntersection*>(shape);
+    c.operands = {s->getOpA(),s->getOpB()};
+    c.bytes = sizeof(GeoShapeIntersection);
+  }
+  else {
+    throw std::runtime_error("GeoContentHash: unknown shape type "+shape->type());
+  }
+}
+
+size_t GeoShapeUtils::hashContent(const ShapeContent& c, const std::vector<size_t>& operandHashes)
+{
+  size_t h = std::hash<ShapeType>()(c.type);
+  for (double v : c.values) h = hashCombine(h,std::hash<double>()(v));
+  for (const std::string& s : c.strings) h = hashCombine(h,std::hash<std::string>()(s));
+  for (size_t o : operandHashes) h = hashCombine(h,o);
+  return h;
+}
+
+size_t GeoShapeUtils::nodeBytes(const GeoShape* shape)
+{
+  ShapeContent content;
+  getContent(shape,content);
+  return content.bytes;
+}
+
+size_t GeoShapeUtils::nodeBytes(const GeoElement* element)
+{
+  return sizeof(GeoElement) + heapBytes(element->getName()) + heapBytes(element->getSymbol());
+}
+
+size_t GeoShapeUtils::nodeBytes(const GeoMaterial* material)
+{
+  return sizeof(GeoMaterial) + heapBytes(material->getName())
+    + material->getNumElements()*(sizeof(const GeoElement*) + sizeof(double));
+}
+
+size_t GeoShapeUtils::nodeBytes(const GeoLogVol* logVol)
+{
+  return sizeof(GeoLogVol) + heapBytes(logVol->getName());
+}
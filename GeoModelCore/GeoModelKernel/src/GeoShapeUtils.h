@@ -0,0 +1,358 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#ifndef GEOMODELKERNEL_GEOSHAPEUTILS_H
+#define GEOMODELKERNEL_GEOSHAPEUTILS_H
+
+//
+// Geometry helpers shared by the shape implementations.  Not installed.
+// Those which are not inline are defined in GeoShapeUtils.cxx.
+//
+// Point classification works with approximate signed distances: negative
+// inside, positive outside.  A solid bounded by several surfaces is the
+// maximum of the distances to each of them.  The magnitudes are lower
+// bounds of the true distances, so they double as safety distances.
+//
+// Ray queries work with the intervals of the ray parameter in which the
+// ray is inside a solid.  Solids bounded by several surfaces intersect,
+// unite or subtract the intervals of each surface.
+//
+
+#include "GeoModelKernel/GeoShape.h"
+#include "GeoModelKernel/GeoDefinitions.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+class GeoElement;
+class GeoMaterial;
+class GeoLogVol;
+
+namespace GeoShapeUtils {
+
+  // Turns a signed distance into a location
+  inline GeoShape::Location classify(double d, double tolerance)
+  {
+    return d > tolerance ? GeoShape::OUTSIDE : (d < -tolerance ? GeoShape::INSIDE : GeoShape::SURFACE);
+  }
+
+  // True if the phi segment covers the full circle
+  inline bool isFullPhi(double dPhi)
+  {
+    return dPhi >= 2.0*M_PI - 1e-12;
+  }
+
+  // Signed distance to the phi segment [sPhi,sPhi+dPhi] in the xy plane
+  inline double phiDistance(double x, double y, double sPhi, double dPhi)
+  {
+    if (isFullPhi(dPhi)) return -HUGE_VAL;
+    double ePhi = sPhi + dPhi;
+    // Outward normals of the starting and the ending half planes
+    double dStart = x*std::sin(sPhi) - y*std::cos(sPhi);
+    double dEnd   = y*std::cos(ePhi) - x*std::sin(ePhi);
+    // Up to pi the segment is the intersection of the two half spaces, beyond it their union
+    return dPhi <= M_PI ? std::max(dStart,dEnd) : std::min(dStart,dEnd);
+  }
+
+  // Distance from (px,py) to the segment (ax,ay)-(bx,by)
+  inline double segmentDistance(double px, double py, double ax, double ay, double bx, double by)
+  {
+    double ex = bx-ax, ey = by-ay;
+    double len2 = ex*ex + ey*ey;
+    double t = len2 > 0 ? ((px-ax)*ex + (py-ay)*ey)/len2 : 0;
+    t = std::min(1.0,std::max(0.0,t));
+    double dx = px - (ax + t*ex), dy = py - (ay + t*ey);
+    return std::sqrt(dx*dx + dy*dy);
+  }
+
+  // Signed distance from (px,py) to a simple polygon, of either orientation
+  inline double polygonDistance(double px, double py, const double* xs, const double* ys, unsigned int n)
+  {
+    bool in = false;
+    double dMin = HUGE_VAL;
+    for (unsigned int i = 0, j = n-1; i < n; j = i++) {
+      if (((ys[i] > py) != (ys[j] > py))
+	  && (px < (xs[j]-xs[i])*(py-ys[i])/(ys[j]-ys[i]) + xs[i])) in = !in;
+      dMin = std::min(dMin,segmentDistance(px,py,xs[j],ys[j],xs[i],ys[i]));
+    }
+    return in ? -dMin : dMin;
+  }
+
+  // A plane n.p = d, with unit outward normal
+  struct Plane {
+    GeoTrf::Vector3D n;
+    double d;
+    double distance(const GeoTrf::Vector3D& p) const { return n.dot(p) - d; }
+  };
+
+  // Plane through four (nearly) coplanar points, oriented away from centre
+  inline Plane makePlane(const GeoTrf::Vector3D& p0, const GeoTrf::Vector3D& p1
+			 ,const GeoTrf::Vector3D& p2, const GeoTrf::Vector3D& p3
+			 ,const GeoTrf::Vector3D& centre)
+  {
+    GeoTrf::Vector3D n = (p2-p0).cross(p3-p1);
+    if (n.squaredNorm() == 0) n = (p1-p0).cross(p2-p0);
+    n.normalize();
+    double d = n.dot(0.25*(p0+p1+p2+p3));
+    if (n.dot(centre) > d) { n = -n; d = -d; }
+    return Plane{n,d};
+  }
+
+  // Classification of a union of z slices (the sections of a polycone or of
+  // a polyhedra).  Faces shared by adjacent slices are interior.
+  class SliceUnion {
+  public:
+    // Adds the result of one slice: its radial distance and its distances to the bottom and top planes
+    void add(double dRadial, double dBottom, double dTop, double tolerance)
+    {
+      double d = std::max(dRadial,std::max(dBottom,dTop));
+      if (d < -tolerance) { m_inside = true; return; }
+      if (d > tolerance) return;
+      m_surface = true;
+      if (dRadial < -tolerance) {
+	if (dBottom >= -tolerance && dTop < -tolerance) m_onBottom = true;
+	if (dTop >= -tolerance && dBottom < -tolerance) m_onTop = true;
+      }
+    }
+    GeoShape::Location location() const
+    {
+      if (m_inside || (m_onBottom && m_onTop)) return GeoShape::INSIDE;
+      return m_surface ? GeoShape::SURFACE : GeoShape::OUTSIDE;
+    }
+  private:
+    bool m_inside = false;
+    bool m_surface = false;
+    bool m_onBottom = false;
+    bool m_onTop = false;
+  };
+
+  // Bounding box in the xy plane of the ring sector rMin<r<rMax, sPhi<phi<sPhi+dPhi
+  inline void sectorExtent(double rMin, double rMax, double sPhi, double dPhi
+			   ,double& xmin, double& ymin, double& xmax, double& ymax)
+  {
+    if (isFullPhi(dPhi)) {
+      xmin = ymin = -rMax;
+      xmax = ymax = rMax;
+      return;
+    }
+    xmin = ymin = HUGE_VAL;
+    xmax = ymax = -HUGE_VAL;
+    auto addPoint = [&](double r, double phi) {
+      double x = r*std::cos(phi), y = r*std::sin(phi);
+      xmin = std::min(xmin,x); xmax = std::max(xmax,x);
+      ymin = std::min(ymin,y); ymax = std::max(ymax,y);
+    };
+    double ePhi = sPhi + dPhi;
+    addPoint(rMin,sPhi); addPoint(rMax,sPhi);
+    addPoint(rMin,ePhi); addPoint(rMax,ePhi);
+    // Where the outer arc crosses the axes
+    for (double k = std::ceil(sPhi/M_PI_2); k*M_PI_2 <= ePhi; k += 1) addPoint(rMax,k*M_PI_2);
+  }
+
+  typedef GeoShape::RayIntervals Intervals;
+
+  // Intervals in which the linear function b*t + c is negative
+  inline void linearIntervals(double b, double c, Intervals& out)
+  {
+    out.clear();
+    if (b > 0)       out.emplace_back(-HUGE_VAL,-c/b);
+    else if (b < 0)  out.emplace_back(-c/b,HUGE_VAL);
+    else if (c <= 0) out.emplace_back(-HUGE_VAL,HUGE_VAL);
+  }
+
+  // Intervals in which the quadratic function a*t*t + b*t + c is negative
+  inline void quadraticIntervals(double a, double b, double c, Intervals& out)
+  {
+    // Treat a tiny leading coefficient as zero, relative to the others
+    if (std::abs(a) <= 1e-14*(std::abs(b) + std::abs(c))) {
+      linearIntervals(b,c,out);
+      return;
+    }
+    out.clear();
+    double disc = b*b - 4*a*c;
+    if (disc < 0) {
+      if (a < 0) out.emplace_back(-HUGE_VAL,HUGE_VAL);
+      return;
+    }
+    double q = -0.5*(b + (b >= 0 ? std::sqrt(disc) : -std::sqrt(disc)));
+    double t1 = q/a, t2 = q != 0 ? c/q : t1;
+    if (t1 > t2) std::swap(t1,t2);
+    if (a > 0) {
+      out.emplace_back(t1,t2);
+    }
+    else {
+      out.emplace_back(-HUGE_VAL,t1);
+      out.emplace_back(t2,HUGE_VAL);
+    }
+  }
+
+  // Intervals in which p+t*v lies in the half space n.x <= d
+  inline void halfSpaceIntervals(const GeoTrf::Vector3D& p, const GeoTrf::Vector3D& v
+				 ,const GeoTrf::Vector3D& n, double d, Intervals& out)
+  {
+    linearIntervals(n.dot(v),n.dot(p)-d,out);
+  }
+
+  // Intervals in which p+t*v lies between the planes z=zMin and z=zMax
+  inline void slabIntervals(double pz, double vz, double zMin, double zMax, Intervals& out)
+  {
+    out.clear();
+    if (vz == 0) {
+      if (pz >= zMin && pz <= zMax) out.emplace_back(-HUGE_VAL,HUGE_VAL);
+      return;
+    }
+    double t1 = (zMin-pz)/vz, t2 = (zMax-pz)/vz;
+    out.emplace_back(std::min(t1,t2),std::max(t1,t2));
+  }
+
+  inline void intersectIntervals(const Intervals& a, const Intervals& b, Intervals& out)
+  {
+    Intervals result;
+    for (size_t i = 0, j = 0; i < a.size() && j < b.size(); ) {
+      double lo = std::max(a[i].first,b[j].first), hi = std::min(a[i].second,b[j].second);
+      if (lo <= hi) result.emplace_back(lo,hi);
+      if (a[i].second < b[j].second) ++i; else ++j;
+    }
+    out.swap(result);
+  }
+
+  inline void uniteIntervals(const Intervals& a, const Intervals& b, Intervals& out)
+  {
+    Intervals all(a);
+    all.insert(all.end(),b.begin(),b.end());
+    std::sort(all.begin(),all.end());
+    Intervals result;
+    for (const auto& iv : all) {
+      if (!result.empty() && iv.first <= result.back().second) result.back().second = std::max(result.back().second,iv.second);
+      else result.push_back(iv);
+    }
+    out.swap(result);
+  }
+
+  inline void subtractIntervals(const Intervals& a, const Intervals& b, Intervals& out)
+  {
+    Intervals result;
+    size_t j = 0;
+    for (auto iv : a) {
+      while (j < b.size() && b[j].second <= iv.first) ++j;
+      for (size_t k = j; k < b.size() && b[k].first < iv.second; ++k) {
+	if (b[k].first > iv.first) result.emplace_back(iv.first,b[k].first);
+	iv.first = std::max(iv.first,b[k].second);
+      }
+      if (iv.first < iv.second) result.push_back(iv);
+    }
+    out.swap(result);
+  }
+
+  // Intervals in which p+t*v lies in the phi segment [sPhi,sPhi+dPhi]
+  inline void phiIntervals(const GeoTrf::Vector3D& p, const GeoTrf::Vector3D& v
+			   ,double sPhi, double dPhi, Intervals& out)
+  {
+    if (isFullPhi(dPhi)) {
+      out.assign(1,std::make_pair(-HUGE_VAL,HUGE_VAL));
+      return;
+    }
+    double ePhi = sPhi + dPhi;
+    Intervals start, end;
+    halfSpaceIntervals(p,v,GeoTrf::Vector3D(std::sin(sPhi),-std::cos(sPhi),0),0,start);
+    halfSpaceIntervals(p,v,GeoTrf::Vector3D(-std::sin(ePhi),std::cos(ePhi),0),0,end);
+    if (dPhi <= M_PI) intersectIntervals(start,end,out);
+    else uniteIntervals(start,end,out);
+  }
+
+  // Intervals in which p+t*v lies inside the cone, or cylinder, of radius
+  // r(z) = a + b*z around the z axis.  r must not be negative where this is used
+  inline void coneIntervals(const GeoTrf::Vector3D& p, const GeoTrf::Vector3D& v
+			    ,double a, double b, Intervals& out)
+  {
+    double r0 = a + b*p.z();
+    quadraticIntervals(v.x()*v.x() + v.y()*v.y() - b*b*v.z()*v.z()
+		       ,2*(p.x()*v.x() + p.y()*v.y() - b*v.z()*r0)
+		       ,p.x()*p.x() + p.y()*p.y() - r0*r0
+		       ,out);
+  }
+
+  // Intervals in which the line crosses a simple polygon in the xy plane, counting crossings of its edges
+  inline void polygonIntervals(const GeoTrf::Vector3D& p, const GeoTrf::Vector3D& v
+			       ,const double* xs, const double* ys, unsigned int n, Intervals& out)
+  {
+    out.clear();
+    if (v.x() == 0 && v.y() == 0) {
+      if (polygonDistance(p.x(),p.y(),xs,ys,n) <= 0) out.emplace_back(-HUGE_VAL,HUGE_VAL);
+      return;
+    }
+    std::vector<double> ts;
+    for (unsigned int i = 0, j = n-1; i < n; j = i++) {
+      double ex = xs[i]-xs[j], ey = ys[i]-ys[j];
+      double den = v.x()*ey - v.y()*ex;
+      if (den == 0) continue;
+      double wx = xs[j]-p.x(), wy = ys[j]-p.y();
+      double t = (wx*ey - wy*ex)/den;
+      double s = (wx*v.y() - wy*v.x())/den;
+      // Half open, so that a line through a vertex counts it once
+      if (s >= 0 && s < 1) ts.push_back(t);
+    }
+    std::sort(ts.begin(),ts.end());
+    for (size_t k = 0; k+1 < ts.size(); k += 2) out.emplace_back(ts[k],ts[k+1]);
+  }
+
+  // Restricts a location to a phi segment
+  inline GeoShape::Location intersectPhi(GeoShape::Location loc, double x, double y
+					 ,double sPhi, double dPhi, double tolerance)
+  {
+    if (loc == GeoShape::OUTSIDE || isFullPhi(dPhi)) return loc;
+    GeoShape::Location phiLoc = classify(phiDistance(x,y,sPhi,dPhi),tolerance);
+    if (phiLoc == GeoShape::OUTSIDE) return GeoShape::OUTSIDE;
+    return phiLoc == GeoShape::SURFACE ? GeoShape::SURFACE : loc;
+  }
+
+  // The volume of a boolean shape, for its volume().  Operands give their
+  // own, possibly cached, volume().
+  double booleanVolume(const GeoShape* shape);
+
+  // The content of a shape, for comparing shapes: its type, parameters and
+  // operands, and the approximate memory it takes, operands excluded.
+  // Filled by getContent().
+  struct ShapeContent {
+    ShapeType                    type = 0;
+    std::vector<double>          values;
+    std::vector<std::string>     strings;
+    std::vector<const GeoShape*> operands;
+    size_t                       bytes = 0;
+  };
+  void getContent(const GeoShape* shape, ShapeContent& content);
+
+  inline size_t hashCombine(size_t seed, size_t value)
+  {
+    return seed ^ (value + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2));
+  }
+
+  // Hash of a content, given the hashes of its operands
+  size_t hashContent(const ShapeContent& content, const std::vector<size_t>& operandHashes);
+
+  // True if two contents have the same type and parameters; operands are not compared
+  inline bool sameParameters(const ShapeContent& a, const ShapeContent& b)
+  {
+    return a.type == b.type && a.values == b.values && a.strings == b.strings
+      && a.operands.size() == b.operands.size();
+  }
+
+  // Approximate heap memory of a string, beyond the string itself: none
+  // while its characters are held in place (short string optimization)
+  inline size_t heapBytes(const std::string& s)
+  {
+    const char* self = reinterpret_cast<const char*>(&s);
+    bool inPlace = s.data() >= self && s.data() < reinterpret_cast<const char*>(&s + 1);
+    return inPlace ? 0 : s.capacity() + 1;
+  }
+
+  // Approximate memory of a node, excluding the nodes it refers to.
+  size_t nodeBytes(const GeoShape* shape);
+  size_t nodeBytes(const GeoElement* element);
+  size_t nodeBytes(const GeoMaterial* material);
+  size_t nodeBytes(const GeoLogVol* logVol);
+}
+
+#endif
@@ -7,6 +7,8 @@
 #include "PolygonTriangulator.h"//For volume.
 #include <cmath>
 #include <stdexcept>
+#include "GeoShapeUtils.h"
+#include <algorithm>
 
 const std::string GeoSimplePolygonBrep::s_classType = "SimplePolygonBrep";
 const ShapeType GeoSimplePolygonBrep::s_classTypeID = 0x20;
@@ -47,6 +49,7 @@ void GeoSimplePolygonBrep::addVertex(double XVertex, double YVertex)
 {
   m_xVertices.push_back(XVertex);
   m_yVertices.push_back(YVertex);
+  invalidateExtent();
 }
 
 void GeoSimplePolygonBrep::exec(GeoShapeAction *action) const
@@ -54,3 +57,47 @@ void GeoSimplePolygonBrep::exec(GeoShapeAction *action) const
   action->handleSimplePolygonBrep(this);
 }
 
+
+GeoShape::Location GeoSimplePolygonBrep::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  if (!isValid())
+    throw std::runtime_error ("Point classification requested for incomplete simple polygon brep");
+  return GeoShapeUtils::classify(distance(p), tolerance);
+}
+
+void GeoSimplePolygonBrep::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+					    , RayIntervals &intervals) const
+{
+  if (!isValid())
+    throw std::runtime_error ("Ray intersection requested for incomplete simple polygon brep");
+  RayIntervals polygon;
+  GeoShapeUtils::polygonIntervals(p, v, m_xVertices.data(), m_yVertices.data(), getNVertices(), polygon);
+  GeoShapeUtils::slabIntervals(p.z(), v.z(), -m_dZ, m_dZ, intervals);
+  GeoShapeUtils::intersectIntervals(intervals, polygon, intervals);
+}
+
+double GeoSimplePolygonBrep::safety (const GeoTrf::Vector3D &p) const
+{
+  if (!isValid())
+    throw std::runtime_error ("Safety distance requested for incomplete simple polygon brep");
+  return std::abs(distance(p));
+}
+
+double GeoSimplePolygonBrep::distance (const GeoTrf::Vector3D &p) const
+{
+  return std::max(GeoShapeUtils::polygonDistance(p.x(), p.y(), m_xVertices.data(), m_yVertices.data(), getNVertices())
+		  , std::abs(p.z()) - m_dZ);
+}
+
+void GeoSimplePolygonBrep::computeExtent (double &xmin, double &ymin, double &zmin
+					, double &xmax, double &ymax, double &zmax) const
+{
+  if (!isValid())
+    throw std::runtime_error ("Extent requested for incomplete simple polygon brep");
+  xmin = *std::min_element(m_xVertices.begin(), m_xVertices.end());
+  xmax = *std::max_element(m_xVertices.begin(), m_xVertices.end());
+  ymin = *std::min_element(m_yVertices.begin(), m_yVertices.end());
+  ymax = *std::max_element(m_yVertices.begin(), m_yVertices.end());
+  zmin = -m_dZ;
+  zmax =  m_dZ;
+}
@@ -0,0 +1,451 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoModelKernel/GeoSubtreeInstancer.h"
+#include "GeoModelKernel/GeoPhysVol.h"
+#include "GeoModelKernel/GeoFullPhysVol.h"
+#include "GeoModelKernel/GeoTransform.h"
+#include "GeoModelKernel/GeoNameTag.h"
+#include "GeoModelKernel/GeoIdentifierTag.h"
+#include "GeoModelKernel/GeoSerialDenominator.h"
+#include "GeoModelKernel/GeoSerialIdentifier.h"
+#include "GeoModelKernel/GeoSerialTransformer.h"
+#include "GeoModelKernel/GeoContentHash.h"
+#include "GeoModelKernel/GeoMemoryAccountAction.h"
+#include "GeoModelKernel/GeoXF.h"
+#include "GeoGenericFunctions/Variable.h"
+#include "GeoShapeUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+  // Signatures are the bytes of the content of a volume, compared exactly
+  template <class T>
+  void append(std::string& signature, const T& value)
+  {
+    signature.append(reinterpret_cast<const char*>(&value),sizeof(T));
+  }
+
+  void append(std::string& signature, const std::string& value)
+  {
+    append(signature,value.size());
+    signature.append(value);
+  }
+
+  void append(std::string& signature, const GeoTrf::Transform3D& xform)
+  {
+    signature.append(reinterpret_cast<const char*>(xform.matrix().data()),12*sizeof(double));
+  }
+
+  //
+  // The state of one pass over a tree.
+  //
+  class InstancingPass
+  {
+   public:
+    InstancingPass(unsigned int minSerialCopies, double tolerance, GeoSubtreeInstancer::Statistics& stats)
+      : m_minSerialCopies(minSerialCopies)
+      , m_tolerance(tolerance)
+      , m_stats(stats)
+    {
+    }
+
+    ~InstancingPass()
+    {
+      for (auto& rebuilt : m_rebuilt) rebuilt.second->unref();
+      for (const GeoSerialTransformer* sT : m_serialized) sT->unref();
+      for (const GeoVPhysVol* vol : m_volumes) vol->unref();
+    }
+
+    void run(const GeoVPhysVol* top)
+    {
+      classify(top);
+      m_stats.nVolumes = m_volumes.size();
+      m_stats.nDistinctVolumes = m_representative.size();
+      // Only the instances kept need their daughters rewritten
+      for (const GeoVPhysVol* vol : m_representative) rewrite(vol);
+    }
+
+   private:
+    /// Returns the class of the content of a volume, classifying its
+    /// daughters first.
+    unsigned int classify(const GeoVPhysVol* vol)
+    {
+      auto found = m_classOf.find(vol);
+      if (found != m_classOf.end()) return found->second;
+
+      // Keep the volume alive while its parents are rewritten
+      vol->ref();
+      m_volumes.push_back(vol);
+
+      bool pinned = typeid(*vol) != typeid(GeoPhysVol);
+      std::string signature;
+      append(signature,classify(vol->getLogVol()));
+      for (unsigned int i = 0; i < vol->getNChildNodes(); ++i) {
+	const GeoGraphNode* node = *vol->getChildNode(i);
+	if (const GeoVPhysVol* child = dynamic_cast<const GeoVPhysVol*>(node)) {
+	  unsigned int id = classify(child);
+	  pinned |= m_pinned[id];
+	  signature += 'V';
+	  append(signature,id);
+	}
+	else if (typeid(*node) == typeid(GeoTransform)) {
+	  signature += 'T';
+	  append(signature,static_cast<const GeoTransform*>(node)->getDefTransform());
+	}
+	else if (const GeoNameTag* nameTag = dynamic_cast<const GeoNameTag*>(node)) {
+	  signature += 'N';
+	  append(signature,nameTag->getName());
+	}
+	else if (const GeoIdentifierTag* idTag = dynamic_cast<const GeoIdentifierTag*>(node)) {
+	  signature += 'I';
+	  append(signature,idTag->getIdentifier());
+	}
+	else if (const GeoSerialDenominator* sD = dynamic_cast<const GeoSerialDenominator*>(node)) {
+	  signature += 'D';
+	  append(signature,sD->getBaseName());
+	}
+	else if (const GeoSerialIdentifier* sI = dynamic_cast<const GeoSerialIdentifier*>(node)) {
+	  signature += 'S';
+	  append(signature,sI->getBaseId());
+	}
+	else if (const GeoSerialTransformer* sT = dynamic_cast<const GeoSerialTransformer*>(node)) {
+	  unsigned int id = classify(&*sT->getVolume());
+	  pinned |= m_pinned[id];
+	  signature += 'X';
+	  append(signature,id);
+	  append(signature,classify(sT));
+	}
+	else {
+	  // Alignable transforms and nodes of unknown kinds
+	  pinned = true;
+	}
+      }
+
+      unsigned int id;
+      if (pinned) {
+	id = newClass(vol,true);
+      }
+      else {
+	auto inserted = m_classes.emplace(std::move(signature),m_representative.size());
+	if (inserted.second) newClass(vol,false);
+	id = inserted.first->second;
+      }
+      m_classOf.emplace(vol,id);
+      return id;
+    }
+
+    /// Returns the class of the content of a logical volume.
+    unsigned int classify(const GeoLogVol* logVol)
+    {
+      if (!logVol) return ~0u;
+      auto found = m_logVolClassOf.find(logVol);
+      if (found != m_logVolClassOf.end()) return found->second;
+
+      size_t hash = GeoContentHash::hash(logVol);
+      unsigned int id = m_nLogVolClasses;
+      auto range = m_logVolClasses.equal_range(hash);
+      for (auto it = range.first; it != range.second; ++it) {
+	if (GeoContentHash::equal(logVol,it->second.first)) {
+	  id = it->second.second;
+	  break;
+	}
+      }
+      if (id == m_nLogVolClasses) {
+	m_logVolClasses.emplace(hash,std::make_pair(logVol,id));
+	m_nLogVolClasses++;
+      }
+      m_logVolClassOf.emplace(logVol,id);
+      return id;
+    }
+
+    /// Returns the class of the copy transforms of a serial transformer.
+    /// They are hashed from the number of copies and a few of the copies,
+    /// and compared in full only against those with the same hash.
+    unsigned int classify(const GeoSerialTransformer* sT)
+    {
+      auto found = m_serialClassOf.find(sT);
+      if (found != m_serialClassOf.end()) return found->second;
+
+      unsigned int nCopies = sT->getNCopies();
+      size_t hash = std::hash<unsigned int>()(nCopies);
+      for (unsigned int copy : {0u, 1u, nCopies - 1}) {
+	if (copy >= nCopies) continue;
+	GeoTrf::Transform3D xform = sT->getTransform(copy);
+	for (int i = 0; i < 12; ++i) hash = GeoShapeUtils::hashCombine(hash,std::hash<double>()(xform.matrix().data()[i]));
+      }
+
+      unsigned int id = m_nSerialClasses;
+      auto range = m_serialClasses.equal_range(hash);
+      for (auto it = range.first; it != range.second; ++it) {
+	if (sameTransforms(sT,it->second.first)) {
+	  id = it->second.second;
+	  break;
+	}
+      }
+      if (id == m_nSerialClasses) {
+	m_serialClasses.emplace(hash,std::make_pair(sT,id));
+	m_nSerialClasses++;
+      }
+      m_serialClassOf.emplace(sT,id);
+      return id;
+    }
+
+    static bool sameTransforms(const GeoSerialTransformer* a, const GeoSerialTransformer* b)
+    {
+      if (a->getNCopies() != b->getNCopies()) return false;
+      if (a->getFunction() == b->getFunction()) return true;
+      for (unsigned int copy = 0; copy < a->getNCopies(); ++copy) {
+	if (a->getTransform(copy).matrix() != b->getTransform(copy).matrix()) return false;
+      }
+      return true;
+    }
+
+    unsigned int newClass(const GeoVPhysVol* vol, bool pinned)
+    {
+      m_representative.push_back(vol);
+      m_pinned.push_back(pinned);
+      return m_representative.size() - 1;
+    }
+
+    const GeoVPhysVol* representative(const GeoVPhysVol* vol) const
+    {
+      return m_representative[m_classOf.at(vol)];
+    }
+
+    /// Points the daughters of a volume to the shared instances, and
+    /// replaces its runs of placements.
+    void rewrite(const GeoVPhysVol* vol)
+    {
+      // Volumes of other classes may not take new daughters, and are left
+      // as they are rather than failing with the tree half rewritten
+      if (typeid(*vol) != typeid(GeoPhysVol) && typeid(*vol) != typeid(GeoFullPhysVol)) return;
+      const GeoFullPhysVol* fullVol = dynamic_cast<const GeoFullPhysVol*>(vol);
+      if (fullVol && fullVol->cloneOrigin()) return;
+
+      std::vector<GeoGraphNode*> nodes;
+      nodes.reserve(vol->getNChildNodes());
+      bool changed = false;
+      for (unsigned int i = 0; i < vol->getNChildNodes(); ++i) {
+	const GeoGraphNode* node = *vol->getChildNode(i);
+	const GeoGraphNode* replacement = node;
+	if (const GeoVPhysVol* child = dynamic_cast<const GeoVPhysVol*>(node)) {
+	  replacement = representative(child);
+	}
+	else if (const GeoSerialTransformer* sT = dynamic_cast<const GeoSerialTransformer*>(node)) {
+	  replacement = rebuild(sT);
+	}
+	if (replacement != node) {
+	  m_stats.nReplacedPlacements++;
+	  changed = true;
+	}
+	nodes.push_back(const_cast<GeoGraphNode*>(replacement));
+      }
+      if (m_minSerialCopies && serialize(nodes)) changed = true;
+      if (changed) const_cast<GeoVPhysVol*>(vol)->setChildNodes(nodes);
+    }
+
+    /// Returns the serial transformer replicating the shared instance of
+    /// the volume of sT, sT itself if it does already.
+    const GeoSerialTransformer* rebuild(const GeoSerialTransformer* sT)
+    {
+      const GeoVPhysVol* vol = representative(&*sT->getVolume());
+      if (vol == &*sT->getVolume()) return sT;
+      auto found = m_rebuilt.find(sT);
+      if (found != m_rebuilt.end()) return found->second;
+      GeoSerialTransformer* rebuilt = new GeoSerialTransformer(vol,sT->getFunction(),sT->getNCopies());
+      rebuilt->ref();
+      m_rebuilt.emplace(sT,rebuilt);
+      return rebuilt;
+    }
+
+    /// A daughter volume and the nodes before it.
+    struct Placement {
+      size_t begin;
+      size_t end;
+      /// Serial denominators and identifiers end here, before the transform.
+      size_t tags;
+      const GeoTransform* xform;
+      const GeoVPhysVol*  vol;
+    };
+
+    /// Replaces the runs of placements of nodes by serial transformers,
+    /// returning true if there were any.
+    bool serialize(std::vector<GeoGraphNode*>& nodes)
+    {
+      std::vector<Placement> placements;
+      size_t begin = 0;
+      for (size_t i = 0; i < nodes.size(); ++i) {
+	if (dynamic_cast<const GeoVPhysVol*>(nodes[i]) || dynamic_cast<const GeoSerialTransformer*>(nodes[i])) {
+	  placements.push_back(makePlacement(nodes,begin,i + 1));
+	  begin = i + 1;
+	}
+      }
+      if (placements.size() < m_minSerialCopies) return false;
+
+      std::vector<GeoGraphNode*> serialized;
+      size_t copied = 0;
+      for (size_t p = 0; p < placements.size();) {
+	const Placement& first = placements[p];
+	GeoSerialTransformer* sT = nullptr;
+	size_t nCopies = 0;
+	if (first.vol && placements.size() - p >= m_minSerialCopies && placements[p + 1].vol == first.vol) {
+	  const GeoTrf::Transform3D& x0 = first.xform->getDefTransform();
+	  const GeoTrf::Transform3D& x1 = placements[p + 1].xform->getDefTransform();
+	  GeoGenfun::Variable x;
+	  // Steps applied on the right, x0*Pow(D,i), as for a row of modules
+	  // along their own axis, or on the left, Pow(D,i)*x0, as for a ring of
+	  // modules turned about an axis of the mother.  Pow() is a true power
+	  // only when the translation of D lies along its axis, so the two are
+	  // not equivalent.
+	  GeoXF::PreMult right = x0 * GeoXF::Pow(x0.inverse() * x1,x);
+	  GeoXF::PostMult left = GeoXF::Pow(x1 * x0.inverse(),x) * x0;
+	  size_t nRight = runLength(placements,p,right);
+	  size_t nLeft = runLength(placements,p,left);
+	  nCopies = std::max(nRight,nLeft);
+	  if (nCopies >= m_minSerialCopies) {
+	    const GeoXF::Function& function = nRight >= nLeft ? static_cast<const GeoXF::Function&>(right) : left;
+	    sT = new GeoSerialTransformer(first.vol,&function,nCopies);
+	    sT->ref();
+	    // The copies must be where the placements were
+	    for (size_t i = 0; i < nCopies && sT; ++i) {
+	      if (!close(sT->getTransform(i),placements[p + i].xform->getDefTransform())) {
+		sT->unref();
+		sT = nullptr;
+	      }
+	    }
+	    if (sT) m_serialized.push_back(sT);
+	  }
+	}
+	if (!sT) {
+	  p++;
+	  continue;
+	}
+
+	serialized.insert(serialized.end(),nodes.begin() + copied,nodes.begin() + first.tags);
+	serialized.push_back(sT);
+	copied = placements[p + nCopies - 1].end;
+	m_stats.nSerialTransformers++;
+	m_stats.nSerializedPlacements += nCopies;
+	p += nCopies;
+      }
+      if (copied == 0) return false;
+      serialized.insert(serialized.end(),nodes.begin() + copied,nodes.end());
+      nodes.swap(serialized);
+      return true;
+    }
+
+    /// A placement of nodes[begin,end), with its volume and transform if
+    /// it may be part of a run.
+    Placement makePlacement(const std::vector<GeoGraphNode*>& nodes, size_t begin, size_t end) const
+    {
+      Placement placement{begin,end,begin,nullptr,nullptr};
+      size_t i = begin;
+      while (i < end && (dynamic_cast<const GeoSerialDenominator*>(nodes[i]) || dynamic_cast<const GeoSerialIdentifier*>(nodes[i]))) i++;
+      placement.tags = i;
+      if (end - i == 2 && typeid(*nodes[i]) == typeid(GeoTransform)) {
+	const GeoVPhysVol* vol = dynamic_cast<const GeoVPhysVol*>(nodes[i + 1]);
+	if (vol && !m_pinned[m_classOf.at(vol)]) {
+	  placement.xform = static_cast<const GeoTransform*>(nodes[i]);
+	  placement.vol = vol;
+	}
+      }
+      return placement;
+    }
+
+    /// The number of placements from p on following function(i).
+    size_t runLength(const std::vector<Placement>& placements, size_t p, const GeoXF::Function& function) const
+    {
+      size_t n = 0;
+      for (size_t q = p; q < placements.size(); ++q, ++n) {
+	const Placement& placement = placements[q];
+	if (!placement.vol || placement.vol != placements[p].vol) break;
+	if (q != p && placement.tags != placement.begin) break;
+	if (!close(function(n),placement.xform->getDefTransform())) break;
+      }
+      return n;
+    }
+
+    bool close(const GeoTrf::Transform3D& a, const GeoTrf::Transform3D& b) const
+    {
+      for (int row = 0; row < 3; ++row) {
+	for (int column = 0; column < 4; ++column) {
+	  double difference = std::abs(a(row,column) - b(row,column));
+	  if (difference > m_tolerance * std::max(1.0,std::abs(b(row,column)))) return false;
+	}
+      }
+      return true;
+    }
+
+    unsigned int                                                    m_minSerialCopies;
+    double                                                          m_tolerance;
+    GeoSubtreeInstancer::Statistics&                                m_stats;
+
+    /// The volumes classified, the class of each, and the instance kept
+    /// for each class.
+    std::vector<const GeoVPhysVol*>                                 m_volumes;
+    std::unordered_map<const GeoVPhysVol*,unsigned int>             m_classOf;
+    std::vector<const GeoVPhysVol*>                                 m_representative;
+    std::vector<bool>                                               m_pinned;
+    std::unordered_map<std::string,unsigned int>                    m_classes;
+
+    std::unordered_map<const GeoLogVol*,unsigned int>               m_logVolClassOf;
+    std::unordered_multimap<size_t,std::pair<const GeoLogVol*,unsigned int>> m_logVolClasses;
+    unsigned int                                                    m_nLogVolClasses = 0;
+
+    std::unordered_map<const GeoSerialTransformer*,unsigned int>    m_serialClassOf;
+    std::unordered_multimap<size_t,std::pair<const GeoSerialTransformer*,unsigned int>> m_serialClasses;
+    unsigned int                                                    m_nSerialClasses = 0;
+
+    std::unordered_map<const GeoSerialTransformer*,GeoSerialTransformer*> m_rebuilt;
+    /// The serial transformers built from runs, held until their volumes hold them.
+    std::vector<const GeoSerialTransformer*>                        m_serialized;
+  };
+
+  void account(PVConstLink top, unsigned long& nodes, size_t& bytes)
+  {
+    GeoMemoryAccountAction action;
+    top->exec(&action);
+    nodes = action.getTotal().count;
+    bytes = action.getTotal().bytes;
+  }
+}
+
+GeoSubtreeInstancer::GeoSubtreeInstancer()
+  : m_minSerialCopies(8)
+  , m_tolerance(1e-9)
+{
+}
+
+GeoSubtreeInstancer::~GeoSubtreeInstancer()
+{
+}
+
+void GeoSubtreeInstancer::setMinSerialCopies(unsigned int nCopies)
+{
+  // A run of one placement is not worth a serial transformer
+  m_minSerialCopies = nCopies == 1 ? 2 : nCopies;
+}
+
+void GeoSubtreeInstancer::setTolerance(double tolerance)
+{
+  m_tolerance = tolerance;
+}
+
+const GeoSubtreeInstancer::Statistics& GeoSubtreeInstancer::apply(PVLink top)
+{
+  m_stats = Statistics();
+  account(top,m_stats.nodesBefore,m_stats.bytesBefore);
+  {
+    InstancingPass pass(m_minSerialCopies,m_tolerance,m_stats);
+    pass.run(&*top);
+  }
+  account(top,m_stats.nodesAfter,m_stats.bytesAfter);
+  return m_stats;
+}
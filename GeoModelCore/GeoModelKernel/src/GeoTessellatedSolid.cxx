@@ -4,18 +4,39 @@
 
 #include "GeoModelKernel/GeoTessellatedSolid.h"
 #include "GeoModelKernel/GeoShapeAction.h"
+#include "GeoShapeUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
 
 const std::string GeoTessellatedSolid::s_classType = "TessellatedSolid";
 const ShapeType GeoTessellatedSolid::s_classTypeID = 0x21;
 
 GeoTessellatedSolid::GeoTessellatedSolid()
+  : m_verticesPerFacet(3)
+  , m_meshFacets(nullptr)
 {
 }
 
+GeoTessellatedSolid::GeoTessellatedSolid(std::vector<GeoFacetVertex> vertices
+					 , std::vector<unsigned int> indices
+					 , unsigned int verticesPerFacet)
+  : m_verticesPerFacet(3)
+  , m_meshFacets(nullptr)
+{
+  setMesh(std::move(vertices), std::move(indices), verticesPerFacet);
+}
+
 GeoTessellatedSolid::~GeoTessellatedSolid()
 {
   for(size_t i=0; i<m_facets.size(); ++i)
     m_facets[i]->unref();
+  GeoFacet* const* meshFacets = m_meshFacets.load();
+  if (meshFacets) {
+    for (size_t i = 0; i < getNumberOfFacets(); ++i) meshFacets[i]->unref();
+    delete [] meshFacets;
+  }
 }
 
 double GeoTessellatedSolid::volume() const
@@ -23,14 +44,13 @@ double GeoTessellatedSolid::volume() const
   if (!isValid ())
     throw std::runtime_error ("Volume requested for incomplete tessellated solid");
   double v = 0.;
-  for (size_t i = 0; i < m_facets.size(); ++i)
+  GeoFacetVertex vertex[4];
+  for (size_t i = 0; i < getNumberOfFacets(); ++i)
   {
-    GeoFacet* facet = getFacet(i);
-    GeoTrf::Vector3D e1 = facet->getVertex(2) - facet->getVertex(0);
-    GeoTrf::Vector3D e2 = (facet->getNumberOfVertices() == 4) ?
-      facet->getVertex(3) - facet->getVertex(1) :
-      facet->getVertex(2) - facet->getVertex(1);
-    v += facet->getVertex(0).dot(e1.cross(e2));
+    size_t n = getFacetVertices(i, vertex);
+    GeoTrf::Vector3D e1 = vertex[2] - vertex[0];
+    GeoTrf::Vector3D e2 = (n == 4) ? vertex[3] - vertex[1] : vertex[2] - vertex[1];
+    v += vertex[0].dot(e1.cross(e2));
   }
   if (v < 0.)
     throw std::runtime_error ("Incorrect order of vertices in tessellated solid");
@@ -54,16 +74,260 @@ void GeoTessellatedSolid::exec(GeoShapeAction *action) const
 
 void GeoTessellatedSolid::addFacet(GeoFacet* facet)
 {
+  if (isIndexed())
+    throw std::runtime_error ("Facet added to a tessellated solid made of a mesh");
   facet->ref();
   m_facets.push_back(facet);
+  invalidateExtent();
 }
   
 GeoFacet* GeoTessellatedSolid::getFacet(size_t index) const
 {
-  return (index<m_facets.size() ? m_facets[index] : 0);
+  if (!isIndexed()) return (index<m_facets.size() ? m_facets[index] : 0);
+  if (index >= getNumberOfFacets()) return 0;
+
+  GeoFacet* const* meshFacets = m_meshFacets.load(std::memory_order_acquire);
+  if (!meshFacets) {
+    // Build the facets.  If another thread got there first, use its facets instead
+    size_t nFacets = getNumberOfFacets();
+    GeoFacet** newFacets = new GeoFacet*[nFacets];
+    GeoFacetVertex v[4];
+    for (size_t i = 0; i < nFacets; ++i) {
+      if (getFacetVertices(i, v) == 4)
+	newFacets[i] = new GeoQuadrangularFacet(v[0], v[1], v[2], v[3], GeoFacet::ABSOLUTE);
+      else
+	newFacets[i] = new GeoTriangularFacet(v[0], v[1], v[2], GeoFacet::ABSOLUTE);
+      newFacets[i]->ref();
+    }
+    if (m_meshFacets.compare_exchange_strong(meshFacets, newFacets, std::memory_order_acq_rel)) {
+      meshFacets = newFacets;
+    }
+    else {
+      for (size_t i = 0; i < nFacets; ++i) newFacets[i]->unref();
+      delete [] newFacets;
+    }
+  }
+  return meshFacets[index];
 }
 
 size_t GeoTessellatedSolid::getNumberOfFacets() const
 {
-  return m_facets.size();
+  return isIndexed() ? m_indices.size() / m_verticesPerFacet : m_facets.size();
+}
+
+void GeoTessellatedSolid::setMesh(std::vector<GeoFacetVertex> vertices
+				  , std::vector<unsigned int> indices
+				  , unsigned int verticesPerFacet)
+{
+  if (!m_facets.empty() || isIndexed())
+    throw std::runtime_error ("Mesh set on a tessellated solid which has facets already");
+  if (indices.empty())
+    throw std::runtime_error ("Tessellated solid mesh without facets");
+  if (verticesPerFacet != 3 && verticesPerFacet != 4)
+    throw std::runtime_error ("Tessellated solid mesh with facets of neither 3 nor 4 vertices");
+  if (indices.size() % verticesPerFacet)
+    throw std::runtime_error ("Tessellated solid mesh with an incomplete facet");
+  for (size_t i = 0; i < indices.size(); ++i) {
+    bool triangle = verticesPerFacet == 4 && i % 4 == 3 && indices[i] == NO_VERTEX;
+    if (indices[i] >= vertices.size() && !triangle)
+      throw std::runtime_error ("Tessellated solid mesh with an index out of range");
+  }
+  m_vertices = std::move(vertices);
+  m_indices = std::move(indices);
+  m_verticesPerFacet = verticesPerFacet;
+  invalidateExtent();
+}
+
+size_t GeoTessellatedSolid::getFacetVertices(size_t index, GeoFacetVertex v[4]) const
+{
+  if (isIndexed()) {
+    const unsigned int* facet = &m_indices[index * m_verticesPerFacet];
+    size_t n = (m_verticesPerFacet == 4 && facet[3] != NO_VERTEX) ? 4 : 3;
+    for (size_t i = 0; i < n; ++i) v[i] = m_vertices[facet[i]];
+    return n;
+  }
+  const GeoFacet* facet = m_facets[index];
+  size_t n = facet->getNumberOfVertices();
+  for (size_t i = 0; i < n; ++i) {
+    v[i] = facet->getVertex(i);
+    if (i > 0 && facet->getVertexType() == GeoFacet::RELATIVE) v[i] += v[0];
+  }
+  return n;
+}
+
+namespace {
+  // Distance from a point to a triangle, see Ericson, Real-Time Collision Detection, 5.1.5
+  double triangleDistance(const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &a
+			  , const GeoTrf::Vector3D &b, const GeoTrf::Vector3D &c)
+  {
+    GeoTrf::Vector3D ab = b - a, ac = c - a, ap = p - a;
+    double d1 = ab.dot(ap), d2 = ac.dot(ap);
+    if (d1 <= 0 && d2 <= 0) return ap.norm();
+    GeoTrf::Vector3D bp = p - b;
+    double d3 = ab.dot(bp), d4 = ac.dot(bp);
+    if (d3 >= 0 && d4 <= d3) return bp.norm();
+    double vc = d1 * d4 - d3 * d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0) return (p - (a + ab * (d1 / (d1 - d3)))).norm();
+    GeoTrf::Vector3D cp = p - c;
+    double d5 = ab.dot(cp), d6 = ac.dot(cp);
+    if (d6 >= 0 && d5 <= d6) return cp.norm();
+    double vb = d5 * d2 - d1 * d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0) return (p - (a + ac * (d2 / (d2 - d6)))).norm();
+    double va = d3 * d6 - d5 * d4;
+    if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+      return (p - (b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6))))).norm();
+    double denom = 1.0 / (va + vb + vc);
+    return (p - (a + ab * (vb * denom) + ac * (vc * denom))).norm();
+  }
+
+  // Ray/triangle crossing, Moller-Trumbore.  Returns -1 if the ray grazes an edge
+  int rayCrosses(const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &dir, const GeoTrf::Vector3D &a
+		 , const GeoTrf::Vector3D &b, const GeoTrf::Vector3D &c)
+  {
+    const double eps = 1e-12;
+    GeoTrf::Vector3D e1 = b - a, e2 = c - a;
+    GeoTrf::Vector3D h = dir.cross(e2);
+    double det = e1.dot(h);
+    if (std::abs(det) < eps) return 0;
+    GeoTrf::Vector3D s = p - a;
+    double u = s.dot(h) / det;
+    GeoTrf::Vector3D q = s.cross(e1);
+    double v = dir.dot(q) / det;
+    if (u < -eps || v < -eps || u + v > 1 + eps) return 0;
+    if (e2.dot(q) / det <= 0) return 0;
+    if (u < eps || v < eps || u + v > 1 - eps) return -1;
+    return 1;
+  }
+
+  // Calls f(a, b, c) for each triangle of the facets, a quadrangle being split
+  // in two, until f returns false.  Reads the facets in place, without copying
+  // the solid into a triangle buffer
+  template <class F>
+  void forEachTriangle(const GeoTessellatedSolid &solid, F f)
+  {
+    GeoFacetVertex v[4];
+    for (size_t facet = 0; facet < solid.getNumberOfFacets(); ++facet) {
+      size_t n = solid.getFacetVertices(facet, v);
+      if (!f(v[0], v[1], v[2])) return;
+      if (n == 4 && !f(v[0], v[2], v[3])) return;
+    }
+  }
+}
+
+GeoShape::Location GeoTessellatedSolid::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  if (!isValid ())
+    throw std::runtime_error ("Point classification requested for incomplete tessellated solid");
+
+  bool surface = false;
+  forEachTriangle(*this, [&](const GeoTrf::Vector3D &a, const GeoTrf::Vector3D &b, const GeoTrf::Vector3D &c) {
+    surface = triangleDistance(p, a, b, c) <= tolerance;
+    return !surface;
+  });
+  if (surface) return SURFACE;
+
+  // Count the crossings of a ray.  Try another direction if it grazes an edge
+  static const GeoTrf::Vector3D directions[] = {
+    GeoTrf::Vector3D(0.5773, 0.5774, 0.5773).normalized(),
+    GeoTrf::Vector3D(-0.2673, 0.8018, -0.5345).normalized(),
+    GeoTrf::Vector3D(0.8729, -0.2182, 0.4364).normalized()
+  };
+  int crossings = 0;
+  for (const GeoTrf::Vector3D &dir : directions) {
+    crossings = 0;
+    bool grazed = false;
+    forEachTriangle(*this, [&](const GeoTrf::Vector3D &a, const GeoTrf::Vector3D &b, const GeoTrf::Vector3D &c) {
+      int cross = rayCrosses(p, dir, a, b, c);
+      if (cross < 0) grazed = true;
+      else crossings += cross;
+      return !grazed;
+    });
+    if (!grazed) break;
+  }
+  return crossings % 2 ? INSIDE : OUTSIDE;
+}
+
+void GeoTessellatedSolid::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+					   , RayIntervals &intervals) const
+{
+  if (!isValid ())
+    throw std::runtime_error ("Ray intersection requested for incomplete tessellated solid");
+
+  // Crossings of the line with the facets, and whether they enter (+1) or leave (-1)
+  // the solid, according to the outward normals
+  const double eps = 1e-12;
+  std::vector<std::pair<double,int> > crossings;
+  forEachTriangle(*this, [&](const GeoTrf::Vector3D &a, const GeoTrf::Vector3D &b, const GeoTrf::Vector3D &c) {
+    GeoTrf::Vector3D e1 = b - a, e2 = c - a;
+    GeoTrf::Vector3D h = v.cross(e2);
+    double det = e1.dot(h);
+    if (std::abs(det) < eps) return true;
+    GeoTrf::Vector3D s = p - a;
+    double u = s.dot(h) / det;
+    GeoTrf::Vector3D q = s.cross(e1);
+    double w = v.dot(q) / det;
+    if (u < -eps || w < -eps || u + w > 1 + eps) return true;
+    crossings.emplace_back(e2.dot(q) / det, v.dot(e1.cross(e2)) < 0 ? 1 : -1);
+    return true;
+  });
+  std::sort(crossings.begin(), crossings.end());
+
+  // A line through an edge or a vertex crosses several facets at once. Count
+  // each of these crossings once per direction
+  intervals.clear();
+  int depth = 0;
+  double start = 0;
+  for (size_t i = 0; i < crossings.size(); ++i) {
+    bool seen = false;
+    for (size_t k = i; k-- > 0 && crossings[i].first - crossings[k].first <= 1e-9; ) {
+      if (crossings[k].second == crossings[i].second) seen = true;
+    }
+    if (seen) continue;
+    if (crossings[i].second > 0) {
+      if (depth++ == 0) start = crossings[i].first;
+    }
+    else if (depth > 0 && --depth == 0) {
+      intervals.emplace_back(start, crossings[i].first);
+    }
+  }
+}
+
+double GeoTessellatedSolid::safety (const GeoTrf::Vector3D &p) const
+{
+  if (!isValid ())
+    throw std::runtime_error ("Safety distance requested for incomplete tessellated solid");
+  double d = HUGE_VAL;
+  forEachTriangle(*this, [&](const GeoTrf::Vector3D &a, const GeoTrf::Vector3D &b, const GeoTrf::Vector3D &c) {
+    d = std::min(d, triangleDistance(p, a, b, c));
+    return true;
+  });
+  return d;
+}
+
+void GeoTessellatedSolid::computeExtent (double &xmin, double &ymin, double &zmin
+				       , double &xmax, double &ymax, double &zmax) const
+{
+  if (!isValid ())
+    throw std::runtime_error ("Extent requested for incomplete tessellated solid");
+  GeoTrf::Vector3D lo(HUGE_VAL, HUGE_VAL, HUGE_VAL), hi(-HUGE_VAL, -HUGE_VAL, -HUGE_VAL);
+  if (isIndexed()) {
+    // Vertices used by no facet do not count
+    for (unsigned int index : m_indices) {
+      if (index == NO_VERTEX) continue;
+      lo = lo.cwiseMin(m_vertices[index]);
+      hi = hi.cwiseMax(m_vertices[index]);
+    }
+  }
+  else {
+    GeoTrf::Vector3D v[4];
+    for (size_t f = 0; f < m_facets.size(); ++f) {
+      size_t n = getFacetVertices(f, v);
+      for (size_t i = 0; i < n; ++i) {
+	lo = lo.cwiseMin(v[i]);
+	hi = hi.cwiseMax(v[i]);
+      }
+    }
+  }
+  xmin = lo.x(); ymin = lo.y(); zmin = lo.z();
+  xmax = hi.x(); ymax = hi.y(); zmax = hi.z();
 }
@@ -5,6 +5,10 @@
 #include "GeoModelKernel/GeoTorus.h"
 #include "GeoModelKernel/GeoShapeAction.h"
 #include <cmath>
+#include "GeoShapeUtils.h"
+#include <algorithm>
+#include <complex>
+#include <vector>
 
 const std::string GeoTorus::s_classType = "Torus";
 const ShapeType GeoTorus::s_classTypeID = 0x24;
@@ -46,3 +50,91 @@ void GeoTorus::exec (GeoShapeAction *action) const
 {
   action->handleTorus(this);
 }
+
+GeoShape::Location GeoTorus::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  return GeoShapeUtils::intersectPhi(GeoShapeUtils::classify(radialDistance(p), tolerance), p.x(), p.y(), m_sPhi, m_dPhi, tolerance);
+}
+
+namespace {
+  // Intervals in which p+t*v is inside the torus of tube radius r around the circle of
+  // radius rTor, where the quartic (|q|^2 + rTor^2 - r^2)^2 - 4 rTor^2 (qx^2 + qy^2) is negative
+  void torusIntervals(const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v, double rTor, double r
+		      , GeoShape::RayIntervals &out)
+  {
+    out.clear();
+    // Expand around the point of the line nearest to the centre, where the coefficients are best conditioned
+    double vv = v.squaredNorm();
+    double t0 = -p.dot(v) / vv;
+    GeoTrf::Vector3D q = p + t0 * v;
+    double b1 = 2.0 * q.dot(v), c1 = q.squaredNorm() + rTor * rTor - r * r;
+    double a2 = v.x() * v.x() + v.y() * v.y(), b2 = 2.0 * (q.x() * v.x() + q.y() * v.y()), c2 = q.x() * q.x() + q.y() * q.y();
+    double k = 4.0 * rTor * rTor;
+    const double c[5] = { c1 * c1 - k * c2
+			  , 2.0 * b1 * c1 - k * b2
+			  , b1 * b1 + 2.0 * vv * c1 - k * a2
+			  , 2.0 * vv * b1
+			  , vv * vv };
+    auto f = [&c](double t) { return (((c[4] * t + c[3]) * t + c[2]) * t + c[1]) * t + c[0]; };
+    auto df = [&c](double t) { return ((4.0 * c[4] * t + 3.0 * c[3]) * t + 2.0 * c[2]) * t + c[1]; };
+
+    // Real roots, as eigenvalues of the companion matrix, polished by Newton iterations
+    Eigen::Matrix4d companion = Eigen::Matrix4d::Zero();
+    for (int i = 0; i < 3; ++i) companion(i + 1, i) = 1.0;
+    for (int i = 0; i < 4; ++i) companion(i, 3) = -c[i] / c[4];
+    Eigen::EigenSolver<Eigen::Matrix4d> solver(companion, false);
+    std::vector<double> roots;
+    for (int i = 0; i < 4; ++i) {
+      std::complex<double> z = solver.eigenvalues()[i];
+      if (std::abs(z.imag()) > 1e-7 * (1.0 + std::abs(z.real()))) continue;
+      double t = z.real();
+      for (int it = 0; it < 3; ++it) {
+	double slope = df(t);
+	if (slope == 0) break;
+	t -= f(t) / slope;
+      }
+      roots.push_back(t);
+    }
+
+    // The quartic is positive far away. It is negative between some pairs of adjacent roots
+    std::sort(roots.begin(), roots.end());
+    for (size_t i = 0; i + 1 < roots.size(); ++i) {
+      if (f(0.5 * (roots[i] + roots[i+1])) < 0) out.emplace_back(roots[i] + t0, roots[i+1] + t0);
+    }
+  }
+}
+
+void GeoTorus::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+				, RayIntervals &intervals) const
+{
+  RayIntervals other;
+  torusIntervals(p, v, m_rTor, m_rMax, intervals);
+  if (m_rMin > 0) {
+    torusIntervals(p, v, m_rTor, m_rMin, other);
+    GeoShapeUtils::subtractIntervals(intervals, other, intervals);
+  }
+  GeoShapeUtils::phiIntervals(p, v, m_sPhi, m_dPhi, other);
+  GeoShapeUtils::intersectIntervals(intervals, other, intervals);
+}
+
+double GeoTorus::safety (const GeoTrf::Vector3D &p) const
+{
+  return std::abs(std::max(radialDistance(p), GeoShapeUtils::phiDistance(p.x(), p.y(), m_sPhi, m_dPhi)));
+}
+
+double GeoTorus::radialDistance (const GeoTrf::Vector3D &p) const
+{
+  // Distance from the centre line of the tube
+  double r = std::hypot(std::hypot(p.x(), p.y()) - m_rTor, p.z());
+  double d = r - m_rMax;
+  if (m_rMin > 0) d = std::max(d, m_rMin - r);
+  return d;
+}
+
+void GeoTorus::computeExtent (double &xmin, double &ymin, double &zmin
+			    , double &xmax, double &ymax, double &zmax) const
+{
+  GeoShapeUtils::sectorExtent(std::max(0.0, m_rTor - m_rMax), m_rTor + m_rMax, m_sPhi, m_dPhi, xmin, ymin, xmax, ymax);
+  zmin = -m_rMax;
+  zmax =  m_rMax;
+}
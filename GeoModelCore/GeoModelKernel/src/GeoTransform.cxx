@@ -4,24 +4,115 @@
 
 #include "GeoModelKernel/GeoTransform.h"
 #include "GeoModelKernel/GeoNodeAction.h"
+#include <cmath>
+#include <limits>
+
+namespace {
+
+  // Rotations built from an angle and an axis have entries like (1-c)+c, which
+  // may miss 1 by a rounding error; such entries are taken to be exact.
+  constexpr double TOLERANCE = 4*std::numeric_limits<double>::epsilon();
+
+  inline bool equal(double a, double b)
+  {
+    return std::abs(a-b) <= TOLERANCE;
+  }
+
+  // Rotates the columns i and j of the linear part of x, that is multiplies
+  // it on the right by a rotation about the third axis
+  inline void rotateColumns(GeoTrf::Transform3D& x, int i, int j, double c, double s)
+  {
+    auto linear = x.linear();
+    const GeoTrf::Vector3D ci = linear.col(i);
+    const GeoTrf::Vector3D cj = linear.col(j);
+    linear.col(i) = c*ci + s*cj;
+    linear.col(j) = c*cj - s*ci;
+  }
+}
 
 GeoTransform::GeoTransform (const GeoTrf::Transform3D& transform)
-  : m_transform(transform)
+  : m_kind(GENERAL)
+  , m_axis(0)
+  , m_translation{transform(0,3),transform(1,3),transform(2,3)}
+  , m_matrix(nullptr)
 {
+  // Only forms that reproduce the matrix up to rounding errors are used
+  const auto linear = transform.linear();
+  bool identity = true;
+  for (int r = 0; r < 3; ++r) {
+    for (int c = 0; c < 3; ++c) {
+      if (!equal(linear(r,c),r==c ? 1.0 : 0.0)) identity = false;
+    }
+  }
+  if (identity) {
+    m_kind = (m_translation[0]==0 && m_translation[1]==0 && m_translation[2]==0) ? IDENTITY : TRANSLATION;
+    return;
+  }
+
+  for (int a = 0; a < 3; ++a) {
+    const int i = (a+1)%3, j = (a+2)%3;
+    if (equal(linear(a,a),1) && equal(linear(a,i),0) && equal(linear(a,j),0) && equal(linear(i,a),0)
+	&& equal(linear(j,a),0) && equal(linear(i,i),linear(j,j)) && equal(linear(i,j),-linear(j,i))) {
+      m_kind = AXIS_ROTATION;
+      m_axis = a;
+      m_cosSin[0] = linear(i,i);
+      m_cosSin[1] = linear(j,i);
+      return;
+    }
+  }
+
+  m_matrix = new double[9];
+  for (int c = 0; c < 3; ++c) {
+    for (int r = 0; r < 3; ++r) m_matrix[3*c+r] = linear(r,c);
+  }
 }
 
 GeoTransform::~GeoTransform()
 {
+  if (m_kind==GENERAL) delete [] m_matrix;
 }
 
-GeoTrf::Transform3D GeoTransform::getTransform(const GeoVAlignmentStore* /*store*/) const
+GeoTrf::Transform3D GeoTransform::getTransform(const GeoVAlignmentStore* store) const
 {
-  return m_transform;
+  return getDefTransform(store);
 }
 
 GeoTrf::Transform3D GeoTransform::getDefTransform(const GeoVAlignmentStore* /*store*/) const
 {
-  return m_transform;
+  GeoTrf::Transform3D x(GeoTrf::Transform3D::Identity());
+  if (m_kind==IDENTITY) return x;
+  x.translation() = GeoTrf::Vector3D(m_translation[0],m_translation[1],m_translation[2]);
+  if (m_kind==AXIS_ROTATION) {
+    const int i = (m_axis+1)%3, j = (m_axis+2)%3;
+    x(i,i) = x(j,j) = m_cosSin[0];
+    x(j,i) = m_cosSin[1];
+    x(i,j) = -m_cosSin[1];
+  }
+  else if (m_kind==GENERAL) {
+    x.linear() = Eigen::Map<const GeoTrf::RotationMatrix3D>(m_matrix);
+  }
+  return x;
+}
+
+void GeoTransform::accumulateTransform(GeoTrf::Transform3D& x, const GeoVAlignmentStore* /*store*/) const
+{
+  accumulateDefTransform(x);
+}
+
+#if defined(FLATTEN) && defined(__GNUC__)
+// See GeoAlignableTransform.cxx: keep the Eigen code inlined in debug builds.
+__attribute__ ((flatten))
+#endif
+void GeoTransform::accumulateDefTransform(GeoTrf::Transform3D& x) const
+{
+  if (m_kind==IDENTITY) return;
+  x.translation() += x.linear()*GeoTrf::Vector3D(m_translation[0],m_translation[1],m_translation[2]);
+  if (m_kind==AXIS_ROTATION) {
+    rotateColumns(x,(m_axis+1)%3,(m_axis+2)%3,m_cosSin[0],m_cosSin[1]);
+  }
+  else if (m_kind==GENERAL) {
+    x.linear() = x.linear()*Eigen::Map<const GeoTrf::RotationMatrix3D>(m_matrix);
+  }
 }
 
 void GeoTransform::exec(GeoNodeAction *action) const
@@ -4,6 +4,9 @@
 
 #include "GeoModelKernel/GeoTrap.h"
 #include "GeoModelKernel/GeoShapeAction.h"
+#include "GeoShapeUtils.h"
+#include <cmath>
+#include <algorithm>
 
 const std::string GeoTrap::s_classType = "Trap";
 const ShapeType GeoTrap::s_classTypeID = 0x15;
@@ -54,3 +57,104 @@ void GeoTrap::exec (GeoShapeAction *action) const
 {
   action->handleTrap(this);
 }
+
+GeoShape::Location GeoTrap::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  return GeoShapeUtils::classify(distance(p), tolerance);
+}
+
+void GeoTrap::inside (size_t n, const double *x, const double *y, const double *z
+		      , Location *result, double tolerance) const
+{
+  // The side planes are built once for all the points
+  GeoTrf::Vector3D nk[4];
+  double d[4];
+  getSidePlanes(nk, d);
+  for (size_t i = 0; i < n; ++i) {
+    double dist = std::abs(z[i]) - m_zHalfLength;
+    for (unsigned int k = 0; k < 4; ++k) {
+      dist = std::max(dist, nk[k].x() * x[i] + nk[k].y() * y[i] + nk[k].z() * z[i] - d[k]);
+    }
+    result[i] = GeoShapeUtils::classify(dist, tolerance);
+  }
+}
+
+void GeoTrap::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+			       , RayIntervals &intervals) const
+{
+  GeoTrf::Vector3D n[4];
+  double d[4];
+  getSidePlanes(n, d);
+  RayIntervals side;
+  GeoShapeUtils::slabIntervals(p.z(), v.z(), -m_zHalfLength, m_zHalfLength, intervals);
+  for (unsigned int k = 0; k < 4; ++k) {
+    GeoShapeUtils::halfSpaceIntervals(p, v, n[k], d[k], side);
+    GeoShapeUtils::intersectIntervals(intervals, side, intervals);
+  }
+}
+
+double GeoTrap::safety (const GeoTrf::Vector3D &p) const
+{
+  return std::abs(distance(p));
+}
+
+double GeoTrap::distance (const GeoTrf::Vector3D &p) const
+{
+  GeoTrf::Vector3D n[4];
+  double d[4];
+  getSidePlanes(n, d);
+  double dist = std::abs(p.z()) - m_zHalfLength;
+  for (unsigned int k = 0; k < 4; ++k) dist = std::max(dist, n[k].dot(p) - d[k]);
+  return dist;
+}
+
+void GeoTrap::getSidePlanes (GeoTrf::Vector3D *n, double *d) const
+{
+  // Corners of the trapezoids at -dz and +dz, as in the polyhedron of the trap
+  double dz = m_zHalfLength;
+  double tx = std::tan(m_theta) * std::cos(m_phi), ty = std::tan(m_theta) * std::sin(m_phi);
+  double ta1 = std::tan(m_angleydzn), ta2 = std::tan(m_angleydzp);
+  GeoTrf::Vector3D pt[8] = {
+    {-dz*tx - m_dydzn*ta1 - m_dxdyndzn, -dz*ty - m_dydzn, -dz},
+    {-dz*tx - m_dydzn*ta1 + m_dxdyndzn, -dz*ty - m_dydzn, -dz},
+    {-dz*tx + m_dydzn*ta1 - m_dxdypdzn, -dz*ty + m_dydzn, -dz},
+    {-dz*tx + m_dydzn*ta1 + m_dxdypdzn, -dz*ty + m_dydzn, -dz},
+    { dz*tx - m_dydzp*ta2 - m_dxdyndzp,  dz*ty - m_dydzp,  dz},
+    { dz*tx - m_dydzp*ta2 + m_dxdyndzp,  dz*ty - m_dydzp,  dz},
+    { dz*tx + m_dydzp*ta2 - m_dxdypdzp,  dz*ty + m_dydzp,  dz},
+    { dz*tx + m_dydzp*ta2 + m_dxdypdzp,  dz*ty + m_dydzp,  dz}
+  };
+  GeoTrf::Vector3D centre(0, 0, 0);
+  for (const GeoTrf::Vector3D &v : pt) centre += 0.125 * v;
+
+  const GeoShapeUtils::Plane planes[4] = {
+    GeoShapeUtils::makePlane(pt[0], pt[1], pt[5], pt[4], centre),
+    GeoShapeUtils::makePlane(pt[2], pt[3], pt[7], pt[6], centre),
+    GeoShapeUtils::makePlane(pt[0], pt[2], pt[6], pt[4], centre),
+    GeoShapeUtils::makePlane(pt[1], pt[3], pt[7], pt[5], centre)
+  };
+  for (unsigned int k = 0; k < 4; ++k) {
+    n[k] = planes[k].n;
+    d[k] = planes[k].d;
+  }
+}
+
+void GeoTrap::computeExtent (double &xmin, double &ymin, double &zmin
+			   , double &xmax, double &ymax, double &zmax) const
+{
+  double dz = m_zHalfLength;
+  double tx = std::tan(m_theta) * std::cos(m_phi), ty = std::tan(m_theta) * std::sin(m_phi);
+  double ta1 = std::tan(m_angleydzn), ta2 = std::tan(m_angleydzp);
+  // Centres of the edges at -y and +y, at both ends, and their half lengths
+  const double xc[4] = {-dz*tx - m_dydzn*ta1, -dz*tx + m_dydzn*ta1, dz*tx - m_dydzp*ta2, dz*tx + m_dydzp*ta2};
+  const double yc[4] = {-dz*ty - m_dydzn, -dz*ty + m_dydzn, dz*ty - m_dydzp, dz*ty + m_dydzp};
+  const double hx[4] = {m_dxdyndzn, m_dxdypdzn, m_dxdyndzp, m_dxdypdzp};
+  xmin = ymin = HUGE_VAL;
+  xmax = ymax = -HUGE_VAL;
+  for (unsigned int i = 0; i < 4; ++i) {
+    xmin = std::min(xmin, xc[i] - hx[i]); xmax = std::max(xmax, xc[i] + hx[i]);
+    ymin = std::min(ymin, yc[i]);         ymax = std::max(ymax, yc[i]);
+  }
+  zmin = -dz;
+  zmax =  dz;
+}
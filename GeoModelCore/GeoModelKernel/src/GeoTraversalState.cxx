@@ -3,12 +3,41 @@
 */
 
 #include "GeoModelKernel/GeoTraversalState.h"
+#include "GeoModelKernel/GeoChildVolumeIndex.h"
+
+namespace {
+
+  // Sets result to parent * transform, with shortcuts for the many
+  // placements that only translate, and for the identity at the top
+  inline void compose(GeoTrf::Transform3D& result, const GeoTrf::Transform3D& parent, const GeoTrf::Transform3D& transform)
+  {
+    if (transform.linear().isIdentity(0)) {
+      result.linear() = parent.linear();
+      result.translation() = parent.translation() + parent.linear()*transform.translation();
+    }
+    else if (parent.linear().isIdentity(0)) {
+      result.linear() = transform.linear();
+      result.translation() = parent.translation() + transform.translation();
+    }
+    else {
+      result = parent * transform;
+    }
+  }
+}
+
+GeoTraversalState::Level::Level ()
+  : index(0)
+  , valid(VALID_ALL)
+  , transform(GeoTrf::Transform3D::Identity())
+  , defTransform(GeoTrf::Transform3D::Identity())
+  , absTransform(GeoTrf::Transform3D::Identity())
+  , defAbsTransform(GeoTrf::Transform3D::Identity())
+{
+}
 
 GeoTraversalState::GeoTraversalState ()
-  : m_absTransform(GeoTrf::Transform3D::Identity())
-  , m_defAbsTransform(GeoTrf::Transform3D::Identity())
-  , m_transform(GeoTrf::Transform3D::Identity())
-  , m_defTransform(GeoTrf::Transform3D::Identity())
+  : m_levels(1)
+  , m_needs(ALL)
 {
 }
 
@@ -16,78 +45,175 @@ GeoTraversalState::~GeoTraversalState()
 {
 }
 
+GeoTraversalState::Level & GeoTraversalState::current ()
+{
+  return m_levels[m_path.getLength()];
+}
+
+const GeoTraversalState::Level & GeoTraversalState::current () const
+{
+  return m_levels[m_path.getLength()];
+}
+
+unsigned int GeoTraversalState::notNeeded () const
+{
+  unsigned int valid = 0;
+  if (!(m_needs & TRANSFORMS)) valid |= Level::TRANSFORM | Level::DEF_TRANSFORM | Level::ABS_TRANSFORM | Level::DEF_ABS_TRANSFORM;
+  if (!(m_needs & NAMES)) valid |= Level::NAME | Level::ABS_NAME;
+  if (!(m_needs & IDS)) valid |= Level::ID;
+  return valid;
+}
+
+const GeoTrf::Transform3D & GeoTraversalState::transformAt (unsigned int level) const
+{
+  const Level& l = m_levels[level];
+  if (!(l.valid & Level::TRANSFORM)) {
+    l.transform = m_childVolumes[level-1]->getXToChildVol(l.index);
+    l.valid |= Level::TRANSFORM;
+  }
+  return l.transform;
+}
+
+const GeoTrf::Transform3D & GeoTraversalState::defTransformAt (unsigned int level) const
+{
+  const Level& l = m_levels[level];
+  if (!(l.valid & Level::DEF_TRANSFORM)) {
+    l.defTransform = m_childVolumes[level-1]->getDefXToChildVol(l.index);
+    l.valid |= Level::DEF_TRANSFORM;
+  }
+  return l.defTransform;
+}
+
+const GeoTrf::Transform3D & GeoTraversalState::absTransformAt (unsigned int level) const
+{
+  const Level& l = m_levels[level];
+  if (!(l.valid & Level::ABS_TRANSFORM)) {
+    compose(l.absTransform,absTransformAt(level-1),transformAt(level));
+    l.valid |= Level::ABS_TRANSFORM;
+  }
+  return l.absTransform;
+}
+
+const GeoTrf::Transform3D & GeoTraversalState::defAbsTransformAt (unsigned int level) const
+{
+  const Level& l = m_levels[level];
+  if (!(l.valid & Level::DEF_ABS_TRANSFORM)) {
+    compose(l.defAbsTransform,defAbsTransformAt(level-1),defTransformAt(level));
+    l.valid |= Level::DEF_ABS_TRANSFORM;
+  }
+  return l.defAbsTransform;
+}
+
+const std::string & GeoTraversalState::nameAt (unsigned int level) const
+{
+  const Level& l = m_levels[level];
+  if (!(l.valid & Level::NAME)) {
+    l.name = m_childVolumes[level-1]->getNameOfChildVol(l.index);
+    l.valid |= Level::NAME;
+  }
+  return l.name;
+}
+
+const std::string & GeoTraversalState::absNameAt (unsigned int level) const
+{
+  const Level& l = m_levels[level];
+  if (!(l.valid & Level::ABS_NAME)) {
+    // Assigned piece by piece so that the string keeps its capacity
+    l.absName = absNameAt(level-1);
+    l.absName += "/";
+    l.absName += nameAt(level);
+    l.valid |= Level::ABS_NAME;
+  }
+  return l.absName;
+}
+
 const GeoTrf::Transform3D & GeoTraversalState::getTransform () const
 {
-  return m_transform;
+  return transformAt(m_path.getLength());
 }
 
 const std::string & GeoTraversalState::getName () const
 {
-  return m_name;
+  return nameAt(m_path.getLength());
 }
 
 const GeoTrf::Transform3D & GeoTraversalState::getDefTransform () const
 {
-  return m_defTransform;
+  return defTransformAt(m_path.getLength());
 }
 
 const std::string & GeoTraversalState::getAbsoluteName () const
 {
-  return m_absName;
+  return absNameAt(m_path.getLength());
 }
 
 const GeoTrf::Transform3D & GeoTraversalState::getDefAbsoluteTransform () const
 {
-  return m_defAbsTransform;
+  return defAbsTransformAt(m_path.getLength());
 }
 
 const GeoTrf::Transform3D & GeoTraversalState::getAbsoluteTransform () const
 {
-  return m_absTransform;
+  return absTransformAt(m_path.getLength());
 }
 
 void GeoTraversalState::setTransform (const GeoTrf::Transform3D &transform)
 {
-  m_transform = transform;
-  m_absTransform = m_absTransformList.top () * transform;
+  Level& l = current();
+  l.transform = transform;
+  l.valid |= Level::TRANSFORM;
+  if (m_path.getLength()) l.valid &= ~Level::ABS_TRANSFORM;
+  else l.absTransform = transform;
 }
 
 void GeoTraversalState::setName (const std::string &name)
 {
-  m_name = name;
-  m_absName = m_absNameList.top () + "/" + name;
+  Level& l = current();
+  l.name = name;
+  l.valid |= Level::NAME;
+  if (m_path.getLength()) l.valid &= ~Level::ABS_NAME;
 }
 
 void GeoTraversalState::setDefTransform (const GeoTrf::Transform3D &transform)
 {
-  m_defTransform = transform;
-  m_defAbsTransform = m_defAbsTransformList.top () * transform;
+  Level& l = current();
+  l.defTransform = transform;
+  l.valid |= Level::DEF_TRANSFORM;
+  if (m_path.getLength()) l.valid &= ~Level::DEF_ABS_TRANSFORM;
+  else l.defAbsTransform = transform;
 }
 
-void GeoTraversalState::nextLevel (const GeoVPhysVol* pv)
+void GeoTraversalState::setChildVol (unsigned int index)
 {
-  m_absNameList.push (m_absName);
-  m_absTransformList.push (m_absTransform);
-  m_defAbsTransformList.push (m_defAbsTransform);
+  Level& l = current();
+  l.index = index;
+  l.valid = notNeeded();
+}
 
+void GeoTraversalState::nextLevel (const GeoVPhysVol* pv)
+{
   m_path.push(pv);
-  //      
-  // Reinitialize to identity.     
-  //     
-
-  m_absTransform = m_defAbsTransform = m_transform = m_defTransform =
-    GeoTrf::Transform3D::Identity();
+  if (m_levels.size() <= m_path.getLength()) m_levels.emplace_back();
+  if (m_childVolumes.size() < m_path.getLength()) m_childVolumes.emplace_back(new GeoChildVolumeIndex);
+  m_childVolumes[m_path.getLength()-1]->rebuild(pv);
+  //
+  // Reinitialize to identity.
+  //
+  Level& l = current();
+  l.transform = l.defTransform = GeoTrf::Transform3D::Identity();
+  l.name.clear();
+  l.id = Query<int>();
+  l.valid = Level::TRANSFORM | Level::DEF_TRANSFORM | Level::NAME | Level::ID | notNeeded();
 }
 
 void GeoTraversalState::previousLevel ()
 {
-  m_absTransform = m_absTransformList.top ();
-  m_defAbsTransform = m_defAbsTransformList.top ();
-  m_absTransformList.pop ();
-  m_defAbsTransformList.pop ();
-  m_absNameList.pop ();
   m_path.pop();
-  m_transform = m_defTransform = GeoTrf::Transform3D::Identity();
+}
+
+const GeoChildVolumeIndex & GeoTraversalState::getChildVolumes () const
+{
+  return *m_childVolumes[m_path.getLength()-1];
 }
 
 const GeoNodePath * GeoTraversalState::getPath () const
@@ -97,10 +223,27 @@ const GeoNodePath * GeoTraversalState::getPath () const
 
 void GeoTraversalState::setId (const Query<int> &id)
 {
-  m_id=id;
+  Level& l = current();
+  l.id = id;
+  l.valid |= Level::ID;
 }
 
 const Query<int> GeoTraversalState::getId () const
 {
-  return m_id;
+  const Level& l = current();
+  if (!(l.valid & Level::ID)) {
+    l.id = m_childVolumes[m_path.getLength()-1]->getIdOfChildVol(l.index);
+    l.valid |= Level::ID;
+  }
+  return l.id;
+}
+
+void GeoTraversalState::setNeeds (unsigned int needs)
+{
+  m_needs = needs & ALL;
+}
+
+unsigned int GeoTraversalState::getNeeds () const
+{
+  return m_needs;
 }
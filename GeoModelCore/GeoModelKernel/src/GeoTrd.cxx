@@ -4,6 +4,9 @@
 
 #include "GeoModelKernel/GeoTrd.h"
 #include "GeoModelKernel/GeoShapeAction.h"
+#include "GeoShapeUtils.h"
+#include <cmath>
+#include <algorithm>
 
 const std::string GeoTrd::s_classType = "Trd";
 const ShapeType GeoTrd::s_classTypeID = 0x16;
@@ -45,3 +48,65 @@ void GeoTrd::exec (GeoShapeAction *action) const
   action->handleTrd(this);
 }
 
+
+GeoShape::Location GeoTrd::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  return GeoShapeUtils::classify(distance(p), tolerance);
+}
+
+void GeoTrd::inside (size_t n, const double *x, const double *y, const double *z
+		     , Location *result, double tolerance) const
+{
+  // The half lengths are linear in z, see distance()
+  const double dz = m_zHalfLength;
+  const double ax = 0.5 * (m_xHalfLength1 + m_xHalfLength2), bx = (m_xHalfLength2 - m_xHalfLength1) / (2.0 * dz);
+  const double ay = 0.5 * (m_yHalfLength1 + m_yHalfLength2), by = (m_yHalfLength2 - m_yHalfLength1) / (2.0 * dz);
+  const double nx = 1.0 / std::hypot(1.0, bx), ny = 1.0 / std::hypot(1.0, by);
+  for (size_t i = 0; i < n; ++i) {
+    double dx = (std::abs(x[i]) - ax - bx * z[i]) * nx;
+    double dy = (std::abs(y[i]) - ay - by * z[i]) * ny;
+    result[i] = GeoShapeUtils::classify(std::max(std::max(dx, dy), std::abs(z[i]) - dz), tolerance);
+  }
+}
+
+void GeoTrd::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+			      , RayIntervals &intervals) const
+{
+  // The half lengths are linear in z: h(z) = (h1+h2)/2 + (h2-h1)/(2dz) z, so
+  // the faces are the planes +-x - bx z = ax and +-y - by z = ay
+  double dz2 = 2.0 * m_zHalfLength;
+  double ax = 0.5 * (m_xHalfLength1 + m_xHalfLength2), bx = (m_xHalfLength2 - m_xHalfLength1) / dz2;
+  double ay = 0.5 * (m_yHalfLength1 + m_yHalfLength2), by = (m_yHalfLength2 - m_yHalfLength1) / dz2;
+  RayIntervals side;
+  GeoShapeUtils::slabIntervals(p.z(), v.z(), -m_zHalfLength, m_zHalfLength, intervals);
+  for (double sign : {-1.0, 1.0}) {
+    GeoShapeUtils::halfSpaceIntervals(p, v, GeoTrf::Vector3D(sign, 0, -bx), ax, side);
+    GeoShapeUtils::intersectIntervals(intervals, side, intervals);
+    GeoShapeUtils::halfSpaceIntervals(p, v, GeoTrf::Vector3D(0, sign, -by), ay, side);
+    GeoShapeUtils::intersectIntervals(intervals, side, intervals);
+  }
+}
+
+double GeoTrd::safety (const GeoTrf::Vector3D &p) const
+{
+  return std::abs(distance(p));
+}
+
+double GeoTrd::distance (const GeoTrf::Vector3D &p) const
+{
+  double t = (p.z() + m_zHalfLength) / (2.0 * m_zHalfLength);
+  double xHalf = m_xHalfLength1 + (m_xHalfLength2 - m_xHalfLength1) * t;
+  double yHalf = m_yHalfLength1 + (m_yHalfLength2 - m_yHalfLength1) * t;
+  double dx = (std::abs(p.x()) - xHalf) / std::hypot(1.0, (m_xHalfLength2 - m_xHalfLength1) / (2.0 * m_zHalfLength));
+  double dy = (std::abs(p.y()) - yHalf) / std::hypot(1.0, (m_yHalfLength2 - m_yHalfLength1) / (2.0 * m_zHalfLength));
+  return std::max(std::max(dx, dy), std::abs(p.z()) - m_zHalfLength);
+}
+
+void GeoTrd::computeExtent (double &xmin, double &ymin, double &zmin
+			  , double &xmax, double &ymax, double &zmax) const
+{
+  xmax = std::max(m_xHalfLength1, m_xHalfLength2);
+  ymax = std::max(m_yHalfLength1, m_yHalfLength2);
+  zmax = m_zHalfLength;
+  xmin = -xmax; ymin = -ymax; zmin = -zmax;
+}
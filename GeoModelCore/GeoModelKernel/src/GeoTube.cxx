@@ -6,6 +6,7 @@
 #include "GeoModelKernel/GeoPolyhedrizeAction.h"
 #include "GeoModelKernel/GeoShapeAction.h"
 #include <cmath>
+#include "GeoShapeUtils.h"
 
 const std::string GeoTube::s_classType = "Tube";
 const ShapeType GeoTube::s_classTypeID = 0x17;
@@ -43,3 +44,53 @@ void GeoTube::exec (GeoShapeAction *action) const
 {
   action->handleTube(this);
 }
+
+GeoShape::Location GeoTube::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  return GeoShapeUtils::classify(distance(p), tolerance);
+}
+
+void GeoTube::inside (size_t n, const double *x, const double *y, const double *z
+		      , Location *result, double tolerance) const
+{
+  // Without an inner radius the axis is inside
+  const double rMin = m_rMin > 0 ? m_rMin : -HUGE_VAL, rMax = m_rMax, dz = m_zHalfLength;
+  for (size_t i = 0; i < n; ++i) {
+    double rho = std::sqrt(x[i]*x[i] + y[i]*y[i]);
+    double d = std::max(std::max(rho - rMax, rMin - rho), std::abs(z[i]) - dz);
+    result[i] = GeoShapeUtils::classify(d, tolerance);
+  }
+}
+
+void GeoTube::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+			       , RayIntervals &intervals) const
+{
+  RayIntervals other;
+  GeoShapeUtils::slabIntervals(p.z(), v.z(), -m_zHalfLength, m_zHalfLength, intervals);
+  GeoShapeUtils::coneIntervals(p, v, m_rMax, 0, other);
+  GeoShapeUtils::intersectIntervals(intervals, other, intervals);
+  if (m_rMin > 0) {
+    GeoShapeUtils::coneIntervals(p, v, m_rMin, 0, other);
+    GeoShapeUtils::subtractIntervals(intervals, other, intervals);
+  }
+}
+
+double GeoTube::safety (const GeoTrf::Vector3D &p) const
+{
+  return std::abs(distance(p));
+}
+
+double GeoTube::distance (const GeoTrf::Vector3D &p) const
+{
+  double rho = std::hypot(p.x(), p.y());
+  double d = std::max(rho - m_rMax, std::abs(p.z()) - m_zHalfLength);
+  if (m_rMin > 0) d = std::max(d, m_rMin - rho);
+  return d;
+}
+
+void GeoTube::computeExtent (double &xmin, double &ymin, double &zmin
+			   , double &xmax, double &ymax, double &zmax) const
+{
+  xmin = ymin = -m_rMax; zmin = -m_zHalfLength;
+  xmax = ymax =  m_rMax; zmax =  m_zHalfLength;
+}
@@ -4,6 +4,8 @@
 
 #include "GeoModelKernel/GeoTubs.h"
 #include "GeoModelKernel/GeoShapeAction.h"
+#include "GeoShapeUtils.h"
+#include <cmath>
 
 const std::string GeoTubs::s_classType = "Tubs";
 const ShapeType GeoTubs::s_classTypeID = 0x18;
@@ -41,3 +43,44 @@ void GeoTubs::exec (GeoShapeAction *action) const
   action->handleTubs(this);
 }
 
+
+GeoShape::Location GeoTubs::inside (const GeoTrf::Vector3D &p, double tolerance) const
+{
+  return GeoShapeUtils::intersectPhi(GeoShapeUtils::classify(radialDistance(p), tolerance), p.x(), p.y(), m_sPhi, m_dPhi, tolerance);
+}
+
+void GeoTubs::getRayIntervals (const GeoTrf::Vector3D &p, const GeoTrf::Vector3D &v
+			       , RayIntervals &intervals) const
+{
+  RayIntervals other;
+  GeoShapeUtils::slabIntervals(p.z(), v.z(), -m_zHalfLength, m_zHalfLength, intervals);
+  GeoShapeUtils::coneIntervals(p, v, m_rMax, 0, other);
+  GeoShapeUtils::intersectIntervals(intervals, other, intervals);
+  if (m_rMin > 0) {
+    GeoShapeUtils::coneIntervals(p, v, m_rMin, 0, other);
+    GeoShapeUtils::subtractIntervals(intervals, other, intervals);
+  }
+  GeoShapeUtils::phiIntervals(p, v, m_sPhi, m_dPhi, other);
+  GeoShapeUtils::intersectIntervals(intervals, other, intervals);
+}
+
+double GeoTubs::safety (const GeoTrf::Vector3D &p) const
+{
+  return std::abs(std::max(radialDistance(p), GeoShapeUtils::phiDistance(p.x(), p.y(), m_sPhi, m_dPhi)));
+}
+
+double GeoTubs::radialDistance (const GeoTrf::Vector3D &p) const
+{
+  double rho = std::hypot(p.x(), p.y());
+  double d = std::max(rho - m_rMax, std::abs(p.z()) - m_zHalfLength);
+  if (m_rMin > 0) d = std::max(d, m_rMin - rho);
+  return d;
+}
+
+void GeoTubs::computeExtent (double &xmin, double &ymin, double &zmin
+			   , double &xmax, double &ymax, double &zmax) const
+{
+  GeoShapeUtils::sectorExtent(m_rMin, m_rMax, m_sPhi, m_dPhi, xmin, ymin, xmax, ymax);
+  zmin = -m_zHalfLength;
+  zmax =  m_zHalfLength;
+}
@@ -5,6 +5,8 @@
 #include "GeoModelKernel/GeoTwistedTrap.h"
 #include "GeoModelKernel/GeoShapeAction.h"
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 
 const std::string GeoTwistedTrap::s_classType = "TwistedTrap";
 const ShapeType GeoTwistedTrap::s_classTypeID = 0x19; //this code should not be used by other shapes
@@ -108,3 +110,22 @@ void GeoTwistedTrap::exec (GeoShapeAction *action) const
 {
   action->handleTwistedTrap(this); 
 }
+
+void GeoTwistedTrap::computeExtent (double &xmin, double &ymin, double &zmin
+				  , double &xmax, double &ymax, double &zmax) const
+{
+  // The end faces turn by -phiTwist/2 and +phiTwist/2 about their centres. Bound each
+  // of them by the circle through its furthest corner
+  double tAlpha = std::tan(m_alph);
+  double tx = std::tan(m_theta) * std::cos(m_phi), ty = std::tan(m_theta) * std::sin(m_phi);
+  double r1 = std::max(std::hypot(m_dx1 + m_dy1 * tAlpha, m_dy1), std::hypot(m_dx2 + m_dy1 * tAlpha, m_dy1));
+  r1 = std::max(r1, std::max(std::hypot(m_dx1 - m_dy1 * tAlpha, m_dy1), std::hypot(m_dx2 - m_dy1 * tAlpha, m_dy1)));
+  double r2 = std::max(std::hypot(m_dx3 + m_dy2 * tAlpha, m_dy2), std::hypot(m_dx4 + m_dy2 * tAlpha, m_dy2));
+  r2 = std::max(r2, std::max(std::hypot(m_dx3 - m_dy2 * tAlpha, m_dy2), std::hypot(m_dx4 - m_dy2 * tAlpha, m_dy2)));
+  xmin = std::min(-m_dz * tx - r1, m_dz * tx - r2);
+  xmax = std::max(-m_dz * tx + r1, m_dz * tx + r2);
+  ymin = std::min(-m_dz * ty - r1, m_dz * ty - r2);
+  ymax = std::max(-m_dz * ty + r1, m_dz * ty + r2);
+  zmin = -m_dz;
+  zmax =  m_dz;
+}
@@ -4,6 +4,8 @@
 
 #include "GeoModelKernel/GeoVFullPhysVol.h"
 #include "GeoModelKernel/GeoVAlignmentStore.h"
+#include "GeoModelKernel/GeoAlignableTransform.h"
+#include "GeoShapeUtils.h"
 #include <string>
 
 GeoVFullPhysVol::GeoVFullPhysVol(const GeoLogVol* logVol)
@@ -31,22 +33,26 @@ const GeoTrf::Transform3D & GeoVFullPhysVol::getAbsoluteTransform(GeoVAlignmentS
   
   if(isShared()) throw std::runtime_error(errorMessage+getLogVol()->getName());
 
-  std::scoped_lock<std::mutex> guard(m_mutex);
-  
+  // The local cache is protected by the mutex. Alignment stores are expected
+  // to take care of their own thread safety, so do not serialize on them
+  std::unique_lock<std::mutex> guard(m_mutex,std::defer_lock);
+  if(store==nullptr) guard.lock();
+
   if(store==nullptr && !m_absPosInfo) m_absPosInfo = new GeoAbsPositionInfo();
 
   //
   // Check the cache first. If not empty, then return the cached value
   //
   if(store==nullptr){
-    if(m_absPosInfo->getAbsTransform()) return *m_absPosInfo->getAbsTransform();
+    if(m_absPosInfo->getAbsTransform() && isAbsPositionCurrent()) return *m_absPosInfo->getAbsTransform();
   }
   else {
     const GeoTrf::Transform3D* storedPos = store->getAbsPosition(this);
     if(storedPos!=nullptr) return *storedPos;
   }
 
-  // The cache is empty. Compute the absolute position from the top of the tree down to here, and cache it 
+  // The cache is empty or stale. Compute the absolute position from the top of the tree down to here, and cache it 
+  unsigned long long epoch = GeoAlignableTransform::getCurrentEpoch();
   PVConstLink child(this), parent(getParent());
   GeoTrf::Transform3D tProd(GeoTrf::Transform3D::Identity());
 
@@ -69,11 +75,15 @@ const GeoTrf::Transform3D & GeoVFullPhysVol::getAbsoluteTransform(GeoVAlignmentS
 
   if(store==nullptr) {
     m_absPosInfo->setAbsTransform(tProd);
+    m_absPosInfo->setEpoch(epoch);
     return *m_absPosInfo->getAbsTransform();
   }
   else {
+    // Another thread may have stored the same position first, the store
+    // keeping the first one
     store->setAbsPosition(this,tProd);
     const GeoTrf::Transform3D* storedPosition = store->getAbsPosition(this);
+    if(storedPosition==nullptr) throw std::runtime_error("The alignment store did not keep the position of " + getLogVol()->getName());
     return *storedPosition;
   }
 }
@@ -82,7 +92,7 @@ const GeoTrf::Transform3D& GeoVFullPhysVol::getCachedAbsoluteTransform(const Geo
 {
   if(store==nullptr) {
     std::scoped_lock<std::mutex> guard(m_mutex);
-    if(m_absPosInfo->getAbsTransform()) return *m_absPosInfo->getAbsTransform();
+    if(m_absPosInfo && m_absPosInfo->getAbsTransform() && isAbsPositionCurrent()) return *m_absPosInfo->getAbsTransform();
   }
   else {
     const GeoTrf::Transform3D* storedPos = store->getAbsPosition(this);
@@ -99,6 +109,29 @@ void GeoVFullPhysVol::clearPositionInfo() const
   m_absPosInfo = nullptr;
 }
 
+void GeoVFullPhysVol::setPositionInfo(const GeoTrf::Transform3D& absXf, const GeoTrf::Transform3D& defAbsXf) const
+{
+  std::scoped_lock<std::mutex> guard(m_mutex);
+  if(!m_absPosInfo) m_absPosInfo = new GeoAbsPositionInfo();
+  m_absPosInfo->setAbsTransform(absXf);
+  m_absPosInfo->setDefAbsTransform(defAbsXf);
+  m_absPosInfo->setEpoch(GeoAlignableTransform::getCurrentEpoch());
+}
+
+bool GeoVFullPhysVol::isAbsPositionCurrent() const
+{
+  unsigned long long epoch = m_absPosInfo->getEpoch();
+  if(epoch > GeoAlignableTransform::getLastChangeEpoch()) return true;
+
+  // Something has been realigned since the position was cached. Was it one of our ancestors?
+  unsigned long long now = GeoAlignableTransform::getCurrentEpoch();
+  for(PVConstLink parent = getParent(); parent; parent = parent->getParent()) {
+    if(parent->getAlignmentEpoch() >= epoch) return false;
+  }
+  m_absPosInfo->setEpoch(now);
+  return true;
+}
+
 const GeoTrf::Transform3D& GeoVFullPhysVol::getDefAbsoluteTransform(GeoVAlignmentStore* store) const
 {
   //------------------------------------------------------------------------------------------------//     
@@ -110,8 +143,10 @@ const GeoTrf::Transform3D& GeoVFullPhysVol::getDefAbsoluteTransform(GeoVAlignmen
   //------------------------------------------------------------------------------------------------//     
   if(isShared()) throw std::runtime_error(errorMessage + getLogVol()->getName());
 
-  std::scoped_lock<std::mutex> guard(m_mutex);
-  
+  // Only the local cache needs the lock, see getAbsoluteTransform()
+  std::unique_lock<std::mutex> guard(m_mutex,std::defer_lock);
+  if(store==nullptr) guard.lock();
+
   if(store==nullptr && !m_absPosInfo) m_absPosInfo = new GeoAbsPositionInfo();
 
   //
@@ -151,8 +186,11 @@ const GeoTrf::Transform3D& GeoVFullPhysVol::getDefAbsoluteTransform(GeoVAlignmen
     return *m_absPosInfo->getDefAbsTransform();
   }
   else {
+    // Another thread may have stored the same position first, the store
+    // keeping the first one
     store->setDefAbsPosition(this,tProd);
     const GeoTrf::Transform3D* storedPosition = store->getDefAbsPosition(this);
+    if(storedPosition==nullptr) throw std::runtime_error("The alignment store did not keep the position of " + getLogVol()->getName());
     return *storedPosition;
   }
 }
@@ -240,3 +278,15 @@ unsigned int GeoVFullPhysVol::getId () const
   return *m_id;
 }
 
+size_t GeoVFullPhysVol::getPositionInfoBytes() const
+{
+  std::scoped_lock<std::mutex> guard(m_mutex);
+  size_t bytes = GeoShapeUtils::heapBytes(m_absName);
+  if(m_id) bytes += sizeof(Query<int>);
+  if(m_absPosInfo) {
+    bytes += sizeof(GeoAbsPositionInfo);
+    if(m_absPosInfo->getAbsTransform()) bytes += sizeof(GeoTrf::Transform3D);
+    if(m_absPosInfo->getDefAbsTransform()) bytes += sizeof(GeoTrf::Transform3D);
+  }
+  return bytes;
+}
@@ -4,7 +4,7 @@
 
 #include "GeoModelKernel/GeoVPhysVol.h"
 #include "GeoModelKernel/GeoVolumeAction.h"
-#include "GeoModelKernel/GeoAccessVolumeAction.h"
+#include "GeoModelKernel/GeoChildVolumeIndex.h"
 
 #include <stdexcept>
 #include <string>
@@ -12,6 +12,8 @@
 GeoVPhysVol::GeoVPhysVol(const GeoLogVol* LogVol)
   : m_parentPtr(nullptr)
   , m_logVol(LogVol)
+  , m_childVolIndex(nullptr)
+  , m_alignEpoch(0)
 {
   if(m_logVol) m_logVol->ref();
 }
@@ -19,6 +21,7 @@ GeoVPhysVol::GeoVPhysVol(const GeoLogVol* LogVol)
 GeoVPhysVol::~GeoVPhysVol()
 {
   if(m_logVol) m_logVol->unref();
+  delete m_childVolIndex.load();
 }
 
 Query<unsigned int> GeoVPhysVol::indexOf(PVConstLink daughter) const
@@ -41,43 +44,41 @@ const GeoLogVol* GeoVPhysVol::getLogVol() const
   return m_logVol;
 }
 
+void GeoVPhysVol::setLogVol(const GeoLogVol* logVol)
+{
+  if(logVol) logVol->ref();
+  if(m_logVol) m_logVol->unref();
+  m_logVol = logVol;
+}
+
 void GeoVPhysVol::apply(GeoVolumeAction *action) const
 {
   int nVols(0);
+  const GeoChildVolumeIndex* children(nullptr);
   switch(action->getType()) {
   case GeoVolumeAction::TOP_DOWN:
     action->handleVPhysVol(this);
     if(action->shouldTerminate()) return;
 
     action->getState()->nextLevel(this);
-    nVols = getNChildVols();
+    children = &action->getState()->getChildVolumes();
+    nVols = children->getNChildVols();
     for(int d = 0; d < nVols; d++) {
-      GeoAccessVolumeAction av(d,nullptr);
-      exec (&av);
-
-      action->getState()->setTransform(av.getTransform());
-      action->getState()->setDefTransform(av.getDefTransform());
-      action->getState()->setId(av.getId());
-      action->getState()->setName(av.getName());
+      action->getState()->setChildVol(d);
 
-      av.getVolume()->apply(action);
+      children->getChildVol(d)->apply(action);
       if(action->shouldTerminate()) break;
     }
     action->getState()->previousLevel();
     break;
   case GeoVolumeAction::BOTTOM_UP:
     action->getState()->nextLevel(this);
-    nVols = getNChildVols();
+    children = &action->getState()->getChildVolumes();
+    nVols = children->getNChildVols();
     for(int d = 0; d < nVols; d++) {
-      GeoAccessVolumeAction av(d,nullptr);
-      exec(&av);
+      action->getState()->setChildVol(d);
 
-      action->getState()->setTransform(av.getTransform());
-      action->getState()->setDefTransform(av.getDefTransform());
-      action->getState()->setId(av.getId());
-      action->getState()->setName(av.getName());
-
-      av.getVolume()->apply(action);
+      children->getChildVol(d)->apply(action);
       if(action->shouldTerminate()) break;
     }
     action->getState()->previousLevel();
@@ -90,6 +91,38 @@ void GeoVPhysVol::apply(GeoVolumeAction *action) const
   }
 }
 
+void GeoVPhysVol::setChildNodes(const std::vector<GeoGraphNode*>& /*nodes*/)
+{
+  throw std::runtime_error("GeoVPhysVol::setChildNodes(). The daughters of this class of volume cannot be replaced");
+}
+
+const GeoChildVolumeIndex& GeoVPhysVol::getChildVolumeIndex() const
+{
+  GeoChildVolumeIndex* index = m_childVolIndex.load(std::memory_order_acquire);
+  if(index && !index->m_stale.load(std::memory_order_acquire)) return *index;
+
+  // Build a new index, retiring the stale one. If another thread got there first, use its index instead
+  GeoChildVolumeIndex* newIndex = new GeoChildVolumeIndex(this);
+  newIndex->m_retired = index;
+  if(m_childVolIndex.compare_exchange_strong(index,newIndex,std::memory_order_acq_rel)) return *newIndex;
+  newIndex->m_retired = nullptr;
+  delete newIndex;
+  return *index;
+}
+
+size_t GeoVPhysVol::getChildVolumeIndexBytes() const
+{
+  const GeoChildVolumeIndex* index = m_childVolIndex.load(std::memory_order_acquire);
+  return index ? index->getBytes() : 0;
+}
+
+void GeoVPhysVol::clearChildVolumeIndex()
+{
+  // Readers may still hold the index, which is retired rather than deleted
+  const GeoChildVolumeIndex* index = m_childVolIndex.load(std::memory_order_acquire);
+  if(index) index->m_stale.store(true,std::memory_order_release);
+}
+
 void GeoVPhysVol::dockTo(GeoVPhysVol* parent)
 {
   if(m_parentPtr) {
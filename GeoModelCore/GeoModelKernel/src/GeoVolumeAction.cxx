@@ -4,10 +4,11 @@
 
 #include "GeoModelKernel/GeoVolumeAction.h"
 
-GeoVolumeAction::GeoVolumeAction (Type type)
+GeoVolumeAction::GeoVolumeAction (Type type, unsigned int needs)
   : m_type(type)
   , m_terminate(false)
 {
+  m_traversalState.setNeeds(needs);
 }
 
 GeoVolumeAction::~GeoVolumeAction()
@@ -0,0 +1,339 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoModelKernel/GeoVolumeBVH.h"
+#include "GeoModelKernel/GeoChildVolumeIndex.h"
+#include "GeoModelKernel/GeoLogVol.h"
+#include "GeoModelKernel/GeoShape.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+  // Largest number of daughters in a leaf
+  constexpr unsigned int LEAF_SIZE = 4;
+
+  // Depth of the traversal stacks. Hierarchies are balanced, so this covers any realistic number of daughters
+  constexpr unsigned int STACK_SIZE = 64;
+
+  inline bool boxContains(const double* lo, const double* hi, const GeoTrf::Vector3D& p)
+  {
+    return p.x() >= lo[0] && p.x() <= hi[0]
+      &&   p.y() >= lo[1] && p.y() <= hi[1]
+      &&   p.z() >= lo[2] && p.z() <= hi[2];
+  }
+
+  // Slab test. Narrows [tIn,tOut] to the part of the ray inside the box, returns false if that is empty
+  inline bool boxCrossing(const double* lo, const double* hi
+			  ,const GeoTrf::Vector3D& origin, const GeoTrf::Vector3D& invDir
+			  ,double& tIn, double& tOut)
+  {
+    for (unsigned int k = 0; k < 3; ++k) {
+      if (std::isinf(invDir[k])) {
+	if (origin[k] < lo[k] || origin[k] > hi[k]) return false;
+	continue;
+      }
+      double t1 = (lo[k]-origin[k])*invDir[k];
+      double t2 = (hi[k]-origin[k])*invDir[k];
+      if (t1 > t2) std::swap(t1,t2);
+      tIn  = std::max(tIn,t1);
+      tOut = std::min(tOut,t2);
+      if (tIn > tOut) return false;
+    }
+    return true;
+  }
+}
+
+GeoVolumeBVH::GeoVolumeBVH(PVConstLink top, const GeoVAlignmentStore* store)
+  : m_top(&*top)
+  , m_store(store)
+  , m_topMother(nullptr)
+{
+  m_top->ref();
+
+  // Build one hierarchy per distinct volume with daughters
+  std::vector<const GeoVPhysVol*> pending;
+  if (m_top->getNChildVols()) {
+    m_topMother = m_mothers.emplace(m_top,std::make_unique<Mother>()).first->second.get();
+    pending.push_back(m_top);
+  }
+  while (!pending.empty()) {
+    const GeoVPhysVol* vol = pending.back();
+    pending.pop_back();
+    build(vol,*m_mothers[vol],pending);
+  }
+}
+
+GeoVolumeBVH::~GeoVolumeBVH()
+{
+  m_top->unref();
+}
+
+void GeoVolumeBVH::build(const GeoVPhysVol* vol, Mother& mother, std::vector<const GeoVPhysVol*>& pending)
+{
+  // A local index, so that the volumes do not keep one each
+  GeoChildVolumeIndex children(vol);
+  unsigned int nDaughters = children.getNChildVols();
+
+  std::vector<Daughter> daughters(nDaughters);
+  std::vector<GeoTrf::Vector3D> centres(nDaughters);
+  for (unsigned int i = 0; i < nDaughters; ++i) {
+    Daughter& d = daughters[i];
+    d.volume = children.getChildVol(i);
+    d.childIndex = i;
+    d.xf = children.getXToChildVol(i,m_store);
+    d.invXf = d.xf.inverse();
+    d.mother = nullptr;
+    if (d.volume->getNChildVols()) {
+      auto it = m_mothers.find(d.volume);
+      if (it==m_mothers.end()) {
+	it = m_mothers.emplace(d.volume,std::make_unique<Mother>()).first;
+	pending.push_back(d.volume);
+      }
+      d.mother = it->second.get();
+    }
+
+    // Box around the placed corners of the box of the shape
+    double lo[3], hi[3];
+    d.volume->getLogVol()->getShape()->extent(lo[0],lo[1],lo[2],hi[0],hi[1],hi[2]);
+    std::fill(d.lo,d.lo+3,HUGE_VAL);
+    std::fill(d.hi,d.hi+3,-HUGE_VAL);
+    for (unsigned int c = 0; c < 8; ++c) {
+      GeoTrf::Vector3D corner = d.xf * GeoTrf::Vector3D(c & 1 ? hi[0] : lo[0], c & 2 ? hi[1] : lo[1], c & 4 ? hi[2] : lo[2]);
+      for (unsigned int k = 0; k < 3; ++k) {
+	d.lo[k] = std::min(d.lo[k],corner[k]);
+	d.hi[k] = std::max(d.hi[k],corner[k]);
+      }
+    }
+    centres[i] = 0.5*(GeoTrf::Vector3D(d.lo[0],d.lo[1],d.lo[2]) + GeoTrf::Vector3D(d.hi[0],d.hi[1],d.hi[2]));
+  }
+
+  //
+  // Split at the median of the box centres, along the axis in which they spread most
+  //
+  std::vector<unsigned int> order(nDaughters);
+  std::iota(order.begin(),order.end(),0);
+  mother.nodes.reserve(2*nDaughters/LEAF_SIZE+1);
+
+  auto split = [&](auto& self, unsigned int begin, unsigned int end) -> void {
+    unsigned int nodeIndex = mother.nodes.size();
+    Node node;
+    std::fill(node.lo,node.lo+3,HUGE_VAL);
+    std::fill(node.hi,node.hi+3,-HUGE_VAL);
+    GeoTrf::Vector3D cLo(HUGE_VAL,HUGE_VAL,HUGE_VAL), cHi(-HUGE_VAL,-HUGE_VAL,-HUGE_VAL);
+    for (unsigned int i = begin; i < end; ++i) {
+      const Daughter& d = daughters[order[i]];
+      for (unsigned int k = 0; k < 3; ++k) {
+	node.lo[k] = std::min(node.lo[k],d.lo[k]);
+	node.hi[k] = std::max(node.hi[k],d.hi[k]);
+      }
+      cLo = cLo.cwiseMin(centres[order[i]]);
+      cHi = cHi.cwiseMax(centres[order[i]]);
+    }
+    node.first = begin;
+    node.count = end-begin;
+    mother.nodes.push_back(node);
+    if (end-begin <= LEAF_SIZE) return;
+
+    unsigned int axis;
+    (cHi-cLo).maxCoeff(&axis);
+    unsigned int mid = (begin+end)/2;
+    std::nth_element(order.begin()+begin,order.begin()+mid,order.begin()+end
+		     ,[&](unsigned int a, unsigned int b) { return centres[a][axis] < centres[b][axis]; });
+    self(self,begin,mid);
+    mother.nodes[nodeIndex].first = mother.nodes.size();
+    mother.nodes[nodeIndex].count = 0;
+    self(self,mid,end);
+  };
+  if (nDaughters) split(split,0,nDaughters);
+
+  mother.daughters.reserve(nDaughters);
+  for (unsigned int i : order) mother.daughters.push_back(daughters[i]);
+}
+
+bool GeoVolumeBVH::locate(const GeoTrf::Vector3D& point
+			  ,GeoNodePath& path
+			  ,std::vector<unsigned int>* childIndices
+			  ,GeoTrf::Transform3D* absXf) const
+{
+  while (path.getLength()) path.pop();
+  if (childIndices) childIndices->clear();
+  if (m_top->getLogVol()->getShape()->inside(point) == GeoShape::OUTSIDE) return false;
+
+  path.push(m_top);
+  GeoTrf::Vector3D p(point);
+  GeoTrf::Transform3D xf(GeoTrf::Transform3D::Identity());
+  const Mother* mother = m_topMother;
+
+  while (mother) {
+    //
+    // Find the daughter containing the point. Daughters do not overlap, the first one will do
+    //
+    const Daughter* found = nullptr;
+    unsigned int stack[STACK_SIZE];
+    unsigned int nStack = 0;
+    stack[nStack++] = 0;
+    while (nStack && !found) {
+      const Node& node = mother->nodes[stack[--nStack]];
+      if (!boxContains(node.lo,node.hi,p)) continue;
+      if (node.count) {
+	for (unsigned int i = node.first; i < node.first+node.count; ++i) {
+	  const Daughter& d = mother->daughters[i];
+	  if (boxContains(d.lo,d.hi,p)
+	      && d.volume->getLogVol()->getShape()->inside(d.invXf*p) != GeoShape::OUTSIDE) {
+	    found = &d;
+	    break;
+	  }
+	}
+      }
+      else {
+	unsigned int left = &node - mother->nodes.data() + 1;
+	stack[nStack++] = node.first;
+	stack[nStack++] = left;
+      }
+    }
+    if (!found) break;
+
+    p = found->invXf * p;
+    xf = xf * found->xf;
+    path.push(found->volume);
+    if (childIndices) childIndices->push_back(found->childIndex);
+    mother = found->mother;
+  }
+
+  if (absXf) *absXf = xf;
+  return true;
+}
+
+void GeoVolumeBVH::intersect(const GeoTrf::Vector3D& origin
+			     ,const GeoTrf::Vector3D& direction
+			     ,std::vector<Crossing>& crossings
+			     ,double tMax) const
+{
+  if (!m_topMother) return;
+  Crossing prefix;
+  prefix.volumes.push_back(m_top);
+  intersect(*m_topMother,origin,direction,tMax,prefix,crossings);
+}
+
+void GeoVolumeBVH::intersect(const Mother& mother
+			     ,const GeoTrf::Vector3D& origin
+			     ,const GeoTrf::Vector3D& direction
+			     ,double tMax
+			     ,Crossing& prefix
+			     ,std::vector<Crossing>& crossings) const
+{
+  GeoTrf::Vector3D invDir(1.0/direction.x(),1.0/direction.y(),1.0/direction.z());
+
+  unsigned int stack[STACK_SIZE];
+  unsigned int nStack = 0;
+  stack[nStack++] = 0;
+  while (nStack) {
+    const Node& node = mother.nodes[stack[--nStack]];
+    double tIn = 0, tOut = tMax;
+    if (!boxCrossing(node.lo,node.hi,origin,invDir,tIn,tOut)) continue;
+    if (!node.count) {
+      unsigned int left = &node - mother.nodes.data() + 1;
+      stack[nStack++] = node.first;
+      stack[nStack++] = left;
+      continue;
+    }
+    for (unsigned int i = node.first; i < node.first+node.count; ++i) {
+      const Daughter& d = mother.daughters[i];
+      tIn = 0;
+      tOut = tMax;
+      if (!boxCrossing(d.lo,d.hi,origin,invDir,tIn,tOut)) continue;
+
+      prefix.volumes.push_back(d.volume);
+      prefix.childIndices.push_back(d.childIndex);
+      crossings.push_back(prefix);
+      crossings.back().tIn = tIn;
+      crossings.back().tOut = tOut;
+      // The ray parameter is the same in the frame of the daughter
+      if (d.mother) intersect(*d.mother,d.invXf*origin,d.invXf.linear()*direction,tMax,prefix,crossings);
+      prefix.volumes.pop_back();
+      prefix.childIndices.pop_back();
+    }
+  }
+}
+
+void GeoVolumeBVH::getSegments(const GeoTrf::Vector3D& origin
+			       ,const GeoTrf::Vector3D& direction
+			       ,std::vector<Segment>& segments
+			       ,double tMax) const
+{
+  segments.clear();
+  GeoShape::RayIntervals intervals;
+  m_top->getLogVol()->getShape()->getRayIntervals(origin,direction,intervals);
+  for (const auto& iv : intervals) {
+    double tIn = std::max(iv.first,0.0), tOut = std::min(iv.second,tMax);
+    if (tIn < tOut) getSegments(m_top,m_topMother,origin,direction,tIn,tOut,segments);
+  }
+}
+
+void GeoVolumeBVH::getSegments(const GeoVPhysVol* vol
+			       ,const Mother* mother
+			       ,const GeoTrf::Vector3D& origin
+			       ,const GeoTrf::Vector3D& direction
+			       ,double tIn
+			       ,double tOut
+			       ,std::vector<Segment>& segments) const
+{
+  if (!mother) {
+    segments.push_back(Segment{vol,tIn,tOut});
+    return;
+  }
+
+  //
+  // Collect the pieces of the ray inside the daughters whose boxes it crosses
+  //
+  struct Piece {
+    double          tIn;
+    double          tOut;
+    const Daughter* daughter;
+  };
+  std::vector<Piece> pieces;
+  GeoShape::RayIntervals intervals;
+  GeoTrf::Vector3D invDir(1.0/direction.x(),1.0/direction.y(),1.0/direction.z());
+
+  unsigned int stack[STACK_SIZE];
+  unsigned int nStack = 0;
+  stack[nStack++] = 0;
+  while (nStack) {
+    const Node& node = mother->nodes[stack[--nStack]];
+    double t1 = tIn, t2 = tOut;
+    if (!boxCrossing(node.lo,node.hi,origin,invDir,t1,t2)) continue;
+    if (!node.count) {
+      unsigned int left = &node - mother->nodes.data() + 1;
+      stack[nStack++] = node.first;
+      stack[nStack++] = left;
+      continue;
+    }
+    for (unsigned int i = node.first; i < node.first+node.count; ++i) {
+      const Daughter& d = mother->daughters[i];
+      t1 = tIn;
+      t2 = tOut;
+      if (!boxCrossing(d.lo,d.hi,origin,invDir,t1,t2)) continue;
+      d.volume->getLogVol()->getShape()->getRayIntervals(d.invXf*origin,d.invXf.linear()*direction,intervals);
+      for (const auto& iv : intervals) {
+	t1 = std::max(iv.first,tIn);
+	t2 = std::min(iv.second,tOut);
+	if (t1 < t2) pieces.push_back(Piece{t1,t2,&d});
+      }
+    }
+  }
+  std::sort(pieces.begin(),pieces.end(),[](const Piece& a, const Piece& b) { return a.tIn < b.tIn; });
+
+  //
+  // The gaps between the pieces are in the mother itself
+  //
+  double t = tIn;
+  for (const Piece& piece : pieces) {
+    if (piece.tOut <= t) continue;
+    if (piece.tIn > t) segments.push_back(Segment{vol,t,piece.tIn});
+    const Daughter& d = *piece.daughter;
+    getSegments(d.volume,d.mother,d.invXf*origin,d.invXf.linear()*direction,std::max(piece.tIn,t),piece.tOut,segments);
+    t = piece.tOut;
+  }
+  if (t < tOut) segments.push_back(Segment{vol,t,tOut});
+}
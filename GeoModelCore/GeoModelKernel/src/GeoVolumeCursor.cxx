@@ -108,8 +108,8 @@ void GeoVolumeCursor::handlePhysVol (const GeoPhysVol *vol)
     m_transform = m_pendingTransformList[0]->getTransform(m_alignStore);
     m_defTransform = m_pendingTransformList[0]->getDefTransform(m_alignStore);
     for (unsigned int t = 1; t < m_pendingTransformList.size (); t++) {
-      m_transform    = m_transform    * m_pendingTransformList[t]->getTransform(m_alignStore);
-      m_defTransform = m_defTransform * m_pendingTransformList[t]->getDefTransform(m_alignStore);
+      m_pendingTransformList[t]->accumulateTransform(m_transform,m_alignStore);
+      m_pendingTransformList[t]->accumulateDefTransform(m_defTransform);
     }
   }
   terminate ();
@@ -127,8 +127,8 @@ void GeoVolumeCursor::handleFullPhysVol (const GeoFullPhysVol *vol)
     m_transform = m_pendingTransformList[0]->getTransform(m_alignStore);
     m_defTransform = m_pendingTransformList[0]->getDefTransform(m_alignStore);
     for (unsigned int t = 1; t < m_pendingTransformList.size (); t++) {
-      m_transform    = m_transform    * m_pendingTransformList[t]->getTransform(m_alignStore);
-      m_defTransform = m_defTransform * m_pendingTransformList[t]->getDefTransform(m_alignStore);
+      m_pendingTransformList[t]->accumulateTransform(m_transform,m_alignStore);
+      m_pendingTransformList[t]->accumulateDefTransform(m_defTransform);
     }
   }
   terminate ();
@@ -151,8 +151,8 @@ void GeoVolumeCursor::handleSerialTransformer (const GeoSerialTransformer  *sT)
     m_transform = m_pendingTransformList[0]->getTransform(m_alignStore);
     m_defTransform = m_pendingTransformList[0]->getDefTransform(m_alignStore);
     for (unsigned int t = 1; t < m_pendingTransformList.size (); t++) {
-      m_transform    = m_transform    * m_pendingTransformList[t]->getTransform(m_alignStore);
-      m_defTransform = m_defTransform * m_pendingTransformList[t]->getDefTransform(m_alignStore);
+      m_pendingTransformList[t]->accumulateTransform(m_transform,m_alignStore);
+      m_pendingTransformList[t]->accumulateDefTransform(m_defTransform);
     }
   }
   terminate ();
@@ -0,0 +1,124 @@
+/*
+  Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+#include "GeoModelKernel/GeoXFCompiled.h"
+
+namespace GeoXF
+{
+  struct CompiledFunction::Form
+  {
+    GeoTrf::Transform3D pre{GeoTrf::Transform3D::Identity()};
+    GeoTrf::Transform3D post{GeoTrf::Transform3D::Identity()};
+    const Pow*          power{nullptr};
+    double              a{0};
+    double              b{0};
+  };
+
+  bool CompiledFunction::analyse(const Function& function, Form& form)
+  {
+    if (const Pow* power = dynamic_cast<const Pow*>(&function)) {
+      double a, b;
+      if (!power->function()->isLinear(a,b)) return false;
+      if (a == 0) {
+        form.pre = (*power)(0.0);
+      }
+      else {
+        form.power = power;
+        form.a = a;
+        form.b = b;
+      }
+      return true;
+    }
+    if (const PreMult* preMult = dynamic_cast<const PreMult*>(&function)) {
+      if (!analyse(*preMult->arg2(),form)) return false;
+      form.pre = preMult->arg1() * form.pre;
+      return true;
+    }
+    if (const PostMult* postMult = dynamic_cast<const PostMult*>(&function)) {
+      if (!analyse(*postMult->arg1(),form)) return false;
+      form.post = form.post * postMult->arg2();
+      return true;
+    }
+    if (const Product* product = dynamic_cast<const Product*>(&function)) {
+      Form left, right;
+      if (!analyse(*product->arg1(),left) || !analyse(*product->arg2(),right)) return false;
+      // At most one of the factors may depend on x
+      if (left.power && right.power) return false;
+      if (!left.power) {
+        form = right;
+        form.pre = left.pre * left.post * right.pre;
+      }
+      else {
+        form = left;
+        form.post = left.post * right.pre * right.post;
+      }
+      return true;
+    }
+    return false;
+  }
+
+  CompiledFunction::CompiledFunction(const Function& function)
+    : m_kind(NONE)
+    , m_bare(true)
+    , m_a(0)
+    , m_b(0)
+    , m_constant(GeoTrf::Transform3D::Identity())
+    , m_step(GeoTrf::Vector3D::Zero())
+    , m_angle(0)
+    , m_axis(GeoTrf::Vector3D::UnitZ())
+    , m_translation(GeoTrf::Vector3D::Zero())
+    , m_pre(GeoTrf::Transform3D::Identity())
+    , m_post(GeoTrf::Transform3D::Identity())
+  {
+    Form form;
+    if (!analyse(function,form)) return;
+
+    if (!form.power) {
+      m_kind = CONSTANT;
+      m_constant = form.pre * form.post;
+      return;
+    }
+
+    m_a = form.a;
+    m_b = form.b;
+    // Decompose T as Pow does
+    const GeoTrf::Transform3D& xf = form.power->transform();
+    GeoTrf::RotationMatrix3D rotate = xf.rotation();
+    GeoTrf::AngleAxis3D aa(rotate);
+    if (aa.angle() == 0) {
+      m_kind = TRANSLATION;
+      m_constant = form.pre * form.post;
+      m_step = form.pre.linear() * xf.translation();
+    }
+    else {
+      m_kind = ROTATION;
+      m_angle = aa.angle();
+      m_axis = aa.axis();
+      m_translation = xf.translation();
+      m_pre = form.pre;
+      m_post = form.post;
+      m_bare = form.pre.matrix() == GeoTrf::Transform3D::Identity().matrix()
+        && form.post.matrix() == GeoTrf::Transform3D::Identity().matrix();
+    }
+  }
+
+  GeoTrf::Transform3D CompiledFunction::operator()(double x) const
+  {
+    double nTimes = m_a * x + m_b;
+    switch (m_kind) {
+    case CONSTANT:
+      return m_constant;
+    case TRANSLATION: {
+      GeoTrf::Transform3D result = m_constant;
+      result.translation() += nTimes * m_step;
+      return result;
+    }
+    default: {
+      GeoTrf::Transform3D result = GeoTrf::Translation3D(m_translation * nTimes) * GeoTrf::AngleAxis3D(m_angle * nTimes, m_axis);
+      if (m_bare) return result;
+      return m_pre * result * m_post;
+    }
+    }
+  }
+}
@@ -3,10 +3,12 @@
 */
 
 #include "GeoModelKernel/RCBase.h"
+#include "GeoModelKernel/GeoArena.h"
 #include <exception>
 
 RCBase::RCBase()
   : m_count(0)
+  , m_arena(GeoArena::slotOf(this))
 {
 }
 
@@ -14,17 +16,62 @@ RCBase::~RCBase()
 {
 }
 
+inline bool RCBase::isAtomic () const
+{
+  return !m_arena || GeoArena::inSlot(m_arena)->getAtomicRefCounts();
+}
+
 void RCBase::ref () const
 {
-  m_count++;
+  if (isAtomic()) m_count++;
+  else m_count.store(m_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 }
 
 void RCBase::unref () const
 {
-  if (--m_count == 0) delete this;
+  unsigned int count;
+  if (isAtomic()) count = --m_count;
+  else {
+    count = m_count.load(std::memory_order_relaxed) - 1;
+    m_count.store(count, std::memory_order_relaxed);
+  }
+  if (count != 0) return;
+
+  if (m_arena) {
+    // The memory goes with the arena
+    unsigned int arena = m_arena;
+    const_cast<RCBase*>(this)->~RCBase();
+    GeoArena::deallocate(arena);
+  }
+  else {
+    delete this;
+  }
 }
 
 unsigned int RCBase::refCount () const
 {
   return m_count.load();
 }
+
+void* RCBase::operator new (size_t size)
+{
+  void* p = GeoArena::allocate(size, alignof(std::max_align_t));
+  return p ? p : ::operator new(size);
+}
+
+void* RCBase::operator new (size_t size, std::align_val_t alignment)
+{
+  void* p = GeoArena::allocate(size, static_cast<size_t>(alignment));
+  return p ? p : ::operator new(size, alignment);
+}
+
+// Reached from unref() for objects on the heap, and when a constructor throws
+void RCBase::operator delete (void* p)
+{
+  if (!GeoArena::isInScope(p)) ::operator delete(p);
+}
+
+void RCBase::operator delete (void* p, std::align_val_t alignment)
+{
+  if (!GeoArena::isInScope(p)) ::operator delete(p, alignment);
+}
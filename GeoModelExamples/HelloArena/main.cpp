@@ -0,0 +1,105 @@
+// Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+
+/*
+ * HelloArena.cpp
+ *
+ * Compares the build and teardown times of a large tree with the nodes
+ * on the heap, and in a GeoArena with atomic or non-atomic reference
+ * counts.
+ */
+
+// GeoModel includes
+#include "GeoModelKernel/GeoArena.h"
+#include "GeoModelKernel/GeoBox.h"
+#include "GeoModelKernel/GeoTubs.h"
+#include "GeoModelKernel/GeoPhysVol.h"
+#include "GeoModelKernel/GeoNameTag.h"
+#include "GeoModelKernel/GeoIdentifierTag.h"
+#include "GeoModelKernel/GeoTransform.h"
+#include "GeoModelKernel/GeoMaterial.h"
+#include "GeoModelKernel/GeoElement.h"
+
+// C++ includes
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// Units
+#include "GeoModelKernel/Units.h"
+#define SYSTEM_OF_UNITS GeoModelKernelUnits // so we will get, e.g., 'GeoModelKernelUnits::cm'
+
+typedef std::chrono::steady_clock Clock;
+
+GeoPhysVol* buildWorld(unsigned int nLayers, unsigned int nCells)
+{
+  GeoElement* hydrogen = new GeoElement("Hydrogen", "H", 1.0, 1.008*SYSTEM_OF_UNITS::g/SYSTEM_OF_UNITS::mole);
+  GeoMaterial* air = new GeoMaterial("Air", 0.0012*SYSTEM_OF_UNITS::g/SYSTEM_OF_UNITS::cm3);
+  air->add(hydrogen, 1.0);
+  air->lock();
+
+  GeoPhysVol* world = new GeoPhysVol(new GeoLogVol("World", new GeoBox(10*SYSTEM_OF_UNITS::m, 10*SYSTEM_OF_UNITS::m, 10*SYSTEM_OF_UNITS::m), air));
+  for (unsigned int l = 0; l < nLayers; ++l) {
+    GeoPhysVol* layer = new GeoPhysVol(new GeoLogVol("Layer", new GeoTubs(l*SYSTEM_OF_UNITS::cm, (l+1)*SYSTEM_OF_UNITS::cm, 1*SYSTEM_OF_UNITS::m, 0, 2*M_PI), air));
+    for (unsigned int c = 0; c < nCells; ++c) {
+      // Every cell has its own nodes, as many factories do
+      layer->add(new GeoNameTag("Cell"));
+      layer->add(new GeoIdentifierTag(c));
+      layer->add(new GeoTransform(GeoTrf::RotateZ3D(c*2*M_PI/nCells)*GeoTrf::TranslateX3D((l+0.5)*SYSTEM_OF_UNITS::cm)));
+      layer->add(new GeoPhysVol(new GeoLogVol("Cell", new GeoBox(1*SYSTEM_OF_UNITS::mm, 1*SYSTEM_OF_UNITS::mm, 1*SYSTEM_OF_UNITS::m), air)));
+    }
+    world->add(new GeoNameTag("Layer"));
+    world->add(layer);
+  }
+  return world;
+}
+
+enum Mode { HEAP, ARENA, ARENA_NONATOMIC };
+
+// Builds and deletes the tree once, returning the two times in ms
+std::pair<double,double> run(Mode mode, unsigned int nLayers, unsigned int nCells)
+{
+  GeoArena* arena = mode == HEAP ? nullptr : new GeoArena;
+  if (arena) arena->setAtomicRefCounts(mode == ARENA);
+
+  Clock::time_point start = Clock::now();
+  GeoPhysVol* world;
+  if (arena) {
+    GeoArena::Scope scope(arena);
+    world = buildWorld(nLayers, nCells);
+    world->ref();
+    arena->setAtomicRefCounts(true);
+    arena->release();
+  }
+  else {
+    world = buildWorld(nLayers, nCells);
+    world->ref();
+  }
+  Clock::time_point built = Clock::now();
+  world->unref();
+  Clock::time_point end = Clock::now();
+
+  return std::make_pair(std::chrono::duration<double,std::milli>(built - start).count(),
+                        std::chrono::duration<double,std::milli>(end - built).count());
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned int nLayers = argc > 1 ? std::atoi(argv[1]) : 100;
+  unsigned int nCells  = argc > 2 ? std::atoi(argv[2]) : 2000;
+  unsigned int nRep    = argc > 3 ? std::atoi(argv[3]) : 5;
+
+  std::cout << "Tree of " << nLayers << " layers of " << nCells << " cells, best of " << nRep << " runs" << std::endl;
+  const char* names[] = {"heap", "arena", "arena, non-atomic counts"};
+  for (Mode mode : {HEAP, ARENA, ARENA_NONATOMIC}) {
+    double build = 1e30, teardown = 1e30;
+    for (unsigned int i = 0; i < nRep; ++i) {
+      std::pair<double,double> t = run(mode, nLayers, nCells);
+      build = std::min(build, t.first);
+      teardown = std::min(teardown, t.second);
+    }
+    std::cout << names[mode] << ":\tbuild " << build << " ms,\tteardown " << teardown << " ms" << std::endl;
+  }
+  return 0;
+}
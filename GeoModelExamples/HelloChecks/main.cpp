@@ -0,0 +1,307 @@
+// Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+
+/*
+ * HelloChecks.cpp
+ *
+ * Checks results of the kernel against independent references, and exits
+ * with a non-zero status if any of them does not match:
+ *  - the volumes of boolean shapes computed by GeoBooleanVolume, against
+ *    closed forms and against the polyhedral booleans;
+ *  - the volume and the point classification of closed tessellated solids,
+ *    built from facet objects and from indexed meshes;
+ *  - the placements, names and identifiers of the volumes of a tree,
+ *    before and after GeoSubtreeInstancer rewrites it.
+ */
+
+// GeoModel includes
+#include "GeoModelKernel/GeoBooleanVolume.h"
+#include "GeoModelKernel/GeoBox.h"
+#include "GeoModelKernel/GeoTrd.h"
+#include "GeoModelKernel/GeoTube.h"
+#include "GeoModelKernel/GeoShapeShift.h"
+#include "GeoModelKernel/GeoShapeUnion.h"
+#include "GeoModelKernel/GeoShapeSubtraction.h"
+#include "GeoModelKernel/GeoShapeIntersection.h"
+#include "GeoModelKernel/GeoPolyhedrizeAction.h"
+#include "GeoModelKernel/GeoPolyhedron.h"
+#include "GeoModelKernel/GeoTessellatedSolid.h"
+#include "GeoModelKernel/GeoFacet.h"
+#include "GeoModelKernel/GeoElement.h"
+#include "GeoModelKernel/GeoMaterial.h"
+#include "GeoModelKernel/GeoLogVol.h"
+#include "GeoModelKernel/GeoPhysVol.h"
+#include "GeoModelKernel/GeoFullPhysVol.h"
+#include "GeoModelKernel/GeoTransform.h"
+#include "GeoModelKernel/GeoNameTag.h"
+#include "GeoModelKernel/GeoIdentifierTag.h"
+#include "GeoModelKernel/GeoVolumeAction.h"
+#include "GeoModelKernel/GeoSubtreeInstancer.h"
+
+// C++ includes
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Units
+#include "GeoModelKernel/Units.h"
+#define SYSTEM_OF_UNITS GeoModelKernelUnits // so we will get, e.g., 'GeoModelKernelUnits::cm'
+
+namespace {
+  unsigned int nChecks = 0;
+  unsigned int nFailures = 0;
+
+  // Counts a check, and reports it if it fails
+  void check(bool ok, const std::string& what)
+  {
+    ++nChecks;
+    if (ok) return;
+    ++nFailures;
+    std::cout << "FAILED: " << what << std::endl;
+  }
+
+  bool close(double value, double reference, double relative)
+  {
+    return std::abs(value - reference) <= relative * std::abs(reference);
+  }
+}
+
+// Boolean volumes: the sampled overlaps are checked against closed forms, and
+// against the polyhedral booleans where these are reliable
+void checkBooleanVolumes()
+{
+  // The sampling aims at a relative error of 1e-3 of each overlap
+  const double tolerance = 5e-3;
+  GeoBooleanVolume::Config config = GeoBooleanVolume::getDefaultConfig();
+
+  // The closed form is checked if there is one (a positive reference), and
+  // the polyhedral boolean if asked for.  Curved surfaces are divided in
+  // fine steps, for the faceting to be well below the tolerance
+  auto checkVolume = [&](const GeoShape* shape, double reference, bool polyhedral, const std::string& name) {
+    shape->ref();
+    double volume = GeoBooleanVolume::compute(shape, config);
+    if (reference > 0) {
+      check(close(volume, reference, tolerance), name + " volume " + std::to_string(volume) + ", expected " + std::to_string(reference));
+    }
+    if (polyhedral) {
+      GeoPolyhedrizeAction action(360);
+      shape->exec(&action);
+      double polyhedralVolume = action.getPolyhedron()->GetVolume();
+      check(close(volume, polyhedralVolume, tolerance), name + " volume " + std::to_string(volume) + ", polyhedral " + std::to_string(polyhedralVolume));
+    }
+    check(close(shape->volume(), volume, tolerance), name + " volume() " + std::to_string(shape->volume()));
+    shape->unref();
+  };
+
+  // Boxes overlapping at an angle.  The polyhedral booleans fail on boxes
+  // which are only translated with respect to each other, and go wrong when
+  // the overlap is small, so the boxes are only slightly apart
+  const GeoBox* a = new GeoBox(10, 10, 10);
+  const GeoBox* b = new GeoBox(10, 10, 8);
+  const GeoShape& bPlaced = (*b) << (GeoTrf::Translate3D(4, 3, 3.1) * GeoTrf::RotateZ3D(0.3) * GeoTrf::RotateX3D(0.2));
+  // The operands are referenced, as they outlive the booleans built from them
+  a->ref();
+  bPlaced.ref();
+  checkVolume(&a->add(bPlaced), 0, true, "box union");
+  checkVolume(&a->subtract(bPlaced), 0, true, "box subtraction");
+  checkVolume(&a->intersect(bPlaced), 0, true, "box intersection");
+  a->unref();
+  bPlaced.unref();
+
+  // A trd cut by a box: the half lengths in x and y grow from 5 to 15 over z in
+  // [-10,10], and the box keeps the frustum above z = 2, of half lengths 11 to 15.
+  // The polyhedral boolean of this one is empty
+  const GeoTrd* trd = new GeoTrd(5, 15, 5, 15, 10);
+  const GeoBox* cut = new GeoBox(20, 20, 10);
+  const double h1 = 11, h2 = 15;
+  checkVolume(&trd->intersect((*cut) << GeoTrf::TranslateZ3D(12)), 4 * 8.0/3 * (h1*h1 + h1*h2 + h2*h2), false, "trd intersection");
+
+  // Two cylinders of radius r crossing at right angles: 16 r^3 / 3
+  const double r = 10;
+  const GeoTube* tube = new GeoTube(0, r, 5*r);
+  const GeoShape& crossed = (*tube) << GeoTrf::RotateX3D(M_PI/2);
+  tube->ref();
+  crossed.ref();
+  checkVolume(&tube->intersect(crossed), 16*r*r*r/3, true, "Steinmetz solid");
+  checkVolume(&tube->add(crossed), 2*M_PI*r*r*10*r - 16*r*r*r/3, true, "cross of tubes");
+  tube->unref();
+  crossed.unref();
+}
+
+// Closed tessellated solids: a cube of quadrangles and an octahedron of
+// triangles, each as facet objects and as an indexed mesh
+void checkTessellatedSolids()
+{
+  const double a = 10;
+  std::vector<GeoFacetVertex> cubeVertices;
+  for (int k = 0; k < 8; ++k) cubeVertices.emplace_back(k & 1 ? a : -a, k & 2 ? a : -a, k & 4 ? a : -a);
+  // Counter-clockwise seen from outside
+  std::vector<unsigned int> cubeIndices = { 0,2,3,1, 4,5,7,6, 0,1,5,4, 2,6,7,3, 0,4,6,2, 1,3,7,5 };
+
+  std::vector<GeoFacetVertex> octaVertices = { {a,0,0}, {-a,0,0}, {0,a,0}, {0,-a,0}, {0,0,a}, {0,0,-a} };
+  std::vector<unsigned int> octaIndices;
+  for (unsigned int x : {0u, 1u}) {
+    for (unsigned int y : {2u, 3u}) {
+      for (unsigned int z : {4u, 5u}) {
+        // The facet is counter-clockwise seen from outside if the octant has an even number of negative axes
+        bool even = ((x == 1) + (y == 3) + (z == 5)) % 2 == 0;
+        octaIndices.insert(octaIndices.end(), {x, even ? y : z, even ? z : y});
+      }
+    }
+  }
+
+  struct Case {
+    std::string name;
+    const std::vector<GeoFacetVertex>* vertices;
+    const std::vector<unsigned int>* indices;
+    unsigned int verticesPerFacet;
+    double volume;
+    // Signed distance to the surface, up to a factor, negative inside
+    double (*distance)(const GeoTrf::Vector3D&, double);
+  };
+  const Case cases[] = {
+    { "cube", &cubeVertices, &cubeIndices, 4, 8*a*a*a,
+      [](const GeoTrf::Vector3D& p, double s) { return p.cwiseAbs().maxCoeff() - s; } },
+    { "octahedron", &octaVertices, &octaIndices, 3, 4*a*a*a/3,
+      [](const GeoTrf::Vector3D& p, double s) { return (p.cwiseAbs().sum() - s) / std::sqrt(3.0); } }
+  };
+
+  std::mt19937_64 engine(1);
+  std::uniform_real_distribution<double> u(-1.5*a, 1.5*a);
+  const size_t nPoints = 10000;
+  std::vector<double> x(nPoints), y(nPoints), z(nPoints);
+  for (size_t i = 0; i < nPoints; ++i) {
+    x[i] = u(engine);
+    y[i] = u(engine);
+    z[i] = u(engine);
+  }
+  std::vector<GeoShape::Location> batched(nPoints);
+
+  for (const Case& c : cases) {
+    const std::vector<GeoFacetVertex>& v = *c.vertices;
+    const std::vector<unsigned int>& idx = *c.indices;
+    GeoTessellatedSolid* facets = new GeoTessellatedSolid();
+    for (size_t i = 0; i < idx.size(); i += c.verticesPerFacet) {
+      if (c.verticesPerFacet == 4) {
+        facets->addFacet(new GeoQuadrangularFacet(v[idx[i]], v[idx[i+1]], v[idx[i+2]], v[idx[i+3]], GeoFacet::ABSOLUTE));
+      }
+      else {
+        facets->addFacet(new GeoTriangularFacet(v[idx[i]], v[idx[i+1]], v[idx[i+2]], GeoFacet::ABSOLUTE));
+      }
+    }
+    GeoTessellatedSolid* mesh = new GeoTessellatedSolid(v, idx, c.verticesPerFacet);
+
+    for (GeoTessellatedSolid* solid : {facets, mesh}) {
+      solid->ref();
+      std::string name = c.name + (solid == mesh ? " mesh" : " facets");
+      check(close(solid->volume(), c.volume, 1e-12), name + " volume " + std::to_string(solid->volume()));
+
+      solid->inside(nPoints, x.data(), y.data(), z.data(), batched.data());
+      unsigned int wrong = 0, different = 0;
+      for (size_t i = 0; i < nPoints; ++i) {
+        GeoTrf::Vector3D p(x[i], y[i], z[i]);
+        GeoShape::Location single = solid->inside(p);
+        if (single != batched[i]) ++different;
+        // Points near the surface are left out of the comparison with the reference
+        double d = c.distance(p, a);
+        if (std::abs(d) < 1e-6) continue;
+        if (single != (d < 0 ? GeoShape::INSIDE : GeoShape::OUTSIDE)) ++wrong;
+      }
+      check(wrong == 0, name + ": " + std::to_string(wrong) + " points misclassified");
+      check(different == 0, name + ": " + std::to_string(different) + " points classified differently in batches");
+      solid->unref();
+    }
+  }
+}
+
+// Collects the placements of all the volumes of a tree, in traversal order
+class PlacementsAction : public GeoVolumeAction
+{
+ public:
+  struct Placement {
+    std::string name;
+    std::string logVol;
+    Query<int> id;
+    GeoTrf::Transform3D transform;
+  };
+  virtual void handleVPhysVol(const GeoVPhysVol* vol) override
+  {
+    placements.push_back({getState()->getAbsoluteName(), vol->getLogVol()->getName(), getState()->getId(), getState()->getAbsoluteTransform()});
+  }
+  std::vector<Placement> placements;
+};
+
+// Subtree instancing: a ring of twelve modules of identical content, a row of
+// full physical volumes and a regular row of one volume
+void checkSubtreeInstancer()
+{
+  GeoMaterial* air = new GeoMaterial("Air", 1.2*SYSTEM_OF_UNITS::mg/SYSTEM_OF_UNITS::cm3);
+  air->add(new GeoElement("Nitrogen", "N", 7, 14*SYSTEM_OF_UNITS::g/SYSTEM_OF_UNITS::mole));
+  air->lock();
+  const GeoLogVol* worldLog = new GeoLogVol("World", new GeoBox(1000, 1000, 1000), air);
+  const GeoLogVol* moduleLog = new GeoLogVol("Module", new GeoBox(10, 20, 30), air);
+  const GeoLogVol* sensorLog = new GeoLogVol("Sensor", new GeoBox(2, 2, 2), air);
+  const GeoLogVol* padLog = new GeoLogVol("Pad", new GeoBox(5, 5, 1), air);
+
+  GeoPhysVol* world = new GeoPhysVol(worldLog);
+  world->ref();
+  for (int i = 0; i < 12; ++i) {
+    GeoPhysVol* module = new GeoPhysVol(moduleLog);
+    for (int k = 0; k < 3; ++k) {
+      module->add(new GeoNameTag("Sensor"));
+      module->add(new GeoIdentifierTag(k));
+      module->add(new GeoTransform(GeoTrf::TranslateZ3D(10*(k-1))));
+      module->add(new GeoPhysVol(sensorLog));
+    }
+    world->add(new GeoNameTag("Module"));
+    world->add(new GeoIdentifierTag(i));
+    world->add(new GeoTransform(GeoTrf::RotateZ3D(i*M_PI/6) * GeoTrf::TranslateX3D(200)));
+    world->add(module);
+  }
+  for (int i = 0; i < 4; ++i) {
+    world->add(new GeoNameTag("Station"));
+    world->add(new GeoIdentifierTag(100 + i));
+    world->add(new GeoTransform(GeoTrf::TranslateZ3D(400 + 50*i)));
+    world->add(new GeoFullPhysVol(moduleLog));
+  }
+  GeoPhysVol* pad = new GeoPhysVol(padLog);
+  for (int i = 0; i < 8; ++i) {
+    world->add(new GeoTransform(GeoTrf::Translate3D(-300, 0, 20*i)));
+    world->add(pad);
+  }
+
+  PlacementsAction before;
+  world->apply(&before);
+
+  GeoSubtreeInstancer instancer;
+  const GeoSubtreeInstancer::Statistics& stats = instancer.apply(world);
+
+  PlacementsAction after;
+  world->apply(&after);
+
+  check(stats.nodesAfter < stats.nodesBefore, "instancing left " + std::to_string(stats.nodesAfter) + " of " + std::to_string(stats.nodesBefore) + " nodes");
+  check(before.placements.size() == after.placements.size(), "instancing changed the number of volumes from "
+        + std::to_string(before.placements.size()) + " to " + std::to_string(after.placements.size()));
+  unsigned int different = 0;
+  for (size_t i = 0; i < std::min(before.placements.size(), after.placements.size()); ++i) {
+    const PlacementsAction::Placement& p = before.placements[i];
+    const PlacementsAction::Placement& q = after.placements[i];
+    bool sameId = p.id.isValid() == q.id.isValid() && (!p.id.isValid() || int(p.id) == int(q.id));
+    bool sameTransform = (p.transform.matrix() - q.transform.matrix()).cwiseAbs().maxCoeff() < 1e-9;
+    if (p.name != q.name || p.logVol != q.logVol || !sameId || !sameTransform) ++different;
+  }
+  check(different == 0, "instancing changed " + std::to_string(different) + " placements");
+  world->unref();
+}
+
+int main()
+{
+  checkBooleanVolumes();
+  checkTessellatedSolids();
+  checkSubtreeInstancer();
+
+  std::cout << nChecks - nFailures << " of " << nChecks << " checks passed" << std::endl;
+  return nFailures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
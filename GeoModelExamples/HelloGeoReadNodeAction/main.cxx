@@ -18,6 +18,7 @@
 #include "GeoModelKernel/GeoPhysVol.h"
 #include "GeoModelKernel/GeoFullPhysVol.h"
 #include "GeoModelKernel/GeoNameTag.h"
+#include "GeoModelKernel/GeoParallelTraversal.h"
 
 // C++ includes
 #include <iostream>
@@ -179,8 +180,10 @@ int main(int argc, char *argv[])
   }
 
 
+  // The subtrees of the world are visited in parallel; the output is the
+  // same as that of world->exec(&action)
   GeoInventoryGraphAction action(std::cout);
-  world->exec(&action);
+  GeoParallelTraversal::exec(world,&action);
 
 
 
@@ -0,0 +1,149 @@
+// Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+
+/*
+ * HelloMesh.cpp
+ *
+ * Compares the memory taken by a large tessellated solid made of facet
+ * objects, and by the same solid made of an indexed mesh.
+ */
+
+// GeoModel includes
+#include "GeoModelKernel/GeoTessellatedSolid.h"
+#include "GeoModelKernel/GeoFacet.h"
+
+// C++ includes
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// Units
+#include "GeoModelKernel/Units.h"
+#define SYSTEM_OF_UNITS GeoModelKernelUnits // so we will get, e.g., 'GeoModelKernelUnits::cm'
+
+typedef std::chrono::steady_clock Clock;
+
+// Heap accounting: every allocation is counted, and its size kept in a
+// header in front of the block so that the live bytes can be followed
+namespace {
+  constexpr size_t HEADER = alignof(std::max_align_t);
+  size_t nAllocations = 0;
+  size_t liveBytes = 0;
+}
+
+void* operator new(size_t size)
+{
+  char* block = static_cast<char*>(std::malloc(size + HEADER));
+  if (!block) throw std::bad_alloc();
+  *reinterpret_cast<size_t*>(block) = size;
+  ++nAllocations;
+  liveBytes += size;
+  return block + HEADER;
+}
+
+void operator delete(void* p) noexcept
+{
+  if (!p) return;
+  char* block = static_cast<char*>(p) - HEADER;
+  liveBytes -= *reinterpret_cast<size_t*>(block);
+  std::free(block);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  operator delete(p);
+}
+
+// The vertices of a UV sphere: the two poles, then nTheta-1 rings of nPhi vertices
+std::vector<GeoFacetVertex> sphereVertices(unsigned int nPhi, unsigned int nTheta, double radius)
+{
+  std::vector<GeoFacetVertex> vertices;
+  vertices.reserve(2 + (nTheta-1)*nPhi);
+  vertices.emplace_back(0, 0, radius);
+  vertices.emplace_back(0, 0, -radius);
+  for (unsigned int t = 1; t < nTheta; ++t) {
+    double theta = t*M_PI/nTheta;
+    for (unsigned int p = 0; p < nPhi; ++p) {
+      double phi = p*2*M_PI/nPhi;
+      vertices.emplace_back(radius*std::sin(theta)*std::cos(phi), radius*std::sin(theta)*std::sin(phi), radius*std::cos(theta));
+    }
+  }
+  return vertices;
+}
+
+// The triangles of the UV sphere, three indices each, counter-clockwise seen from outside
+std::vector<unsigned int> sphereIndices(unsigned int nPhi, unsigned int nTheta)
+{
+  auto ring = [nPhi](unsigned int t, unsigned int p) { return 2 + (t-1)*nPhi + p%nPhi; };
+  std::vector<unsigned int> indices;
+  indices.reserve(3*2*nPhi*(nTheta-1));
+  for (unsigned int p = 0; p < nPhi; ++p) {
+    indices.insert(indices.end(), {0, ring(1, p), ring(1, p+1)});
+    indices.insert(indices.end(), {1, ring(nTheta-1, p+1), ring(nTheta-1, p)});
+  }
+  for (unsigned int t = 1; t < nTheta-1; ++t) {
+    for (unsigned int p = 0; p < nPhi; ++p) {
+      indices.insert(indices.end(), {ring(t, p), ring(t+1, p), ring(t+1, p+1)});
+      indices.insert(indices.end(), {ring(t, p), ring(t+1, p+1), ring(t, p+1)});
+    }
+  }
+  return indices;
+}
+
+enum Mode { FACETS, MESH };
+
+void run(Mode mode, const std::vector<GeoFacetVertex>& vertices, const std::vector<unsigned int>& indices)
+{
+  size_t nTriangles = indices.size()/3;
+
+  size_t allocationsBefore = nAllocations;
+  size_t bytesBefore = liveBytes;
+  Clock::time_point start = Clock::now();
+  GeoTessellatedSolid* solid;
+  if (mode == MESH) {
+    // The solid takes copies of the buffers, which count as its memory
+    solid = new GeoTessellatedSolid(vertices, indices, 3);
+  }
+  else {
+    solid = new GeoTessellatedSolid();
+    for (size_t i = 0; i < indices.size(); i += 3) {
+      solid->addFacet(new GeoTriangularFacet(vertices[indices[i]], vertices[indices[i+1]], vertices[indices[i+2]], GeoFacet::ABSOLUTE));
+    }
+  }
+  solid->ref();
+  Clock::time_point built = Clock::now();
+  size_t allocations = nAllocations - allocationsBefore;
+  size_t bytes = liveBytes - bytesBefore;
+
+  double volume = solid->volume();
+  Clock::time_point end = Clock::now();
+  solid->unref();
+
+  std::cout << (mode == MESH ? "mesh" : "facets") << ":\t"
+            << allocations << " allocations,\t"
+            << bytes << " bytes (" << double(bytes)/nTriangles << " B/triangle),\t"
+            << "build " << std::chrono::duration<double,std::milli>(built - start).count() << " ms,\t"
+            << "volume " << std::chrono::duration<double,std::milli>(end - built).count() << " ms"
+            << " (" << volume/SYSTEM_OF_UNITS::cm3 << " cm3)" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned int nPhi   = argc > 1 ? std::atoi(argv[1]) : 400;
+  unsigned int nTheta = argc > 2 ? std::atoi(argv[2]) : 200;
+  if (nPhi < 3 || nTheta < 2) {
+    std::cout << "Usage: hellomesh [nPhi >= 3] [nTheta >= 2]" << std::endl;
+    return 1;
+  }
+
+  std::vector<GeoFacetVertex> vertices = sphereVertices(nPhi, nTheta, 1*SYSTEM_OF_UNITS::m);
+  std::vector<unsigned int> indices = sphereIndices(nPhi, nTheta);
+
+  std::cout << "UV sphere of " << indices.size()/3 << " triangles and " << vertices.size() << " vertices" << std::endl;
+  for (Mode mode : {FACETS, MESH}) run(mode, vertices, indices);
+  return 0;
+}
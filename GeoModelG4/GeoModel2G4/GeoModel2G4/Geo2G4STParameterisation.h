@@ -10,8 +10,10 @@
 #include "G4RotationMatrix.hh"
 
 #include "GeoModelKernel/GeoXF.h"
+#include "GeoModelKernel/GeoXFCompiled.h"
 
 class G4VPhysicalVolume;
+class GeoSerialTransformer;
 
 // Dummy declarations. To avoid warnings
 class G4Box;
@@ -36,6 +38,9 @@ public:
   Geo2G4STParameterisation(const GeoXF::Function* func,
                            unsigned int copies);
 
+  // Takes the copy transforms from the table of the serial transformer
+  Geo2G4STParameterisation(const GeoSerialTransformer* serialTransformer);
+
   virtual ~Geo2G4STParameterisation();
 
   void ComputeTransformation (const G4int copyNo,
@@ -66,6 +71,9 @@ private:
   void ComputeDimensions (G4Ellipsoid&,const G4int,const G4VPhysicalVolume*) const {}
 
   const GeoXF::Function *m_function;
+  // The closed form of the function, if it has one
+  GeoXF::CompiledFunction m_compiled;
+  const GeoSerialTransformer *m_serialTransformer;
   G4RotationMatrix* m_rotation;
   unsigned int m_nCopies;
 };
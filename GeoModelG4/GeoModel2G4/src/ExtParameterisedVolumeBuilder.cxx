@@ -103,8 +103,7 @@ G4LogicalVolume* ExtParameterisedVolumeBuilder::Build(const PVConstLink theGeoPh
       if (nameChild == "ANON") nameChild=theG4LogChild->GetName();
       nameChild += "_Param";
 
-      Geo2G4STParameterisation* stParameterisation = new Geo2G4STParameterisation(serialTransformerChild->getFunction(),
-                                                                                  serialTransformerChild->getNCopies());
+      Geo2G4STParameterisation* stParameterisation = new Geo2G4STParameterisation(serialTransformerChild);
 
       G4VPhysicalVolume* pvParametrised __attribute__ ((unused)) = new G4PVParameterised(nameChild,
                                                                                          theG4LogChild,
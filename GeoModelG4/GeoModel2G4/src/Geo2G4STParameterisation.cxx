@@ -6,24 +6,41 @@
 #include "G4VPhysicalVolume.hh"
 #include "GeoModel2G4/CLHEPtoEigenConverter.h"
 #include "CLHEP/Geometry/Transform3D.h"
+#include "GeoModelKernel/GeoSerialTransformer.h"
 
 Geo2G4STParameterisation::Geo2G4STParameterisation(const GeoXF::Function* func,
                                                    unsigned int copies):
   m_function(func->clone()),
+  m_compiled(*m_function),
+  m_serialTransformer(nullptr),
   m_nCopies(copies)
 {
   m_rotation = new G4RotationMatrix();
 }
 
+Geo2G4STParameterisation::Geo2G4STParameterisation(const GeoSerialTransformer* serialTransformer):
+  m_function(serialTransformer->getFunction()->clone()),
+  m_compiled(serialTransformer->getCompiledFunction()),
+  m_serialTransformer(serialTransformer),
+  m_nCopies(serialTransformer->getNCopies())
+{
+  m_serialTransformer->ref();
+  // Geant4 asks for the copies over and over: evaluate them once, now
+  m_serialTransformer->getTransforms();
+  m_rotation = new G4RotationMatrix();
+}
+
 Geo2G4STParameterisation::~Geo2G4STParameterisation()
 {
+  if (m_serialTransformer) m_serialTransformer->unref();
   delete m_rotation;
 }
 
 void Geo2G4STParameterisation::ComputeTransformation(const G4int copyNo,
                                                      G4VPhysicalVolume* physVol) const
 {
-  HepGeom::Transform3D transform = Amg::EigenTransformToCLHEP((*m_function)(copyNo));
+  HepGeom::Transform3D transform = Amg::EigenTransformToCLHEP(m_serialTransformer ? m_serialTransformer->getTransform(copyNo)
+                                                              : m_compiled.isValid() ? m_compiled(copyNo) : (*m_function)(copyNo));
   G4ThreeVector translation = transform.getTranslation();
   *m_rotation = transform.getRotation().inverse();
 
@@ -349,7 +349,26 @@ G4VSolid *Geo2G4SolidFactory::Build(const GeoShape* geoShape, std::string name)
       if(n.empty()) n="G4TessellatedSolid";
 
       G4TessellatedSolid* g4Tessellated = new G4TessellatedSolid(n);
-      for(size_t i=0; i<theTessellated->getNumberOfFacets(); ++i) {
+      if(theTessellated->isIndexed()) {
+        // Read the mesh directly, without building GeoFacets
+        GeoFacetVertex v[4];
+        for(size_t i=0; i<theTessellated->getNumberOfFacets(); ++i) {
+          G4VFacet* g4Facet(nullptr);
+          if(theTessellated->getFacetVertices(i,v)==3)
+            g4Facet = new G4TriangularFacet(Amg::EigenToHep3Vector(v[0]),
+                                            Amg::EigenToHep3Vector(v[1]),
+                                            Amg::EigenToHep3Vector(v[2]),
+                                            ABSOLUTE);
+          else
+            g4Facet = new G4QuadrangularFacet(Amg::EigenToHep3Vector(v[0]),
+                                              Amg::EigenToHep3Vector(v[1]),
+                                              Amg::EigenToHep3Vector(v[2]),
+                                              Amg::EigenToHep3Vector(v[3]),
+                                              ABSOLUTE);
+          g4Tessellated->AddFacet(g4Facet);
+        }
+      }
+      else for(size_t i=0; i<theTessellated->getNumberOfFacets(); ++i) {
         GeoFacet* geoFacet = theTessellated->getFacet(i);
         G4FacetVertexType vertexType = (geoFacet->getVertexType()==GeoFacet::ABSOLUTE? ABSOLUTE : RELATIVE);
         G4VFacet* g4Facet(nullptr);
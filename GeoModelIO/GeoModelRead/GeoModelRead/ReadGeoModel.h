@@ -82,6 +82,7 @@ class GeoSerialTransformer;
 class GeoGraphNode;
 class GeoShapeSubtraction;
 class GeoBox;
+class GeoArena;
 
 // type definitions
 typedef const GeoXF::Function& TRANSFUNCTION;
@@ -100,6 +101,10 @@ class ReadGeoModel {
 
     GeoPhysVol* buildGeoModel();
 
+    /// Builds the nodes in an arena, on all the threads used (see GeoArena).
+    /// The arena must not have been released yet.
+    void setArena(GeoArena* arena) { m_arena = arena; }
+
     //NB, this template method needs only the "publisher name" to be specified (i.e. the last suffix), since
     //the first part of the table name get added automatically according to the data type it is templated on
     template <typename T, class N>
@@ -133,6 +138,9 @@ class ReadGeoModel {
 
     GeoPhysVol* buildGeoModelPrivate();
 
+    /// Runs one of the build steps above within the arena, if any.
+    void runInArena(void (ReadGeoModel::*step)());
+
     GeoBox* buildDummyShape();
 
     void loopOverAllChildrenInBunches();
@@ -270,6 +278,7 @@ class ReadGeoModel {
     bool m_timing;
     bool m_runMultithreaded;
     int m_runMultithreaded_nThreads;
+    GeoArena* m_arena;
 
     // callback handles
     unsigned long* m_progress;
@@ -29,6 +29,7 @@
 #include "TFPersistification/TransFunctionInterpreter.h"
 
 // GeoModelKernel includes
+#include "GeoModelKernel/GeoArena.h"
 #include "GeoModelKernel/GeoUtilFunctions.h"
 #include "GeoModelKernel/GeoTransform.h"
 #include "GeoModelKernel/GeoAlignableTransform.h"
@@ -88,6 +89,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <thread>
+#include <optional>
 
 
 // mutexes for synchronized access to containers and output streams in multi-threading mode
@@ -113,7 +115,7 @@ namespace GeoModelIO {
 
 ReadGeoModel::ReadGeoModel(GMDBManager* db, unsigned long* progress) : m_deepDebug(GEOMODEL_IO_DEBUG_VERBOSE),
   m_debug(GEOMODEL_IO_READ_DEBUG), m_timing(GEOMODEL_IO_READ_TIMING), m_runMultithreaded(false),
-  m_runMultithreaded_nThreads(0), m_progress(nullptr)
+  m_runMultithreaded_nThreads(0), m_arena(nullptr), m_progress(nullptr)
 {
   // Check if the user asked for debug messages
   if ( "" != getEnvVar("GEOMODEL_ENV_IO_READ_DEBUG")) {
@@ -204,8 +206,19 @@ GeoPhysVol* ReadGeoModel::buildGeoModel()
 }
 
 
+void ReadGeoModel::runInArena(void (ReadGeoModel::*step)())
+{
+  std::optional<GeoArena::Scope> scope;
+  if (m_arena) scope.emplace(m_arena);
+  (this->*step)();
+}
+
 GeoPhysVol* ReadGeoModel::buildGeoModelPrivate()
 {
+  // nodes built on this thread go to the arena, if any
+  std::optional<GeoArena::Scope> arenaScope;
+  if (m_arena) arenaScope.emplace(m_arena);
+
   // *** get all data from the DB ***
   std::chrono::system_clock::time_point start = std::chrono::system_clock::now(); // timing: get start time
 	// get all GeoModel nodes from the DB
@@ -242,40 +255,40 @@ GeoPhysVol* ReadGeoModel::buildGeoModelPrivate()
   // parallel mode:
   if (m_runMultithreaded) {
       if (m_debug) std::cout << "Building nodes concurrently..." << std::endl;
-      std::thread t2(&ReadGeoModel::buildAllElements, this);
+      std::thread t2(&ReadGeoModel::runInArena, this, &ReadGeoModel::buildAllElements);
       //  std::thread t7(&ReadGeoModel::buildAllFunctions, this); // FIXME: implement cache for Functions
 
-      std::thread t8(&ReadGeoModel::buildAllTransforms, this);
-      std::thread t9(&ReadGeoModel::buildAllAlignableTransforms, this);
-      std::thread t10(&ReadGeoModel::buildAllSerialDenominators, this);
-      std::thread t13(&ReadGeoModel::buildAllSerialIdentifiers, this);
-      std::thread t14(&ReadGeoModel::buildAllIdentifierTags, this);
-      std::thread t11(&ReadGeoModel::buildAllNameTags, this);
+      std::thread t8(&ReadGeoModel::runInArena, this, &ReadGeoModel::buildAllTransforms);
+      std::thread t9(&ReadGeoModel::runInArena, this, &ReadGeoModel::buildAllAlignableTransforms);
+      std::thread t10(&ReadGeoModel::runInArena, this, &ReadGeoModel::buildAllSerialDenominators);
+      std::thread t13(&ReadGeoModel::runInArena, this, &ReadGeoModel::buildAllSerialIdentifiers);
+      std::thread t14(&ReadGeoModel::runInArena, this, &ReadGeoModel::buildAllIdentifierTags);
+      std::thread t11(&ReadGeoModel::runInArena, this, &ReadGeoModel::buildAllNameTags);
 
       t8.join(); // ok, all Transforms have been built
       t9.join(); // ok, all AlignableTransforms have been built
       // needs Transforms and AlignableTransforms for Shift boolean shapes
-      std::thread t1(&ReadGeoModel::buildAllShapes, this);
+      std::thread t1(&ReadGeoModel::runInArena, this, &ReadGeoModel::buildAllShapes);
 
       t2.join(); // ok, all Elements have been built
       // needs Elements
-      std::thread t3(&ReadGeoModel::buildAllMaterials, this);
+      std::thread t3(&ReadGeoModel::runInArena, this, &ReadGeoModel::buildAllMaterials);
 
       t1.join(); // ok, all Shapes have been built
       t3.join(); // ok, all Materials have been built
       // needs Shapes and Materials
-      std::thread t4(&ReadGeoModel::buildAllLogVols, this);
+      std::thread t4(&ReadGeoModel::runInArena, this, &ReadGeoModel::buildAllLogVols);
 
       t4.join(); // ok, all LogVols have been built
       // needs LogVols
-      std::thread t5(&ReadGeoModel::buildAllPhysVols, this);
-      std::thread t6(&ReadGeoModel::buildAllFullPhysVols, this);
+      std::thread t5(&ReadGeoModel::runInArena, this, &ReadGeoModel::buildAllPhysVols);
+      std::thread t6(&ReadGeoModel::runInArena, this, &ReadGeoModel::buildAllFullPhysVols);
 
       t5.join(); // ok, all PhysVols have been built
       t6.join(); // ok, all FullPhysVols have been built
       //  t7.join(); // ok, all Functions have been built
       // needs Functions, PhysVols, FullPhysVols
-      std::thread t12(&ReadGeoModel::buildAllSerialTransformers, this);
+      std::thread t12(&ReadGeoModel::runInArena, this, &ReadGeoModel::buildAllSerialTransformers);
 
       t10.join(); // ok, all SerialDenominators have been built
       t11.join(); // ok, all NameTags have been built
@@ -324,6 +337,9 @@ GeoPhysVol* ReadGeoModel::buildGeoModelPrivate()
 // loop over parent-child relationship data
   void ReadGeoModel::loopOverAllChildrenRecords(std::vector<std::vector<std::string>> records)
 {
+  // this may run on a worker thread
+  std::optional<GeoArena::Scope> arenaScope;
+  if (m_arena) arenaScope.emplace(m_arena);
 
   int nChildrenRecords = records.size();
 
@@ -1593,10 +1609,70 @@ GeoShape* ReadGeoModel::buildShape(const unsigned int shapeId, type_shapes_boole
     std::string varValue;
 
 		int sizePars = shapePars.size();
+		// a mesh, written as the shared vertices and then the indices of the vertices of each facet:
+		// "nVertices=4;xV=0;yV=0;zV=0;...;verticesPerFacet=3;nFacets=4;iV=0,2,1;..."
+		if (sizePars > 0 && splitString(shapePars[0], '=')[0] == "nVertices") {
+			int it = 0;
+			// get the value of the next parameter, checking its name
+			auto nextValue = [&](const std::string& name) {
+				if (it >= sizePars) {
+					error = 1;
+					return std::string("0");
+				}
+				vars = splitString(shapePars[it++], '=');
+				if (vars.size() != 2 || vars[0] != name) {
+          muxCout.lock();
+					std::cout << "ERROR! GeoTessellatedSolid - Got '" << vars[0] << "' instead of '" << name << "'!" << std::endl;
+          muxCout.unlock();
+					error = 1;
+					return std::string("0");
+				}
+				return vars[1];
+			};
+
+			const unsigned int nVertices = std::stoul(nextValue("nVertices"));
+			std::vector<GeoFacetVertex> vertices;
+			vertices.reserve(nVertices);
+			for (unsigned int iV=0; iV<nVertices && !error; ++iV) {
+				double xV = std::stod(nextValue("xV"));
+				double yV = std::stod(nextValue("yV"));
+				double zV = std::stod(nextValue("zV"));
+				vertices.emplace_back(xV, yV, zV);
+			}
+			const unsigned int verticesPerFacet = std::stoul(nextValue("verticesPerFacet"));
+			nFacets = std::stoul(nextValue("nFacets"));
+			std::vector<unsigned int> indices;
+			indices.reserve(nFacets * verticesPerFacet);
+			for (unsigned int iF=0; iF<nFacets && !error; ++iF) {
+				std::vector<std::string> facet = splitString(nextValue("iV"), ',');
+				for (const std::string& index : facet) indices.push_back(std::stoul(index));
+				// a triangle in a mesh of four vertices per facet
+				if (facet.size() == 3 && verticesPerFacet == 4) indices.push_back(GeoTessellatedSolid::NO_VERTEX);
+			}
+
+			if (!error) {
+				try {
+					sh = new GeoTessellatedSolid(std::move(vertices), std::move(indices), verticesPerFacet);
+				}
+				catch (const std::runtime_error& e) {
+          muxCout.lock();
+					std::cout << "ERROR! GeoTessellatedSolid - " << e.what() << std::endl;
+          muxCout.unlock();
+					error = 1;
+				}
+			}
+			if (sh && sh->getNumberOfFacets() != nFacets) error = 1;
+			if (error) {
+        muxCout.lock();
+        std::cout << "ERROR! GeoTessellatedSolid mesh is not valid! --> ";
+        printStdVectorStrings(shapePars);
+        muxCout.unlock();
+			}
+		}
 		// check if we have at least 13 parameters,
 		// which is the minimum for a shape
 		// with a single triangular facet
-		if (sizePars >= 13) {
+		else if (sizePars >= 13) {
 
 			// get the first parameter
 			par = shapePars[0];
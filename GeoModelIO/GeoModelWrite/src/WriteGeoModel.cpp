@@ -1041,25 +1041,48 @@ std::string WriteGeoModel::getShapeParameters(const GeoShape* shape)
 		const GeoTessellatedSolid* shapeIn = dynamic_cast<const GeoTessellatedSolid*>(shape);
 		// get number of facets
 		const size_t nFacets = shapeIn->getNumberOfFacets();
-		pars.push_back("nFacets=" + std::to_string(nFacets)); //size_t
-		// loop over the facets
-		for (size_t i=0; i<nFacets; ++i) {
-			GeoFacet* facet = shapeIn->getFacet(i);
-			// get GeoFacet actual implementation
-			if (dynamic_cast<GeoTriangularFacet*>(facet))        pars.push_back("TRI");
-			else if (dynamic_cast<GeoQuadrangularFacet*>(facet)) pars.push_back("QUAD");
-			// get vertex type (ABSOLUTE/RELATIVE)
-			GeoFacet::GeoFacetVertexType facetVertexType = facet->getVertexType();
-			if (facetVertexType == GeoFacet::ABSOLUTE) pars.push_back("vT=ABSOLUTE");
-			if (facetVertexType == GeoFacet::RELATIVE) pars.push_back("vT=RELATIVE");
-			// get number of vertices and loop over them
-			const size_t nVertices = facet->getNumberOfVertices();
-			pars.push_back("nV=" + std::to_string(nVertices)); //size_t
-			for (size_t i=0; i<nVertices; ++i) {
-				GeoFacetVertex facetVertex = facet->getVertex(i);
-				pars.push_back("xV=" + to_string_with_precision( facetVertex[0] ));
-				pars.push_back("yV=" + to_string_with_precision( facetVertex[1] ));
-				pars.push_back("zV=" + to_string_with_precision( facetVertex[2] ));
+		if (shapeIn->isIndexed()) {
+			// a mesh: the shared vertices, then the indices of the vertices of each facet
+			// e.g. "nVertices=4;xV=0;yV=0;zV=0;...;verticesPerFacet=3;nFacets=4;iV=0,2,1;..."
+			const std::vector<GeoFacetVertex>& vertices = shapeIn->getVertices();
+			const std::vector<unsigned int>& indices = shapeIn->getIndices();
+			const unsigned int verticesPerFacet = shapeIn->getVerticesPerFacet();
+			pars.push_back("nVertices=" + std::to_string(vertices.size())); //size_t
+			for (const GeoFacetVertex& vertex : vertices) {
+				pars.push_back("xV=" + to_string_with_precision( vertex[0] ));
+				pars.push_back("yV=" + to_string_with_precision( vertex[1] ));
+				pars.push_back("zV=" + to_string_with_precision( vertex[2] ));
+			}
+			pars.push_back("verticesPerFacet=" + std::to_string(verticesPerFacet));
+			pars.push_back("nFacets=" + std::to_string(nFacets)); //size_t
+			for (size_t i=0; i<indices.size(); i+=verticesPerFacet) {
+				// the fourth index of a triangle is left out
+				std::string facet = "iV=" + std::to_string(indices[i]) + "," + std::to_string(indices[i+1]) + "," + std::to_string(indices[i+2]);
+				if (verticesPerFacet == 4 && indices[i+3] != GeoTessellatedSolid::NO_VERTEX) facet += "," + std::to_string(indices[i+3]);
+				pars.push_back(facet);
+			}
+		}
+		else {
+			pars.push_back("nFacets=" + std::to_string(nFacets)); //size_t
+			// loop over the facets
+			for (size_t i=0; i<nFacets; ++i) {
+				GeoFacet* facet = shapeIn->getFacet(i);
+				// get GeoFacet actual implementation
+				if (dynamic_cast<GeoTriangularFacet*>(facet))        pars.push_back("TRI");
+				else if (dynamic_cast<GeoQuadrangularFacet*>(facet)) pars.push_back("QUAD");
+				// get vertex type (ABSOLUTE/RELATIVE)
+				GeoFacet::GeoFacetVertexType facetVertexType = facet->getVertexType();
+				if (facetVertexType == GeoFacet::ABSOLUTE) pars.push_back("vT=ABSOLUTE");
+				if (facetVertexType == GeoFacet::RELATIVE) pars.push_back("vT=RELATIVE");
+				// get number of vertices and loop over them
+				const size_t nVertices = facet->getNumberOfVertices();
+				pars.push_back("nV=" + std::to_string(nVertices)); //size_t
+				for (size_t i=0; i<nVertices; ++i) {
+					GeoFacetVertex facetVertex = facet->getVertex(i);
+					pars.push_back("xV=" + to_string_with_precision( facetVertex[0] ));
+					pars.push_back("yV=" + to_string_with_precision( facetVertex[1] ));
+					pars.push_back("zV=" + to_string_with_precision( facetVertex[2] ));
+				}
 			}
 		}
 	}
@@ -1,21 +1,28 @@
-
 #ifndef tessellatedHandler_H
 #define tessellatedHandler_H
 
-class GeoFacet;
-
 #include "GDMLInterface/GDMLHandler.h"
 #include "GDMLInterface/GDMLController.h"
+#include "GeoModelKernel/GeoFacet.h"
+#include <map>
 #include <string>
+#include <vector>
 
 class tessellatedHandler:public GDMLHandler {
 public:
 	tessellatedHandler(std::string, GDMLController*);
 	void ElementHandle();
 	void postLoopHandling();
-	void addFacet(GeoFacet*);
+	// adds a facet given the names of its three or four vertices
+	void addFacet(const std::vector<std::string>&);
 	
-	std::vector<GeoFacet*> facets;
+	// the solid is built as a mesh, each named vertex being stored once
+	std::map<std::string,unsigned int> vertexIndex;
+	std::vector<GeoFacetVertex> vertices;
+	std::vector<unsigned int> indices;
+	// three indices per facet until the first quadrangle, four from then
+	// on, the triangles being padded with GeoTessellatedSolid::NO_VERTEX
+	bool hasQuadrangles=false;
 	std::string name;
 };
 
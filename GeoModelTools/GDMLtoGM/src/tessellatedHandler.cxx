@@ -1,9 +1,9 @@
 #include "GDMLInterface/tessellatedHandler.h"
 #include "GDMLInterface/GDMLHandler.h"
 #include <iostream>
+#include <utility>
 
 #include "GeoModelKernel/GeoTessellatedSolid.h"
-#include "GeoModelKernel/GeoFacet.h"
 
 
 
@@ -15,21 +15,49 @@ tessellatedHandler::tessellatedHandler(std::string s,GDMLController* g):GDMLHand
 void tessellatedHandler::ElementHandle()
 {
   name=getAttributeAsString("name");
+  vertexIndex.clear();
+  vertices.clear();
+  indices.clear();
+  hasQuadrangles=false;
 }
 
-void tessellatedHandler::addFacet(GeoFacet* f)
+void tessellatedHandler::addFacet(const std::vector<std::string>& vertexNames)
 {
-	static int nEntry=0;
-	//std::cout<<" adding facet "<<nEntry<<std::endl;
-	facets.push_back(f);
-	nEntry++;
+	if (vertexNames.size()==4 && !hasQuadrangles)
+	{
+		// first quadrangle: go over to four indices per facet, padding the triangles so far
+		std::vector<unsigned int> padded;
+		padded.reserve(4*(indices.size()/3+1));
+		for (size_t i=0; i<indices.size(); i++)
+		{
+			padded.push_back(indices[i]);
+			if (i%3==2) padded.push_back(GeoTessellatedSolid::NO_VERTEX);
+		}
+		indices.swap(padded);
+		hasQuadrangles=true;
+	}
+	for (const auto& vertexName: vertexNames)
+	{
+		auto index=vertexIndex.find(vertexName);
+		if (index==vertexIndex.end())
+		{
+			position p=theController->retrievePosition(vertexName);
+			index=vertexIndex.emplace(vertexName,vertices.size()).first;
+			vertices.emplace_back(p.x,p.y,p.z);
+		}
+		indices.push_back(index->second);
+	}
+	if (vertexNames.size()==3 && hasQuadrangles) indices.push_back(GeoTessellatedSolid::NO_VERTEX);
 }
 
 void tessellatedHandler::postLoopHandling() 
 {
-  GeoTessellatedSolid* tessellated=new GeoTessellatedSolid();
-  //std::cout<<" tessellated solid "<<name<<" nr. of facets: "<<facets.size()<<std::endl;
-  for (auto facet: facets)
-  	tessellated->addFacet(facet);
+  // a tessellated solid without facets imports as an empty solid
+  GeoTessellatedSolid* tessellated=indices.empty() ? new GeoTessellatedSolid()
+    : new GeoTessellatedSolid(std::move(vertices),std::move(indices),hasQuadrangles ? 4 : 3);
   theController->saveSolid(name,tessellated);
+  vertexIndex.clear();
+  vertices.clear();
+  indices.clear();
+  hasQuadrangles=false;
 }
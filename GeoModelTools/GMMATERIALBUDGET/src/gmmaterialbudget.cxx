@@ -0,0 +1,141 @@
+/*
+ *   Copyright (C) 2002-2023 CERN for the benefit of the ATLAS collaboration
+*/
+
+/*
+ * gmmaterialbudget: shoots straight rays through the geometry of a GeoModel
+ * SQLite file and writes the material they cross, in radiation lengths and
+ * interaction lengths, as the profiles of GeoMaterialBudget.  Unlike
+ * gmgeantino, it does not need Geant4.
+ */
+
+#include "GeoModelDBManager/GMDBManager.h"
+#include "GeoModelRead/ReadGeoModel.h"
+
+#include "GeoModelKernel/GeoMaterialBudget.h"
+#include "GeoModelKernel/GeoPhysVol.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, char ** argv) {
+
+  //
+  // Usage message:
+  //
+  std::string gmmaterialbudget= argv[0];
+  std::string usage= "usage: " + gmmaterialbudget
+    + " [-n nRays] [-s seed] [-t nThreads] [-e etaMin etaMax] [-p phiMin phiMax]"
+    + " [-d] [-m] [-x] [-o outputFile] file.db";
+  //
+  // Print usage message if no args given:
+  //
+  if (argc==1) {
+    std::cerr << usage << std::endl;
+    return 0;
+  }
+  //
+  // Parse the command line:
+  //
+  GeoMaterialBudget::Config config;
+  std::string inputFile;
+  std::string outputFile;
+  for (int argi=1;argi<argc;argi++) {
+    std::string argument=argv[argi];
+    // The number of values the option takes
+    int nValues = (argument=="-e" || argument=="-p") ? 2
+      : (argument=="-n" || argument=="-s" || argument=="-t" || argument=="-o") ? 1 : 0;
+    if (argi+nValues>=argc) {
+      std::cerr << "Missing value for " << argument << std::endl;
+      std::cerr << usage << std::endl;
+      return 1;
+    }
+    if (argument=="-n") {
+      config.nRays=std::strtoul(argv[++argi],nullptr,10);
+    }
+    else if (argument=="-s") {
+      config.seed=std::strtoul(argv[++argi],nullptr,10);
+    }
+    else if (argument=="-t") {
+      config.nThreads=std::strtoul(argv[++argi],nullptr,10);
+    }
+    else if (argument=="-e") {
+      config.etaMin=std::atof(argv[++argi]);
+      config.etaMax=std::atof(argv[++argi]);
+    }
+    else if (argument=="-p") {
+      config.phiMin=std::atof(argv[++argi]);
+      config.phiMax=std::atof(argv[++argi]);
+    }
+    else if (argument=="-d") {
+      config.detectorsMaps=true;
+    }
+    else if (argument=="-m") {
+      config.materialsMaps=true;
+    }
+    else if (argument=="-x") {
+      config.elementsMaps=true;
+    }
+    else if (argument=="-o") {
+      outputFile=argv[++argi];
+    }
+    else if (argument.find(".db")!=std::string::npos && inputFile.empty()) {
+      inputFile=argument;
+    }
+    else {
+      std::cerr << "Unrecognized argument " << argument << std::endl;
+      std::cerr << usage << std::endl;
+      return 2;
+    }
+  }
+  if (inputFile.empty()) {
+    std::cerr << "No input file" << std::endl;
+    std::cerr << usage << std::endl;
+    return 3;
+  }
+  if (config.etaMin>=config.etaMax || config.phiMin>=config.phiMax) {
+    std::cerr << "Empty eta or phi range" << std::endl;
+    return 4;
+  }
+
+  //
+  // Build the geometry:
+  //
+  GMDBManager db(inputFile);
+  if (!db.checkIsDBOpen()) {
+    std::cerr << "gmmaterialbudget -- Error opening the input file: " << inputFile << std::endl;
+    return 5;
+  }
+  GeoModelIO::ReadGeoModel readInGeo(&db);
+  GeoPhysVol* world = readInGeo.buildGeoModel();
+  if (!world) {
+    std::cerr << "gmmaterialbudget -- No geometry in " << inputFile << std::endl;
+    return 6;
+  }
+  world->ref();
+
+  //
+  // Scan, and write the profiles:
+  //
+  {
+    GeoMaterialBudget budget(world);
+    GeoMaterialBudget::Maps maps = budget.scan(config);
+    if (outputFile.empty()) {
+      GeoMaterialBudget::write(maps,std::cout);
+    }
+    else {
+      std::ofstream out(outputFile);
+      if (!out) {
+        std::cerr << "gmmaterialbudget -- Error opening the output file: " << outputFile << std::endl;
+        world->unref();
+        return 7;
+      }
+      GeoMaterialBudget::write(maps,out);
+    }
+  }
+
+  world->unref();
+  return 0;
+}
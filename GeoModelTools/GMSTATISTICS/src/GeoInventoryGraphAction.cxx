@@ -14,11 +14,29 @@ GeoInventoryGraphAction::GeoInventoryGraphAction (std::ostream &o)
   , m_serialDenominatorState(true)
   , m_serialTransformerState(true)
   , m_identifierState(true)
+  , m_leadingIndent(0)
   , m_o(o)
   , m_indented(false)
 {
 }
 
+GeoInventoryGraphAction::GeoInventoryGraphAction (std::unique_ptr<std::ostringstream> buffer)
+  : m_nameTag(nullptr)
+  , m_serialDenominator(nullptr)
+  , m_idTag(nullptr)
+  , m_transformState(true)
+  , m_volumeState(true)
+  , m_nametagState(true)
+  , m_serialDenominatorState(true)
+  , m_serialTransformerState(true)
+  , m_identifierState(true)
+  , m_buffer(std::move(buffer))
+  , m_leadingIndent(0)
+  , m_o(*m_buffer)
+  , m_indented(false)
+{
+}
+
 GeoInventoryGraphAction::~GeoInventoryGraphAction()
 {
 }
@@ -106,10 +124,35 @@ void GeoInventoryGraphAction::indent ()
 {
   if (!m_indented) {
     m_indented=true;
+    if (m_buffer && m_buffer->tellp()==0) m_leadingIndent = 3*getPath()->getLength();
     for (size_t i=0;i<getPath()->getLength(); i++) {
       m_o << "   ";
     }
   }
 }
 
+GeoNodeAction* GeoInventoryGraphAction::clone () const
+{
+  GeoInventoryGraphAction* action = new GeoInventoryGraphAction(std::make_unique<std::ostringstream>());
+  action->m_transformState = m_transformState;
+  action->m_volumeState = m_volumeState;
+  action->m_nametagState = m_nametagState;
+  action->m_serialDenominatorState = m_serialDenominatorState;
+  action->m_serialTransformerState = m_serialTransformerState;
+  action->m_identifierState = m_identifierState;
+  return action;
+}
 
+void GeoInventoryGraphAction::merge (const GeoNodeAction &other)
+{
+  const GeoInventoryGraphAction& clone = static_cast<const GeoInventoryGraphAction &>(other);
+  if (!clone.m_buffer) return;
+  const std::string text = clone.m_buffer->str();
+  if (text.empty()) return;
+  //
+  // Continue a line left open by the previous clone, without indenting:
+  //
+  size_t skip = m_indented ? clone.m_leadingIndent : 0;
+  m_o << text.substr(skip);
+  m_indented = clone.m_indented;
+}
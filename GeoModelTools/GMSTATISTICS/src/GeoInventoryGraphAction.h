@@ -15,10 +15,17 @@
  *      * SerialDenominators
  *      * SerialTransforms 
  *      * IdentifierTag
+ *
+ * It can be executed with GeoParallelTraversal: each clone prints into a
+ * buffer, and the buffers are printed in order when merged.  A line may
+ * run over from one clone to the next, in which case the indent printed
+ * by the second clone is dropped.
  */
 
 #include "GeoModelKernel/GeoNodeAction.h"
 #include <iostream>
+#include <memory>
+#include <sstream>
 
 class GeoInventoryGraphAction : public GeoNodeAction
 {
@@ -53,8 +60,17 @@ class GeoInventoryGraphAction : public GeoNodeAction
   
   //	Sets the notification state.  Default: everything on.
   void setNotification (Type type, bool state);
+
+  //	Returns a clone printing into its own buffer.
+  virtual GeoNodeAction* clone () const;
+
+  //	Prints the buffer of a clone.
+  virtual void merge (const GeoNodeAction &other);
   
  private:
+  //	Constructs a clone, printing into the buffer.
+  GeoInventoryGraphAction (std::unique_ptr<std::ostringstream> buffer);
+
   GeoInventoryGraphAction(const GeoInventoryGraphAction &right);
   GeoInventoryGraphAction & operator=(const GeoInventoryGraphAction &right);
   
@@ -92,6 +108,12 @@ class GeoInventoryGraphAction : public GeoNodeAction
   //	On/off flag for identifier tags.
   bool m_identifierState;
 
+  //	The buffer of a clone.
+  std::unique_ptr<std::ostringstream> m_buffer;
+
+  //	The length of the indent at the start of the buffer.
+  size_t m_leadingIndent;
+
   std::ostream &m_o;
 
   //	Flag for indent (intially 0)
@@ -12,6 +12,8 @@
 #include "GeoModelKernel/GeoCountVolAction.h"
 #include "GeoModelKernel/GeoAccessVolumeAction.h"
 #include "GeoModelKernel/GeoNameTag.h"
+#include "GeoModelKernel/GeoMemoryAccountAction.h"
+#include "GeoModelKernel/GeoParallelTraversal.h"
 #include "GeoInventoryGraphAction.h"
 #include <fstream>
 #include <iostream>
@@ -60,8 +62,9 @@ int main(int argc, char ** argv) {
   //
   std::string xtraOpts="";
   bool printTree=false;
+  bool printMemory=false;
   std::string gmstat= argv[0];
-  std::string usage= "usage: " + gmstat + " [-p] " + xtraOpts +  "[plugin1"+shared_obj_extension
+  std::string usage= "usage: " + gmstat + " [-p] [-j] " + xtraOpts +  "[plugin1"+shared_obj_extension
     + "] [plugin2" + shared_obj_extension
     + "] ";
   //
@@ -85,6 +88,9 @@ int main(int argc, char ** argv) {
     else if (argument=="-p") {
       printTree=true;
     }
+    else if (argument=="-j") {
+      printMemory=true;
+    }
     else {
       std::cerr << "Unrecognized argument " << argument << std::endl;
       std::cerr << usage << std::endl;
@@ -151,8 +157,16 @@ int main(int argc, char ** argv) {
     std::cout.rdbuf(coutBuff);
  
     if (printTree) {
+      // The subtrees are printed in parallel, and in order
       GeoInventoryGraphAction action(std::cout);
+      GeoParallelTraversal::exec(world,&action);
+    }
+
+    if (printMemory) {
+      // Bytes by node class, shape type and subtree, as JSON
+      GeoMemoryAccountAction action;
       world->exec(&action);
+      action.writeJSON(std::cout);
     }
 
 #ifndef __APPLE__